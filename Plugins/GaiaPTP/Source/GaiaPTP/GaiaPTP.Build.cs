@@ -21,10 +21,20 @@ public class GaiaPTP : ModuleRules
         PrivateDependencyModuleNames.AddRange(new string[]
         {
             "Projects",
+            "RealtimeMeshExt",
+            // 16-bit heightfield tiles and their JSON manifest
+            "ImageCore",
+            "Json",
             // Access public headers from CGAL provider module (IPTPAdjacencyProvider)
             "GaiaPTPCGAL"
         });
 
+        if (Target.bBuildEditor)
+        {
+            // Rebuild progress notifications
+            PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
+        }
+
         PublicIncludePaths.AddRange(new string[]
         {
             System.IO.Path.Combine(ModuleDirectory, "Public")
@@ -3,10 +3,17 @@
 #include "Async/ParallelFor.h"
 #include "GaiaPTP.h"
 #include "HAL/PlatformTime.h"
-
-void FCrustInitialization::InitializeCrustData(
-    const TArray<FVector>& SamplePoints,
-    const TArray<TArray<int32>>& PlateToPoints,
+#include "PTPArena.h"
+#include "PTPPlatePartition.h"
+#include "PTPProfiling.h"
+#include "PTPRandom.h"
+#include "PTPSimd.h"
+
+template <typename VectorType>
+void FCrustInitialization::InitializeCrustDataForPlates(
+    const TArray<VectorType>& SamplePoints,
+    int32 NumPlates,
+    TFunctionRef<TConstArrayView<int32>(int32)> GetPlatePoints,
     float ContinentalRatio,
     float AbyssalPlainElevationKm,
     float HighestOceanicRidgeElevationKm,
@@ -15,7 +22,6 @@ void FCrustInitialization::InitializeCrustData(
 )
 {
     const int32 NumPoints = SamplePoints.Num();
-    const int32 NumPlates = PlateToPoints.Num();
 
     OutCrustData.SetNum(NumPoints);
 
@@ -23,50 +29,69 @@ void FCrustInitialization::InitializeCrustData(
     TArray<bool> IsPlateContinent;
     ClassifyPlates(NumPlates, ContinentalRatio, Seed, IsPlateContinent);
 
-    FRandomStream RandStream(Seed + 1); // Offset seed for different random sequence
+    // Step 2: Initialize crust data for each plate, split into balanced items so large plates do not serialize the pass
+    const bool bDoParallel = PTPProfiling::IsParallelEnabled();
 
-    // Step 2: Initialize crust data for each plate (parallelizable)
-    const bool bDoParallel = IConsoleManager::Get().FindConsoleVariable(TEXT("ptp.parallel"))
-        ? IConsoleManager::Get().FindConsoleVariable(TEXT("ptp.parallel"))->GetInt() != 0
-        : true;
+    FPTPPlatePartition Partition;
+    Partition.Build(NumPlates, [&GetPlatePoints](int32 PlateIdx) { return GetPlatePoints(PlateIdx).Num(); });
 
-    auto WorkPerPlate = [&](int32 PlateIdx)
-    {
-        const bool bIsContinental = IsPlateContinent[PlateIdx];
-        const TArray<int32>& PlatePoints = PlateToPoints[PlateIdx];
+    // Plate centroids for distance calculations: per-item partial sums folded per plate (double, see PTPPrecision.h)
+    TArray<FVector> PartialSums;
+    PartialSums.SetNumUninitialized(Partition.GetNumItems());
+    TArray<FVector> PlateCentroids;
+    PlateCentroids.SetNumUninitialized(NumPlates);
 
-        // Deterministic per-plate RNG (order independent)
-        FRandomStream LocalRand(Seed + 1000 + PlateIdx * 10007);
-
-        // Compute plate centroid for distance calculations
-        FVector PlateCentroid = FVector::ZeroVector;
-        for (int32 PointIdx : PlatePoints)
+    const double StartTime = FPlatformTime::Seconds();
+    Partition.Dispatch(
+        [](int32 PlateIdx) {},
+        [&](int32 ItemIdx, const FPTPPlateWorkItem& Item)
         {
-            PlateCentroid += SamplePoints[PointIdx];
-        }
-        if (PlatePoints.Num() > 0)
+            FVector Sum = FVector::ZeroVector;
+            for (int32 PointIdx : Item.Slice(GetPlatePoints(Item.Plate)))
+            {
+                Sum += FVector(SamplePoints[PointIdx]);
+            }
+            PartialSums[ItemIdx] = Sum;
+        },
+        [&](int32 PlateIdx)
         {
-            PlateCentroid /= PlatePoints.Num();
-            PlateCentroid.Normalize();
-        }
+            // Folded in item order, so the centroid does not depend on which worker finished first
+            const int32 FirstItem = Partition.GetFirstItem(PlateIdx);
+            FVector Centroid = FVector::ZeroVector;
+            for (int32 i = 0; i < Partition.GetPlateItems(PlateIdx).Num(); ++i)
+            {
+                Centroid += PartialSums[FirstItem + i];
+            }
+            PlateCentroids[PlateIdx] = Centroid.GetSafeNormal();
+        },
+        !bDoParallel);
+
+    Partition.Dispatch([&](int32 ItemIdx, const FPTPPlateWorkItem& Item)
+    {
+        const int32 PlateIdx = Item.Plate;
+        const bool bIsContinental = IsPlateContinent[PlateIdx];
+        const FVector& PlateCentroid = PlateCentroids[PlateIdx];
 
-        for (int32 PointIdx : PlatePoints)
+        for (int32 PointIdx : Item.Slice(GetPlatePoints(PlateIdx)))
         {
             FCrustData& Crust = OutCrustData[PointIdx];
 
+            // Counter-based per-point RNG: the same values however the plate is split (PTPRandom.h)
+            const uint32 PointHash = FPTPHash::Hash((uint32)Seed + 1000u, (uint32)PlateIdx, (uint32)PointIdx);
+
             if (bIsContinental)
             {
                 // Continental crust
                 Crust.Type = ECrustType::Continental;
                 Crust.Thickness = 35.0f; // km
-                Crust.Elevation = 0.5f + LocalRand.FRandRange(-0.2f, 0.2f); // ~0.5km with variation
-                Crust.OrogenyAge = LocalRand.FRandRange(500.0f, 3000.0f); // 500-3000 My
+                Crust.Elevation = 0.5f + FMath::Lerp(-0.2f, 0.2f, FPTPHash::UnitFloat(PointHash)); // ~0.5km with variation
+                Crust.OrogenyAge = FMath::Lerp(500.0f, 3000.0f, FPTPHash::UnitFloat(FPTPHash::Mix(PointHash))); // 500-3000 My
                 Crust.OrogenyType = EOrogenyType::None; // Set during collisions later
-                Crust.FoldDirection = FVector::ZeroVector; // Set during collisions later
+                Crust.FoldDirection = FVector3f::ZeroVector; // Set during collisions later
 
                 // Reset oceanic fields
                 Crust.OceanicAge = 0.0f;
-                Crust.RidgeDirection = FVector::ZeroVector;
+                Crust.RidgeDirection = FVector3f::ZeroVector;
             }
             else
             {
@@ -76,7 +101,7 @@ void FCrustInitialization::InitializeCrustData(
 
                 // Elevation varies linearly from ridge (center) to abyssal plain (edge)
                 // Distance from plate center determines age and elevation
-                const FVector& Point = SamplePoints[PointIdx];
+                const FVector Point(SamplePoints[PointIdx]);
                 const float DistanceAngle = FMath::Acos(FMath::Clamp(FVector::DotProduct(Point, PlateCentroid), -1.0f, 1.0f));
                 const float MaxAngle = PI / 4.0f; // Assume max distance is ~45 degrees
                 const float NormalizedDist = FMath::Clamp(DistanceAngle / MaxAngle, 0.0f, 1.0f);
@@ -91,32 +116,64 @@ void FCrustInitialization::InitializeCrustData(
                 FVector ToCenter = PlateCentroid - Point;
                 ToCenter.Normalize();
                 FVector Perpendicular = FVector::CrossProduct(ToCenter, Point); // Tangent on sphere
-                Crust.RidgeDirection = Perpendicular.GetSafeNormal();
+                Crust.RidgeDirection = FVector3f(Perpendicular.GetSafeNormal());
 
                 // Reset continental fields
                 Crust.OrogenyAge = 0.0f;
                 Crust.OrogenyType = EOrogenyType::None;
-                Crust.FoldDirection = FVector::ZeroVector;
+                Crust.FoldDirection = FVector3f::ZeroVector;
             }
         }
-    };
+    }, !bDoParallel);
 
-    const double StartTime = FPlatformTime::Seconds();
-    if (bDoParallel)
-    {
-        ParallelFor(NumPlates, WorkPerPlate);
-        const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
-        UE_LOG(LogGaiaPTP, Log, TEXT("Crust init: %d plates parallelized in %.2fms"), NumPlates, ElapsedMs);
-    }
-    else
-    {
-        for (int32 PlateIdx = 0; PlateIdx < NumPlates; ++PlateIdx)
-        {
-            WorkPerPlate(PlateIdx);
-        }
-        const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
-        UE_LOG(LogGaiaPTP, Log, TEXT("Crust init: %d plates sequential in %.2fms"), NumPlates, ElapsedMs);
-    }
+    const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    UE_LOG(LogGaiaPTP, Log, TEXT("Crust init: %d plates in %d items %s in %.2fms"), NumPlates, Partition.GetNumItems(),
+        bDoParallel ? TEXT("parallelized") : TEXT("sequential"), ElapsedMs);
+}
+
+void FCrustInitialization::InitializeCrustData(
+    const TArray<FVector>& SamplePoints,
+    const TArray<TArray<int32>>& PlateToPoints,
+    float ContinentalRatio,
+    float AbyssalPlainElevationKm,
+    float HighestOceanicRidgeElevationKm,
+    int32 Seed,
+    TArray<FCrustData>& OutCrustData
+)
+{
+    InitializeCrustDataForPlates(SamplePoints, PlateToPoints.Num(),
+        [&PlateToPoints](int32 PlateIdx) { return TConstArrayView<int32>(PlateToPoints[PlateIdx]); },
+        ContinentalRatio, AbyssalPlainElevationKm, HighestOceanicRidgeElevationKm, Seed, OutCrustData);
+}
+
+void FCrustInitialization::InitializeCrustData(
+    const TArray<FVector>& SamplePoints,
+    const FPTPPlateMembership& Membership,
+    float ContinentalRatio,
+    float AbyssalPlainElevationKm,
+    float HighestOceanicRidgeElevationKm,
+    int32 Seed,
+    TArray<FCrustData>& OutCrustData
+)
+{
+    InitializeCrustDataForPlates(SamplePoints, Membership.GetNumPlates(),
+        [&Membership](int32 PlateIdx) { return Membership.GetPlatePoints(PlateIdx); },
+        ContinentalRatio, AbyssalPlainElevationKm, HighestOceanicRidgeElevationKm, Seed, OutCrustData);
+}
+
+void FCrustInitialization::InitializeCrustData(
+    const TArray<FVector3f>& SamplePoints,
+    const FPTPPlateMembership& Membership,
+    float ContinentalRatio,
+    float AbyssalPlainElevationKm,
+    float HighestOceanicRidgeElevationKm,
+    int32 Seed,
+    TArray<FCrustData>& OutCrustData
+)
+{
+    InitializeCrustDataForPlates(SamplePoints, Membership.GetNumPlates(),
+        [&Membership](int32 PlateIdx) { return Membership.GetPlatePoints(PlateIdx); },
+        ContinentalRatio, AbyssalPlainElevationKm, HighestOceanicRidgeElevationKm, Seed, OutCrustData);
 }
 
 void FCrustInitialization::InitializePlateDynamics(
@@ -169,9 +226,7 @@ void FCrustInitialization::DetectPlateBoundaries(
     const int32 NumPoints = PointPlateIds.Num();
     OutIsBoundaryPoint.SetNumZeroed(NumPoints);
 
-    const bool bDoParallel = IConsoleManager::Get().FindConsoleVariable(TEXT("ptp.parallel"))
-        ? IConsoleManager::Get().FindConsoleVariable(TEXT("ptp.parallel"))->GetInt() != 0
-        : true;
+    const bool bDoParallel = PTPProfiling::IsParallelEnabled();
 
     auto WorkPerPoint = [&](int32 PointIdx)
     {
@@ -209,6 +264,194 @@ void FCrustInitialization::DetectPlateBoundaries(
     }
 }
 
+namespace
+{
+    template <typename VectorType>
+    void ClassifyBoundaries(
+        const TArray<VectorType>& SamplePoints,
+        const TArray<int32>& PointPlateIds,
+        const TArray<FTectonicPlate>& Plates,
+        const TArray<TArray<int32>>& Neighbors,
+        TArray<EPTPBoundaryType>& OutBoundaryTypes,
+        FPTPStepScratch* Scratch)
+    {
+        FPTPKernelScratchScope KernelScope(Scratch, TEXT("ClassifyBoundaries"));
+        const int32 NumPoints = PointPlateIds.Num();
+        OutBoundaryTypes.SetNumZeroed(NumPoints);
+
+        const bool bDoParallel = PTPProfiling::IsParallelEnabled();
+
+        ParallelFor(NumPoints, [&](int32 PointIdx)
+        {
+            const int32 MyPlateId = PointPlateIds[PointIdx];
+            if (!Neighbors.IsValidIndex(PointIdx) || !Plates.IsValidIndex(MyPlateId) || !SamplePoints.IsValidIndex(PointIdx))
+            {
+                return;
+            }
+            const FVector P(SamplePoints[PointIdx]);
+
+            // Boundary normal: mean direction towards neighbors on other plates, in the tangent plane
+            FVector Normal = FVector::ZeroVector;
+            int32 OtherPlateId = INDEX_NONE;
+            for (int32 NeighborIdx : Neighbors[PointIdx])
+            {
+                if (PointPlateIds.IsValidIndex(NeighborIdx) && PointPlateIds[NeighborIdx] != MyPlateId && SamplePoints.IsValidIndex(NeighborIdx))
+                {
+                    Normal += (FVector(SamplePoints[NeighborIdx]) - P).GetSafeNormal();
+                    if (OtherPlateId == INDEX_NONE || !Plates.IsValidIndex(OtherPlateId))
+                    {
+                        OtherPlateId = PointPlateIds[NeighborIdx];
+                    }
+                }
+            }
+            if (OtherPlateId == INDEX_NONE)
+            {
+                return;
+            }
+            const FVector Up = P.GetSafeNormal();
+            Normal = (Normal - FVector::DotProduct(Normal, Up) * Up).GetSafeNormal();
+
+            // Both velocities are taken at this point so only the plates' relative motion counts
+            const FVector Relative = Plates[MyPlateId].GetVelocityAtPoint(P)
+                - (Plates.IsValidIndex(OtherPlateId) ? Plates[OtherPlateId].GetVelocityAtPoint(P) : FVector::ZeroVector);
+            const double Speed = Relative.Size();
+            const double Approach = Speed > UE_KINDA_SMALL_NUMBER ? FVector::DotProduct(Relative, Normal) / Speed : 0.0;
+            OutBoundaryTypes[PointIdx] = Approach > 0.5 ? EPTPBoundaryType::Convergent
+                : Approach < -0.5 ? EPTPBoundaryType::Divergent
+                : EPTPBoundaryType::Transform;
+        }, !bDoParallel);
+    }
+
+    template <typename VectorType>
+    void DistanceToFront(
+        const TArray<VectorType>& SamplePoints,
+        const TArray<TArray<int32>>& Neighbors,
+        const TArray<EPTPBoundaryType>& BoundaryTypes,
+        TArray<float>& OutDistanceKm,
+        FPTPStepScratch* Scratch)
+    {
+        // Without a caller's scratch the kernel still runs on arenas, they just die with it
+        TOptional<FPTPStepScratch> LocalScratch;
+        if (!Scratch)
+        {
+            Scratch = &LocalScratch.Emplace();
+        }
+        FPTPKernelScratchScope KernelScope(Scratch, TEXT("DistanceToFront"));
+        FPTPArena& StepArena = Scratch->GetStepArena();
+
+        const int32 NumPoints = SamplePoints.Num();
+        OutDistanceKm.Init(TNumericLimits<float>::Max(), NumPoints);
+
+        struct FQueueEntry
+        {
+            float Distance;
+            int32 PointIdx;
+            bool operator<(const FQueueEntry& Other) const { return Distance < Other.Distance; }
+        };
+
+        const bool bDoParallel = PTPProfiling::IsParallelEnabled();
+
+        // Gather convergent points per chunk into the chunk's own slice of one step span. A chunk never has more
+        // seeds than points, so the bytes are the same every step whichever workers run the chunks
+        const int32 NumChunks = PTPSimd::NumChunks(NumPoints);
+        TArrayView<int32> SeedSlots = StepArena.NewSpan<int32>(NumPoints);
+        TArrayView<TArrayView<int32>> ChunkSeeds = StepArena.NewSpan<TArrayView<int32>>(NumChunks);
+        ParallelFor(NumChunks, [&](int32 ChunkIdx)
+        {
+            const int32 Begin = ChunkIdx * PTPSimd::ChunkSize;
+            const int32 End = FMath::Min(Begin + PTPSimd::ChunkSize, NumPoints);
+            int32 NumSeeds = 0;
+            for (int32 PointIdx = Begin; PointIdx < End; ++PointIdx)
+            {
+                if (BoundaryTypes.IsValidIndex(PointIdx) && BoundaryTypes[PointIdx] == EPTPBoundaryType::Convergent)
+                {
+                    OutDistanceKm[PointIdx] = 0.0f;
+                    SeedSlots[Begin + NumSeeds++] = PointIdx;
+                }
+            }
+            ChunkSeeds[ChunkIdx] = SeedSlots.Slice(Begin, NumSeeds);
+        }, !bDoParallel);
+
+        // Seed with every convergent point, then settle points in order of distance
+        TPTPArenaArray<FQueueEntry> Queue(StepArena, NumPoints / 4);
+        for (const TArrayView<int32>& Seeds : ChunkSeeds)
+        {
+            for (int32 PointIdx : Seeds)
+            {
+                Queue.HeapPush({ 0.0f, PointIdx });
+            }
+        }
+
+        while (!Queue.IsEmpty())
+        {
+            const FQueueEntry Entry = Queue.HeapPop();
+            if (Entry.Distance > OutDistanceKm[Entry.PointIdx] || !Neighbors.IsValidIndex(Entry.PointIdx))
+            {
+                continue;   // stale entry
+            }
+            for (int32 NeighborIdx : Neighbors[Entry.PointIdx])
+            {
+                if (!SamplePoints.IsValidIndex(NeighborIdx))
+                {
+                    continue;
+                }
+                const float Distance = Entry.Distance + (float)(SamplePoints[Entry.PointIdx] - SamplePoints[NeighborIdx]).Size();
+                if (Distance < OutDistanceKm[NeighborIdx])
+                {
+                    OutDistanceKm[NeighborIdx] = Distance;
+                    Queue.HeapPush({ Distance, NeighborIdx });
+                }
+            }
+        }
+    }
+}
+
+void FCrustInitialization::ClassifyPlateBoundaries(
+    const TArray<FVector>& SamplePoints,
+    const TArray<int32>& PointPlateIds,
+    const TArray<FTectonicPlate>& Plates,
+    const TArray<TArray<int32>>& Neighbors,
+    TArray<EPTPBoundaryType>& OutBoundaryTypes,
+    FPTPStepScratch* Scratch
+)
+{
+    ClassifyBoundaries(SamplePoints, PointPlateIds, Plates, Neighbors, OutBoundaryTypes, Scratch);
+}
+
+void FCrustInitialization::ClassifyPlateBoundaries(
+    const TArray<FVector3f>& SamplePoints,
+    const TArray<int32>& PointPlateIds,
+    const TArray<FTectonicPlate>& Plates,
+    const TArray<TArray<int32>>& Neighbors,
+    TArray<EPTPBoundaryType>& OutBoundaryTypes,
+    FPTPStepScratch* Scratch
+)
+{
+    ClassifyBoundaries(SamplePoints, PointPlateIds, Plates, Neighbors, OutBoundaryTypes, Scratch);
+}
+
+void FCrustInitialization::ComputeDistanceToFront(
+    const TArray<FVector>& SamplePoints,
+    const TArray<TArray<int32>>& Neighbors,
+    const TArray<EPTPBoundaryType>& BoundaryTypes,
+    TArray<float>& OutDistanceKm,
+    FPTPStepScratch* Scratch
+)
+{
+    DistanceToFront(SamplePoints, Neighbors, BoundaryTypes, OutDistanceKm, Scratch);
+}
+
+void FCrustInitialization::ComputeDistanceToFront(
+    const TArray<FVector3f>& SamplePoints,
+    const TArray<TArray<int32>>& Neighbors,
+    const TArray<EPTPBoundaryType>& BoundaryTypes,
+    TArray<float>& OutDistanceKm,
+    FPTPStepScratch* Scratch
+)
+{
+    DistanceToFront(SamplePoints, Neighbors, BoundaryTypes, OutDistanceKm, Scratch);
+}
+
 void FCrustInitialization::ClassifyPlates(
     int32 NumPlates,
     float ContinentalRatio,
@@ -10,6 +10,7 @@ UGaiaPTPSettings::UGaiaPTPSettings()
     NumSamplePoints = 500000;            // default sphere sampling
     DebugDrawStride = 50;                // draw 1 of N points in debug overlays
     bAllowDynamicResample = true;
+    MemoryBudgetMB = 1024;               // warn past 1 GB per planet; see ptp.mem.report
     InitialSeed = 1337;
     NumPlates = 40;                      // typical initial plate count
     ContinentalRatio = 0.3f;             // 30% continental
@@ -0,0 +1,886 @@
+#include "PTPAdaptiveSubdivider.h"
+#include "Async/ParallelFor.h"
+#include "GaiaPTP.h"
+#include "PTPPlanetChunks.h"
+#include "PTPPlanetMeshBuilder.h"
+#include "PTPProfiling.h"
+#include "RealtimeMeshSimple.h"
+#include "Core/RealtimeMeshDataStream.h"
+#include "Core/RealtimeMeshDataTypes.h"
+
+namespace
+{
+    FORCEINLINE uint64 EdgeKey(int32 A, int32 B)
+    {
+        return (uint64(uint32(FMath::Min(A, B))) << 32) | uint64(uint32(FMath::Max(A, B)));
+    }
+}
+
+void FPTPSubdivisionDelta::Reset()
+{
+    Patches.Reset();
+    RemovedPatches.Reset();
+    NumSplits = 0;
+    NumMerges = 0;
+    NumNewVertices = 0;
+    NumChecks = 0;
+}
+
+void FPTPAdaptiveSubdivider::Reset()
+{
+    HeightSource = nullptr;
+    Nodes.Empty();
+    FreeBlocks.Empty();
+    NumBaseNodes = 0;
+    NumLeaves = 0;
+    Vertices.Empty();
+    FreeVertices.Empty();
+    PendingVertices.Empty();
+    Edges.Empty();
+    FreeEdges.Empty();
+    EdgeLookup.Empty();
+    Patches.Empty();
+    FreePatches.Empty();
+    DirtyPatches.Empty();
+    RemovedPatches.Empty();
+    NumLivePatches = 0;
+    Queue.Empty();
+    TravelKm = 0.0;
+    LastQueryKm = FVector::ZeroVector;
+    bHasQuery = false;
+}
+
+void FPTPAdaptiveSubdivider::Build(const TArray<FVector3f>& Points, const TArray<FIntVector>& Triangles, const FPTPSubdivisionSettings& InSettings,
+                                   FPTPPointHeightSource InHeightSource)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, AdaptiveSubdivisionBuild);
+    Reset();
+    Settings = InSettings;
+    Settings.SplitRatio = FMath::Max(Settings.SplitRatio, UE_KINDA_SMALL_NUMBER);
+    Settings.MergeHysteresis = FMath::Max(Settings.MergeHysteresis, 1.01f);
+    Settings.MaxLevel = FMath::Clamp(Settings.MaxLevel, 0, 24);
+    Settings.PatchLevels = FMath::Max(Settings.PatchLevels, 1);
+    Settings.MaxSplitsPerUpdate = FMath::Max(Settings.MaxSplitsPerUpdate, 1);
+    HeightSource = MoveTemp(InHeightSource);
+
+    const int32 NumPoints = Points.Num();
+    TArray<FVector3f> Directions;
+    Directions.SetNumUninitialized(NumPoints);
+    Vertices.SetNum(NumPoints);
+    PendingVertices.SetNumUninitialized(NumPoints);
+    for (int32 v = 0; v < NumPoints; ++v)
+    {
+        Directions[v] = Points[v].GetSafeNormal(UE_SMALL_NUMBER, FVector3f::UnitZ());
+        Vertices[v].Direction = Directions[v];
+        Vertices[v].bAlive = true;
+        Vertices[v].bPending = true;
+        PendingVertices[v] = v;
+    }
+
+    // Every base triangle wound outward, so children and leaf patterns are too
+    TArray<FIntVector> Base;
+    Base.Reserve(Triangles.Num());
+    for (const FIntVector& Tri : Triangles)
+    {
+        if (Tri.X < 0 || Tri.X >= NumPoints || Tri.Y < 0 || Tri.Y >= NumPoints || Tri.Z < 0 || Tri.Z >= NumPoints)
+        {
+            continue;
+        }
+        const FVector3f& A = Directions[Tri.X];
+        const FVector3f& B = Directions[Tri.Y];
+        const FVector3f& C = Directions[Tri.Z];
+        const bool bInward = FVector3f::DotProduct(FVector3f::CrossProduct(B - A, C - A), A + B + C) < 0.0f;
+        Base.Add(bInward ? FIntVector(Tri.X, Tri.Z, Tri.Y) : Tri);
+    }
+
+    NumBaseNodes = Base.Num();
+    NumLeaves = NumBaseNodes;
+    Nodes.SetNum(NumBaseNodes);
+    for (int32 t = 0; t < NumBaseNodes; ++t)
+    {
+        InitNode(t, Base[t].X, Base[t].Y, Base[t].Z, INDEX_NONE, 0);
+    }
+
+    // Root patches are the cube-face chunks the preview mesh culls by
+    FPTPPlanetChunks Chunks;
+    Chunks.Build(Directions, Base, FMath::Max(Settings.RootPatchLevel, 0), 1.0f);
+    const TConstArrayView<int32> Order = Chunks.GetTriangleOrder();
+    for (int32 Chunk = 0; Chunk < Chunks.GetNumChunks(); ++Chunk)
+    {
+        if (Chunks.GetChunkBegin(Chunk) == Chunks.GetChunkEnd(Chunk))
+        {
+            continue;
+        }
+        const int32 Patch = AllocPatch();
+        for (int32 k = Chunks.GetChunkBegin(Chunk); k < Chunks.GetChunkEnd(Chunk); ++k)
+        {
+            Patches[Patch].Roots.Add(Order[k]);
+            Nodes[Order[k]].Patch = Patch;
+        }
+    }
+
+    for (int32 t = 0; t < NumBaseNodes; ++t)
+    {
+        Schedule(t, 0.0);
+    }
+    EvaluatePending();
+
+    UE_LOG(LogGaiaPTP, Log, TEXT("Adaptive subdivision: %d base triangles in %d root patches, up to %d levels"),
+        NumBaseNodes, NumLivePatches, Settings.MaxLevel);
+}
+
+bool FPTPAdaptiveSubdivider::Update(const FVector& QueryPointKm, FPTPSubdivisionDelta& OutDelta)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, AdaptiveSubdivision);
+    OutDelta.Reset();
+
+    // Every due time is in distance travelled by the query point, so a still camera pops nothing
+    if (bHasQuery)
+    {
+        TravelKm += FVector::Distance(QueryPointKm, LastQueryKm);
+    }
+    LastQueryKm = QueryPointKm;
+    bHasQuery = true;
+
+    SplitBudget = Settings.MaxSplitsPerUpdate;
+    UpdateSplits = 0;
+    UpdateMerges = 0;
+    bool bComplete = true;
+    while (Queue.Num() > 0 && Queue.HeapTop().Deadline <= TravelKm)
+    {
+        if (SplitBudget <= 0)
+        {
+            bComplete = false;
+            break;
+        }
+        FCheck Due;
+        Queue.HeapPop(Due, EAllowShrinking::No);
+        if (Nodes[Due.Node].Stamp != Due.Stamp)
+        {
+            continue;
+        }
+        ++OutDelta.NumChecks;
+        Check(Due.Node);
+    }
+
+    // Superseded checks with far deadlines would otherwise pile up
+    if (Queue.Num() > 2 * GetNumNodes() + 1024)
+    {
+        Queue.RemoveAllSwap([this](const FCheck& Entry) { return Nodes[Entry.Node].Stamp != Entry.Stamp; }, EAllowShrinking::No);
+        Queue.Heapify();
+    }
+
+    OutDelta.NumSplits = UpdateSplits;
+    OutDelta.NumMerges = UpdateMerges;
+    OutDelta.NumNewVertices = EvaluatePending();
+
+    OutDelta.RemovedPatches = MoveTemp(RemovedPatches);
+    RemovedPatches.Reset();
+    TArray<int32> Emit;
+    Emit.Reserve(DirtyPatches.Num());
+    for (const int32 Patch : DirtyPatches)
+    {
+        Patches[Patch].bDirty = false;
+        if (Patches[Patch].bAlive)
+        {
+            Emit.Add(Patch);
+        }
+    }
+    DirtyPatches.Reset();
+
+    OutDelta.Patches.SetNum(Emit.Num());
+    ParallelFor(Emit.Num(), [&](int32 i)
+    {
+        EmitPatch(Emit[i], OutDelta.Patches[i]);
+    }, !PTPProfiling::IsParallelEnabled());
+    for (int32 i = 0; i < Emit.Num(); ++i)
+    {
+        OutDelta.Patches[i].bCreated = !Patches[Emit[i]].bUploaded;
+        Patches[Emit[i]].bUploaded = true;
+    }
+
+    if (UpdateSplits + UpdateMerges > 0)
+    {
+        UE_LOG(LogGaiaPTP, Verbose, TEXT("Adaptive subdivision: %d splits, %d merges, %d new vertices, %d patches out, %d removed, %d leaves"),
+            UpdateSplits, UpdateMerges, OutDelta.NumNewVertices, OutDelta.Patches.Num(), OutDelta.RemovedPatches.Num(), NumLeaves);
+    }
+    return bComplete;
+}
+
+bool FPTPAdaptiveSubdivider::IsMergeable(int32 Node) const
+{
+    const int32 First = Nodes[Node].FirstChild;
+    return First != INDEX_NONE && IsLeaf(First) && IsLeaf(First + 1) && IsLeaf(First + 2) && IsLeaf(First + 3);
+}
+
+bool FPTPAdaptiveSubdivider::CanMerge(int32 Node) const
+{
+    if (!IsMergeable(Node))
+    {
+        return false;
+    }
+    // A split child edge means a finer neighbour that would end up two levels below this node
+    const int32 First = Nodes[Node].FirstChild;
+    for (int32 c = First; c < First + 4; ++c)
+    {
+        for (int32 k = 0; k < 3; ++k)
+        {
+            if (Edges[Nodes[c].Edges[k]].NumSplit != 0)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+double FPTPAdaptiveSubdivider::GetDistanceKm(int32 Node) const
+{
+    const FNode& N = Nodes[Node];
+    return FMath::Max(FVector::Distance(LastQueryKm, FVector(N.CenterKm)) - N.BoundKm, 0.0);
+}
+
+FVector3f FPTPAdaptiveSubdivider::GetSurfaceKm(int32 Vertex, float* OutElevationKm) const
+{
+    const FVertex& V = Vertices[Vertex];
+    bool bGhost = false;
+    if (V.Edge != INDEX_NONE)
+    {
+        const FEdge& E = Edges[V.Edge];
+        bGhost = E.NumSplit == 1 && E.Users[0] != INDEX_NONE && E.Users[1] != INDEX_NONE;
+    }
+    if (OutElevationKm)
+    {
+        *OutElevationKm = bGhost ? V.GhostElevationKm : V.ElevationKm;
+    }
+    return bGhost ? V.GhostKm : V.PositionKm;
+}
+
+void FPTPAdaptiveSubdivider::Check(int32 Node)
+{
+    const double DistanceKm = GetDistanceKm(Node);
+    const double SplitKm = Nodes[Node].SizeKm / Settings.SplitRatio;
+    if (IsLeaf(Node))
+    {
+        if (Nodes[Node].Level >= Settings.MaxLevel)
+        {
+            return;
+        }
+        if (DistanceKm <= SplitKm)
+        {
+            Split(Node);
+        }
+        else
+        {
+            Schedule(Node, TravelKm + (DistanceKm - SplitKm));
+        }
+    }
+    else if (IsMergeable(Node))
+    {
+        const double MergeKm = SplitKm * Settings.MergeHysteresis;
+        if (DistanceKm < MergeKm)
+        {
+            Schedule(Node, TravelKm + (MergeKm - DistanceKm));
+        }
+        else if (CanMerge(Node))
+        {
+            Merge(Node);
+        }
+        // Otherwise a finer neighbour holds it; that neighbour's merge reschedules this one
+    }
+    // A parent of split children is rescheduled when the last of them merges
+}
+
+void FPTPAdaptiveSubdivider::Schedule(int32 Node, double Deadline)
+{
+    FCheck Entry;
+    Entry.Deadline = Deadline;
+    Entry.Node = Node;
+    Entry.Stamp = ++Nodes[Node].Stamp;
+    Queue.HeapPush(Entry);
+}
+
+void FPTPAdaptiveSubdivider::Split(int32 Node)
+{
+    if (!IsLeaf(Node))
+    {
+        return;
+    }
+    const int32 Level = Nodes[Node].Level;
+
+    // An edge used by this node alone is half of a parent edge whose far side is still a leaf:
+    // split that side first so the far side stays within one level
+    if (Level > 0)
+    {
+        const int32 Parent = Nodes[Node].Parent;
+        for (int32 k = 0; k < 3; ++k)
+        {
+            const FEdge& E = Edges[Nodes[Node].Edges[k]];
+            if (E.Users[0] != INDEX_NONE && E.Users[1] != INDEX_NONE)
+            {
+                continue;
+            }
+            for (int32 j = 0; j < 2; ++j)
+            {
+                const int32 ParentEdge = Vertices[Nodes[Node].Corners[(k + j) % 3]].Edge;
+                if (ParentEdge != INDEX_NONE && (Edges[ParentEdge].Users[0] == Parent || Edges[ParentEdge].Users[1] == Parent))
+                {
+                    const int32 Coarse = GetOtherUser(ParentEdge, Parent);
+                    if (Coarse != INDEX_NONE)
+                    {
+                        Split(Coarse);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    int32 Mid[3];
+    for (int32 k = 0; k < 3; ++k)
+    {
+        const int32 E = Nodes[Node].Edges[k];
+        if (Edges[E].Midpoint == INDEX_NONE)
+        {
+            const int32 M = NewMidpoint(E);
+            Edges[E].Midpoint = M;
+        }
+        ++Edges[E].NumSplit;
+        Mid[k] = Edges[E].Midpoint;
+    }
+
+    int32 First;
+    if (FreeBlocks.Num() > 0)
+    {
+        First = FreeBlocks.Pop(EAllowShrinking::No);
+    }
+    else
+    {
+        First = Nodes.AddDefaulted(4);
+    }
+    const int32 C0 = Nodes[Node].Corners[0];
+    const int32 C1 = Nodes[Node].Corners[1];
+    const int32 C2 = Nodes[Node].Corners[2];
+    InitNode(First + 0, C0, Mid[0], Mid[2], Node, Level + 1);
+    InitNode(First + 1, Mid[0], C1, Mid[1], Node, Level + 1);
+    InitNode(First + 2, Mid[2], Mid[1], C2, Node, Level + 1);
+    InitNode(First + 3, Mid[0], Mid[1], Mid[2], Node, Level + 1);
+    Nodes[Node].FirstChild = First;
+    NumLeaves += 3;
+
+    const bool bNewPatches = (Level + 1) % Settings.PatchLevels == 0;
+    for (int32 c = First; c < First + 4; ++c)
+    {
+        if (bNewPatches)
+        {
+            const int32 Patch = AllocPatch();
+            Patches[Patch].Roots.Add(c);
+            Nodes[c].Patch = Patch;
+        }
+        else
+        {
+            Nodes[c].Patch = Nodes[Node].Patch;
+        }
+        Schedule(c, TravelKm);
+    }
+    Schedule(Node, TravelKm);
+
+    // Leaves touching the new midpoints: this subtree, and the far side's pattern or its ghost-turned-real vertex
+    MarkDirty(Node, 2);
+    for (int32 k = 0; k < 3; ++k)
+    {
+        const int32 Other = GetOtherUser(Nodes[Node].Edges[k], Node);
+        if (Other != INDEX_NONE)
+        {
+            MarkDirty(Other, 2);
+        }
+    }
+    ++UpdateSplits;
+    --SplitBudget;
+}
+
+void FPTPAdaptiveSubdivider::Merge(int32 Node)
+{
+    const int32 First = Nodes[Node].FirstChild;
+    for (int32 c = First; c < First + 4; ++c)
+    {
+        for (int32 k = 0; k < 3; ++k)
+        {
+            RemoveEdgeUser(Nodes[c].Edges[k], c);
+        }
+        if (Nodes[c].Patch != Nodes[Node].Patch)
+        {
+            FreePatch(Nodes[c].Patch);
+        }
+        ReleaseNode(c);
+    }
+    FreeBlocks.Add(First);
+    Nodes[Node].FirstChild = INDEX_NONE;
+    NumLeaves -= 3;
+
+    for (int32 k = 0; k < 3; ++k)
+    {
+        FEdge& E = Edges[Nodes[Node].Edges[k]];
+        if (--E.NumSplit == 0)
+        {
+            FreeVertex(E.Midpoint);
+            E.Midpoint = INDEX_NONE;
+        }
+    }
+
+    MarkDirty(Node, 0);
+    for (int32 k = 0; k < 3; ++k)
+    {
+        const int32 Other = GetOtherUser(Nodes[Node].Edges[k], Node);
+        if (Other == INDEX_NONE)
+        {
+            continue;
+        }
+        MarkDirty(Other, 2);
+
+        // The far side's parent may have been held back by this node's children
+        const int32 OtherParent = Nodes[Other].Parent;
+        if (OtherParent != INDEX_NONE && IsMergeable(OtherParent))
+        {
+            Schedule(OtherParent, TravelKm);
+        }
+    }
+    const int32 Parent = Nodes[Node].Parent;
+    if (Parent != INDEX_NONE && IsMergeable(Parent))
+    {
+        Schedule(Parent, TravelKm);
+    }
+    Schedule(Node, TravelKm);
+    ++UpdateMerges;
+}
+
+void FPTPAdaptiveSubdivider::InitNode(int32 Node, int32 A, int32 B, int32 C, int32 Parent, int32 Level)
+{
+    const float RadiusKm = Settings.PlanetRadiusKm;
+    const FVector3f PA = Vertices[A].Direction * RadiusKm;
+    const FVector3f PB = Vertices[B].Direction * RadiusKm;
+    const FVector3f PC = Vertices[C].Direction * RadiusKm;
+
+    FNode& N = Nodes[Node];
+    N.Corners[0] = A;
+    N.Corners[1] = B;
+    N.Corners[2] = C;
+    N.Parent = Parent;
+    N.FirstChild = INDEX_NONE;
+    N.Patch = INDEX_NONE;
+    N.Level = Level;
+    N.SizeKm = FMath::Max3(FVector3f::Distance(PA, PB), FVector3f::Distance(PB, PC), FVector3f::Distance(PC, PA));
+
+    // The cap around the centre direction reaching the farthest corner holds the spherical triangle
+    N.CenterKm = (PA + PB + PC).GetSafeNormal(UE_SMALL_NUMBER, Vertices[A].Direction) * RadiusKm;
+    N.BoundKm = FMath::Max3(FVector3f::Distance(N.CenterKm, PA), FVector3f::Distance(N.CenterKm, PB), FVector3f::Distance(N.CenterKm, PC))
+        + Settings.MaxReliefKm * FMath::Abs(Settings.VerticalScale);
+
+    const int32 E0 = AddEdgeUser(A, B, Node);
+    const int32 E1 = AddEdgeUser(B, C, Node);
+    const int32 E2 = AddEdgeUser(C, A, Node);
+    Nodes[Node].Edges[0] = E0;
+    Nodes[Node].Edges[1] = E1;
+    Nodes[Node].Edges[2] = E2;
+}
+
+void FPTPAdaptiveSubdivider::ReleaseNode(int32 Node)
+{
+    FNode& N = Nodes[Node];
+    const uint32 Stamp = N.Stamp + 1;
+    N = FNode();
+    N.Stamp = Stamp;
+}
+
+int32 FPTPAdaptiveSubdivider::AddEdgeUser(int32 A, int32 B, int32 Node)
+{
+    const uint64 Key = EdgeKey(A, B);
+    int32 E;
+    if (const int32* Found = EdgeLookup.Find(Key))
+    {
+        E = *Found;
+    }
+    else
+    {
+        E = FreeEdges.Num() > 0 ? FreeEdges.Pop(EAllowShrinking::No) : Edges.AddDefaulted();
+        Edges[E] = FEdge();
+        Edges[E].V[0] = A;
+        Edges[E].V[1] = B;
+        EdgeLookup.Add(Key, E);
+    }
+
+    FEdge& Edge = Edges[E];
+    check(Edge.Users[0] == INDEX_NONE || Edge.Users[1] == INDEX_NONE);
+    Edge.Users[Edge.Users[0] == INDEX_NONE ? 0 : 1] = Node;
+    return E;
+}
+
+void FPTPAdaptiveSubdivider::RemoveEdgeUser(int32 Edge, int32 Node)
+{
+    FEdge& E = Edges[Edge];
+    E.Users[E.Users[0] == Node ? 0 : 1] = INDEX_NONE;
+    if (E.Users[0] == INDEX_NONE && E.Users[1] == INDEX_NONE)
+    {
+        check(E.NumSplit == 0);
+        EdgeLookup.Remove(EdgeKey(E.V[0], E.V[1]));
+        FreeEdges.Add(Edge);
+    }
+}
+
+int32 FPTPAdaptiveSubdivider::GetOtherUser(int32 Edge, int32 Node) const
+{
+    const FEdge& E = Edges[Edge];
+    return E.Users[0] == Node ? E.Users[1] : E.Users[0];
+}
+
+int32 FPTPAdaptiveSubdivider::NewMidpoint(int32 Edge)
+{
+    const int32 M = AllocVertex();
+    const FEdge& E = Edges[Edge];
+    FVertex& V = Vertices[M];
+    V.Direction = (Vertices[E.V[0]].Direction + Vertices[E.V[1]].Direction).GetSafeNormal(UE_SMALL_NUMBER, Vertices[E.V[0]].Direction);
+    V.Edge = Edge;
+    return M;
+}
+
+int32 FPTPAdaptiveSubdivider::AllocVertex()
+{
+    const int32 v = FreeVertices.Num() > 0 ? FreeVertices.Pop(EAllowShrinking::No) : Vertices.AddDefaulted();
+
+    // A slot freed before its height was evaluated is still in the pending list
+    const bool bWasPending = Vertices[v].bPending;
+    Vertices[v] = FVertex();
+    Vertices[v].bAlive = true;
+    Vertices[v].bPending = true;
+    if (!bWasPending)
+    {
+        PendingVertices.Add(v);
+    }
+    return v;
+}
+
+void FPTPAdaptiveSubdivider::FreeVertex(int32 Vertex)
+{
+    Vertices[Vertex].bAlive = false;
+    FreeVertices.Add(Vertex);
+}
+
+int32 FPTPAdaptiveSubdivider::AllocPatch()
+{
+    const int32 Patch = FreePatches.Num() > 0 ? FreePatches.Pop(EAllowShrinking::No) : Patches.AddDefaulted();
+    FPatch& P = Patches[Patch];
+    P.Roots.Reset();
+    P.bAlive = true;
+    P.bUploaded = false;
+    ++NumLivePatches;
+    MarkPatchDirty(Patch);
+    return Patch;
+}
+
+void FPTPAdaptiveSubdivider::FreePatch(int32 Patch)
+{
+    FPatch& P = Patches[Patch];
+    if (P.bUploaded)
+    {
+        RemovedPatches.Add(Patch);
+    }
+    // bDirty is kept: the id may still be in DirtyPatches, and a reuse must not queue it twice
+    P.Roots.Reset();
+    P.bAlive = false;
+    P.bUploaded = false;
+    --NumLivePatches;
+    FreePatches.Add(Patch);
+}
+
+void FPTPAdaptiveSubdivider::MarkPatchDirty(int32 Patch)
+{
+    if (Patch != INDEX_NONE && !Patches[Patch].bDirty)
+    {
+        Patches[Patch].bDirty = true;
+        DirtyPatches.Add(Patch);
+    }
+}
+
+void FPTPAdaptiveSubdivider::MarkDirty(int32 Node, int32 Depth)
+{
+    // A changed midpoint is only ever used within two levels below the nodes sharing its edge
+    MarkPatchDirty(Nodes[Node].Patch);
+    const int32 First = Nodes[Node].FirstChild;
+    if (Depth > 0 && First != INDEX_NONE)
+    {
+        for (int32 c = First; c < First + 4; ++c)
+        {
+            MarkDirty(c, Depth - 1);
+        }
+    }
+}
+
+int32 FPTPAdaptiveSubdivider::EvaluatePending()
+{
+    int32 Num = 0;
+    for (const int32 v : PendingVertices)
+    {
+        if (Vertices[v].bAlive)
+        {
+            PendingVertices[Num++] = v;
+        }
+        else
+        {
+            Vertices[v].bPending = false;
+        }
+    }
+    PendingVertices.SetNum(Num, EAllowShrinking::No);
+    if (Num == 0)
+    {
+        return 0;
+    }
+
+    // One batch per update through the amplification callbacks
+    TArray<FVector3f> Directions;
+    TArray<float> ElevationKm;
+    Directions.SetNumUninitialized(Num);
+    ElevationKm.SetNumZeroed(Num);
+    for (int32 i = 0; i < Num; ++i)
+    {
+        Directions[i] = Vertices[PendingVertices[i]].Direction;
+    }
+    if (HeightSource)
+    {
+        HeightSource(Directions, ElevationKm);
+    }
+
+    const float RadiusKm = Settings.PlanetRadiusKm;
+    for (int32 i = 0; i < Num; ++i)
+    {
+        FVertex& V = Vertices[PendingVertices[i]];
+        V.ElevationKm = ElevationKm[i];
+        V.PositionKm = V.Direction * (RadiusKm + Settings.VerticalScale * V.ElevationKm);
+        V.bPending = false;
+    }
+
+    // Ghost placement needs both parent heights, which may have come in this same batch
+    for (int32 i = 0; i < Num; ++i)
+    {
+        FVertex& V = Vertices[PendingVertices[i]];
+        if (V.Edge != INDEX_NONE)
+        {
+            const FVertex& A = Vertices[Edges[V.Edge].V[0]];
+            const FVertex& B = Vertices[Edges[V.Edge].V[1]];
+            V.GhostKm = (A.PositionKm + B.PositionKm) * 0.5f;
+            V.GhostElevationKm = (A.ElevationKm + B.ElevationKm) * 0.5f;
+        }
+    }
+    PendingVertices.Reset();
+    return Num;
+}
+
+void FPTPAdaptiveSubdivider::EmitLeaf(int32 Node, TFunctionRef<void(int32, int32, int32)> Emit) const
+{
+    const FNode& N = Nodes[Node];
+    int32 Mid[3];
+    int32 NumMid = 0;
+    for (int32 k = 0; k < 3; ++k)
+    {
+        Mid[k] = Edges[N.Edges[k]].Midpoint;
+        NumMid += Mid[k] != INDEX_NONE ? 1 : 0;
+    }
+    const int32* C = N.Corners;
+
+    // Dyadic patterns over the midpoints finer neighbours put on this leaf's edges
+    if (NumMid == 0)
+    {
+        Emit(C[0], C[1], C[2]);
+    }
+    else if (NumMid == 3)
+    {
+        Emit(C[0], Mid[0], Mid[2]);
+        Emit(Mid[0], C[1], Mid[1]);
+        Emit(Mid[2], Mid[1], C[2]);
+        Emit(Mid[0], Mid[1], Mid[2]);
+    }
+    else if (NumMid == 1)
+    {
+        const int32 k = Mid[0] != INDEX_NONE ? 0 : (Mid[1] != INDEX_NONE ? 1 : 2);
+        Emit(C[k], Mid[k], C[(k + 2) % 3]);
+        Emit(Mid[k], C[(k + 1) % 3], C[(k + 2) % 3]);
+    }
+    else
+    {
+        // Edge k is whole; edges k + 1 and k + 2 carry midpoints
+        const int32 k = Mid[0] == INDEX_NONE ? 0 : (Mid[1] == INDEX_NONE ? 1 : 2);
+        const int32 A = C[k];
+        const int32 B = C[(k + 1) % 3];
+        const int32 D = C[(k + 2) % 3];
+        const int32 MBD = Mid[(k + 1) % 3];
+        const int32 MDA = Mid[(k + 2) % 3];
+        Emit(MDA, MBD, D);
+        Emit(A, B, MBD);
+        Emit(A, MBD, MDA);
+    }
+}
+
+void FPTPAdaptiveSubdivider::EmitPatch(int32 Patch, FPTPSubdivisionPatch& OutPatch) const
+{
+    OutPatch.Id = Patch;
+    OutPatch.Positions.Reset();
+    OutPatch.ElevationKm.Reset();
+    OutPatch.Triangles.Reset();
+
+    TMap<int32, int32> LocalIndex;
+    auto ToLocal = [&](int32 Vertex)
+    {
+        if (const int32* Found = LocalIndex.Find(Vertex))
+        {
+            return *Found;
+        }
+        float ElevationKm = 0.0f;
+        const int32 Local = OutPatch.Positions.Add(GetSurfaceKm(Vertex, &ElevationKm));
+        OutPatch.ElevationKm.Add(ElevationKm);
+        LocalIndex.Add(Vertex, Local);
+        return Local;
+    };
+    auto Emit = [&](int32 A, int32 B, int32 C)
+    {
+        const int32 LA = ToLocal(A);
+        const int32 LB = ToLocal(B);
+        const int32 LC = ToLocal(C);
+        OutPatch.Triangles.Add(FIntVector(LA, LB, LC));
+    };
+
+    TArray<int32, TInlineAllocator<64>> Stack(Patches[Patch].Roots);
+    while (Stack.Num() > 0)
+    {
+        const int32 Node = Stack.Pop(EAllowShrinking::No);
+        const int32 First = Nodes[Node].FirstChild;
+        if (First == INDEX_NONE)
+        {
+            EmitLeaf(Node, Emit);
+            continue;
+        }
+        for (int32 c = First; c < First + 4; ++c)
+        {
+            if (Nodes[c].Patch == Patch)
+            {
+                Stack.Add(c);
+            }
+        }
+    }
+}
+
+void FPTPAdaptiveSubdivider::GetMesh(TArray<FVector3f>& OutPositions, TArray<FIntVector>& OutTriangles) const
+{
+    OutPositions.SetNumUninitialized(Vertices.Num());
+    for (int32 v = 0; v < Vertices.Num(); ++v)
+    {
+        OutPositions[v] = Vertices[v].bAlive ? GetSurfaceKm(v) : FVector3f::ZeroVector;
+    }
+
+    OutTriangles.Reset(NumLeaves * 2);
+    for (int32 Node = 0; Node < Nodes.Num(); ++Node)
+    {
+        if (Nodes[Node].Corners[0] != INDEX_NONE && IsLeaf(Node))
+        {
+            EmitLeaf(Node, [&OutTriangles](int32 A, int32 B, int32 C) { OutTriangles.Add(FIntVector(A, B, C)); });
+        }
+    }
+}
+
+bool FPTPAdaptiveSubdivider::IsRestricted() const
+{
+    for (int32 Node = 0; Node < Nodes.Num(); ++Node)
+    {
+        if (Nodes[Node].Corners[0] == INDEX_NONE || !IsLeaf(Node))
+        {
+            continue;
+        }
+        for (int32 k = 0; k < 3; ++k)
+        {
+            const int32 M = Edges[Nodes[Node].Edges[k]].Midpoint;
+            if (M == INDEX_NONE)
+            {
+                continue;
+            }
+            for (const int32 Corner : { Nodes[Node].Corners[k], Nodes[Node].Corners[(k + 1) % 3] })
+            {
+                const int32* Half = EdgeLookup.Find(EdgeKey(Corner, M));
+                if (Half && Edges[*Half].NumSplit != 0)
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+int32 FPTPAdaptiveSubdivider::GetMaxDepth() const
+{
+    int32 MaxDepth = 0;
+    for (const FNode& N : Nodes)
+    {
+        if (N.Corners[0] != INDEX_NONE)
+        {
+            MaxDepth = FMath::Max(MaxDepth, N.Level);
+        }
+    }
+    return MaxDepth;
+}
+
+SIZE_T FPTPAdaptiveSubdivider::GetAllocatedSize() const
+{
+    SIZE_T Bytes = Nodes.GetAllocatedSize() + FreeBlocks.GetAllocatedSize() + Vertices.GetAllocatedSize() + FreeVertices.GetAllocatedSize()
+        + PendingVertices.GetAllocatedSize() + Edges.GetAllocatedSize() + FreeEdges.GetAllocatedSize() + EdgeLookup.GetAllocatedSize()
+        + Patches.GetAllocatedSize() + FreePatches.GetAllocatedSize() + DirtyPatches.GetAllocatedSize() + RemovedPatches.GetAllocatedSize()
+        + Queue.GetAllocatedSize();
+    for (const FPatch& P : Patches)
+    {
+        Bytes += P.Roots.GetAllocatedSize();
+    }
+    return Bytes;
+}
+
+void FPTPAdaptiveSubdivider::ApplyToRealtimeMesh(URealtimeMeshSimple& Mesh, const FPTPSubdivisionDelta& Delta, float Scale, int32 LODIndex)
+{
+    using namespace RealtimeMesh;
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, AdaptiveSubdivisionUpload);
+
+    auto GroupKey = [LODIndex](int32 Patch)
+    {
+        return FRealtimeMeshSectionGroupKey::Create(FRealtimeMeshLODKey(LODIndex), FName(TEXT("PTPAdaptive"), NAME_EXTERNAL_TO_INTERNAL(Patch)));
+    };
+
+    for (const int32 Patch : Delta.RemovedPatches)
+    {
+        Mesh.RemoveSectionGroup(GroupKey(Patch));
+    }
+
+    for (const FPTPSubdivisionPatch& Patch : Delta.Patches)
+    {
+        FRealtimeMeshStreamSet Streams;
+        FPTPPlanetMeshBuilder::BuildSurface(Patch.Positions, Patch.Triangles, Scale, Streams);
+        if (FRealtimeMeshStream* Colors = Streams.Find(FRealtimeMeshStreams::Color))
+        {
+            for (FColor& Color : Colors->GetArrayView<FColor>())
+            {
+                Color = FColor::White;
+            }
+        }
+        if (FRealtimeMeshStream* TexCoordStream = Streams.Find(FRealtimeMeshStreams::TexCoords))
+        {
+            TArrayView<FRealtimeMeshTexCoordsNormal> TexCoords = TexCoordStream->GetArrayView<FRealtimeMeshTexCoordsNormal>();
+            for (int32 v = 0; v < Patch.ElevationKm.Num(); ++v)
+            {
+                TexCoords[v][0].X = FFloat16(Patch.ElevationKm[v]);
+            }
+        }
+
+        if (Patch.bCreated)
+        {
+            Mesh.CreateSectionGroup(GroupKey(Patch.Id), MoveTemp(Streams));
+        }
+        else
+        {
+            Mesh.UpdateSectionGroup(GroupKey(Patch.Id), MoveTemp(Streams));
+        }
+    }
+}
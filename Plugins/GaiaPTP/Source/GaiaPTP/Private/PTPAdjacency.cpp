@@ -0,0 +1,116 @@
+#include "PTPAdjacency.h"
+#include "Algo/Sort.h"
+#include "Async/ParallelFor.h"
+#include "PTPProfiling.h"
+#include "PTPSimd.h"
+
+void FPTPAdjacency::Build(const TArray<TArray<int32>>& InNeighbors)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, Adjacency);
+    const int32 NumVertices = InNeighbors.Num();
+
+    Offsets.SetNumUninitialized(NumVertices + 1);
+    Offsets[0] = 0;
+    for (int32 v = 0; v < NumVertices; ++v)
+    {
+        Offsets[v + 1] = Offsets[v] + InNeighbors[v].Num();
+    }
+
+    Neighbors.SetNumUninitialized(Offsets.Last());
+    ParallelFor(PTPSimd::NumChunks(NumVertices), [&](int32 Chunk)
+    {
+        const int32 Begin = Chunk * PTPSimd::ChunkSize;
+        const int32 End = FMath::Min(Begin + PTPSimd::ChunkSize, NumVertices);
+        for (int32 v = Begin; v < End; ++v)
+        {
+            FMemory::Memcpy(Neighbors.GetData() + Offsets[v], InNeighbors[v].GetData(), InNeighbors[v].Num() * sizeof(int32));
+        }
+    }, !PTPProfiling::IsParallelEnabled());
+}
+
+void FPTPAdjacency::BuildFromTriangles(TConstArrayView<FIntVector> Triangles, int32 NumVertices)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, Adjacency);
+    NumVertices = FMath::Max(NumVertices, 0);
+    auto IsValid = [NumVertices](const FIntVector& Tri)
+    {
+        return Tri.X >= 0 && Tri.X < NumVertices && Tri.Y >= 0 && Tri.Y < NumVertices && Tri.Z >= 0 && Tri.Z < NumVertices;
+    };
+
+    // Each triangle gives its corners two candidates; interior edges arrive twice and are merged below
+    TArray<int32> Counts;
+    Counts.SetNumZeroed(NumVertices + 1);
+    for (const FIntVector& Tri : Triangles)
+    {
+        if (IsValid(Tri))
+        {
+            Counts[Tri.X + 1] += 2;
+            Counts[Tri.Y + 1] += 2;
+            Counts[Tri.Z + 1] += 2;
+        }
+    }
+    for (int32 v = 0; v < NumVertices; ++v)
+    {
+        Counts[v + 1] += Counts[v];
+    }
+
+    TArray<int32> Candidates;
+    Candidates.SetNumUninitialized(Counts.Last());
+    {
+        TArray<int32> Cursor(Counts.GetData(), NumVertices);
+        for (const FIntVector& Tri : Triangles)
+        {
+            if (!IsValid(Tri))
+            {
+                continue;
+            }
+            for (int32 k = 0; k < 3; ++k)
+            {
+                const int32 A = Tri[k];
+                Candidates[Cursor[A]++] = Tri[(k + 1) % 3];
+                Candidates[Cursor[A]++] = Tri[(k + 2) % 3];
+            }
+        }
+    }
+
+    // Sort and dedupe each row in place, then compact
+    const bool bDoParallel = PTPProfiling::IsParallelEnabled();
+    Offsets.SetNumUninitialized(NumVertices + 1);
+    ParallelFor(PTPSimd::NumChunks(NumVertices), [&](int32 Chunk)
+    {
+        const int32 Begin = Chunk * PTPSimd::ChunkSize;
+        const int32 End = FMath::Min(Begin + PTPSimd::ChunkSize, NumVertices);
+        for (int32 v = Begin; v < End; ++v)
+        {
+            int32* Row = Candidates.GetData() + Counts[v];
+            const int32 RowNum = Counts[v + 1] - Counts[v];
+            Algo::Sort(MakeArrayView(Row, RowNum));
+            int32 Unique = 0;
+            for (int32 i = 0; i < RowNum; ++i)
+            {
+                if (Unique == 0 || Row[Unique - 1] != Row[i])
+                {
+                    Row[Unique++] = Row[i];
+                }
+            }
+            Offsets[v + 1] = Unique;
+        }
+    }, !bDoParallel);
+
+    Offsets[0] = 0;
+    for (int32 v = 0; v < NumVertices; ++v)
+    {
+        Offsets[v + 1] += Offsets[v];
+    }
+
+    Neighbors.SetNumUninitialized(Offsets.Last());
+    ParallelFor(PTPSimd::NumChunks(NumVertices), [&](int32 Chunk)
+    {
+        const int32 Begin = Chunk * PTPSimd::ChunkSize;
+        const int32 End = FMath::Min(Begin + PTPSimd::ChunkSize, NumVertices);
+        for (int32 v = Begin; v < End; ++v)
+        {
+            FMemory::Memcpy(Neighbors.GetData() + Offsets[v], Candidates.GetData() + Counts[v], GetDegree(v) * sizeof(int32));
+        }
+    }, !bDoParallel);
+}
@@ -0,0 +1,252 @@
+#include "PTPArena.h"
+#include "GaiaPTP.h"
+#include "PTPMemory.h"
+#include "PTPProfiling.h"
+
+// Capacity is accounted per planet in the Scratch bucket of FPTPMemoryReport
+DECLARE_MEMORY_STAT(TEXT("Scratch high water"), STAT_PTP_ScratchHighWater, STATGROUP_GaiaPTP);
+
+namespace
+{
+    // Smallest block; a step of a 100k-point planet fits in a few of these
+    constexpr SIZE_T MinBlockBytes = 64 * 1024;
+    constexpr SIZE_T BlockAlignment = 64;
+
+#if STATS
+    void MoveStat(FName Stat, SIZE_T& InOutReported, SIZE_T Current)
+    {
+        if (Current > InOutReported)
+        {
+            INC_MEMORY_STAT_BY_FName(Stat, Current - InOutReported);
+        }
+        else if (Current < InOutReported)
+        {
+            DEC_MEMORY_STAT_BY_FName(Stat, InOutReported - Current);
+        }
+        InOutReported = Current;
+    }
+#endif
+}
+
+FPTPArena::~FPTPArena()
+{
+    FreeBlocks();
+}
+
+void* FPTPArena::Allocate(SIZE_T Bytes, SIZE_T Alignment)
+{
+    Alignment = FMath::Max<SIZE_T>(Alignment, 1);
+    while (Current < Blocks.Num())
+    {
+        const FBlock& Block = Blocks[Current];
+        const SIZE_T Start = Align(Offset, Alignment);
+        if (Start + Bytes <= Block.Size)
+        {
+            Used += Start - Offset + Bytes;
+            Offset = Start + Bytes;
+            Peak = FMath::Max(Peak, Used);
+            HighWater = FMath::Max(HighWater, Used);
+            Last = Block.Data + Start;
+            return Last;
+        }
+        // The tail of a full block is not counted as used; the next block starts fresh
+        if (Current + 1 == Blocks.Num())
+        {
+            break;
+        }
+        ++Current;
+        Offset = 0;
+    }
+
+    AddBlock(Bytes + Alignment);
+    Current = Blocks.Num() - 1;
+    Offset = 0;
+    return Allocate(Bytes, Alignment);
+}
+
+void* FPTPArena::Reallocate(void* Ptr, SIZE_T OldBytes, SIZE_T NewBytes, SIZE_T Alignment)
+{
+    if (Ptr && Ptr == Last && NewBytes >= OldBytes)
+    {
+        const FBlock& Block = Blocks[Current];
+        const SIZE_T Start = static_cast<uint8*>(Ptr) - Block.Data;
+        if (Start + NewBytes <= Block.Size)
+        {
+            Used += NewBytes - OldBytes;
+            Offset = Start + NewBytes;
+            Peak = FMath::Max(Peak, Used);
+            HighWater = FMath::Max(HighWater, Used);
+            return Ptr;
+        }
+    }
+    void* Moved = Allocate(NewBytes, Alignment);
+    if (Ptr && OldBytes > 0)
+    {
+        FMemory::Memcpy(Moved, Ptr, FMath::Min(OldBytes, NewBytes));
+    }
+    return Moved;
+}
+
+void FPTPArena::Reset()
+{
+    // Several blocks mean the last run outgrew the first; one block of the high-water size serves it next time
+    if (Blocks.Num() > 1)
+    {
+        FreeBlocks();
+        AddBlock(HighWater + BlockAlignment);
+    }
+    Current = 0;
+    Offset = 0;
+    Used = 0;
+    Peak = 0;
+    PeakBase = 0;
+    Last = nullptr;
+}
+
+void FPTPArena::ResetPeak()
+{
+    Peak = Used;
+    PeakBase = Used;
+}
+
+SIZE_T FPTPArena::GetCapacityBytes() const
+{
+    SIZE_T Bytes = 0;
+    for (const FBlock& Block : Blocks)
+    {
+        Bytes += Block.Size;
+    }
+    return Bytes;
+}
+
+void FPTPArena::AddBlock(SIZE_T MinBytes)
+{
+    LLM_SCOPE_BYTAG(GaiaPTP);
+    const SIZE_T Previous = Blocks.Num() > 0 ? Blocks.Last().Size : 0;
+    FBlock& Block = Blocks.AddDefaulted_GetRef();
+    Block.Size = Align(FMath::Max3(MinBytes, MinBlockBytes, Previous * 2), MinBlockBytes);
+    Block.Data = static_cast<uint8*>(FMemory::Malloc(Block.Size, BlockAlignment));
+    ++NumBlockAllocations;
+}
+
+void FPTPArena::FreeBlocks()
+{
+    for (const FBlock& Block : Blocks)
+    {
+        FMemory::Free(Block.Data);
+    }
+    Blocks.Reset();
+}
+
+FPTPStepScratch::FWorkerLease::~FWorkerLease()
+{
+    if (Owner)
+    {
+        Owner->ReleaseWorkerArena(Index);
+    }
+}
+
+FPTPStepScratch::~FPTPStepScratch()
+{
+#if STATS
+    MoveStat(GET_STATFNAME(STAT_PTP_ScratchHighWater), ReportedHighWater, 0);
+#endif
+}
+
+FPTPStepScratch::FWorkerLease FPTPStepScratch::AcquireWorkerArena()
+{
+    FScopeLock Lock(&WorkerLock);
+    if (FreeWorkers.Num() == 0)
+    {
+        LLM_SCOPE_BYTAG(GaiaPTP);
+        FreeWorkers.Add(WorkerArenas.Add(MakeUnique<FPTPArena>()));
+    }
+    const int32 Index = FreeWorkers.Pop(EAllowShrinking::No);
+    return FWorkerLease(*this, Index, *WorkerArenas[Index]);
+}
+
+void FPTPStepScratch::ReleaseWorkerArena(int32 Index)
+{
+    FScopeLock Lock(&WorkerLock);
+    FreeWorkers.Add(Index);
+}
+
+void FPTPStepScratch::BeginKernel(FName Kernel)
+{
+    CurrentKernel = Kernel;
+    StepArena.ResetPeak();
+    for (const TUniquePtr<FPTPArena>& Worker : WorkerArenas)
+    {
+        Worker->ResetPeak();
+    }
+}
+
+void FPTPStepScratch::EndKernel()
+{
+    // Worker peaks add up: every leased arena can be at its peak in the same instant
+    SIZE_T Bytes = StepArena.GetPeakBytes();
+    for (const TUniquePtr<FPTPArena>& Worker : WorkerArenas)
+    {
+        Bytes += Worker->GetPeakBytes();
+    }
+    SIZE_T& Peak = KernelPeaks.FindOrAdd(CurrentKernel);
+    Peak = FMath::Max(Peak, Bytes);
+    CurrentKernel = NAME_None;
+}
+
+void FPTPStepScratch::EndStep()
+{
+    SIZE_T StepBytes = StepArena.GetUsedBytes();
+    StepArena.Reset();
+    for (const TUniquePtr<FPTPArena>& Worker : WorkerArenas)
+    {
+        StepBytes += Worker->GetUsedBytes();
+        Worker->Reset();
+    }
+    HighWater = FMath::Max(HighWater, StepBytes);
+    CSV_CUSTOM_STAT(GAIA_PTP, ScratchKB, float(StepBytes / 1024), ECsvCustomStatOp::Max);
+    UpdateStats();
+}
+
+SIZE_T FPTPStepScratch::GetKernelPeak(FName Kernel) const
+{
+    const SIZE_T* Peak = KernelPeaks.Find(Kernel);
+    return Peak ? *Peak : 0;
+}
+
+SIZE_T FPTPStepScratch::GetCapacityBytes() const
+{
+    SIZE_T Bytes = StepArena.GetCapacityBytes();
+    for (const TUniquePtr<FPTPArena>& Worker : WorkerArenas)
+    {
+        Bytes += Worker->GetCapacityBytes();
+    }
+    return Bytes;
+}
+
+int32 FPTPStepScratch::GetNumBlockAllocations() const
+{
+    int32 Num = StepArena.GetNumBlockAllocations();
+    for (const TUniquePtr<FPTPArena>& Worker : WorkerArenas)
+    {
+        Num += Worker->GetNumBlockAllocations();
+    }
+    return Num;
+}
+
+void FPTPStepScratch::LogKernelPeaks() const
+{
+    UE_LOG(LogGaiaPTP, Log, TEXT("  Scratch: %.2f MB reserved, %.2f MB high water, %d worker arenas"),
+        GetCapacityBytes() / (1024.0 * 1024.0), HighWater / (1024.0 * 1024.0), WorkerArenas.Num());
+    for (const TPair<FName, SIZE_T>& Kernel : KernelPeaks)
+    {
+        UE_LOG(LogGaiaPTP, Log, TEXT("    %-20s %9.2f MB peak"), *Kernel.Key.ToString(), Kernel.Value / (1024.0 * 1024.0));
+    }
+}
+
+void FPTPStepScratch::UpdateStats()
+{
+#if STATS
+    MoveStat(GET_STATFNAME(STAT_PTP_ScratchHighWater), ReportedHighWater, HighWater);
+#endif
+}
@@ -0,0 +1,226 @@
+#include "PTPCraterCatalog.h"
+#include "Async/ParallelFor.h"
+#include "GaiaPTP.h"
+#include "PTPCubeMap.h"
+#include "PTPProfiling.h"
+#include "PTPRandom.h"
+#include "PTPSimd.h"
+
+namespace
+{
+    /** Hash streams per crater. */
+    enum ECraterStream : uint32
+    {
+        StreamZ,
+        StreamPhi,
+        StreamDiameter,
+        StreamAge
+    };
+}
+
+int32 FPTPCraterCatalog::ComputeNumCraters(int32 NumVertices, float SurfaceAgeGyr, float TectonicActivity, float AtmosphericDensity)
+{
+    const float PerVertex = 0.01f * SurfaceAgeGyr * FMath::Exp(-2.0f * TectonicActivity) * FMath::Exp(-AtmosphericDensity);
+    return FMath::Max(0, FMath::RoundToInt(NumVertices * PerVertex));
+}
+
+float FPTPCraterCatalog::SampleDiameterKm(float U, float MinKm, float MaxKm, float Exponent)
+{
+    const double A = double(Exponent) + 1.0;
+    if (FMath::Abs(A) < 1e-6)
+    {
+        return float(MinKm * FMath::Pow(double(MaxKm) / MinKm, double(U)));
+    }
+    const double Lo = FMath::Pow(double(MinKm), A);
+    const double Hi = FMath::Pow(double(MaxKm), A);
+    return FMath::Clamp(float(FMath::Pow(Lo + U * (Hi - Lo), 1.0 / A)), MinKm, MaxKm);
+}
+
+int32 FPTPCraterCatalog::GetSizeClass(float Diameter) const
+{
+    const int32 Class = FMath::FloorToInt(FMath::Log2(Diameter / Params.MinDiameterKm));
+    return FMath::Clamp(Class, 0, Classes.Num() - 1);
+}
+
+void FPTPCraterCatalog::Generate(const FPTPCraterParams& InParams)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, CraterCatalog);
+
+    const bool bDoParallel = PTPProfiling::IsParallelEnabled();
+
+    Params = InParams;
+    Params.MinDiameterKm = FMath::Max(Params.MinDiameterKm, 1e-4f);
+    Params.MaxDiameterKm = FMath::Max(Params.MaxDiameterKm, Params.MinDiameterKm);
+    const int32 N = FMath::Max(Params.NumCraters, 0);
+    const double StartTime = FPlatformTime::Seconds();
+
+    Classes.Reset();
+    Classes.SetNum(FMath::FloorToInt(FMath::Log2(Params.MaxDiameterKm / Params.MinDiameterKm)) + 1);
+
+    // Sample in id order; every value depends only on (Seed, id)
+    TArray<FVector3f> RawCenters;
+    TArray<float> RawDiameters;
+    TArray<float> RawAges;
+    TArray<uint8> RawClasses;
+    RawCenters.SetNumUninitialized(N);
+    RawDiameters.SetNumUninitialized(N);
+    RawAges.SetNumUninitialized(N);
+    RawClasses.SetNumUninitialized(N);
+
+    const uint32 Seed = uint32(Params.Seed);
+    ParallelFor(PTPSimd::NumChunks(N), [&](int32 Chunk)
+    {
+        const int32 Begin = Chunk * PTPSimd::ChunkSize;
+        const int32 End = FMath::Min(Begin + PTPSimd::ChunkSize, N);
+        for (int32 i = Begin; i < End; ++i)
+        {
+            // Uniform on the sphere: uniform height and azimuth
+            const float Z = 2.0f * FPTPHash::UnitFloat(FPTPHash::Hash(Seed, i, StreamZ)) - 1.0f;
+            const float Phi = 2.0f * PI * FPTPHash::UnitFloat(FPTPHash::Hash(Seed, i, StreamPhi));
+            const float R = FMath::Sqrt(FMath::Max(1.0f - Z * Z, 0.0f));
+            float SinPhi, CosPhi;
+            FMath::SinCos(&SinPhi, &CosPhi, Phi);
+            RawCenters[i] = FVector3f(R * CosPhi, R * SinPhi, Z);
+
+            const float Diameter = SampleDiameterKm(FPTPHash::UnitFloat(FPTPHash::Hash(Seed, i, StreamDiameter)),
+                Params.MinDiameterKm, Params.MaxDiameterKm, Params.PowerLawExponent);
+            RawDiameters[i] = Diameter;
+            RawAges[i] = Params.SurfaceAgeMy * FPTPHash::UnitFloat(FPTPHash::Hash(Seed, i, StreamAge));
+            RawClasses[i] = uint8(GetSizeClass(Diameter));
+        }
+    }, !bDoParallel);
+
+    // Grid per class: cells wide enough for the class's largest reach, and about one crater per cell
+    TArray<int32> ClassCounts;
+    ClassCounts.SetNumZeroed(Classes.Num());
+    for (int32 i = 0; i < N; ++i)
+    {
+        ++ClassCounts[RawClasses[i]];
+    }
+    int32 NumKeys = 0;
+    for (int32 k = 0; k < Classes.Num(); ++k)
+    {
+        FSizeClass& Class = Classes[k];
+        const float MaxDiameter = FMath::Min(Params.MinDiameterKm * FMath::Pow(2.0f, float(k + 1)), Params.MaxDiameterKm);
+        const float MaxAngle = 0.5f * MaxDiameter * Params.InfluenceRadii / Params.PlanetRadiusKm;
+        const int32 GeometricRes = FMath::FloorToInt(FPTPCubeMap::MinCellWidthFraction * HALF_PI / FMath::Max(MaxAngle, 1e-9f));
+        const int32 OccupancyRes = FMath::CeilToInt(FMath::Sqrt(ClassCounts[k] / float(FPTPCubeMap::NumFaces)));
+        Class.Resolution = FMath::Min3(GeometricRes, OccupancyRes, FPTPCubeMap::MaxCellIdResolution);
+        if (Class.Resolution < 2)
+        {
+            Class.Resolution = 0;   // a 3x3 block of face-sized cells would wrap past the neighbouring faces
+        }
+        Class.NumCells = Class.Resolution > 0 ? FPTPCubeMap::NumFaces * Class.Resolution * Class.Resolution : 1;
+        Class.CellBase = NumKeys;
+        NumKeys += Class.NumCells;
+    }
+
+    TArray<int32> Keys;
+    Keys.SetNumUninitialized(N);
+    ParallelFor(PTPSimd::NumChunks(N), [&](int32 Chunk)
+    {
+        const int32 Begin = Chunk * PTPSimd::ChunkSize;
+        const int32 End = FMath::Min(Begin + PTPSimd::ChunkSize, N);
+        for (int32 i = Begin; i < End; ++i)
+        {
+            const FSizeClass& Class = Classes[RawClasses[i]];
+            Keys[i] = Class.CellBase + (Class.Resolution > 0 ? FPTPCubeMap::CellId(RawCenters[i], Class.Resolution) : 0);
+        }
+    }, !bDoParallel);
+
+    // Stable counting sort by (class, cell): cell ranges become contiguous crater ranges
+    CellOffsets.Reset();
+    CellOffsets.SetNumZeroed(NumKeys + 1);
+    for (int32 i = 0; i < N; ++i)
+    {
+        ++CellOffsets[Keys[i] + 1];
+    }
+    for (int32 Key = 0; Key < NumKeys; ++Key)
+    {
+        CellOffsets[Key + 1] += CellOffsets[Key];
+    }
+
+    Centers.SetNumUninitialized(N);
+    DiameterKm.SetNumUninitialized(N);
+    DepthKm.SetNumUninitialized(N);
+    AgeMy.SetNumUninitialized(N);
+    Ids.SetNumUninitialized(N);
+    {
+        TArray<int32> Cursor(CellOffsets.GetData(), NumKeys);
+        for (int32 i = 0; i < N; ++i)
+        {
+            const int32 Dst = Cursor[Keys[i]]++;
+            const float Diameter = RawDiameters[i];
+            Centers[Dst] = RawCenters[i];
+            DiameterKm[Dst] = Diameter;
+            DepthKm[Dst] = ComputeDepthKm(Diameter, Params.ComplexTransitionKm, Params.DepthRatio, Params.ComplexDepthSlope);
+            AgeMy[Dst] = RawAges[i];
+            Ids[Dst] = uint32(i);
+        }
+    }
+
+    const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    UE_LOG(LogGaiaPTP, Log, TEXT("Crater catalogue: %d craters in %d size classes, %d cells, %.1f bytes/crater, %.2fms"),
+        N, Classes.Num(), NumKeys, N > 0 ? double(GetAllocatedSize()) / N : 0.0, ElapsedMs);
+}
+
+void FPTPCraterCatalog::ForEachCraterAffecting(const FVector3f& P, TFunctionRef<void(int32 Crater)> Visit) const
+{
+    for (const FSizeClass& Class : Classes)
+    {
+        if (Class.Resolution == 0)
+        {
+            for (int32 Crater = CellOffsets[Class.CellBase]; Crater < CellOffsets[Class.CellBase + 1]; ++Crater)
+            {
+                if (Affects(Crater, P))
+                {
+                    Visit(Crater);
+                }
+            }
+            continue;
+        }
+
+        int32 Cells[9];
+        const int32 NumCells = FPTPCubeMap::NeighborhoodCells(FPTPCubeMap::CellId(P, Class.Resolution), Class.Resolution, Cells);
+        for (int32 c = 0; c < NumCells; ++c)
+        {
+            const int32 Key = Class.CellBase + Cells[c];
+            for (int32 Crater = CellOffsets[Key]; Crater < CellOffsets[Key + 1]; ++Crater)
+            {
+                if (Affects(Crater, P))
+                {
+                    Visit(Crater);
+                }
+            }
+        }
+    }
+}
+
+void FPTPCraterCatalog::GatherCratersAffecting(const FVector3f& P, TArray<int32>& OutCraters) const
+{
+    ForEachCraterAffecting(P, [&OutCraters](int32 Crater) { OutCraters.Add(Crater); });
+}
+
+void FPTPCraterCatalog::GatherCratersAffectingBruteForce(const FVector3f& P, TArray<int32>& OutCraters) const
+{
+    for (int32 Crater = 0; Crater < Num(); ++Crater)
+    {
+        if (Affects(Crater, P))
+        {
+            OutCraters.Add(Crater);
+        }
+    }
+}
+
+void FPTPCraterCatalog::GetSizeClassRange(int32 Class, int32& OutBegin, int32& OutEnd) const
+{
+    const FSizeClass& SizeClass = Classes[Class];
+    OutBegin = CellOffsets[SizeClass.CellBase];
+    OutEnd = CellOffsets[SizeClass.CellBase + SizeClass.NumCells];
+}
+
+SIZE_T FPTPCraterCatalog::GetAllocatedSize() const
+{
+    return Centers.GetAllocatedSize() + DiameterKm.GetAllocatedSize() + DepthKm.GetAllocatedSize()
+        + AgeMy.GetAllocatedSize() + Ids.GetAllocatedSize() + Classes.GetAllocatedSize() + CellOffsets.GetAllocatedSize();
+}
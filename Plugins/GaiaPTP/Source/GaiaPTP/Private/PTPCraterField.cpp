@@ -0,0 +1,536 @@
+#include "PTPCraterField.h"
+#include "Async/ParallelFor.h"
+#include "GaiaPTP.h"
+#include "PTPCraterCatalog.h"
+#include "PTPProfiling.h"
+#include "PTPRandom.h"
+#include "PTPSimd.h"
+
+namespace
+{
+    /** Queries per ParallelFor task; each query sums a few blocks per octave. */
+    constexpr int32 QueryChunkSize = 1024;
+
+    /** Largest per-face resolution: cell coordinates stay exact in float through FaceToDirection. */
+    constexpr int32 MaxOctaveResolution = 1 << 22;
+
+    /** Complex crater layout in crater radii: central peak, flat floor edge, terraced wall steps. */
+    constexpr float PeakRadius = 0.2f;
+    constexpr float FloorRadius = 0.7f;
+    constexpr float NumTerraces = 3.0f;
+
+    /** Hash streams per crater of a cell (stream 0 of the cell hash is the crater count). */
+    enum ECraterStream : uint32
+    {
+        StreamU,
+        StreamV,
+        StreamDiameter,
+        StreamAge,
+        StreamRings
+    };
+
+    /** Ejecta blanket outside the rim: thickness ~ R^-3 (McGetchin et al.), Rim at R = 1 and 0 at Reach. */
+    float EjectaProfile(float R, float RimKm, float Reach)
+    {
+        if (R >= Reach)
+        {
+            return 0.0f;
+        }
+        const float InvReach3 = 1.0f / (Reach * Reach * Reach);
+        return RimKm * (1.0f / (R * R * R) - InvReach3) / (1.0f - InvReach3);
+    }
+
+    /** Smooth staircase over t in [0,1]: NumTerraces slumped steps. */
+    float Terrace(float T)
+    {
+        const float X = T * NumTerraces;
+        const float Step = FMath::Min(FMath::FloorToFloat(X), NumTerraces - 1.0f);
+        const float F = X - Step;
+        return (Step + F * F * (3.0f - 2.0f * F)) / NumTerraces;
+    }
+}
+
+FPTPCraterField::FPTPCraterField(const FPTPCraterFieldParams& InParams)
+    : Params(InParams)
+{
+    Params.MinDiameterKm = FMath::Max(Params.MinDiameterKm, 1e-4f);
+    Params.MaxDiameterKm = FMath::Max(Params.MaxDiameterKm, Params.MinDiameterKm);
+    Params.InfluenceRadii = FMath::Max(Params.InfluenceRadii, 1.2f);
+
+    const int32 NumOctaves = FMath::Max(1, FMath::CeilToInt(FMath::Log2(Params.MaxDiameterKm / Params.MinDiameterKm)));
+    const double B = double(Params.PowerLawExponent) + 1.0;
+    const double SphereAreaKm2 = 4.0 * PI * double(Params.PlanetRadiusKm) * Params.PlanetRadiusKm;
+
+    Octaves.SetNum(NumOctaves);
+    for (int32 k = 0; k < NumOctaves; ++k)
+    {
+        FOctave& Octave = Octaves[k];
+        Octave.MaxDiameterKm = Params.MaxDiameterKm / float(1 << FMath::Min(k, 30));
+        Octave.MinDiameterKm = FMath::Max(0.5f * Octave.MaxDiameterKm, Params.MinDiameterKm);
+
+        // Cells at least as wide as the reach of the octave's largest crater
+        const float MaxAngle = 0.5f * Octave.MaxDiameterKm * Params.InfluenceRadii / Params.PlanetRadiusKm;
+        const int32 GeometricRes = FMath::FloorToInt(FMath::Min(FPTPCubeMap::MinCellWidthFraction * HALF_PI / MaxAngle, float(MaxOctaveResolution)));
+        Octave.Resolution = GeometricRes < 2 ? 1 : GeometricRes;
+
+        const double PerKm2 = FMath::Abs(B) < 1e-6
+            ? Params.DensityAt1Km * FMath::Loge(double(Octave.MaxDiameterKm) / Octave.MinDiameterKm)
+            : Params.DensityAt1Km * (FMath::Pow(double(Octave.MinDiameterKm), B) - FMath::Pow(double(Octave.MaxDiameterKm), B));
+        const double NumCells = double(FPTPCubeMap::NumFaces) * Octave.Resolution * Octave.Resolution;
+        Octave.MeanPerCell = float(FMath::Max(PerKm2, 0.0) * SphereAreaKm2 / NumCells);
+    }
+}
+
+int64 FPTPCraterField::HomeCell(int32 Octave, const FVector3f& Dir) const
+{
+    const int64 Res = Octaves[Octave].Resolution;
+    int32 Face;
+    float S, T;
+    FPTPCubeMap::DirectionToFace(Dir, Face, S, T);
+    const int64 X = FMath::Clamp<int64>(int64((double(S) + 1.0) * 0.5 * Res), 0, Res - 1);
+    const int64 Y = FMath::Clamp<int64>(int64((double(T) + 1.0) * 0.5 * Res), 0, Res - 1);
+    return (Face * Res + Y) * Res + X;
+}
+
+int32 FPTPCraterField::NeighborhoodCells(int32 Octave, int64 Cell, int64 OutCells[9]) const
+{
+    const int64 Res = Octaves[Octave].Resolution;
+    if (Res == 1)
+    {
+        for (int32 Face = 0; Face < FPTPCubeMap::NumFaces; ++Face)
+        {
+            OutCells[Face] = Face;
+        }
+        return FPTPCubeMap::NumFaces;
+    }
+
+    // FPTPCubeMap::NeighborhoodCells with 64-bit ids: metre-scale octaves exceed int32 cell ids
+    const int64 X = Cell % Res;
+    const int64 Y = (Cell / Res) % Res;
+    const int32 Face = int32(Cell / (Res * Res));
+    const double Step = 2.0 / double(Res);
+
+    int32 Count = 0;
+    for (int32 DY = -1; DY <= 1; ++DY)
+    {
+        for (int32 DX = -1; DX <= 1; ++DX)
+        {
+            const int64 NX = X + DX;
+            const int64 NY = Y + DY;
+            const bool bOffX = NX < 0 || NX >= Res;
+            const bool bOffY = NY < 0 || NY >= Res;
+            int64 Id;
+            if (!bOffX && !bOffY)
+            {
+                Id = (Face * Res + NY) * Res + NX;
+            }
+            else if (bOffX && bOffY)
+            {
+                continue; // diagonal past a cube corner: the two edge neighbours already cover it
+            }
+            else
+            {
+                const FVector3f Center = FPTPCubeMap::FaceToDirection(Face, float(-1.0 + (NX + 0.5) * Step), float(-1.0 + (NY + 0.5) * Step));
+                Id = HomeCell(Octave, Center);
+            }
+
+            bool bSeen = false;
+            for (int32 i = 0; i < Count; ++i)
+            {
+                bSeen |= OutCells[i] == Id;
+            }
+            if (!bSeen)
+            {
+                OutCells[Count++] = Id;
+            }
+        }
+    }
+
+    Algo::Sort(MakeArrayView(OutCells, Count));
+    return Count;
+}
+
+void FPTPCraterField::GenerateCell(int32 OctaveIdx, int64 Cell, float MinDiameterKm, TArray<FCrater>& OutCraters) const
+{
+    const FOctave& Octave = Octaves[OctaveIdx];
+    const int64 Res = Octave.Resolution;
+    const int64 X = Cell % Res;
+    const int64 Y = (Cell / Res) % Res;
+    const int32 Face = int32(Cell / (Res * Res));
+    const double Step = 2.0 / double(Res);
+
+    // Counter-based: a cell's craters are the same no matter which batch, tile or LOD asks for them
+    const uint32 CellHash = FPTPHash::Hash(FPTPHash::Hash(uint32(Params.Seed), uint32(OctaveIdx)), uint32(Cell), uint32(Cell >> 32));
+
+    // Poisson crater count by inversion
+    const float U = FPTPHash::UnitFloat(FPTPHash::Mix(CellHash));
+    float P = FMath::Exp(-Octave.MeanPerCell);
+    float Cdf = P;
+    int32 NumCraters = 0;
+    while (U > Cdf && NumCraters < Params.MaxCratersPerCell)
+    {
+        ++NumCraters;
+        P *= Octave.MeanPerCell / NumCraters;
+        Cdf += P;
+    }
+
+    for (int32 j = 0; j < NumCraters; ++j)
+    {
+        const uint32 Key = uint32(j + 1);
+        const float Diameter = FPTPCraterCatalog::SampleDiameterKm(FPTPHash::UnitFloat(FPTPHash::Hash(CellHash, Key, StreamDiameter)),
+            Octave.MinDiameterKm, Octave.MaxDiameterKm, Params.PowerLawExponent);
+        if (Diameter < MinDiameterKm)
+        {
+            continue;
+        }
+
+        const double CU = FPTPHash::UnitFloat(FPTPHash::Hash(CellHash, Key, StreamU));
+        const double CV = FPTPHash::UnitFloat(FPTPHash::Hash(CellHash, Key, StreamV));
+        const float Age = FPTPHash::UnitFloat(FPTPHash::Hash(CellHash, Key, StreamAge));
+        const float Freshness = FMath::Lerp(1.0f, Params.MinFreshness, Age);
+        const float ChordRadius = 2.0f * FMath::Sin(0.25f * Diameter / Params.PlanetRadiusKm);
+
+        FCrater& Crater = OutCraters.AddDefaulted_GetRef();
+        Crater.Center = FPTPCubeMap::FaceToDirection(Face, float(-1.0 + (X + CU) * Step), float(-1.0 + (Y + CV) * Step));
+        Crater.InvChordRadius2 = 1.0f / (ChordRadius * ChordRadius);
+        Crater.DepthKm = Freshness * FPTPCraterCatalog::ComputeDepthKm(Diameter, Params.ComplexTransitionKm, Params.DepthRatio, Params.ComplexDepthSlope);
+        if (Diameter > Params.MultiRingTransitionKm)
+        {
+            Crater.Kind = ECraterKind::MultiRing;
+            Crater.NumRings = uint8(2 + FMath::Min(int32(3.0f * FPTPHash::UnitFloat(FPTPHash::Hash(CellHash, Key, StreamRings))), 2));
+        }
+        else if (Diameter > Params.ComplexTransitionKm)
+        {
+            Crater.Kind = ECraterKind::Complex;
+            Crater.RimKm = Params.ComplexRimRatio * Crater.DepthKm;
+        }
+        else
+        {
+            Crater.Kind = ECraterKind::Simple;
+            Crater.RimKm = Params.SimpleRimRatio * Crater.DepthKm;
+        }
+    }
+}
+
+float FPTPCraterField::SimpleProfile(float R, float DepthKm, float RimKm, float Reach)
+{
+    if (R < 1.0f)
+    {
+        // Parabolic bowl from -Depth at the centre up to the rim crest
+        return RimKm - (DepthKm + RimKm) * (1.0f - R * R);
+    }
+    return EjectaProfile(R, RimKm, Reach);
+}
+
+float FPTPCraterField::ComplexProfile(float R, float DepthKm, float RimKm, float PeakKm, float Reach)
+{
+    if (R < 1.0f)
+    {
+        // Flat floor, terraced wall from FloorRadius to the rim, central peak from crustal rebound
+        const float Wall = -DepthKm + (DepthKm + RimKm) * Terrace(FMath::Clamp((R - FloorRadius) / (1.0f - FloorRadius), 0.0f, 1.0f));
+        const float Peak = FMath::Max(1.0f - R / PeakRadius, 0.0f);
+        return Wall + PeakKm * Peak * Peak;
+    }
+    return EjectaProfile(R, RimKm, Reach);
+}
+
+float FPTPCraterField::MultiRingProfile(float R, float DepthKm, int32 NumRings, float Reach)
+{
+    // Flat basin floor rising to the surrounding plain, with concentric uplifted rings (fault scarps)
+    float Height = -0.8f * DepthKm * (1.0f - FMath::SmoothStep(0.4f, 1.0f, R));
+    for (int32 Ring = 0; Ring < NumRings; ++Ring)
+    {
+        const float RingRadius = 0.5f + 0.4f * Ring;
+        if (RingRadius + 0.1f <= Reach)
+        {
+            Height += 0.2f * DepthKm * FMath::Max(1.0f - FMath::Abs(R - RingRadius) / 0.1f, 0.0f);
+        }
+    }
+    return Height;
+}
+
+float FPTPCraterField::EvaluateScalarCrater(const FCrater& Crater, const FVector3f& P) const
+{
+    const float R = FMath::Sqrt((P - Crater.Center).SizeSquared() * Crater.InvChordRadius2);
+    switch (Crater.Kind)
+    {
+    case ECraterKind::Simple:
+        return SimpleProfile(R, Crater.DepthKm, Crater.RimKm, Params.InfluenceRadii);
+    case ECraterKind::Complex:
+        return ComplexProfile(R, Crater.DepthKm, Crater.RimKm, Params.PeakRatio * Crater.DepthKm, Params.InfluenceRadii);
+    default:
+        return MultiRingProfile(R, Crater.DepthKm, Crater.NumRings, Params.InfluenceRadii);
+    }
+}
+
+float FPTPCraterField::EvaluateBlock(const FPackedCraters& Simple, const FPackedCraters& Complex, TConstArrayView<FCrater> Basins,
+                                     const FBlock& Block, const FVector3f& P) const
+{
+    const float Reach = Params.InfluenceRadii;
+    const float InvReach3 = 1.0f / (Reach * Reach * Reach);
+
+    const VectorRegister4Float QX = VectorSetFloat1(P.X);
+    const VectorRegister4Float QY = VectorSetFloat1(P.Y);
+    const VectorRegister4Float QZ = VectorSetFloat1(P.Z);
+    const VectorRegister4Float One = VectorOne();
+    const VectorRegister4Float Zero = VectorZeroFloat();
+    const VectorRegister4Float Reach2 = VectorSetFloat1(Reach * Reach);
+    const VectorRegister4Float VInvReach3 = VectorSetFloat1(InvReach3);
+    const VectorRegister4Float EjectaNorm = VectorSetFloat1(1.0f / (1.0f - InvReach3));
+
+    // Normalized squared distance; padding lanes sit at the origin with zero InvChordRadius2, depth and rim
+    auto LoadR2 = [&](const FPackedCraters& Packed, int32 j)
+    {
+        const VectorRegister4Float DX = VectorSubtract(QX, VectorLoad(Packed.CX.GetData() + j));
+        const VectorRegister4Float DY = VectorSubtract(QY, VectorLoad(Packed.CY.GetData() + j));
+        const VectorRegister4Float DZ = VectorSubtract(QZ, VectorLoad(Packed.CZ.GetData() + j));
+        const VectorRegister4Float D2 = VectorAdd(VectorAdd(VectorMultiply(DX, DX), VectorMultiply(DY, DY)), VectorMultiply(DZ, DZ));
+        return VectorMultiply(D2, VectorLoad(Packed.InvChordRadius2.GetData() + j));
+    };
+
+    // EjectaProfile, selected only outside the rim (R2 >= 1, so the reciprocal square root is finite)
+    auto Ejecta = [&](const VectorRegister4Float& R2, const VectorRegister4Float& Rim)
+    {
+        const VectorRegister4Float InvR = VectorReciprocalSqrt(R2);
+        const VectorRegister4Float InvR3 = VectorMultiply(VectorMultiply(InvR, InvR), InvR);
+        const VectorRegister4Float Blanket = VectorMultiply(VectorMultiply(Rim, VectorSubtract(InvR3, VInvReach3)), EjectaNorm);
+        return VectorSelect(VectorCompareLT(R2, Reach2), Blanket, Zero);
+    };
+
+    VectorRegister4Float Sum = VectorZeroFloat();
+    for (int32 j = Block.SimpleFirst; j < Block.SimpleFirst + Block.SimpleNum; j += PTPSimd::Lanes)
+    {
+        const VectorRegister4Float R2 = LoadR2(Simple, j);
+        const VectorRegister4Float Depth = VectorLoad(Simple.Depth.GetData() + j);
+        const VectorRegister4Float Rim = VectorLoad(Simple.Rim.GetData() + j);
+
+        // SimpleProfile: Rim - (Depth + Rim) (1 - R^2) inside the rim
+        const VectorRegister4Float Bowl = VectorSubtract(Rim, VectorMultiply(VectorAdd(Depth, Rim), VectorSubtract(One, R2)));
+        Sum = VectorAdd(Sum, VectorSelect(VectorCompareLT(R2, One), Bowl, Ejecta(R2, Rim)));
+    }
+
+    const VectorRegister4Float InvPeakRadius = VectorSetFloat1(1.0f / PeakRadius);
+    const VectorRegister4Float VFloorRadius = VectorSetFloat1(FloorRadius);
+    const VectorRegister4Float InvWallWidth = VectorSetFloat1(1.0f / (1.0f - FloorRadius));
+    const VectorRegister4Float VNumTerraces = VectorSetFloat1(NumTerraces);
+    const VectorRegister4Float LastTerrace = VectorSetFloat1(NumTerraces - 1.0f);
+    const VectorRegister4Float InvNumTerraces = VectorSetFloat1(1.0f / NumTerraces);
+    const VectorRegister4Float Three = VectorSetFloat1(3.0f);
+    const VectorRegister4Float Two = VectorSetFloat1(2.0f);
+    const VectorRegister4Float PeakRatio = VectorSetFloat1(Params.PeakRatio);
+    for (int32 j = Block.ComplexFirst; j < Block.ComplexFirst + Block.ComplexNum; j += PTPSimd::Lanes)
+    {
+        const VectorRegister4Float R2 = LoadR2(Complex, j);
+        const VectorRegister4Float R = VectorSqrt(R2);
+        const VectorRegister4Float Depth = VectorLoad(Complex.Depth.GetData() + j);
+        const VectorRegister4Float Rim = VectorLoad(Complex.Rim.GetData() + j);
+
+        // ComplexProfile: terraced wall over a flat floor, plus the central peak
+        const VectorRegister4Float T = PTPSimd::Clamp(VectorMultiply(VectorSubtract(R, VFloorRadius), InvWallWidth), Zero, One);
+        const VectorRegister4Float X = VectorMultiply(T, VNumTerraces);
+        const VectorRegister4Float Step = VectorMin(VectorFloor(X), LastTerrace);
+        const VectorRegister4Float F = VectorSubtract(X, Step);
+        const VectorRegister4Float Smooth = VectorMultiply(VectorMultiply(F, F), VectorSubtract(Three, VectorMultiply(Two, F)));
+        const VectorRegister4Float Stairs = VectorMultiply(VectorAdd(Step, Smooth), InvNumTerraces);
+        const VectorRegister4Float Wall = VectorSubtract(VectorMultiply(VectorAdd(Depth, Rim), Stairs), Depth);
+        const VectorRegister4Float Peak = VectorMax(VectorSubtract(One, VectorMultiply(R, InvPeakRadius)), Zero);
+        const VectorRegister4Float Inside = VectorAdd(Wall, VectorMultiply(VectorMultiply(PeakRatio, Depth), VectorMultiply(Peak, Peak)));
+        Sum = VectorAdd(Sum, VectorSelect(VectorCompareLT(R2, One), Inside, Ejecta(R2, Rim)));
+    }
+
+    alignas(16) float Lanes[4];
+    VectorStoreAligned(Sum, Lanes);
+    float Total = (Lanes[0] + Lanes[1]) + (Lanes[2] + Lanes[3]);
+
+    for (int32 j = Block.BasinFirst; j < Block.BasinFirst + Block.BasinNum; ++j)
+    {
+        Total += EvaluateScalarCrater(Basins[j], P);
+    }
+    return Total;
+}
+
+void FPTPCraterField::Evaluate(TConstArrayView<FVector3f> Directions, TArrayView<float> OutReliefKm, float MinDiameterKm, bool bParallel) const
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, CraterFieldEvaluate);
+
+    const int32 Num = Directions.Num();
+    check(OutReliefKm.Num() == Num);
+    if (Num == 0)
+    {
+        return;
+    }
+
+    int32 NumActive = 0;
+    while (NumActive < Octaves.Num() && Octaves[NumActive].MaxDiameterKm >= MinDiameterKm)
+    {
+        ++NumActive;
+    }
+
+    FPackedCraters Simple, Complex;
+    TArray<FCrater> Basins;
+    TArray<FBlock> Blocks;
+    TArray<int32> BlockOfQuery;
+    BlockOfQuery.SetNumUninitialized(NumActive * Num);
+
+    TArray<FCrater> CellCraters;
+    TArray<FCrater> BlockCraters;
+    for (int32 Octave = 0; Octave < NumActive; ++Octave)
+    {
+        // 1) Home cell per query; one block per distinct home cell
+        TMap<int64, int32> HomeToBlock;
+        TArray<int64> HomeCells;
+        for (int32 i = 0; i < Num; ++i)
+        {
+            const int64 Home = HomeCell(Octave, Directions[i]);
+            const int32* Found = HomeToBlock.Find(Home);
+            if (!Found)
+            {
+                Found = &HomeToBlock.Add(Home, Blocks.Num() + HomeCells.Num());
+                HomeCells.Add(Home);
+            }
+            BlockOfQuery[Octave * Num + i] = *Found;
+        }
+
+        // 2) Craters of every cell the blocks touch, generated once
+        TMap<int64, TPair<int32, int32>> CellRanges;
+        CellCraters.Reset();
+        for (const int64 Home : HomeCells)
+        {
+            int64 Cells[9];
+            const int32 NumCells = NeighborhoodCells(Octave, Home, Cells);
+            for (int32 c = 0; c < NumCells; ++c)
+            {
+                if (!CellRanges.Contains(Cells[c]))
+                {
+                    const int32 First = CellCraters.Num();
+                    GenerateCell(Octave, Cells[c], MinDiameterKm, CellCraters);
+                    CellRanges.Add(Cells[c], TPair<int32, int32>(First, CellCraters.Num() - First));
+                }
+            }
+        }
+
+        // 3) Per-home-cell blocks, split by morphology and padded to whole vectors
+        for (const int64 Home : HomeCells)
+        {
+            BlockCraters.Reset();
+            int64 Cells[9];
+            const int32 NumCells = NeighborhoodCells(Octave, Home, Cells);
+            for (int32 c = 0; c < NumCells; ++c)
+            {
+                const TPair<int32, int32>& Range = CellRanges.FindChecked(Cells[c]);
+                BlockCraters.Append(CellCraters.GetData() + Range.Key, Range.Value);
+            }
+
+            FBlock& Block = Blocks.AddDefaulted_GetRef();
+            Block.SimpleFirst = Simple.Depth.Num();
+            Block.ComplexFirst = Complex.Depth.Num();
+            Block.BasinFirst = Basins.Num();
+            for (const FCrater& Crater : BlockCraters)
+            {
+                if (Crater.Kind == ECraterKind::MultiRing)
+                {
+                    Basins.Add(Crater);
+                    continue;
+                }
+                FPackedCraters& Packed = Crater.Kind == ECraterKind::Simple ? Simple : Complex;
+                Packed.CX.Add(Crater.Center.X);
+                Packed.CY.Add(Crater.Center.Y);
+                Packed.CZ.Add(Crater.Center.Z);
+                Packed.InvChordRadius2.Add(Crater.InvChordRadius2);
+                Packed.Depth.Add(Crater.DepthKm);
+                Packed.Rim.Add(Crater.RimKm);
+            }
+            for (FPackedCraters* Packed : { &Simple, &Complex })
+            {
+                const int32 Padded = Align(Packed->Depth.Num(), PTPSimd::Lanes);
+                for (TArray<float>* Stream : { &Packed->CX, &Packed->CY, &Packed->CZ, &Packed->InvChordRadius2, &Packed->Depth, &Packed->Rim })
+                {
+                    Stream->SetNumZeroed(Padded);
+                }
+            }
+            Block.SimpleNum = Simple.Depth.Num() - Block.SimpleFirst;
+            Block.ComplexNum = Complex.Depth.Num() - Block.ComplexFirst;
+            Block.BasinNum = Basins.Num() - Block.BasinFirst;
+        }
+    }
+
+    // 4) Sum every octave's block per query
+    ParallelFor(PTPSimd::NumChunks(Num, QueryChunkSize), [&](int32 ChunkIdx)
+    {
+        const int32 Begin = ChunkIdx * QueryChunkSize;
+        const int32 End = FMath::Min(Begin + QueryChunkSize, Num);
+        for (int32 i = Begin; i < End; ++i)
+        {
+            float Relief = 0.0f;
+            for (int32 Octave = 0; Octave < NumActive; ++Octave)
+            {
+                Relief += EvaluateBlock(Simple, Complex, Basins, Blocks[BlockOfQuery[Octave * Num + i]], Directions[i]);
+            }
+            OutReliefKm[i] = Relief;
+        }
+    }, !bParallel || !PTPProfiling::IsParallelEnabled());
+
+    UE_LOG(LogGaiaPTP, Verbose, TEXT("Crater field: %d queries, %d octaves, %d blocks, %d simple / %d complex / %d basin lanes"),
+        Num, NumActive, Blocks.Num(), Simple.Depth.Num(), Complex.Depth.Num(), Basins.Num());
+}
+
+void FPTPCraterField::EvaluateScalar(TConstArrayView<FVector3f> Directions, TArrayView<float> OutReliefKm, float MinDiameterKm) const
+{
+    const int32 Num = Directions.Num();
+    check(OutReliefKm.Num() == Num);
+
+    TArray<FCrater> Craters;
+    for (int32 i = 0; i < Num; ++i)
+    {
+        float Relief = 0.0f;
+        for (int32 Octave = 0; Octave < Octaves.Num() && Octaves[Octave].MaxDiameterKm >= MinDiameterKm; ++Octave)
+        {
+            int64 Cells[9];
+            const int32 NumCells = NeighborhoodCells(Octave, HomeCell(Octave, Directions[i]), Cells);
+            Craters.Reset();
+            for (int32 c = 0; c < NumCells; ++c)
+            {
+                GenerateCell(Octave, Cells[c], MinDiameterKm, Craters);
+            }
+            for (const FCrater& Crater : Craters)
+            {
+                Relief += EvaluateScalarCrater(Crater, Directions[i]);
+            }
+        }
+        OutReliefKm[i] = Relief;
+    }
+}
+
+bool FPTPCraterField::AmplifyTile(const FPTPAmplifyTile& Tile, TArray<float>& InOutElevationKm, float MinFeatureTexels) const
+{
+    const int32 Res = Tile.Resolution;
+    if (Res <= 0 || InOutElevationKm.Num() != Res * Res)
+    {
+        UE_LOG(LogGaiaPTP, Error, TEXT("Crater relief skipped for face %d tile (%d, %d): %d elevations, expected %d"),
+            Tile.Face, Tile.TileX, Tile.TileY, InOutElevationKm.Num(), Res * Res);
+        return false;
+    }
+
+    TArray<FVector3f> Directions;
+    Directions.SetNumUninitialized(Res * Res);
+    for (int32 Y = 0; Y < Res; ++Y)
+    {
+        for (int32 X = 0; X < Res; ++X)
+        {
+            Directions[Y * Res + X] = Tile.TexelDirection(X, Y);
+        }
+    }
+
+    // Craters narrower than a few texels would only alias
+    const int32 TexelsPerFace = Tile.TilesPerFace * FMath::Max(Tile.bSharedEdges ? Res - 1 : Res, 1);
+    const float TexelKm = HALF_PI * Params.PlanetRadiusKm / TexelsPerFace;
+
+    TArray<float> Relief;
+    Relief.SetNumUninitialized(Directions.Num());
+    Evaluate(Directions, Relief, MinFeatureTexels * TexelKm, false);
+    for (int32 i = 0; i < Directions.Num(); ++i)
+    {
+        InOutElevationKm[i] += Relief[i];
+    }
+    return true;
+}
@@ -0,0 +1,215 @@
+#include "PTPCrustSample.h"
+#include "PTPCubeMap.h"
+#include "PTPPointLocator.h"
+
+namespace
+{
+    /** Nearest samples blended by the default crust sampler. */
+    constexpr int32 SamplerNeighbors = 4;
+
+    /** Blend unit tangent fields that are line orientations (sign-free), then re-project onto the tangent plane. */
+    FVector3f BlendOrientation(const FVector3f& Sum, const FVector3f& Dir)
+    {
+        return (Sum - Dir * FVector3f::DotProduct(Sum, Dir)).GetSafeNormal();
+    }
+
+    FPTPCrustSample ToSample(const FCrustData& C)
+    {
+        const bool bOceanic = C.Type == ECrustType::Oceanic;
+        FPTPCrustSample S;
+        S.Elevation = C.Elevation;
+        S.OceanicAge = bOceanic ? C.OceanicAge : 0.0f;
+        S.RidgeDirection = bOceanic ? C.RidgeDirection : FVector3f::ZeroVector;
+        S.OceanicWeight = bOceanic ? 1.0f : 0.0f;
+        S.OrogenyAge = bOceanic ? 0.0f : C.OrogenyAge;
+        S.OrogenyType = bOceanic ? EOrogenyType::None : C.OrogenyType;
+        S.FoldDirection = bOceanic ? FVector3f::ZeroVector : C.FoldDirection;
+        return S;
+    }
+
+    /** Sample directions bucketed by cube-map cell (counting sort), with their crust copied alongside. */
+    struct FNearestSamplerGrid
+    {
+        int32 Resolution = 1;
+        TArray<int32> CellStart;   // NumCells + 1 offsets into Order
+        TArray<int32> Order;
+        TArray<FVector3f> Directions;
+        TArray<FPTPCrustSample> Samples;
+
+        void Build(const TArray<FVector3f>& SamplePoints, const TArray<FCrustData>& CrustData)
+        {
+            const int32 N = SamplePoints.Num();
+            Resolution = FMath::Max(1, FMath::FloorToInt(FMath::Sqrt(N / (FPTPCubeMap::NumFaces * (float)SamplerNeighbors))));
+            const int32 NumCells = FPTPCubeMap::NumFaces * Resolution * Resolution;
+
+            Directions.SetNumUninitialized(N);
+            Samples.SetNumUninitialized(N);
+            TArray<int32> Cells;
+            Cells.SetNumUninitialized(N);
+            CellStart.Init(0, NumCells + 1);
+            for (int32 i = 0; i < N; ++i)
+            {
+                Directions[i] = SamplePoints[i].GetSafeNormal();
+                Cells[i] = FPTPCubeMap::CellId(Directions[i], Resolution);
+                ++CellStart[Cells[i] + 1];
+
+                Samples[i] = ToSample(CrustData[i]);
+            }
+            for (int32 c = 0; c < NumCells; ++c)
+            {
+                CellStart[c + 1] += CellStart[c];
+            }
+            Order.SetNumUninitialized(N);
+            TArray<int32> Cursor(CellStart.GetData(), NumCells);
+            for (int32 i = 0; i < N; ++i)
+            {
+                Order[Cursor[Cells[i]]++] = i;
+            }
+        }
+
+        FPTPCrustSample Sample(const FVector3f& Dir) const
+        {
+            int32 Best[SamplerNeighbors];
+            float BestD2[SamplerNeighbors];
+            int32 NumBest = 0;
+            auto Consider = [&](int32 Idx)
+            {
+                const float D2 = FVector3f::DistSquared(Dir, Directions[Idx]);
+                if (NumBest == SamplerNeighbors && D2 >= BestD2[NumBest - 1])
+                {
+                    return;
+                }
+                int32 Slot = FMath::Min(NumBest, SamplerNeighbors - 1);
+                while (Slot > 0 && BestD2[Slot - 1] > D2)
+                {
+                    Best[Slot] = Best[Slot - 1];
+                    BestD2[Slot] = BestD2[Slot - 1];
+                    --Slot;
+                }
+                Best[Slot] = Idx;
+                BestD2[Slot] = D2;
+                NumBest = FMath::Min(NumBest + 1, SamplerNeighbors);
+            };
+
+            int32 Cells[9];
+            const int32 NumCells = FPTPCubeMap::NeighborhoodCells(FPTPCubeMap::CellId(Dir, Resolution), Resolution, Cells);
+            for (int32 c = 0; c < NumCells; ++c)
+            {
+                for (int32 k = CellStart[Cells[c]]; k < CellStart[Cells[c] + 1]; ++k)
+                {
+                    Consider(Order[k]);
+                }
+            }
+            if (NumBest == 0)
+            {
+                // Sparse planets can leave a neighbourhood empty; fall back to a full scan
+                for (int32 i = 0; i < Directions.Num(); ++i)
+                {
+                    Consider(i);
+                }
+            }
+
+            FPTPCrustSample Out;
+            if (NumBest == 0)
+            {
+                return Out;
+            }
+
+            // Ridge/fold directions are line orientations: align signs with the nearest before blending
+            const FPTPCrustSample& Nearest = Samples[Best[0]];
+            float WeightSum = 0.0f;
+            FVector3f Ridge = FVector3f::ZeroVector;
+            FVector3f Fold = FVector3f::ZeroVector;
+            for (int32 k = 0; k < NumBest; ++k)
+            {
+                const FPTPCrustSample& S = Samples[Best[k]];
+                const float W = 1.0f / (BestD2[k] + 1e-12f);
+                WeightSum += W;
+                Out.Elevation += W * S.Elevation;
+                Out.OceanicAge += W * S.OceanicAge;
+                Out.OceanicWeight += W * S.OceanicWeight;
+                Out.OrogenyAge += W * S.OrogenyAge;
+                Ridge += S.RidgeDirection * (FVector3f::DotProduct(S.RidgeDirection, Nearest.RidgeDirection) < 0.0f ? -W : W);
+                Fold += S.FoldDirection * (FVector3f::DotProduct(S.FoldDirection, Nearest.FoldDirection) < 0.0f ? -W : W);
+            }
+            const float InvW = 1.0f / WeightSum;
+            Out.Elevation *= InvW;
+            Out.OceanicAge *= InvW;
+            Out.OceanicWeight *= InvW;
+            Out.OrogenyAge *= InvW;
+            Out.OrogenyType = Nearest.OrogenyType;
+            Out.RidgeDirection = BlendOrientation(Ridge, Dir);
+            Out.FoldDirection = BlendOrientation(Fold, Dir);
+            return Out;
+        }
+    };
+}
+
+FPTPCrustSampler FPTPCrustSampling::MakeNearestSampler(const TArray<FVector3f>& SamplePoints, const TArray<FCrustData>& CrustData)
+{
+    check(SamplePoints.Num() == CrustData.Num());
+    TSharedRef<FNearestSamplerGrid> Grid = MakeShared<FNearestSamplerGrid>();
+    Grid->Build(SamplePoints, CrustData);
+
+    return [Grid](TConstArrayView<FVector3f> Directions, TArrayView<FPTPCrustSample> OutSamples)
+    {
+        check(OutSamples.Num() == Directions.Num());
+        for (int32 i = 0; i < Directions.Num(); ++i)
+        {
+            OutSamples[i] = Grid->Sample(Directions[i]);
+        }
+    };
+}
+
+FPTPCrustSampler FPTPCrustSampling::MakeBarycentricSampler(const TArray<FVector3f>& SamplePoints, const TArray<FIntVector>& Triangles,
+                                                          const TArray<FCrustData>& CrustData)
+{
+    check(SamplePoints.Num() == CrustData.Num());
+    TSharedRef<FPTPPointLocator> Locator = MakeShared<FPTPPointLocator>();
+    if (!Locator->Build(SamplePoints, Triangles))
+    {
+        return MakeNearestSampler(SamplePoints, CrustData);
+    }
+
+    TSharedRef<TArray<FPTPCrustSample>> Samples = MakeShared<TArray<FPTPCrustSample>>();
+    Samples->SetNumUninitialized(CrustData.Num());
+    for (int32 i = 0; i < CrustData.Num(); ++i)
+    {
+        (*Samples)[i] = ToSample(CrustData[i]);
+    }
+
+    return [Locator, Samples](TConstArrayView<FVector3f> Directions, TArrayView<FPTPCrustSample> OutSamples)
+    {
+        check(OutSamples.Num() == Directions.Num());
+        TArray<FPTPLocation> Locations;
+        Locations.SetNumUninitialized(Directions.Num());
+        Locator->LocateBatch(Directions, Locations);
+
+        for (int32 i = 0; i < Directions.Num(); ++i)
+        {
+            const FIntVector& Tri = Locator->GetTriangle(Locations[i].Triangle);
+            const FVector3f& W = Locations[i].Barycentrics;
+            const int32 Major = W.X >= W.Y ? (W.X >= W.Z ? 0 : 2) : (W.Y >= W.Z ? 1 : 2);
+            const FPTPCrustSample& Nearest = (*Samples)[Tri[Major]];
+
+            FPTPCrustSample Out;
+            FVector3f Ridge = FVector3f::ZeroVector;
+            FVector3f Fold = FVector3f::ZeroVector;
+            for (int32 k = 0; k < 3; ++k)
+            {
+                const FPTPCrustSample& S = (*Samples)[Tri[k]];
+                const float Wk = W[k];
+                Out.Elevation += Wk * S.Elevation;
+                Out.OceanicAge += Wk * S.OceanicAge;
+                Out.OceanicWeight += Wk * S.OceanicWeight;
+                Out.OrogenyAge += Wk * S.OrogenyAge;
+                Ridge += S.RidgeDirection * (FVector3f::DotProduct(S.RidgeDirection, Nearest.RidgeDirection) < 0.0f ? -Wk : Wk);
+                Fold += S.FoldDirection * (FVector3f::DotProduct(S.FoldDirection, Nearest.FoldDirection) < 0.0f ? -Wk : Wk);
+            }
+            Out.OrogenyType = Nearest.OrogenyType;
+            Out.RidgeDirection = BlendOrientation(Ridge, Directions[i]);
+            Out.FoldDirection = BlendOrientation(Fold, Directions[i]);
+            OutSamples[i] = Out;
+        }
+    };
+}
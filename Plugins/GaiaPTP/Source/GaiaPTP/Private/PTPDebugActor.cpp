@@ -1,11 +1,182 @@
 #include "PTPDebugActor.h"
+#include "PTPOverlayBuilder.h"
+#include "PTPPlanetActor.h"
+#include "PTPPlanetComponent.h"
+#include "PTPVisualizationLayers.h"
 #include "RealtimeMeshComponent.h"
+#include "RealtimeMeshSimple.h"
+#include "Async/Async.h"
+#include "Engine/World.h"
+#include "Materials/MaterialInterface.h"
+
+using namespace RealtimeMesh;
+
+/** Worker output: one stream set per overlay layer. */
+struct FPTPOverlayMeshes
+{
+    FRealtimeMeshStreamSet Arrows;
+    FRealtimeMeshStreamSet Boundaries;
+};
+
+namespace
+{
+    FRealtimeMeshSectionGroupKey VelocityGroupKey()
+    {
+        return FRealtimeMeshSectionGroupKey::Create(FRealtimeMeshLODKey(0), FName("PTPVelocity"));
+    }
+
+    FRealtimeMeshSectionGroupKey BoundaryGroupKey()
+    {
+        return FRealtimeMeshSectionGroupKey::Create(FRealtimeMeshLODKey(0), FName("PTPBoundaries"));
+    }
+}
 
 APTPDebugActor::APTPDebugActor()
 {
-    PrimaryActorTick.bCanEverTick = false;
+    PrimaryActorTick.bCanEverTick = true;  // overlay density follows the camera
 
     RealtimeMesh = CreateDefaultSubobject<URealtimeMeshComponent>(TEXT("RealtimeMesh"));
     SetRootComponent(RealtimeMesh);
+    RealtimeMesh->SetCullDistance(0.0f);
+    RealtimeMesh->bUseAsOccluder = false;
+    RealtimeMesh->CastShadow = false;
+}
+
+void APTPDebugActor::RefreshOverlays()
+{
+    MarkOverlayDirty();
+    if (!PendingBuild.IsValid() && PlanetActor && PlanetActor->GetPlanet())
+    {
+        UpdateView();
+        LaunchOverlayBuild();
+    }
+}
+
+void APTPDebugActor::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    // One build in flight at a time; a view change or dirty mark during it is picked up afterwards
+    if (PendingBuild.IsValid())
+    {
+        if (!PendingBuild.IsReady())
+        {
+            return;
+        }
+        TSharedPtr<FPTPOverlayMeshes> Meshes = PendingBuild.Get();
+        PendingBuild.Reset();
+        if (Meshes)
+        {
+            ApplyOverlays(*Meshes);
+        }
+    }
+
+    if (!PlanetActor || !PlanetActor->GetPlanet())
+    {
+        return;
+    }
+    if (!GetActorTransform().Equals(PlanetActor->GetActorTransform()))
+    {
+        SetActorTransform(PlanetActor->GetActorTransform());
+    }
+    if (UpdateView() || bOverlayDirty)
+    {
+        LaunchOverlayBuild();
+    }
+}
+
+bool APTPDebugActor::UpdateView()
+{
+    const UPTPPlanetComponent* Planet = PlanetActor->GetPlanet();
+    const double RadiusKm = Planet->PlanetRadiusKm;
+
+    // Editor viewports and game views both record their locations here; without one, show the whole planet
+    const UWorld* World = GetWorld();
+    const bool bHasView = World && World->ViewLocationsRenderedLastFrame.Num() > 0 && Planet->VisualizationScale > 0.0f;
+    const FVector CameraKm = bHasView
+        ? PlanetActor->GetActorTransform().InverseTransformPosition(World->ViewLocationsRenderedLastFrame[0]) / Planet->VisualizationScale
+        : FVector(UE_BIG_NUMBER, 0.0, 0.0);
+
+    const double Distance = CameraKm.Size();
+    const int32 Stride = FPTPOverlayBuilder::ChooseArrowStride(Planet->SamplePoints.Num(), Distance, RadiusKm, TargetArrows);
+    const float CapHalfAngle = bHasView && Distance > RadiusKm ? FMath::Acos(float(RadiusKm / Distance)) : PI;
+    const FVector3f Dir(CameraKm.GetSafeNormal());
+
+    // Keep the resident arrows while the visible cap stays inside the cap they were gathered over
+    const float Moved = FMath::Acos(FMath::Clamp(FVector3f::DotProduct(Dir, ViewDir), -1.0f, 1.0f));
+    if (Stride == ViewStride && (ViewHalfAngle >= PI || Moved <= ViewHalfAngle - CapHalfAngle))
+    {
+        return false;
+    }
+    ViewStride = Stride;
+    ViewDir = Dir;
+    ViewHalfAngle = CapHalfAngle >= PI ? PI : FMath::Min(PI, CapHalfAngle * 1.25f + 0.05f);
+    return true;
+}
+
+void APTPDebugActor::LaunchOverlayBuild()
+{
+    bOverlayDirty = false;
+    const UPTPPlanetComponent* Planet = PlanetActor->GetPlanet();
+    const FPTPLayerSource Source = FPTPLayerSource::FromPlanet(*Planet);
+
+    // Gather on the game thread, where the planet data is stable; the worker owns copies
+    TArray<FPTPOverlayArrow> Arrows;
+    TArray<FPTPOverlaySegment> Segments;
+    if (bShowVelocityArrows)
+    {
+        FPTPOverlayBuilder::GatherVelocityArrows(Source, ViewStride, ViewDir, ViewHalfAngle >= PI ? -1.0f : FMath::Cos(ViewHalfAngle), Arrows);
+    }
+    if (bShowBoundaries)
+    {
+        FPTPOverlayBuilder::GatherBoundarySegments(Source, Planet->Neighbors, Segments);
+    }
+
+    // Ribbon sizes follow the spacing between arrows so zooming keeps them legible
+    const int32 NumPoints = FMath::Max(1, Planet->SamplePoints.Num());
+    const float SampleSpacingKm = Planet->PlanetRadiusKm * FMath::Sqrt(4.0f * PI / NumPoints);
+    const float ArrowSpacingKm = SampleSpacingKm * FMath::Sqrt(float(FMath::Max(1, ViewStride)));
+
+    FPTPOverlayStyle ArrowStyle;
+    ArrowStyle.Width = 0.12f * ArrowSpacingKm;
+    ArrowStyle.Lift = 0.002f * Planet->PlanetRadiusKm;
+    ArrowStyle.MaxSpeedMmPerYear = Source.MaxPlateSpeedMmPerYear;
+    ArrowStyle.KmPerMmPerYear = 0.8f * ArrowSpacingKm / FMath::Max(Source.MaxPlateSpeedMmPerYear, 1.0f);
+
+    FPTPOverlayStyle BoundaryStyle = ArrowStyle;
+    BoundaryStyle.Width = FMath::Max(0.25f * SampleSpacingKm, 0.05f * ArrowSpacingKm);
+
+    PendingBuild = Async(EAsyncExecution::ThreadPool,
+        [Arrows = MoveTemp(Arrows), Segments = MoveTemp(Segments), ArrowStyle, BoundaryStyle, Scale = Planet->VisualizationScale]()
+        {
+            TSharedPtr<FPTPOverlayMeshes> Meshes = MakeShared<FPTPOverlayMeshes>();
+            FPTPOverlayBuilder::BuildArrows(Arrows, ArrowStyle, Scale, Meshes->Arrows);
+            FPTPOverlayBuilder::BuildSegments(Segments, BoundaryStyle, Scale, Meshes->Boundaries);
+            return Meshes;
+        });
 }
 
+void APTPDebugActor::ApplyOverlays(FPTPOverlayMeshes& Meshes)
+{
+    URealtimeMeshSimple* RMSimple = RealtimeMesh->GetRealtimeMeshAs<URealtimeMeshSimple>();
+    if (!RMSimple || !bGroupsCreated)
+    {
+        RMSimple = RealtimeMesh->InitializeRealtimeMesh<URealtimeMeshSimple>();
+        if (!RMSimple)
+        {
+            return;
+        }
+        if (OverlayMaterial)
+        {
+            RealtimeMesh->SetMaterial(0, OverlayMaterial);
+        }
+        RMSimple->CreateSectionGroup(VelocityGroupKey(), MoveTemp(Meshes.Arrows));
+        RMSimple->CreateSectionGroup(BoundaryGroupKey(), MoveTemp(Meshes.Boundaries));
+        bGroupsCreated = true;
+        return;
+    }
+
+    // Only the overlay streams change; hidden layers upload empty stream sets
+    RMSimple->UpdateSectionGroup(VelocityGroupKey(), MoveTemp(Meshes.Arrows));
+    RMSimple->UpdateSectionGroup(BoundaryGroupKey(), MoveTemp(Meshes.Boundaries));
+}
@@ -0,0 +1,428 @@
+#include "PTPExemplarLibrary.h"
+#include "Algo/Sort.h"
+#include "Async/MappedFileHandle.h"
+#include "GaiaPTP.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+    // Feature scales: 1 km of elevation ~ 500 My of age ~ half the anisotropy range; types are kept apart
+    constexpr float AgeScaleMy = 500.0f;
+    constexpr float AnisotropyWeight = 2.0f;
+    constexpr float OrogenyTypeWeight = 100.0f;
+
+    struct FFileHeader
+    {
+        uint32 Magic = FPTPExemplarLibrary::FileMagic;
+        uint32 Version = FPTPExemplarLibrary::FileVersion;
+        int32 PatchSize = 0;
+        float MetersPerTexel = 0.0f;
+        int32 NumPatches = 0;
+        int64 DataOffset = 0;
+        int64 IndexOffset = 0;
+
+        friend FArchive& operator<<(FArchive& Ar, FFileHeader& H)
+        {
+            return Ar << H.Magic << H.Version << H.PatchSize << H.MetersPerTexel << H.NumPatches << H.DataOffset << H.IndexOffset;
+        }
+    };
+
+    void PadTo(FArchive& Ar, int64 Offset)
+    {
+        static const uint8 Zeros[FPTPExemplarLibrary::PageAlignment] = {};
+        while (Ar.Tell() < Offset)
+        {
+            Ar.Serialize(const_cast<uint8*>(Zeros), FMath::Min<int64>(Offset - Ar.Tell(), FPTPExemplarLibrary::PageAlignment));
+        }
+    }
+}
+
+void FPTPExemplarDescriptor::ToFeatures(float OutFeatures[NumFeatures]) const
+{
+    OutFeatures[0] = MinElevationKm;
+    OutFeatures[1] = MaxElevationKm;
+    OutFeatures[2] = AgeMy / AgeScaleMy;
+    OutFeatures[3] = static_cast<float>(OrogenyType) * OrogenyTypeWeight;
+    OutFeatures[4] = Anisotropy * AnisotropyWeight;
+}
+
+FArchive& operator<<(FArchive& Ar, FPTPExemplarDescriptor& D)
+{
+    uint8 Type = static_cast<uint8>(D.OrogenyType);
+    Ar << D.MinElevationKm << D.MaxElevationKm << D.MeanElevationKm << D.AgeMy << Type << D.DominantAngle << D.Anisotropy;
+    D.OrogenyType = static_cast<EOrogenyType>(Type);
+    return Ar;
+}
+
+// --- Index ---
+
+void FPTPExemplarIndex::Build(TConstArrayView<FPTPExemplarDescriptor> Descriptors)
+{
+    constexpr int32 Dims = FPTPExemplarDescriptor::NumFeatures;
+    const int32 N = Descriptors.Num();
+
+    TArray<float> Source;
+    Source.SetNumUninitialized(N * Dims);
+    TArray<int32> Order;
+    Order.SetNumUninitialized(N);
+    for (int32 i = 0; i < N; ++i)
+    {
+        Descriptors[i].ToFeatures(&Source[i * Dims]);
+        Order[i] = i;
+    }
+
+    SplitDims.SetNumZeroed(N);
+
+    // Place the median of the widest dimension at the middle of each range, recursively
+    TFunction<void(int32, int32)> BuildRange = [&](int32 Begin, int32 End)
+    {
+        if (End - Begin <= 1)
+        {
+            return;
+        }
+        int32 SplitDim = 0;
+        float WidestSpread = -1.0f;
+        for (int32 d = 0; d < Dims; ++d)
+        {
+            float Lo = MAX_flt, Hi = -MAX_flt;
+            for (int32 i = Begin; i < End; ++i)
+            {
+                Lo = FMath::Min(Lo, Source[Order[i] * Dims + d]);
+                Hi = FMath::Max(Hi, Source[Order[i] * Dims + d]);
+            }
+            if (Hi - Lo > WidestSpread)
+            {
+                WidestSpread = Hi - Lo;
+                SplitDim = d;
+            }
+        }
+
+        Algo::SortBy(MakeArrayView(Order.GetData() + Begin, End - Begin), [&](int32 Idx) { return Source[Idx * Dims + SplitDim]; });
+        const int32 Mid = (Begin + End) / 2;
+        SplitDims[Mid] = static_cast<uint8>(SplitDim);
+        BuildRange(Begin, Mid);
+        BuildRange(Mid + 1, End);
+    };
+    BuildRange(0, N);
+
+    Features.SetNumUninitialized(N * Dims);
+    PatchIds.SetNumUninitialized(N);
+    for (int32 i = 0; i < N; ++i)
+    {
+        FMemory::Memcpy(&Features[i * Dims], &Source[Order[i] * Dims], Dims * sizeof(float));
+        PatchIds[i] = Order[i];
+    }
+}
+
+void FPTPExemplarIndex::Search(int32 Begin, int32 End, const float* Query, int32 K, TArray<TPair<float, int32>>& Heap) const
+{
+    constexpr int32 Dims = FPTPExemplarDescriptor::NumFeatures;
+    if (Begin >= End)
+    {
+        return;
+    }
+
+    const int32 Mid = (Begin + End) / 2;
+    const float* Node = &Features[Mid * Dims];
+    float D2 = 0.0f;
+    for (int32 d = 0; d < Dims; ++d)
+    {
+        D2 += FMath::Square(Query[d] - Node[d]);
+    }
+
+    // Heap is kept sorted ascending; K is small
+    if (Heap.Num() < K || D2 < Heap.Last().Key)
+    {
+        if (Heap.Num() == K)
+        {
+            Heap.Pop(EAllowShrinking::No);
+        }
+        int32 Slot = Heap.Num();
+        while (Slot > 0 && Heap[Slot - 1].Key > D2)
+        {
+            --Slot;
+        }
+        Heap.Insert(TPair<float, int32>(D2, PatchIds[Mid]), Slot);
+    }
+
+    if (End - Begin == 1)
+    {
+        return;
+    }
+
+    const int32 SplitDim = SplitDims[Mid];
+    const float Diff = Query[SplitDim] - Node[SplitDim];
+    const bool bLeftFirst = Diff < 0.0f;
+    Search(bLeftFirst ? Begin : Mid + 1, bLeftFirst ? Mid : End, Query, K, Heap);
+    if (Heap.Num() < K || Diff * Diff < Heap.Last().Key)
+    {
+        Search(bLeftFirst ? Mid + 1 : Begin, bLeftFirst ? End : Mid, Query, K, Heap);
+    }
+}
+
+void FPTPExemplarIndex::FindNearest(const FPTPExemplarDescriptor& Query, int32 K, TArray<int32>& OutPatches) const
+{
+    OutPatches.Reset();
+    if (K <= 0 || PatchIds.Num() == 0)
+    {
+        return;
+    }
+
+    float QueryFeatures[FPTPExemplarDescriptor::NumFeatures];
+    Query.ToFeatures(QueryFeatures);
+
+    TArray<TPair<float, int32>> Nearest;
+    Nearest.Reserve(K + 1);
+    Search(0, PatchIds.Num(), QueryFeatures, K, Nearest);
+
+    for (const TPair<float, int32>& Entry : Nearest)
+    {
+        OutPatches.Add(Entry.Value);
+    }
+}
+
+FArchive& operator<<(FArchive& Ar, FPTPExemplarIndex& Index)
+{
+    return Ar << Index.Features << Index.PatchIds << Index.SplitDims;
+}
+
+// --- Pages ---
+
+FPTPExemplarPage::~FPTPExemplarPage()
+{
+    delete Region;
+}
+
+// --- Library ---
+
+FPTPExemplarLibrary::FPTPExemplarLibrary() = default;
+
+FPTPExemplarLibrary::~FPTPExemplarLibrary()
+{
+    Close();
+}
+
+FPTPExemplarDescriptor FPTPExemplarLibrary::Describe(const float* HeightsM, int32 InPatchSize, EOrogenyType OrogenyType, float AgeMy)
+{
+    FPTPExemplarDescriptor D;
+    D.OrogenyType = OrogenyType;
+    D.AgeMy = AgeMy;
+
+    float Lo = MAX_flt, Hi = -MAX_flt;
+    double Sum = 0.0;
+    for (int32 i = 0; i < InPatchSize * InPatchSize; ++i)
+    {
+        Lo = FMath::Min(Lo, HeightsM[i]);
+        Hi = FMath::Max(Hi, HeightsM[i]);
+        Sum += HeightsM[i];
+    }
+    D.MinElevationKm = Lo * 0.001f;
+    D.MaxElevationKm = Hi * 0.001f;
+    D.MeanElevationKm = static_cast<float>(Sum / (InPatchSize * InPatchSize)) * 0.001f;
+
+    // Structure tensor of the gradient: its major axis is across the ridges
+    double Jxx = 0.0, Jyy = 0.0, Jxy = 0.0;
+    for (int32 Y = 1; Y < InPatchSize - 1; ++Y)
+    {
+        for (int32 X = 1; X < InPatchSize - 1; ++X)
+        {
+            const float Gx = 0.5f * (HeightsM[Y * InPatchSize + X + 1] - HeightsM[Y * InPatchSize + X - 1]);
+            const float Gy = 0.5f * (HeightsM[(Y + 1) * InPatchSize + X] - HeightsM[(Y - 1) * InPatchSize + X]);
+            Jxx += Gx * Gx;
+            Jyy += Gy * Gy;
+            Jxy += Gx * Gy;
+        }
+    }
+    const double Trace = Jxx + Jyy;
+    if (Trace > 0.0)
+    {
+        const double GradientAngle = 0.5 * FMath::Atan2(2.0 * Jxy, Jxx - Jyy);
+        D.DominantAngle = static_cast<float>(GradientAngle + HALF_PI);
+        D.Anisotropy = static_cast<float>(FMath::Sqrt(FMath::Square(Jxx - Jyy) + 4.0 * Jxy * Jxy) / Trace);
+    }
+    return D;
+}
+
+bool FPTPExemplarLibrary::Write(const FString& Path, TConstArrayView<FPTPExemplarSource> Sources, int32 InPatchSize, int32 Stride, float InMetersPerTexel)
+{
+    check(InPatchSize > 2 && Stride > 0);
+
+    TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*Path));
+    if (!Ar)
+    {
+        UE_LOG(LogGaiaPTP, Error, TEXT("Exemplar library: cannot write %s"), *Path);
+        return false;
+    }
+
+    FFileHeader Header;
+    Header.PatchSize = InPatchSize;
+    Header.MetersPerTexel = InMetersPerTexel;
+    Header.DataOffset = PageAlignment;
+    *Ar << Header;
+    PadTo(*Ar, Header.DataOffset);
+
+    const int64 Bytes = Align((int64)InPatchSize * InPatchSize * sizeof(int16), PageAlignment);
+    TArray<FPTPExemplarDescriptor> Descriptors;
+    TArray<float> Patch;
+    Patch.SetNumUninitialized(InPatchSize * InPatchSize);
+    TArray<int16> Quantized;
+    Quantized.SetNumUninitialized(InPatchSize * InPatchSize);
+
+    for (const FPTPExemplarSource& Source : Sources)
+    {
+        check(Source.HeightsM.Num() == Source.Width * Source.Height);
+        for (int32 OY = 0; OY + InPatchSize <= Source.Height; OY += Stride)
+        {
+            for (int32 OX = 0; OX + InPatchSize <= Source.Width; OX += Stride)
+            {
+                for (int32 Y = 0; Y < InPatchSize; ++Y)
+                {
+                    FMemory::Memcpy(&Patch[Y * InPatchSize], &Source.HeightsM[(OY + Y) * Source.Width + OX], InPatchSize * sizeof(float));
+                }
+                for (int32 i = 0; i < Patch.Num(); ++i)
+                {
+                    Quantized[i] = static_cast<int16>(FMath::Clamp(FMath::RoundToInt(Patch[i]), -32768, 32767));
+                }
+
+                Descriptors.Add(Describe(Patch.GetData(), InPatchSize, Source.OrogenyType, Source.AgeMy));
+                const int64 PageStart = Header.DataOffset + (int64)(Descriptors.Num() - 1) * Bytes;
+                Ar->Serialize(Quantized.GetData(), Quantized.Num() * sizeof(int16));
+                PadTo(*Ar, PageStart + Bytes);
+            }
+        }
+    }
+
+    FPTPExemplarIndex Index;
+    Index.Build(Descriptors);
+
+    Header.NumPatches = Descriptors.Num();
+    Header.IndexOffset = Ar->Tell();
+    *Ar << Descriptors;
+    *Ar << Index;
+
+    Ar->Seek(0);
+    *Ar << Header;
+    const bool bOk = Ar->Close() && !Ar->IsError();
+
+    UE_LOG(LogGaiaPTP, Log, TEXT("Exemplar library: wrote %d patches (%dx%d) to %s"), Header.NumPatches, InPatchSize, InPatchSize, *Path);
+    return bOk;
+}
+
+bool FPTPExemplarLibrary::Open(const FString& Path, int32 MaxCachedPages)
+{
+    Close();
+
+    TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*Path));
+    if (!Ar)
+    {
+        UE_LOG(LogGaiaPTP, Warning, TEXT("Exemplar library: cannot open %s"), *Path);
+        return false;
+    }
+
+    FFileHeader Header;
+    *Ar << Header;
+    if (Header.Magic != FileMagic || Header.Version != FileVersion)
+    {
+        UE_LOG(LogGaiaPTP, Warning, TEXT("Exemplar library: %s is not a version %u library"), *Path, FileVersion);
+        return false;
+    }
+
+    Ar->Seek(Header.IndexOffset);
+    *Ar << Descriptors;
+    *Ar << Index;
+    if (Ar->IsError() || Descriptors.Num() != Header.NumPatches || Index.Num() != Header.NumPatches)
+    {
+        UE_LOG(LogGaiaPTP, Warning, TEXT("Exemplar library: %s has a corrupt index"), *Path);
+        Descriptors.Reset();
+        return false;
+    }
+
+    FilePath = Path;
+    PatchSize = Header.PatchSize;
+    MetersPerTexel = Header.MetersPerTexel;
+    DataOffset = Header.DataOffset;
+    NumPatches = Header.NumPatches;
+    PageCache.Empty(FMath::Max(1, MaxCachedPages));
+
+    FOpenMappedResult Mapped = FPlatformFileManager::Get().GetPlatformFile().OpenMappedEx(*Path);
+    if (Mapped.HasValue())
+    {
+        MappedFile = Mapped.StealValue();
+    }
+    else
+    {
+        UE_LOG(LogGaiaPTP, Log, TEXT("Exemplar library: memory mapping unavailable, pages will be read on demand"));
+    }
+
+    UE_LOG(LogGaiaPTP, Log, TEXT("Exemplar library: opened %s (%d patches, %d cached pages)"), *Path, NumPatches, PageCache.Max());
+    return true;
+}
+
+void FPTPExemplarLibrary::Close()
+{
+    {
+        FScopeLock Lock(&CacheLock);
+        PageCache.Empty();
+    }
+    MappedFile.Reset();
+    Descriptors.Reset();
+    Index = FPTPExemplarIndex();
+    NumPatches = 0;
+    NumPageMisses = 0;
+    NumPageHits = 0;
+}
+
+TSharedPtr<const FPTPExemplarPage, ESPMode::ThreadSafe> FPTPExemplarLibrary::GetPage(int32 PatchIndex)
+{
+    check(PatchIndex >= 0 && PatchIndex < NumPatches);
+    {
+        FScopeLock Lock(&CacheLock);
+        if (const TSharedPtr<const FPTPExemplarPage, ESPMode::ThreadSafe>* Cached = PageCache.FindAndTouch(PatchIndex))
+        {
+            ++NumPageHits;
+            return *Cached;
+        }
+    }
+
+    // Map (or read) outside the lock so concurrent tiles can fault in different pages
+    TSharedPtr<FPTPExemplarPage, ESPMode::ThreadSafe> Page = MakeShared<FPTPExemplarPage, ESPMode::ThreadSafe>();
+    const int64 Offset = DataOffset + (int64)PatchIndex * PageBytes();
+    const int64 Size = (int64)PatchSize * PatchSize * sizeof(int16);
+    if (MappedFile)
+    {
+        Page->Region = MappedFile->MapRegion(Offset, Size);
+    }
+    if (Page->Region)
+    {
+        Page->Heights = reinterpret_cast<const int16*>(Page->Region->GetMappedPtr());
+    }
+    else
+    {
+        TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*FilePath));
+        Page->Loaded.SetNumUninitialized(PatchSize * PatchSize);
+        if (Ar)
+        {
+            Ar->Seek(Offset);
+            Ar->Serialize(Page->Loaded.GetData(), Size);
+        }
+        if (!Ar || Ar->IsError())
+        {
+            // Not cached, so a transient failure is retried by the next tile that needs the patch
+            UE_LOG(LogGaiaPTP, Warning, TEXT("Exemplar library: failed to read patch %d from %s"), PatchIndex, *FilePath);
+            return nullptr;
+        }
+        Page->Heights = Page->Loaded.GetData();
+    }
+
+    FScopeLock Lock(&CacheLock);
+    ++NumPageMisses;
+    if (const TSharedPtr<const FPTPExemplarPage, ESPMode::ThreadSafe>* Cached = PageCache.FindAndTouch(PatchIndex))
+    {
+        return *Cached; // another thread won the race
+    }
+    PageCache.Add(PatchIndex, Page);
+    return Page;
+}
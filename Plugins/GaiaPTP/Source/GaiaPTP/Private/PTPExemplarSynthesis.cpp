@@ -0,0 +1,240 @@
+#include "PTPExemplarSynthesis.h"
+#include "Async/ParallelFor.h"
+#include "GaiaPTP.h"
+#include "PTPExemplarLibrary.h"
+#include "PTPProfiling.h"
+#include "PTPRandom.h"
+
+namespace
+{
+    /** Crust samples per splat: centre plus four points at RingFraction of the window radius. */
+    constexpr int32 SamplesPerSplat = 5;
+    constexpr float RingFraction = 0.8f;
+
+    /** A placed, rotated exemplar patch. */
+    struct FSplat
+    {
+        FVector3f Center = FVector3f::ZeroVector;
+        FVector3f East = FVector3f::ZeroVector;
+        FVector3f North = FVector3f::ZeroVector;
+        float Cos = 1.0f;
+        float Sin = 0.0f;
+        float MeanKm = 0.0f;
+        TSharedPtr<const FPTPExemplarPage, ESPMode::ThreadSafe> Page;
+    };
+
+    /** Local east/north frame at a unit direction (falls back to +X near the poles). */
+    void TangentFrame(const FVector3f& N, FVector3f& OutEast, FVector3f& OutNorth)
+    {
+        OutEast = FVector3f::CrossProduct(FVector3f::UnitZ(), N);
+        if (!OutEast.Normalize())
+        {
+            OutEast = FVector3f::UnitX();
+        }
+        OutNorth = FVector3f::CrossProduct(N, OutEast);
+    }
+
+    float SampleBilinear(const int16* Heights, int32 PatchSize, float U, float V)
+    {
+        const float X = FMath::Clamp(U, 0.0f, PatchSize - 1.001f);
+        const float Y = FMath::Clamp(V, 0.0f, PatchSize - 1.001f);
+        const int32 X0 = (int32)X;
+        const int32 Y0 = (int32)Y;
+        const float FX = X - X0;
+        const float FY = Y - Y0;
+        const int16* Row0 = Heights + Y0 * PatchSize + X0;
+        const int16* Row1 = Row0 + PatchSize;
+        const float Top = FMath::Lerp((float)Row0[0], (float)Row0[1], FX);
+        const float Bottom = FMath::Lerp((float)Row1[0], (float)Row1[1], FX);
+        return FMath::Lerp(Top, Bottom, FY);
+    }
+}
+
+FPTPExemplarSynthesizer::FPTPExemplarSynthesizer(const FPTPExemplarSynthesisParams& InParams, FPTPExemplarLibrary& InLibrary, FPTPCrustSampler InSampler)
+    : Params(InParams)
+    , Library(&InLibrary)
+    , Sampler(MoveTemp(InSampler))
+{
+    check(Sampler && Library->IsOpen());
+    TexelKm = Library->GetMetersPerTexel() * 0.001f;
+
+    // Keep the rotated window inside the patch, leaving a texel for bilinear filtering
+    WindowRadiusKm = 0.5f * (Library->GetPatchSize() - 2) * TexelKm;
+
+    // Cells one radius across: every texel is within ~0.7 radius of its home splat
+    SplatResolution = FMath::Min(FPTPCubeMap::ResolutionForCellSize(Params.PlanetRadiusKm, WindowRadiusKm), FPTPCubeMap::MaxCellIdResolution);
+}
+
+void FPTPExemplarSynthesizer::SynthesizeTile(const FPTPAmplifyTile& Tile, TArray<float>& OutElevationKm) const
+{
+    const int32 Res = Tile.Resolution;
+    const int32 NumTexels = Res * Res;
+    const float Radius = Params.PlanetRadiusKm;
+    const int32 PatchSize = Library->GetPatchSize();
+
+    // 1) Texels, their home cells, and every splat cell that can reach them
+    TArray<FVector3f> Directions;
+    Directions.SetNumUninitialized(NumTexels);
+    TArray<int32> HomeOfTexel;
+    HomeOfTexel.SetNumUninitialized(NumTexels);
+    TSet<int32> SplatSet;
+    int32 LastHome = INDEX_NONE;
+    for (int32 Y = 0; Y < Res; ++Y)
+    {
+        for (int32 X = 0; X < Res; ++X)
+        {
+            const int32 i = Y * Res + X;
+            Directions[i] = Tile.TexelDirection(X, Y);
+            HomeOfTexel[i] = FPTPCubeMap::CellId(Directions[i], SplatResolution);
+            if (HomeOfTexel[i] != LastHome)
+            {
+                int32 Cells[9];
+                const int32 NumCells = FPTPCubeMap::NeighborhoodCells(HomeOfTexel[i], SplatResolution, Cells);
+                SplatSet.Append(MakeArrayView(Cells, NumCells));
+                LastHome = HomeOfTexel[i];
+            }
+        }
+    }
+    TArray<int32> SplatCells = SplatSet.Array();
+    const int32 NumSplats = SplatCells.Num();
+
+    // 2) One batched crust lookup for all splat footprints and all texels
+    TArray<FVector3f> Queries;
+    Queries.SetNumUninitialized(NumSplats * SamplesPerSplat + NumTexels);
+    TArray<FSplat> Splats;
+    Splats.SetNum(NumSplats);
+    TMap<int32, int32> CellToSplat;
+    CellToSplat.Reserve(NumSplats);
+    for (int32 s = 0; s < NumSplats; ++s)
+    {
+        int32 Face, X, Y;
+        FPTPCubeMap::CellCoords(SplatCells[s], SplatResolution, Face, X, Y);
+        FSplat& Splat = Splats[s];
+        Splat.Center = FPTPCubeMap::CellCenter(Face, X, Y, SplatResolution);
+        TangentFrame(Splat.Center, Splat.East, Splat.North);
+        CellToSplat.Add(SplatCells[s], s);
+
+        const float Ring = RingFraction * WindowRadiusKm / Radius;
+        FVector3f* Q = &Queries[s * SamplesPerSplat];
+        Q[0] = Splat.Center;
+        Q[1] = (Splat.Center + Splat.East * Ring).GetSafeNormal();
+        Q[2] = (Splat.Center - Splat.East * Ring).GetSafeNormal();
+        Q[3] = (Splat.Center + Splat.North * Ring).GetSafeNormal();
+        Q[4] = (Splat.Center - Splat.North * Ring).GetSafeNormal();
+    }
+    FMemory::Memcpy(&Queries[NumSplats * SamplesPerSplat], Directions.GetData(), NumTexels * sizeof(FVector3f));
+
+    TArray<FPTPCrustSample> Crust;
+    Crust.SetNumUninitialized(Queries.Num());
+    Sampler(Queries, Crust);
+
+    // 3) Match and orient a patch per continental splat (KD-tree k-NN, logarithmic in library size)
+    const uint32 Seed = static_cast<uint32>(Params.Seed);
+    TArray<int32> Candidates;
+    for (int32 s = 0; s < NumSplats; ++s)
+    {
+        const FPTPCrustSample* Footprint = &Crust[s * SamplesPerSplat];
+        const FPTPCrustSample& Centre = Footprint[0];
+        if (Centre.OceanicWeight >= 1.0f)
+        {
+            continue;
+        }
+
+        FPTPExemplarDescriptor Query;
+        Query.MinElevationKm = MAX_flt;
+        Query.MaxElevationKm = -MAX_flt;
+        for (int32 k = 0; k < SamplesPerSplat; ++k)
+        {
+            Query.MinElevationKm = FMath::Min(Query.MinElevationKm, Footprint[k].Elevation);
+            Query.MaxElevationKm = FMath::Max(Query.MaxElevationKm, Footprint[k].Elevation);
+        }
+        Query.MeanElevationKm = Centre.Elevation;
+        Query.AgeMy = Centre.OrogenyAge;
+        Query.OrogenyType = Centre.OrogenyType;
+        Query.Anisotropy = Centre.FoldDirection.IsNearlyZero() ? 0.0f : 1.0f;
+
+        Library->GetIndex().FindNearest(Query, FMath::Max(1, Params.NumCandidates), Candidates);
+        if (Candidates.Num() == 0)
+        {
+            continue;
+        }
+        const uint32 Pick = FPTPHash::Hash(Seed, SplatCells[s], 0);
+        const int32 Patch = Candidates[Pick % Candidates.Num()];
+        const FPTPExemplarDescriptor& Descriptor = Library->GetDescriptor(Patch);
+
+        // Rotate world (east, north) by Phi so the fold direction lands on the patch's dominant orientation
+        FSplat& Splat = Splats[s];
+        const float FoldAngle = Query.Anisotropy > 0.0f
+            ? FMath::Atan2(FVector3f::DotProduct(Centre.FoldDirection, Splat.North), FVector3f::DotProduct(Centre.FoldDirection, Splat.East))
+            : 2.0f * PI * FPTPHash::UnitFloat(FPTPHash::Hash(Seed, SplatCells[s], 1));
+        const float Phi = Descriptor.DominantAngle - FoldAngle;
+        FMath::SinCos(&Splat.Sin, &Splat.Cos, Phi);
+        Splat.MeanKm = Descriptor.MeanElevationKm;
+        Splat.Page = Library->GetPage(Patch);
+    }
+
+    // 4) Blend the 3x3 neighbourhood of splats at each texel
+    const float InvR2 = 1.0f / (WindowRadiusKm * WindowRadiusKm);
+    const float InvTexelKm = 1.0f / TexelKm;
+    const float HalfPatch = 0.5f * (PatchSize - 1);
+    const FPTPCrustSample* Base = &Crust[NumSplats * SamplesPerSplat];
+
+    OutElevationKm.SetNumUninitialized(NumTexels);
+    for (int32 i = 0; i < NumTexels; ++i)
+    {
+        const FPTPCrustSample& Coarse = Base[i];
+        float Elevation = Coarse.Elevation;
+        const float Continental = 1.0f - Coarse.OceanicWeight;
+        if (Continental > 0.0f)
+        {
+            int32 Cells[9];
+            const int32 NumCells = FPTPCubeMap::NeighborhoodCells(HomeOfTexel[i], SplatResolution, Cells);
+            float WeightSum = 0.0f;
+            float DetailSum = 0.0f;
+            for (int32 c = 0; c < NumCells; ++c)
+            {
+                const FSplat& Splat = Splats[CellToSplat.FindChecked(Cells[c])];
+                if (!Splat.Page)
+                {
+                    continue;
+                }
+                const FVector3f D = (Directions[i] - Splat.Center) * Radius;
+                const float X = FVector3f::DotProduct(D, Splat.East);
+                const float Y = FVector3f::DotProduct(D, Splat.North);
+                const float R2 = (X * X + Y * Y) * InvR2;
+                if (R2 >= 1.0f)
+                {
+                    continue;
+                }
+                const float W = FMath::Square(1.0f - R2);
+                const float PX = (X * Splat.Cos - Y * Splat.Sin) * InvTexelKm + HalfPatch;
+                const float PY = (X * Splat.Sin + Y * Splat.Cos) * InvTexelKm + HalfPatch;
+                const float HeightKm = SampleBilinear(Splat.Page->Heights, PatchSize, PX, PY) * 0.001f;
+                DetailSum += W * (HeightKm - Splat.MeanKm);
+                WeightSum += W;
+            }
+            if (WeightSum > 0.0f)
+            {
+                Elevation += (DetailSum / WeightSum) * Params.DetailScale * Continental;
+            }
+        }
+        OutElevationKm[i] = Elevation;
+    }
+}
+
+void FPTPExemplarSynthesizer::SynthesizeTiles(TConstArrayView<FPTPAmplifyTile> Tiles, TArray<TArray<float>>& OutElevationKm) const
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, ExemplarSynthesis);
+
+    const bool bDoParallel = PTPProfiling::IsParallelEnabled();
+
+    OutElevationKm.SetNum(Tiles.Num());
+    const double StartTime = FPlatformTime::Seconds();
+    ParallelFor(Tiles.Num(), [&](int32 TileIdx)
+    {
+        SynthesizeTile(Tiles[TileIdx], OutElevationKm[TileIdx]);
+    }, !bDoParallel);
+    const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    UE_LOG(LogGaiaPTP, Log, TEXT("Exemplar synthesis: %d tiles in %.2fms (page hits %d, misses %d)"),
+        Tiles.Num(), ElapsedMs, Library->GetNumPageHits(), Library->GetNumPageMisses());
+}
@@ -0,0 +1,288 @@
+#include "PTPGaborAmplifier.h"
+#include "Async/ParallelFor.h"
+#include "GaiaPTP.h"
+#include "PTPCubeMap.h"
+#include "PTPProfiling.h"
+#include "PTPRandom.h"
+#include "PTPSimd.h"
+
+namespace
+{
+    /** Queries per ParallelFor task; each query sums ~72 kernels, so small chunks balance well. */
+    constexpr int32 QueryChunkSize = 1024;
+}
+
+FPTPGaborAmplifier::FPTPGaborAmplifier(const FPTPGaborParams& InParams, FPTPCrustSampler InSampler)
+    : Params(InParams)
+    , Sampler(MoveTemp(InSampler))
+{
+    check(Sampler);
+    CellResolution = FPTPCubeMap::ResolutionForCellSize(Params.PlanetRadiusKm, Params.CellSizeKm);
+
+    const float A = Params.EnvelopeSharpness / Params.CellSizeKm;
+    EnvelopeA2Pi = PI * A * A;
+
+    // With impulse density N/C^2 the sum has variance Amp^2 * N / (4 Sharpness^2); rescale so Amp is the std-dev
+    Normalization = 2.0f * Params.EnvelopeSharpness / FMath::Sqrt((float)FMath::Max(1, Params.ImpulsesPerCell));
+}
+
+void FPTPGaborAmplifier::BuildTable(TConstArrayView<int32> Cells, FImpulseTable& OutTable) const
+{
+    const int32 PerCell = FMath::Max(1, Params.ImpulsesPerCell);
+    const int32 NumImpulses = Cells.Num() * PerCell;
+    const float Step = 2.0f / CellResolution;
+    const uint32 Seed = static_cast<uint32>(Params.Seed);
+
+    TArray<FVector3f> Directions;
+    TArray<float> Phases;
+    Directions.SetNumUninitialized(NumImpulses);
+    Phases.SetNumUninitialized(NumImpulses);
+    OutTable.CellToFirst.Reserve(Cells.Num());
+
+    for (int32 c = 0; c < Cells.Num(); ++c)
+    {
+        int32 Face, X, Y;
+        FPTPCubeMap::CellCoords(Cells[c], CellResolution, Face, X, Y);
+        OutTable.CellToFirst.Add(Cells[c], c * PerCell);
+
+        for (int32 k = 0; k < PerCell; ++k)
+        {
+            // Counter-based: impulse k of a cell is the same no matter which batch or tile asks for it
+            const uint32 Key = static_cast<uint32>(k * 3);
+            const float U = FPTPHash::UnitFloat(FPTPHash::Hash(Seed, Cells[c], Key));
+            const float V = FPTPHash::UnitFloat(FPTPHash::Hash(Seed, Cells[c], Key + 1));
+            const int32 Idx = c * PerCell + k;
+            Directions[Idx] = FPTPCubeMap::FaceToDirection(Face, -1.0f + (X + U) * Step, -1.0f + (Y + V) * Step);
+            Phases[Idx] = 2.0f * PI * FPTPHash::UnitFloat(FPTPHash::Hash(Seed, Cells[c], Key + 2));
+        }
+    }
+
+    TArray<FPTPCrustSample> Crust;
+    Crust.SetNumUninitialized(NumImpulses);
+    Sampler(Directions, Crust);
+
+    OutTable.PX.SetNumUninitialized(NumImpulses);
+    OutTable.PY.SetNumUninitialized(NumImpulses);
+    OutTable.PZ.SetNumUninitialized(NumImpulses);
+    OutTable.WX.SetNumUninitialized(NumImpulses);
+    OutTable.WY.SetNumUninitialized(NumImpulses);
+    OutTable.WZ.SetNumUninitialized(NumImpulses);
+    OutTable.Phase = MoveTemp(Phases);
+    OutTable.Amplitude.SetNumUninitialized(NumImpulses);
+
+    for (int32 i = 0; i < NumImpulses; ++i)
+    {
+        const FVector3f& N = Directions[i];
+        const FPTPCrustSample& S = Crust[i];
+
+        // Oscillate across the ridge so crests run parallel to it
+        const FVector3f Across = FVector3f::CrossProduct(N, S.RidgeDirection).GetSafeNormal();
+        const float Age = FMath::Clamp(S.OceanicAge / Params.AgeScaleMy, 0.0f, 1.0f);
+        const float Wavelength = FMath::Lerp(Params.YoungWavelengthKm, Params.OldWavelengthKm, Age);
+        const float Amplitude = FMath::Lerp(Params.YoungAmplitudeKm, Params.OldAmplitudeKm, Age) * S.OceanicWeight;
+        const FVector3f Wave = Across * (2.0f * PI / Wavelength);
+
+        const FVector3f P = N * Params.PlanetRadiusKm;
+        OutTable.PX[i] = P.X; OutTable.PY[i] = P.Y; OutTable.PZ[i] = P.Z;
+        OutTable.WX[i] = Wave.X; OutTable.WY[i] = Wave.Y; OutTable.WZ[i] = Wave.Z;
+        OutTable.Amplitude[i] = Across.IsZero() ? 0.0f : Amplitude;
+    }
+}
+
+void FPTPGaborAmplifier::BuildBlocks(const FImpulseTable& Table, TConstArrayView<int32> HomeCells, TMap<int32, int32>& OutCellToBlock,
+                                     TArray<FBlock>& OutBlocks, FImpulseTable& OutPacked) const
+{
+    const int32 PerCell = FMath::Max(1, Params.ImpulsesPerCell);
+    OutBlocks.SetNum(HomeCells.Num());
+    OutCellToBlock.Reserve(HomeCells.Num());
+
+    int32 Total = 0;
+    for (int32 b = 0; b < HomeCells.Num(); ++b)
+    {
+        int32 Cells[9];
+        const int32 NumCells = FPTPCubeMap::NeighborhoodCells(HomeCells[b], CellResolution, Cells);
+        const int32 Num = Align(NumCells * PerCell, PTPSimd::Lanes);
+        OutBlocks[b] = { Total, Num };
+        OutCellToBlock.Add(HomeCells[b], b);
+        Total += Num;
+    }
+
+    for (TArray<float>* Stream : { &OutPacked.PX, &OutPacked.PY, &OutPacked.PZ, &OutPacked.WX, &OutPacked.WY, &OutPacked.WZ, &OutPacked.Phase, &OutPacked.Amplitude })
+    {
+        Stream->SetNumZeroed(Total);
+    }
+
+    ParallelFor(HomeCells.Num(), [&](int32 b)
+    {
+        int32 Cells[9];
+        const int32 NumCells = FPTPCubeMap::NeighborhoodCells(HomeCells[b], CellResolution, Cells);
+        int32 Dst = OutBlocks[b].First;
+        for (int32 c = 0; c < NumCells; ++c)
+        {
+            const int32 Src = Table.CellToFirst.FindChecked(Cells[c]);
+            for (int32 k = 0; k < PerCell; ++k, ++Dst)
+            {
+                OutPacked.PX[Dst] = Table.PX[Src + k];
+                OutPacked.PY[Dst] = Table.PY[Src + k];
+                OutPacked.PZ[Dst] = Table.PZ[Src + k];
+                OutPacked.WX[Dst] = Table.WX[Src + k];
+                OutPacked.WY[Dst] = Table.WY[Src + k];
+                OutPacked.WZ[Dst] = Table.WZ[Src + k];
+                OutPacked.Phase[Dst] = Table.Phase[Src + k];
+                OutPacked.Amplitude[Dst] = Table.Amplitude[Src + k];
+            }
+        }
+        // Padding lanes keep zero amplitude at the origin, so they contribute exactly zero
+    }, HomeCells.Num() < 64 || !PTPProfiling::IsParallelEnabled());
+}
+
+float FPTPGaborAmplifier::EvaluateBlock(const FImpulseTable& Packed, const FBlock& Block, const FVector3f& PositionKm) const
+{
+    const VectorRegister4Float QX = VectorSetFloat1(PositionKm.X);
+    const VectorRegister4Float QY = VectorSetFloat1(PositionKm.Y);
+    const VectorRegister4Float QZ = VectorSetFloat1(PositionKm.Z);
+    const VectorRegister4Float NegA2Pi = VectorSetFloat1(-EnvelopeA2Pi);
+
+    VectorRegister4Float Sum = VectorZeroFloat();
+    for (int32 j = Block.First; j < Block.First + Block.Num; j += PTPSimd::Lanes)
+    {
+        const VectorRegister4Float DX = VectorSubtract(QX, VectorLoad(Packed.PX.GetData() + j));
+        const VectorRegister4Float DY = VectorSubtract(QY, VectorLoad(Packed.PY.GetData() + j));
+        const VectorRegister4Float DZ = VectorSubtract(QZ, VectorLoad(Packed.PZ.GetData() + j));
+        const VectorRegister4Float R2 = VectorAdd(VectorAdd(VectorMultiply(DX, DX), VectorMultiply(DY, DY)), VectorMultiply(DZ, DZ));
+
+        // g(d) = A * exp(-PI a^2 |d|^2) * cos(w.d + phase)
+        const VectorRegister4Float Envelope = VectorExp(VectorMultiply(NegA2Pi, R2));
+        const VectorRegister4Float Arg = VectorAdd(VectorAdd(VectorAdd(
+            VectorMultiply(DX, VectorLoad(Packed.WX.GetData() + j)),
+            VectorMultiply(DY, VectorLoad(Packed.WY.GetData() + j))),
+            VectorMultiply(DZ, VectorLoad(Packed.WZ.GetData() + j))),
+            VectorLoad(Packed.Phase.GetData() + j));
+        const VectorRegister4Float Kernel = VectorMultiply(VectorMultiply(VectorLoad(Packed.Amplitude.GetData() + j), Envelope), VectorCos(Arg));
+        Sum = VectorAdd(Sum, Kernel);
+    }
+
+    alignas(16) float Lanes[4];
+    VectorStoreAligned(Sum, Lanes);
+    return ((Lanes[0] + Lanes[1]) + (Lanes[2] + Lanes[3])) * Normalization;
+}
+
+void FPTPGaborAmplifier::Evaluate(TConstArrayView<FVector3f> Directions, TArrayView<float> OutDetailKm, bool bParallel) const
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, GaborEvaluate);
+
+    const int32 Num = Directions.Num();
+    check(OutDetailKm.Num() == Num);
+    if (Num == 0)
+    {
+        return;
+    }
+
+    // 1) Home cell per query, and the cells whose impulses can reach them
+    TArray<int32> HomeOfQuery;
+    HomeOfQuery.SetNumUninitialized(Num);
+    TSet<int32> HomeSet;
+    for (int32 i = 0; i < Num; ++i)
+    {
+        HomeOfQuery[i] = FPTPCubeMap::CellId(Directions[i], CellResolution);
+        HomeSet.Add(HomeOfQuery[i]);
+    }
+    TArray<int32> HomeCells = HomeSet.Array();
+
+    TSet<int32> CellSet;
+    for (const int32 Home : HomeCells)
+    {
+        int32 Cells[9];
+        const int32 NumCells = FPTPCubeMap::NeighborhoodCells(Home, CellResolution, Cells);
+        CellSet.Append(MakeArrayView(Cells, NumCells));
+    }
+    TArray<int32> TableCells = CellSet.Array();
+
+    // 2) Impulse table (one batched crust lookup), then per-home-cell SoA blocks
+    FImpulseTable Table;
+    BuildTable(TableCells, Table);
+
+    TMap<int32, int32> CellToBlock;
+    TArray<FBlock> Blocks;
+    FImpulseTable Packed;
+    BuildBlocks(Table, HomeCells, CellToBlock, Blocks, Packed);
+
+    // 3) Sum kernels per query
+    ParallelFor(PTPSimd::NumChunks(Num, QueryChunkSize), [&](int32 ChunkIdx)
+    {
+        const int32 Begin = ChunkIdx * QueryChunkSize;
+        const int32 End = FMath::Min(Begin + QueryChunkSize, Num);
+        for (int32 i = Begin; i < End; ++i)
+        {
+            const FBlock& Block = Blocks[CellToBlock.FindChecked(HomeOfQuery[i])];
+            OutDetailKm[i] = EvaluateBlock(Packed, Block, Directions[i] * Params.PlanetRadiusKm);
+        }
+    }, !bParallel || !PTPProfiling::IsParallelEnabled());
+
+    UE_LOG(LogGaiaPTP, Verbose, TEXT("Gabor: %d queries, %d home cells, %d impulses"), Num, HomeCells.Num(), Table.Amplitude.Num());
+}
+
+void FPTPGaborAmplifier::EvaluateScalar(TConstArrayView<FVector3f> Directions, TArrayView<float> OutDetailKm) const
+{
+    const int32 Num = Directions.Num();
+    check(OutDetailKm.Num() == Num);
+    const int32 PerCell = FMath::Max(1, Params.ImpulsesPerCell);
+
+    for (int32 i = 0; i < Num; ++i)
+    {
+        int32 Cells[9];
+        const int32 NumCells = FPTPCubeMap::NeighborhoodCells(FPTPCubeMap::CellId(Directions[i], CellResolution), CellResolution, Cells);
+
+        FImpulseTable Table;
+        BuildTable(MakeArrayView(Cells, NumCells), Table);
+
+        const FVector3f Q = Directions[i] * Params.PlanetRadiusKm;
+        float Sum = 0.0f;
+        for (int32 k = 0; k < NumCells * PerCell; ++k)
+        {
+            const FVector3f D(Q.X - Table.PX[k], Q.Y - Table.PY[k], Q.Z - Table.PZ[k]);
+            const float Arg = D.X * Table.WX[k] + D.Y * Table.WY[k] + D.Z * Table.WZ[k] + Table.Phase[k];
+            Sum += Table.Amplitude[k] * FMath::Exp(-EnvelopeA2Pi * D.SizeSquared()) * FMath::Cos(Arg);
+        }
+        OutDetailKm[i] = Sum * Normalization;
+    }
+}
+
+void FPTPGaborAmplifier::AmplifyTile(const FPTPAmplifyTile& Tile, TArray<float>& OutElevationKm) const
+{
+    const int32 Res = Tile.Resolution;
+    TArray<FVector3f> Directions;
+    Directions.SetNumUninitialized(Res * Res);
+    for (int32 Y = 0; Y < Res; ++Y)
+    {
+        for (int32 X = 0; X < Res; ++X)
+        {
+            Directions[Y * Res + X] = Tile.TexelDirection(X, Y);
+        }
+    }
+
+    TArray<FPTPCrustSample> Base;
+    Base.SetNumUninitialized(Directions.Num());
+    Sampler(Directions, Base);
+
+    OutElevationKm.SetNumUninitialized(Directions.Num());
+    Evaluate(Directions, OutElevationKm, false);
+    for (int32 i = 0; i < Directions.Num(); ++i)
+    {
+        OutElevationKm[i] += Base[i].Elevation;
+    }
+}
+
+void FPTPGaborAmplifier::AmplifyTiles(TConstArrayView<FPTPAmplifyTile> Tiles, TArray<TArray<float>>& OutElevationKm) const
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, GaborAmplifyTiles);
+
+    OutElevationKm.SetNum(Tiles.Num());
+    const double StartTime = FPlatformTime::Seconds();
+    ParallelFor(Tiles.Num(), [&](int32 TileIdx)
+    {
+        AmplifyTile(Tiles[TileIdx], OutElevationKm[TileIdx]);
+    }, !PTPProfiling::IsParallelEnabled());
+    const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    UE_LOG(LogGaiaPTP, Log, TEXT("Gabor amplification: %d tiles in %.2fms"), Tiles.Num(), ElapsedMs);
+}
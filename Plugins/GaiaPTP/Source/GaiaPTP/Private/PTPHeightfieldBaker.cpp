@@ -0,0 +1,474 @@
+#include "PTPHeightfieldBaker.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Dom/JsonObject.h"
+#include "GaiaPTP.h"
+#include "HAL/FileManager.h"
+#include "ImageCore.h"
+#include "ImageUtils.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "PTPCraterField.h"
+#include "PTPExemplarSynthesis.h"
+#include "PTPGaborAmplifier.h"
+#include "PTPPlanetComponent.h"
+#include "PTPProfiling.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/UObjectIterator.h"
+#include <atomic>
+
+namespace
+{
+    FString TileFileName(const FPTPBakeSettings& Settings, int32 Face, int32 TileX, int32 TileY)
+    {
+        return FString::Printf(TEXT("%s_F%d_X%02d_Y%02d.%s"), *Settings.BaseName, Face, TileX, TileY,
+            FPTPHeightfieldBaker::GetExtension(Settings.Format));
+    }
+}
+
+FPTPHeightSource FPTPHeightSources::MakeCoarse(FPTPCrustSampler Sampler)
+{
+    return [Sampler = MoveTemp(Sampler)](const FPTPAmplifyTile& Tile, TArray<float>& OutElevationKm)
+    {
+        const int32 Res = Tile.Resolution;
+        TArray<FVector3f> Directions;
+        Directions.SetNumUninitialized(Res * Res);
+        for (int32 Y = 0; Y < Res; ++Y)
+        {
+            for (int32 X = 0; X < Res; ++X)
+            {
+                Directions[Y * Res + X] = Tile.TexelDirection(X, Y);
+            }
+        }
+
+        TArray<FPTPCrustSample> Crust;
+        Crust.SetNumUninitialized(Directions.Num());
+        Sampler(Directions, Crust);
+
+        OutElevationKm.SetNumUninitialized(Directions.Num());
+        for (int32 i = 0; i < Directions.Num(); ++i)
+        {
+            OutElevationKm[i] = Crust[i].Elevation;
+        }
+    };
+}
+
+FPTPHeightSource FPTPHeightSources::MakeGabor(TSharedRef<const FPTPGaborAmplifier> Amplifier)
+{
+    return [Amplifier](const FPTPAmplifyTile& Tile, TArray<float>& OutElevationKm)
+    {
+        Amplifier->AmplifyTile(Tile, OutElevationKm);
+    };
+}
+
+FPTPHeightSource FPTPHeightSources::MakeExemplar(TSharedRef<const FPTPExemplarSynthesizer> Synthesizer)
+{
+    return [Synthesizer](const FPTPAmplifyTile& Tile, TArray<float>& OutElevationKm)
+    {
+        Synthesizer->SynthesizeTile(Tile, OutElevationKm);
+    };
+}
+
+FPTPHeightSource FPTPHeightSources::MakeCratered(FPTPHeightSource Base, TSharedRef<const FPTPCraterField> Field)
+{
+    return [Base = MoveTemp(Base), Field](const FPTPAmplifyTile& Tile, TArray<float>& OutElevationKm)
+    {
+        // A wrong-sized base tile is logged and passed through; Bake fails it on the size check
+        Base(Tile, OutElevationKm);
+        Field->AmplifyTile(Tile, OutElevationKm);
+    };
+}
+
+FPTPPointHeightSource FPTPHeightSources::MakeCoarsePoints(FPTPCrustSampler Sampler)
+{
+    return [Sampler = MoveTemp(Sampler)](TConstArrayView<FVector3f> Directions, TArrayView<float> OutElevationKm)
+    {
+        TArray<FPTPCrustSample> Crust;
+        Crust.SetNumUninitialized(Directions.Num());
+        Sampler(Directions, Crust);
+        for (int32 i = 0; i < Directions.Num(); ++i)
+        {
+            OutElevationKm[i] = Crust[i].Elevation;
+        }
+    };
+}
+
+FPTPPointHeightSource FPTPHeightSources::MakeGaborPoints(FPTPCrustSampler Sampler, TSharedRef<const FPTPGaborAmplifier> Amplifier)
+{
+    return [Sampler = MoveTemp(Sampler), Amplifier](TConstArrayView<FVector3f> Directions, TArrayView<float> OutElevationKm)
+    {
+        TArray<FPTPCrustSample> Crust;
+        Crust.SetNumUninitialized(Directions.Num());
+        Sampler(Directions, Crust);
+        Amplifier->Evaluate(Directions, OutElevationKm);
+        for (int32 i = 0; i < Directions.Num(); ++i)
+        {
+            OutElevationKm[i] += Crust[i].Elevation;
+        }
+    };
+}
+
+FPTPPointHeightSource FPTPHeightSources::MakeCrateredPoints(FPTPPointHeightSource Base, TSharedRef<const FPTPCraterField> Field, float MinDiameterKm)
+{
+    return [Base = MoveTemp(Base), Field, MinDiameterKm](TConstArrayView<FVector3f> Directions, TArrayView<float> OutElevationKm)
+    {
+        Base(Directions, OutElevationKm);
+        TArray<float> Relief;
+        Relief.SetNumUninitialized(Directions.Num());
+        Field->Evaluate(Directions, Relief, MinDiameterKm);
+        for (int32 i = 0; i < Directions.Num(); ++i)
+        {
+            OutElevationKm[i] += Relief[i];
+        }
+    };
+}
+
+const TCHAR* FPTPHeightfieldBaker::GetExtension(EPTPHeightfieldFormat Format)
+{
+    return Format == EPTPHeightfieldFormat::Raw16 ? TEXT("r16") : TEXT("png");
+}
+
+uint16 FPTPHeightfieldBaker::Quantize(float ElevationKm, float MinKm, float MaxKm)
+{
+    const float Alpha = (ElevationKm - MinKm) / FMath::Max(MaxKm - MinKm, UE_KINDA_SMALL_NUMBER);
+    return (uint16)FMath::Clamp(FMath::RoundToInt(Alpha * 65535.0f), 0, 65535);
+}
+
+float FPTPHeightfieldBaker::Dequantize(uint16 Value, float MinKm, float MaxKm)
+{
+    return FMath::Lerp(MinKm, MaxKm, Value / 65535.0f);
+}
+
+bool FPTPHeightfieldBaker::EncodeTile(TConstArrayView<uint16> Heights, int32 Resolution, EPTPHeightfieldFormat Format, TArray64<uint8>& OutBytes)
+{
+    if (Heights.Num() != Resolution * Resolution)
+    {
+        return false;
+    }
+    if (Format == EPTPHeightfieldFormat::Raw16)
+    {
+        // Explicit byte order so the files are the same on every platform
+        OutBytes.SetNumUninitialized(int64(Heights.Num()) * 2);
+        for (int32 i = 0; i < Heights.Num(); ++i)
+        {
+            OutBytes[2 * int64(i)] = uint8(Heights[i] & 0xFF);
+            OutBytes[2 * int64(i) + 1] = uint8(Heights[i] >> 8);
+        }
+        return true;
+    }
+    const FImageView Image(const_cast<uint16*>(Heights.GetData()), Resolution, Resolution, ERawImageFormat::G16);
+    return FImageUtils::CompressImage(OutBytes, TEXT("png"), Image);
+}
+
+bool FPTPHeightfieldBaker::ReadTile(const FString& Path, int32 Resolution, EPTPHeightfieldFormat Format, TArray<uint16>& OutHeights)
+{
+    TArray64<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+    {
+        return false;
+    }
+    const int32 NumTexels = Resolution * Resolution;
+    if (Format == EPTPHeightfieldFormat::Raw16)
+    {
+        if (Bytes.Num() != int64(NumTexels) * 2)
+        {
+            return false;
+        }
+        OutHeights.SetNumUninitialized(NumTexels);
+        for (int32 i = 0; i < NumTexels; ++i)
+        {
+            OutHeights[i] = uint16(Bytes[2 * int64(i)]) | (uint16(Bytes[2 * int64(i) + 1]) << 8);
+        }
+        return true;
+    }
+
+    FImage Image;
+    if (!FImageUtils::DecompressImage(Bytes.GetData(), Bytes.Num(), Image)
+        || Image.Format != ERawImageFormat::G16 || Image.SizeX != Resolution || Image.SizeY != Resolution)
+    {
+        return false;
+    }
+    const TArrayView64<uint16> Texels = Image.AsG16();
+    OutHeights.SetNumUninitialized(NumTexels);
+    FMemory::Memcpy(OutHeights.GetData(), Texels.GetData(), NumTexels * sizeof(uint16));
+    return true;
+}
+
+bool FPTPHeightfieldBaker::Bake(const FPTPHeightSource& Source, const FPTPBakeSettings& Settings, FPTPBakeManifest& OutManifest,
+                                FString& OutError, TFunctionRef<bool()> IsCancelled)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, HeightfieldBake);
+
+    if (!Source || Settings.TilesPerFace < 1 || Settings.TileResolution < 2 || Settings.MaxElevationKm <= Settings.MinElevationKm)
+    {
+        OutError = TEXT("invalid bake settings");
+        return false;
+    }
+    if (Settings.OutputDir.IsEmpty() || !IFileManager::Get().MakeDirectory(*Settings.OutputDir, true))
+    {
+        OutError = FString::Printf(TEXT("cannot create output directory '%s'"), *Settings.OutputDir);
+        return false;
+    }
+
+    TArray<int32> Faces = Settings.Faces;
+    if (Faces.Num() == 0)
+    {
+        for (int32 Face = 0; Face < FPTPCubeMap::NumFaces; ++Face)
+        {
+            Faces.Add(Face);
+        }
+    }
+
+    OutManifest = FPTPBakeManifest();
+    OutManifest.TilesPerFace = Settings.TilesPerFace;
+    OutManifest.TileResolution = Settings.TileResolution;
+    OutManifest.Format = Settings.Format;
+    OutManifest.MinElevationKm = Settings.MinElevationKm;
+    OutManifest.MaxElevationKm = Settings.MaxElevationKm;
+    OutManifest.PlanetRadiusKm = Settings.PlanetRadiusKm;
+    for (int32 Face : Faces)
+    {
+        if (Face < 0 || Face >= FPTPCubeMap::NumFaces)
+        {
+            OutError = FString::Printf(TEXT("invalid cube face %d"), Face);
+            return false;
+        }
+        for (int32 TileY = 0; TileY < Settings.TilesPerFace; ++TileY)
+        {
+            for (int32 TileX = 0; TileX < Settings.TilesPerFace; ++TileX)
+            {
+                FPTPBakedTile& Tile = OutManifest.Tiles.AddDefaulted_GetRef();
+                Tile.Face = Face;
+                Tile.TileX = TileX;
+                Tile.TileY = TileY;
+                Tile.File = TileFileName(Settings, Face, TileX, TileY);
+            }
+        }
+    }
+
+    // Waves bound the tiles alive at once; within a wave every tile is computed, encoded, written and dropped
+    const bool bParallel = PTPProfiling::IsParallelEnabled();
+    const int32 InFlight = Settings.MaxTilesInFlight > 0 ? Settings.MaxTilesInFlight
+        : bParallel ? FTaskGraphInterface::Get().GetNumWorkerThreads() + 1 : 1;
+    const int32 Res = Settings.TileResolution;
+    std::atomic<int32> NumFailed{ 0 };
+
+    const double StartTime = FPlatformTime::Seconds();
+    for (int32 WaveStart = 0; WaveStart < OutManifest.Tiles.Num(); WaveStart += InFlight)
+    {
+        if (IsCancelled())
+        {
+            OutError = TEXT("cancelled");
+            return false;
+        }
+        const int32 WaveSize = FMath::Min(InFlight, OutManifest.Tiles.Num() - WaveStart);
+        ParallelFor(WaveSize, [&](int32 i)
+        {
+            FPTPBakedTile& Baked = OutManifest.Tiles[WaveStart + i];
+            FPTPAmplifyTile Tile;
+            Tile.Face = Baked.Face;
+            Tile.TileX = Baked.TileX;
+            Tile.TileY = Baked.TileY;
+            Tile.TilesPerFace = Settings.TilesPerFace;
+            Tile.Resolution = Res;
+            Tile.bSharedEdges = true;
+
+            TArray<float> ElevationKm;
+            Source(Tile, ElevationKm);
+            if (ElevationKm.Num() != Res * Res)
+            {
+                UE_LOG(LogGaiaPTP, Error, TEXT("Height source returned %d elevations for face %d tile (%d, %d), expected %d"),
+                    ElevationKm.Num(), Tile.Face, Tile.TileX, Tile.TileY, Res * Res);
+                ++NumFailed;
+                return;
+            }
+
+            TArray<uint16> Heights;
+            Heights.SetNumUninitialized(Res * Res);
+            Baked.MinKm = TNumericLimits<float>::Max();
+            Baked.MaxKm = TNumericLimits<float>::Lowest();
+            for (int32 t = 0; t < Heights.Num(); ++t)
+            {
+                const float Km = ElevationKm[t];
+                Baked.MinKm = FMath::Min(Baked.MinKm, Km);
+                Baked.MaxKm = FMath::Max(Baked.MaxKm, Km);
+                Baked.NumClamped += Km < Settings.MinElevationKm || Km > Settings.MaxElevationKm ? 1 : 0;
+                Heights[t] = Quantize(Km, Settings.MinElevationKm, Settings.MaxElevationKm);
+            }
+            ElevationKm.Empty();
+
+            TArray64<uint8> Bytes;
+            if (!EncodeTile(Heights, Res, Settings.Format, Bytes) || !FFileHelper::SaveArrayToFile(Bytes, *(Settings.OutputDir / Baked.File)))
+            {
+                ++NumFailed;
+            }
+        }, !bParallel);
+
+        if (NumFailed.load() > 0)
+        {
+            OutError = FString::Printf(TEXT("%d tiles failed to bake or write"), NumFailed.load());
+            return false;
+        }
+    }
+
+    int32 NumClamped = 0;
+    for (const FPTPBakedTile& Tile : OutManifest.Tiles)
+    {
+        NumClamped += Tile.NumClamped;
+    }
+    if (NumClamped > 0)
+    {
+        UE_LOG(LogGaiaPTP, Warning, TEXT("Heightfield bake: %d texels outside [%.1f, %.1f] km were clamped"),
+            NumClamped, Settings.MinElevationKm, Settings.MaxElevationKm);
+    }
+
+    const FString ManifestPath = Settings.OutputDir / (Settings.BaseName + TEXT(".json"));
+    if (!OutManifest.Save(ManifestPath, OutError))
+    {
+        return false;
+    }
+    UE_LOG(LogGaiaPTP, Log, TEXT("Heightfield bake: %d tiles of %d^2 (%d^2 per face) in %.2fs, %d in flight -> %s"),
+        OutManifest.Tiles.Num(), Res, Settings.GetFaceResolution(), FPlatformTime::Seconds() - StartTime, InFlight, *ManifestPath);
+    return true;
+}
+
+const FPTPBakedTile* FPTPBakeManifest::FindTile(int32 Face, int32 TileX, int32 TileY) const
+{
+    return Tiles.FindByPredicate([&](const FPTPBakedTile& Tile)
+    {
+        return Tile.Face == Face && Tile.TileX == TileX && Tile.TileY == TileY;
+    });
+}
+
+bool FPTPBakeManifest::Save(const FString& Path, FString& OutError) const
+{
+    TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+    Root->SetNumberField(TEXT("version"), 1);
+    Root->SetStringField(TEXT("layout"), TEXT("cubemap-equiangular"));
+    Root->SetStringField(TEXT("faceOrder"), TEXT("+X,-X,+Y,-Y,+Z,-Z"));
+    Root->SetNumberField(TEXT("tilesPerFace"), TilesPerFace);
+    Root->SetNumberField(TEXT("tileResolution"), TileResolution);
+    Root->SetNumberField(TEXT("faceResolution"), TilesPerFace * (TileResolution - 1) + 1);
+    Root->SetStringField(TEXT("format"), FPTPHeightfieldBaker::GetExtension(Format));
+    Root->SetNumberField(TEXT("minElevationKm"), MinElevationKm);
+    Root->SetNumberField(TEXT("maxElevationKm"), MaxElevationKm);
+    Root->SetNumberField(TEXT("planetRadiusKm"), PlanetRadiusKm);
+    Root->SetNumberField(TEXT("texelSpacingKm"), GetTexelSpacingKm());
+
+    TArray<TSharedPtr<FJsonValue>> TileValues;
+    for (const FPTPBakedTile& Tile : Tiles)
+    {
+        TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+        Object->SetNumberField(TEXT("face"), Tile.Face);
+        Object->SetNumberField(TEXT("x"), Tile.TileX);
+        Object->SetNumberField(TEXT("y"), Tile.TileY);
+        Object->SetStringField(TEXT("file"), Tile.File);
+        Object->SetNumberField(TEXT("minKm"), Tile.MinKm);
+        Object->SetNumberField(TEXT("maxKm"), Tile.MaxKm);
+        Object->SetNumberField(TEXT("clamped"), Tile.NumClamped);
+        TileValues.Add(MakeShared<FJsonValueObject>(Object));
+    }
+    Root->SetArrayField(TEXT("tiles"), TileValues);
+
+    FString Json;
+    const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+    if (!FJsonSerializer::Serialize(Root, Writer) || !FFileHelper::SaveStringToFile(Json, *Path))
+    {
+        OutError = FString::Printf(TEXT("failed to write manifest '%s'"), *Path);
+        return false;
+    }
+    return true;
+}
+
+bool FPTPBakeManifest::Load(const FString& Path, FPTPBakeManifest& OutManifest, FString& OutError)
+{
+    FString Json;
+    TSharedPtr<FJsonObject> Root;
+    if (!FFileHelper::LoadFileToString(Json, *Path)
+        || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Root) || !Root.IsValid())
+    {
+        OutError = FString::Printf(TEXT("cannot read manifest '%s'"), *Path);
+        return false;
+    }
+
+    OutManifest = FPTPBakeManifest();
+    OutManifest.TilesPerFace = Root->GetIntegerField(TEXT("tilesPerFace"));
+    OutManifest.TileResolution = Root->GetIntegerField(TEXT("tileResolution"));
+    OutManifest.Format = Root->GetStringField(TEXT("format")) == TEXT("r16") ? EPTPHeightfieldFormat::Raw16 : EPTPHeightfieldFormat::Png16;
+    OutManifest.MinElevationKm = (float)Root->GetNumberField(TEXT("minElevationKm"));
+    OutManifest.MaxElevationKm = (float)Root->GetNumberField(TEXT("maxElevationKm"));
+    OutManifest.PlanetRadiusKm = (float)Root->GetNumberField(TEXT("planetRadiusKm"));
+    for (const TSharedPtr<FJsonValue>& Value : Root->GetArrayField(TEXT("tiles")))
+    {
+        const TSharedPtr<FJsonObject>& Object = Value->AsObject();
+        if (!Object.IsValid())
+        {
+            continue;
+        }
+        FPTPBakedTile& Tile = OutManifest.Tiles.AddDefaulted_GetRef();
+        Tile.Face = Object->GetIntegerField(TEXT("face"));
+        Tile.TileX = Object->GetIntegerField(TEXT("x"));
+        Tile.TileY = Object->GetIntegerField(TEXT("y"));
+        Tile.File = Object->GetStringField(TEXT("file"));
+        Tile.MinKm = (float)Object->GetNumberField(TEXT("minKm"));
+        Tile.MaxKm = (float)Object->GetNumberField(TEXT("maxKm"));
+        Tile.NumClamped = Object->GetIntegerField(TEXT("clamped"));
+    }
+    if (OutManifest.TilesPerFace < 1 || OutManifest.TileResolution < 2)
+    {
+        OutError = FString::Printf(TEXT("manifest '%s' has no valid layout"), *Path);
+        return false;
+    }
+    return true;
+}
+
+namespace
+{
+    // Usage: ptp.bake.heightfield [tilesPerFace] [tileResolution] [png|raw] [craters]
+    void PTPBakeHeightfield(const TArray<FString>& Args)
+    {
+        const UPTPPlanetComponent* Planet = nullptr;
+        for (TObjectIterator<UPTPPlanetComponent> It; It; ++It)
+        {
+            if (!It->IsTemplate() && It->SamplePoints.Num() > 0 && It->Triangles.Num() > 0 && It->CrustData.Num() == It->SamplePoints.Num())
+            {
+                Planet = *It;
+                break;
+            }
+        }
+        if (!Planet)
+        {
+            UE_LOG(LogGaiaPTP, Warning, TEXT("ptp.bake.heightfield: no planet with crust and triangulation data"));
+            return;
+        }
+
+        FPTPBakeSettings Settings;
+        Settings.TilesPerFace = Args.Num() > 0 ? FMath::Clamp(FCString::Atoi(*Args[0]), 1, 64) : Settings.TilesPerFace;
+        Settings.TileResolution = Args.Num() > 1 ? FMath::Clamp(FCString::Atoi(*Args[1]), 2, 8193) : Settings.TileResolution;
+        Settings.Format = Args.Num() > 2 && Args[2] == TEXT("raw") ? EPTPHeightfieldFormat::Raw16 : EPTPHeightfieldFormat::Png16;
+        Settings.PlanetRadiusKm = Planet->PlanetRadiusKm;
+        Settings.OutputDir = FPaths::ProjectSavedDir() / TEXT("PTP/Heightfields") / FDateTime::Now().ToString();
+
+        FPTPHeightSource Source = FPTPHeightSources::MakeCoarse(
+            FPTPCrustSampling::MakeBarycentricSampler(Planet->SamplePoints, Planet->Triangles, Planet->CrustData));
+        if (Args.Num() > 3 && Args[3] == TEXT("craters"))
+        {
+            FPTPCraterFieldParams CraterParams;
+            CraterParams.PlanetRadiusKm = Planet->PlanetRadiusKm;
+            Source = FPTPHeightSources::MakeCratered(MoveTemp(Source), MakeShared<FPTPCraterField>(CraterParams));
+        }
+        FPTPBakeManifest Manifest;
+        FString Error;
+        if (!FPTPHeightfieldBaker::Bake(Source, Settings, Manifest, Error))
+        {
+            UE_LOG(LogGaiaPTP, Warning, TEXT("ptp.bake.heightfield: %s"), *Error);
+        }
+    }
+
+    FAutoConsoleCommand CmdBakeHeightfield(
+        TEXT("ptp.bake.heightfield"),
+        TEXT("Bake the first planet's coarse elevation, optionally cratered, to 16-bit cube-map tiles in Saved/PTP/Heightfields: ptp.bake.heightfield [tilesPerFace] [tileResolution] [png|raw] [craters]"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&PTPBakeHeightfield));
+}
@@ -0,0 +1,599 @@
+#include "PTPHydrology.h"
+#include "Algo/AnyOf.h"
+#include "Algo/BinarySearch.h"
+#include "Async/ParallelFor.h"
+#include "GaiaPTP.h"
+#include "PTPAdjacency.h"
+#include "PTPArena.h"
+#include "PTPProfiling.h"
+#include "PTPSimd.h"
+
+namespace
+{
+    /** Vertices per task in the level-by-level passes; most levels are thinner and run inline. */
+    constexpr int32 LevelChunkSize = 4096;
+
+    /** Watershed of the ocean; a region-border seed v labels its provisional watershed v + 1. */
+    constexpr int32 OceanLabel = 0;
+
+    /** Priority-flood entry; ties go to the lower index so a region floods the same way every run. */
+    struct FFloodEntry
+    {
+        float Level;
+        int32 Vertex;
+        bool operator<(const FFloodEntry& Other) const { return Level < Other.Level || (Level == Other.Level && Vertex < Other.Vertex); }
+    };
+
+    /** Level at which water crosses between two watersheds. */
+    struct FSpill
+    {
+        int32 A;
+        int32 B;
+        float Level;
+    };
+}
+
+SIZE_T FPTPDrainage::GetAllocatedSize() const
+{
+    return FilledElevationKm.GetAllocatedSize() + Receivers.GetAllocatedSize() + Flow.GetAllocatedSize()
+        + StrahlerOrder.GetAllocatedSize() + Order.GetAllocatedSize() + LevelOffsets.GetAllocatedSize()
+        + Reaches.GetAllocatedSize() + RiverVertices.GetAllocatedSize();
+}
+
+int32 FPTPHydrology::FillDepressions(const FPTPAdjacency& Adjacency, TConstArrayView<float> ElevationKm, float SeaLevelKm,
+                                     int32 RegionSize, TArray<float>& OutFilledKm, FPTPStepScratch* Scratch)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, FillDepressions);
+
+    TOptional<FPTPStepScratch> LocalScratch;
+    if (!Scratch)
+    {
+        Scratch = &LocalScratch.Emplace();
+    }
+    FPTPKernelScratchScope KernelScope(Scratch, TEXT("FillDepressions"));
+    FPTPArena& StepArena = Scratch->GetStepArena();
+
+    const int32 NumVertices = ElevationKm.Num();
+    check(Adjacency.Num() == NumVertices);
+    OutFilledKm.SetNumUninitialized(NumVertices);
+    if (NumVertices == 0)
+    {
+        return 0;
+    }
+    const bool bDoParallel = PTPProfiling::IsParallelEnabled();
+
+    // Outlets are the ocean, or the lowest vertex of a dry planet
+    bool bHasOcean = false;
+    int32 Lowest = 0;
+    for (int32 v = 0; v < NumVertices; ++v)
+    {
+        bHasOcean |= ElevationKm[v] <= SeaLevelKm;
+        Lowest = ElevationKm[v] < ElevationKm[Lowest] ? v : Lowest;
+    }
+    auto IsOutlet = [&](int32 v) { return bHasOcean ? ElevationKm[v] <= SeaLevelKm : v == Lowest; };
+
+    RegionSize = FMath::Clamp(RegionSize, 1, NumVertices);
+    const int32 NumRegions = FMath::DivideAndRoundUp(NumVertices, RegionSize);
+    TArrayView<int32> Labels = StepArena.NewSpan<int32>(NumVertices);
+    TArrayView<TArrayView<FSpill>> InnerSpills = StepArena.NewSpan<TArrayView<FSpill>>(NumRegions);
+    TArrayView<TArrayView<FSpill>> BorderSpills = StepArena.NewSpan<TArrayView<FSpill>>(NumRegions);
+
+    // Flood every region from its ocean and from its border, each border vertex a provisional outlet
+    ParallelFor(NumRegions, [&](int32 Region)
+    {
+        const int32 Begin = Region * RegionSize;
+        const int32 End = FMath::Min(Begin + RegionSize, NumVertices);
+        auto InRegion = [Begin, End](int32 v) { return v >= Begin && v < End; };
+
+        FPTPStepScratch::FWorkerLease Arena = Scratch->AcquireWorkerArena();
+        TPTPArenaArray<FFloodEntry> Heap(*Arena, 1024);
+        TPTPArenaArray<int32> Pit(*Arena, 1024);
+        TPTPArenaArray<FSpill> Spills(*Arena);
+
+        for (int32 v = Begin; v < End; ++v)
+        {
+            Labels[v] = INDEX_NONE;
+        }
+        for (int32 v = Begin; v < End; ++v)
+        {
+            const TConstArrayView<int32> Neighbors = Adjacency.GetNeighbors(v);
+            if (IsOutlet(v))
+            {
+                Labels[v] = OceanLabel;
+                OutFilledKm[v] = ElevationKm[v];
+                if (Algo::AnyOf(Neighbors, [&](int32 n) { return !IsOutlet(n); }))
+                {
+                    Heap.HeapPush({ ElevationKm[v], v });   // only the coast floods land
+                }
+            }
+            else if (Algo::AnyOf(Neighbors, [&](int32 n) { return !InRegion(n); }))
+            {
+                Labels[v] = v + 1;
+                OutFilledKm[v] = ElevationKm[v];
+                Heap.HeapPush({ ElevationKm[v], v });
+            }
+        }
+
+        // Improved priority-flood: cells below the current level are pits, settled FIFO without the heap
+        int32 PitHead = 0;
+        for (;;)
+        {
+            int32 Vertex;
+            if (PitHead < Pit.Num())
+            {
+                Vertex = Pit[PitHead++];
+            }
+            else if (!Heap.IsEmpty())
+            {
+                Pit.Reset();
+                PitHead = 0;
+                Vertex = Heap.HeapPop().Vertex;
+            }
+            else
+            {
+                break;
+            }
+
+            const int32 Label = Labels[Vertex];
+            const float Level = OutFilledKm[Vertex];
+            for (int32 n : Adjacency.GetNeighbors(Vertex))
+            {
+                if (!InRegion(n))
+                {
+                    continue;
+                }
+                if (Labels[n] != INDEX_NONE)
+                {
+                    if (Labels[n] != Label)
+                    {
+                        Spills.Add({ Label, Labels[n], FMath::Max(Level, OutFilledKm[n]) });
+                    }
+                    continue;
+                }
+                Labels[n] = Label;
+                if (ElevationKm[n] <= Level)
+                {
+                    OutFilledKm[n] = Level;
+                    Pit.Add(n);
+                }
+                else
+                {
+                    OutFilledKm[n] = ElevationKm[n];
+                    Heap.HeapPush({ ElevationKm[n], n });
+                }
+            }
+        }
+        InnerSpills[Region] = Spills.GetView();
+    }, !bDoParallel);
+
+    // Watersheds meeting across region borders; each edge is taken from its lower vertex
+    ParallelFor(NumRegions, [&](int32 Region)
+    {
+        const int32 Begin = Region * RegionSize;
+        const int32 End = FMath::Min(Begin + RegionSize, NumVertices);
+        FPTPStepScratch::FWorkerLease Arena = Scratch->AcquireWorkerArena();
+        TPTPArenaArray<FSpill> Spills(*Arena);
+        for (int32 v = Begin; v < End; ++v)
+        {
+            if (Labels[v] == INDEX_NONE)
+            {
+                continue;
+            }
+            for (int32 n : Adjacency.GetNeighbors(v))
+            {
+                if (n > v && n >= End && Labels[n] != INDEX_NONE && Labels[n] != Labels[v])
+                {
+                    Spills.Add({ Labels[v], Labels[n], FMath::Max(OutFilledKm[v], OutFilledKm[n]) });
+                }
+            }
+        }
+        BorderSpills[Region] = Spills.GetView();
+    }, !bDoParallel);
+
+    // Spill graph over labels [0, NumVertices], both directions
+    const int32 NumLabels = NumVertices + 1;
+    TArrayView<int32> LinkOffsets = StepArena.NewSpan<int32>(NumLabels + 1, 0);
+    auto ForEachSpill = [&](auto&& Visit)
+    {
+        for (int32 Region = 0; Region < NumRegions; ++Region)
+        {
+            for (const FSpill& Spill : InnerSpills[Region])
+            {
+                Visit(Spill);
+            }
+            for (const FSpill& Spill : BorderSpills[Region])
+            {
+                Visit(Spill);
+            }
+        }
+    };
+    ForEachSpill([&](const FSpill& Spill)
+    {
+        ++LinkOffsets[Spill.A + 1];
+        ++LinkOffsets[Spill.B + 1];
+    });
+    for (int32 Label = 0; Label < NumLabels; ++Label)
+    {
+        LinkOffsets[Label + 1] += LinkOffsets[Label];
+    }
+    TArrayView<int32> LinkTargets = StepArena.NewSpan<int32>(LinkOffsets[NumLabels]);
+    TArrayView<float> LinkLevels = StepArena.NewSpan<float>(LinkOffsets[NumLabels]);
+    {
+        TArrayView<int32> Cursor = StepArena.NewSpan<int32>(NumLabels);
+        FMemory::Memcpy(Cursor.GetData(), LinkOffsets.GetData(), NumLabels * sizeof(int32));
+        ForEachSpill([&](const FSpill& Spill)
+        {
+            const int32 AtA = Cursor[Spill.A]++;
+            LinkTargets[AtA] = Spill.B;
+            LinkLevels[AtA] = Spill.Level;
+            const int32 AtB = Cursor[Spill.B]++;
+            LinkTargets[AtB] = Spill.A;
+            LinkLevels[AtB] = Spill.Level;
+        });
+    }
+
+    // Water level of each watershed: the lowest spill path to the ocean, by its highest spill
+    TArrayView<float> WaterLevels = StepArena.NewSpan<float>(NumLabels, TNumericLimits<float>::Max());
+    WaterLevels[OceanLabel] = TNumericLimits<float>::Lowest();
+    TPTPArenaArray<FFloodEntry> Queue(StepArena, 1024);
+    Queue.HeapPush({ WaterLevels[OceanLabel], OceanLabel });
+    while (!Queue.IsEmpty())
+    {
+        const FFloodEntry Entry = Queue.HeapPop();
+        if (Entry.Level > WaterLevels[Entry.Vertex])
+        {
+            continue;   // stale entry
+        }
+        for (int32 Link = LinkOffsets[Entry.Vertex]; Link < LinkOffsets[Entry.Vertex + 1]; ++Link)
+        {
+            const int32 Target = LinkTargets[Link];
+            const float Level = FMath::Max(Entry.Level, LinkLevels[Link]);
+            if (Level < WaterLevels[Target])
+            {
+                WaterLevels[Target] = Level;
+                Queue.HeapPush({ Level, Target });
+            }
+        }
+    }
+
+    // Raise each watershed to its water level
+    TArrayView<int32> ChunkRaised = StepArena.NewSpan<int32>(PTPSimd::NumChunks(NumVertices), 0);
+    ParallelFor(PTPSimd::NumChunks(NumVertices), [&](int32 Chunk)
+    {
+        const int32 Begin = Chunk * PTPSimd::ChunkSize;
+        const int32 End = FMath::Min(Begin + PTPSimd::ChunkSize, NumVertices);
+        int32 Raised = 0;
+        for (int32 v = Begin; v < End; ++v)
+        {
+            const int32 Label = Labels[v];
+            if (Label == INDEX_NONE)
+            {
+                OutFilledKm[v] = ElevationKm[v];   // not connected to any outlet
+                continue;
+            }
+            if (WaterLevels[Label] != TNumericLimits<float>::Max())
+            {
+                OutFilledKm[v] = FMath::Max(OutFilledKm[v], WaterLevels[Label]);
+            }
+            Raised += OutFilledKm[v] > ElevationKm[v] ? 1 : 0;
+        }
+        ChunkRaised[Chunk] = Raised;
+    }, !bDoParallel);
+
+    int32 NumRaised = 0;
+    for (int32 Raised : ChunkRaised)
+    {
+        NumRaised += Raised;
+    }
+    return NumRaised;
+}
+
+void FPTPHydrology::ComputeReceivers(const FPTPAdjacency& Adjacency, TConstArrayView<FVector3f> Points, TConstArrayView<float> FilledKm,
+                                     float SeaLevelKm, TArray<int32>& OutReceivers)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, Receivers);
+    const int32 NumVertices = FilledKm.Num();
+    check(Adjacency.Num() == NumVertices && Points.Num() == NumVertices);
+    OutReceivers.SetNumUninitialized(NumVertices);
+
+    ParallelFor(PTPSimd::NumChunks(NumVertices), [&](int32 Chunk)
+    {
+        const int32 Begin = Chunk * PTPSimd::ChunkSize;
+        const int32 End = FMath::Min(Begin + PTPSimd::ChunkSize, NumVertices);
+        for (int32 v = Begin; v < End; ++v)
+        {
+            int32 Receiver = INDEX_NONE;
+            if (FilledKm[v] > SeaLevelKm)
+            {
+                // Steepest slope, compared squared: drop^2 / distance^2
+                float BestSlope2 = 0.0f;
+                for (int32 n : Adjacency.GetNeighbors(v))
+                {
+                    const float Drop = FilledKm[v] - FilledKm[n];
+                    if (Drop > 0.0f)
+                    {
+                        const float Slope2 = Drop * Drop / FMath::Max((Points[v] - Points[n]).SizeSquared(), UE_SMALL_NUMBER);
+                        if (Slope2 > BestSlope2)
+                        {
+                            BestSlope2 = Slope2;
+                            Receiver = n;
+                        }
+                    }
+                }
+            }
+            OutReceivers[v] = Receiver;
+        }
+    }, !PTPProfiling::IsParallelEnabled());
+
+    // Filled flats have no descent; route them breadth-first towards the vertices of their level that drain
+    TArray<int32> Frontier;
+    TArray<uint8> Pending;
+    for (int32 v = 0; v < NumVertices; ++v)
+    {
+        if (OutReceivers[v] == INDEX_NONE && FilledKm[v] > SeaLevelKm)
+        {
+            if (Pending.Num() == 0)
+            {
+                Pending.SetNumZeroed(NumVertices);
+            }
+            Pending[v] = 1;
+            Frontier.Add(v);
+        }
+    }
+    if (Frontier.Num() == 0)
+    {
+        return;
+    }
+
+    TArray<int32> Flat = MoveTemp(Frontier);
+    for (int32 v : Flat)
+    {
+        for (int32 n : Adjacency.GetNeighbors(v))
+        {
+            if (!Pending[n] && FilledKm[n] == FilledKm[v])
+            {
+                OutReceivers[v] = n;
+                Frontier.Add(v);
+                break;
+            }
+        }
+    }
+    for (int32 v : Frontier)
+    {
+        Pending[v] = 0;
+    }
+    for (int32 Head = 0; Head < Frontier.Num(); ++Head)
+    {
+        const int32 v = Frontier[Head];
+        for (int32 n : Adjacency.GetNeighbors(v))
+        {
+            if (Pending[n] && FilledKm[n] == FilledKm[v])
+            {
+                OutReceivers[n] = v;
+                Pending[n] = 0;
+                Frontier.Add(n);
+            }
+        }
+    }
+}
+
+void FPTPHydrology::Compute(const FPTPAdjacency& Adjacency, TConstArrayView<FVector3f> Points, TConstArrayView<float> ElevationKm,
+                            TConstArrayView<float> Runoff, const FPTPHydrologyParams& Params, FPTPDrainage& Out,
+                            FPTPStepScratch* Scratch)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, Hydrology);
+    const double StartTime = FPlatformTime::Seconds();
+
+    TOptional<FPTPStepScratch> LocalScratch;
+    if (!Scratch)
+    {
+        Scratch = &LocalScratch.Emplace();
+    }
+
+    const int32 NumVertices = ElevationKm.Num();
+    const bool bDoParallel = PTPProfiling::IsParallelEnabled();
+    const bool bUnitRunoff = Runoff.Num() != NumVertices;
+
+    Out.NumFilledVertices = FillDepressions(Adjacency, ElevationKm, Params.SeaLevelKm, Params.FloodRegionSize, Out.FilledElevationKm, Scratch);
+    ComputeReceivers(Adjacency, Points, Out.FilledElevationKm, Params.SeaLevelKm, Out.Receivers);
+    const TArray<int32>& Receivers = Out.Receivers;
+
+    FPTPKernelScratchScope KernelScope(Scratch, TEXT("FlowAccumulation"));
+    FPTPArena& StepArena = Scratch->GetStepArena();
+
+    // Donors of each vertex, ascending: a counting sort of the receivers
+    TArrayView<int32> DonorOffsets = StepArena.NewSpan<int32>(NumVertices + 1, 0);
+    for (int32 v = 0; v < NumVertices; ++v)
+    {
+        if (Receivers[v] != INDEX_NONE)
+        {
+            ++DonorOffsets[Receivers[v] + 1];
+        }
+    }
+    for (int32 v = 0; v < NumVertices; ++v)
+    {
+        DonorOffsets[v + 1] += DonorOffsets[v];
+    }
+    TArrayView<int32> Donors = StepArena.NewSpan<int32>(DonorOffsets[NumVertices]);
+    {
+        TArrayView<int32> Cursor = StepArena.NewSpan<int32>(NumVertices);
+        FMemory::Memcpy(Cursor.GetData(), DonorOffsets.GetData(), NumVertices * sizeof(int32));
+        for (int32 v = 0; v < NumVertices; ++v)
+        {
+            if (Receivers[v] != INDEX_NONE)
+            {
+                Donors[Cursor[Receivers[v]]++] = v;
+            }
+        }
+    }
+
+    // Topological order, breadth-first from the outlets: level k + 1 is the donors of level k
+    Out.Order.SetNumUninitialized(NumVertices);
+    Out.LevelOffsets.Reset();
+    Out.LevelOffsets.Add(0);
+    int32 NumOrdered = 0;
+    for (int32 v = 0; v < NumVertices; ++v)
+    {
+        if (Receivers[v] == INDEX_NONE)
+        {
+            Out.Order[NumOrdered++] = v;
+        }
+    }
+    TArray<int32> ChunkOffsets;
+    while (NumOrdered > Out.LevelOffsets.Last())
+    {
+        const int32 Begin = Out.LevelOffsets.Last();
+        const int32 End = NumOrdered;
+        Out.LevelOffsets.Add(End);
+
+        const int32 NumChunks = PTPSimd::NumChunks(End - Begin, LevelChunkSize);
+        ChunkOffsets.SetNumUninitialized(NumChunks + 1);
+        ChunkOffsets[0] = 0;
+        ParallelFor(NumChunks, [&](int32 Chunk)
+        {
+            const int32 ChunkBegin = Begin + Chunk * LevelChunkSize;
+            const int32 ChunkEnd = FMath::Min(ChunkBegin + LevelChunkSize, End);
+            int32 Count = 0;
+            for (int32 k = ChunkBegin; k < ChunkEnd; ++k)
+            {
+                const int32 v = Out.Order[k];
+                Count += DonorOffsets[v + 1] - DonorOffsets[v];
+            }
+            ChunkOffsets[Chunk + 1] = Count;
+        }, !bDoParallel || NumChunks == 1);
+        for (int32 Chunk = 0; Chunk < NumChunks; ++Chunk)
+        {
+            ChunkOffsets[Chunk + 1] += ChunkOffsets[Chunk];
+        }
+
+        ParallelFor(NumChunks, [&](int32 Chunk)
+        {
+            const int32 ChunkBegin = Begin + Chunk * LevelChunkSize;
+            const int32 ChunkEnd = FMath::Min(ChunkBegin + LevelChunkSize, End);
+            int32 Dst = End + ChunkOffsets[Chunk];
+            for (int32 k = ChunkBegin; k < ChunkEnd; ++k)
+            {
+                const int32 v = Out.Order[k];
+                for (int32 d = DonorOffsets[v]; d < DonorOffsets[v + 1]; ++d)
+                {
+                    Out.Order[Dst++] = Donors[d];
+                }
+            }
+        }, !bDoParallel || NumChunks == 1);
+        NumOrdered = End + ChunkOffsets[NumChunks];
+    }
+    ensureMsgf(NumOrdered == NumVertices, TEXT("Hydrology: %d vertices are on receiver cycles"), NumVertices - NumOrdered);
+    Out.Order.SetNum(NumOrdered);
+    const int32 NumLevels = Out.LevelOffsets.Num() - 1;
+
+    // Accumulate from the sources down; Strahler orders count river donors only
+    Out.Flow.SetNumZeroed(NumVertices);
+    Out.StrahlerOrder.SetNumZeroed(NumVertices);
+    TArrayView<uint8> RiverDonors = StepArena.NewSpan<uint8>(NumVertices, 0);
+    for (int32 Level = NumLevels - 1; Level >= 0; --Level)
+    {
+        const int32 Begin = Out.LevelOffsets[Level];
+        const int32 End = Out.LevelOffsets[Level + 1];
+        const int32 NumChunks = PTPSimd::NumChunks(End - Begin, LevelChunkSize);
+        ParallelFor(NumChunks, [&](int32 Chunk)
+        {
+            const int32 ChunkBegin = Begin + Chunk * LevelChunkSize;
+            const int32 ChunkEnd = FMath::Min(ChunkBegin + LevelChunkSize, End);
+            for (int32 k = ChunkBegin; k < ChunkEnd; ++k)
+            {
+                const int32 v = Out.Order[k];
+                float Flow = bUnitRunoff ? 1.0f : Runoff[v];
+                uint8 MaxOrder = 0;
+                int32 NumAtMax = 0;
+                int32 NumRivers = 0;
+                for (int32 d = DonorOffsets[v]; d < DonorOffsets[v + 1]; ++d)
+                {
+                    const int32 Donor = Donors[d];
+                    Flow += Out.Flow[Donor];
+                    const uint8 DonorOrder = Out.StrahlerOrder[Donor];
+                    if (DonorOrder > 0)
+                    {
+                        ++NumRivers;
+                        NumAtMax = DonorOrder > MaxOrder ? 1 : NumAtMax + (DonorOrder == MaxOrder ? 1 : 0);
+                        MaxOrder = FMath::Max(MaxOrder, DonorOrder);
+                    }
+                }
+                Out.Flow[v] = Flow;
+                RiverDonors[v] = uint8(FMath::Min(NumRivers, 255));
+                if (Flow >= Params.RiverThreshold && Receivers[v] != INDEX_NONE)
+                {
+                    Out.StrahlerOrder[v] = uint8(MaxOrder == 0 ? 1 : NumAtMax > 1 ? FMath::Min(MaxOrder + 1, 255) : MaxOrder);
+                }
+            }
+        }, !bDoParallel || NumChunks == 1);
+    }
+
+    // Reaches start at river sources and confluences and run down to the next confluence or outlet
+    TPTPArenaArray<int32> Heads(StepArena);
+    for (int32 v = 0; v < NumVertices; ++v)
+    {
+        if (Out.StrahlerOrder[v] > 0 && RiverDonors[v] != 1)
+        {
+            Heads.Add(v);
+        }
+    }
+    auto Trace = [&](int32 Head, int32* OutVertices)
+    {
+        int32 Count = 0;
+        int32 Vertex = Head;
+        for (;;)
+        {
+            if (OutVertices)
+            {
+                OutVertices[Count] = Vertex;
+            }
+            ++Count;
+            if (Count > 1 && (Out.StrahlerOrder[Vertex] == 0 || RiverDonors[Vertex] != 1))
+            {
+                break;   // outlet, sink or confluence
+            }
+            Vertex = Receivers[Vertex];
+        }
+        return Count;
+    };
+
+    const int32 NumReaches = Heads.Num();
+    const int32 NumReachChunks = PTPSimd::NumChunks(NumReaches, LevelChunkSize);
+    Out.Reaches.SetNum(NumReaches);
+    ParallelFor(NumReachChunks, [&](int32 Chunk)
+    {
+        const int32 Begin = Chunk * LevelChunkSize;
+        const int32 End = FMath::Min(Begin + LevelChunkSize, NumReaches);
+        for (int32 r = Begin; r < End; ++r)
+        {
+            FPTPRiverReach& Reach = Out.Reaches[r];
+            Reach.Num = Trace(Heads[r], nullptr);
+            Reach.StrahlerOrder = Out.StrahlerOrder[Heads[r]];
+        }
+    }, !bDoParallel);
+
+    int32 NumRiverVertices = 0;
+    for (FPTPRiverReach& Reach : Out.Reaches)
+    {
+        Reach.First = NumRiverVertices;
+        NumRiverVertices += Reach.Num;
+    }
+    Out.RiverVertices.SetNumUninitialized(NumRiverVertices);
+    const TArrayView<int32> HeadView = Heads.GetView();
+    ParallelFor(NumReachChunks, [&](int32 Chunk)
+    {
+        const int32 Begin = Chunk * LevelChunkSize;
+        const int32 End = FMath::Min(Begin + LevelChunkSize, NumReaches);
+        for (int32 r = Begin; r < End; ++r)
+        {
+            FPTPRiverReach& Reach = Out.Reaches[r];
+            Trace(HeadView[r], Out.RiverVertices.GetData() + Reach.First);
+            const int32 Mouth = Out.RiverVertices[Reach.First + Reach.Num - 1];
+            Reach.Downstream = Out.StrahlerOrder[Mouth] > 0 ? Algo::BinarySearch(HeadView, Mouth) : INDEX_NONE;
+        }
+    }, !bDoParallel);
+
+    const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    UE_LOG(LogGaiaPTP, Log, TEXT("Hydrology: %d vertices, %d filled, %d flow levels, %d reaches over %d vertices, %.2fms"),
+        NumVertices, Out.NumFilledVertices, NumLevels, NumReaches, NumRiverVertices, ElapsedMs);
+}
@@ -0,0 +1,158 @@
+#include "PTPMemory.h"
+#include "GaiaPTP.h"
+#include "GaiaPTPSettings.h"
+#include "PTPProfiling.h"
+
+LLM_DEFINE_TAG(GaiaPTP);
+
+DECLARE_MEMORY_STAT(TEXT("Sample points"), STAT_PTP_SamplePoints, STATGROUP_GaiaPTP);
+DECLARE_MEMORY_STAT(TEXT("Plate ids"), STAT_PTP_PlateIds, STATGROUP_GaiaPTP);
+DECLARE_MEMORY_STAT(TEXT("Crust data"), STAT_PTP_CrustData, STATGROUP_GaiaPTP);
+DECLARE_MEMORY_STAT(TEXT("Boundaries"), STAT_PTP_Boundaries, STATGROUP_GaiaPTP);
+DECLARE_MEMORY_STAT(TEXT("Neighbors"), STAT_PTP_Neighbors, STATGROUP_GaiaPTP);
+DECLARE_MEMORY_STAT(TEXT("Triangles"), STAT_PTP_Triangles, STATGROUP_GaiaPTP);
+DECLARE_MEMORY_STAT(TEXT("Plates"), STAT_PTP_Plates, STATGROUP_GaiaPTP);
+DECLARE_MEMORY_STAT(TEXT("Mesh streams"), STAT_PTP_MeshStreams, STATGROUP_GaiaPTP);
+DECLARE_MEMORY_STAT(TEXT("Chunks"), STAT_PTP_Chunks, STATGROUP_GaiaPTP);
+DECLARE_MEMORY_STAT(TEXT("Kernel scratch"), STAT_PTP_Scratch, STATGROUP_GaiaPTP);
+
+namespace
+{
+#if STATS
+    FName GetBucketStat(EPTPMemoryBucket Bucket)
+    {
+        switch (Bucket)
+        {
+        case EPTPMemoryBucket::SamplePoints: return GET_STATFNAME(STAT_PTP_SamplePoints);
+        case EPTPMemoryBucket::PlateIds:     return GET_STATFNAME(STAT_PTP_PlateIds);
+        case EPTPMemoryBucket::CrustData:    return GET_STATFNAME(STAT_PTP_CrustData);
+        case EPTPMemoryBucket::Boundaries:   return GET_STATFNAME(STAT_PTP_Boundaries);
+        case EPTPMemoryBucket::Neighbors:    return GET_STATFNAME(STAT_PTP_Neighbors);
+        case EPTPMemoryBucket::Triangles:    return GET_STATFNAME(STAT_PTP_Triangles);
+        case EPTPMemoryBucket::Plates:       return GET_STATFNAME(STAT_PTP_Plates);
+        case EPTPMemoryBucket::MeshStreams:  return GET_STATFNAME(STAT_PTP_MeshStreams);
+        case EPTPMemoryBucket::Chunks:       return GET_STATFNAME(STAT_PTP_Chunks);
+        case EPTPMemoryBucket::Scratch:      return GET_STATFNAME(STAT_PTP_Scratch);
+        default:                             return NAME_None;
+        }
+    }
+#endif
+
+    double ToMB(SIZE_T Bytes)
+    {
+        return double(Bytes) / (1024.0 * 1024.0);
+    }
+}
+
+SIZE_T FPTPMemoryReport::GetTotal() const
+{
+    SIZE_T Total = 0;
+    for (SIZE_T B : Bytes)
+    {
+        Total += B;
+    }
+    return Total;
+}
+
+FPTPMemoryReport& FPTPMemoryReport::operator+=(const FPTPMemoryReport& Other)
+{
+    for (int32 i = 0; i < (int32)EPTPMemoryBucket::Num; ++i)
+    {
+        Bytes[i] += Other.Bytes[i];
+    }
+    return *this;
+}
+
+const TCHAR* FPTPMemory::GetBucketName(EPTPMemoryBucket Bucket)
+{
+    switch (Bucket)
+    {
+    case EPTPMemoryBucket::SamplePoints: return TEXT("SamplePoints");
+    case EPTPMemoryBucket::PlateIds:     return TEXT("PlateIds");
+    case EPTPMemoryBucket::CrustData:    return TEXT("CrustData");
+    case EPTPMemoryBucket::Boundaries:   return TEXT("Boundaries");
+    case EPTPMemoryBucket::Neighbors:    return TEXT("Neighbors");
+    case EPTPMemoryBucket::Triangles:    return TEXT("Triangles");
+    case EPTPMemoryBucket::Plates:       return TEXT("Plates");
+    case EPTPMemoryBucket::MeshStreams:  return TEXT("MeshStreams");
+    case EPTPMemoryBucket::Chunks:       return TEXT("Chunks");
+    case EPTPMemoryBucket::Scratch:      return TEXT("Scratch");
+    default:                             return TEXT("?");
+    }
+}
+
+SIZE_T FPTPMemory::GetAllocatedSize(const TArray<TArray<int32>>& Nested)
+{
+    SIZE_T Bytes = Nested.GetAllocatedSize();
+    for (const TArray<int32>& Inner : Nested)
+    {
+        Bytes += Inner.GetAllocatedSize();
+    }
+    return Bytes;
+}
+
+void FPTPMemory::UpdateStats(FPTPMemoryReport& InOutReported, const FPTPMemoryReport& Current)
+{
+#if STATS
+    for (int32 i = 0; i < (int32)EPTPMemoryBucket::Num; ++i)
+    {
+        const FName Stat = GetBucketStat((EPTPMemoryBucket)i);
+        if (Current.Bytes[i] > InOutReported.Bytes[i])
+        {
+            INC_MEMORY_STAT_BY_FName(Stat, Current.Bytes[i] - InOutReported.Bytes[i]);
+        }
+        else if (Current.Bytes[i] < InOutReported.Bytes[i])
+        {
+            DEC_MEMORY_STAT_BY_FName(Stat, InOutReported.Bytes[i] - Current.Bytes[i]);
+        }
+    }
+#endif
+    InOutReported = Current;
+}
+
+SIZE_T FPTPMemory::GetBudgetBytes()
+{
+    const UGaiaPTPSettings* Settings = GetDefault<UGaiaPTPSettings>();
+    return Settings && Settings->MemoryBudgetMB > 0 ? SIZE_T(Settings->MemoryBudgetMB) * 1024 * 1024 : 0;
+}
+
+bool FPTPMemory::CheckBudget(const FPTPMemoryReport& Report, const FString& Owner)
+{
+    const SIZE_T Budget = GetBudgetBytes();
+    const SIZE_T Total = Report.GetTotal();
+    if (Budget == 0 || Total <= Budget)
+    {
+        return true;
+    }
+
+    // The two largest buckets are where shrinking pays off first
+    int32 First = 0, Second = 1;
+    for (int32 i = 0; i < (int32)EPTPMemoryBucket::Num; ++i)
+    {
+        if (Report.Bytes[i] > Report.Bytes[First])
+        {
+            Second = First;
+            First = i;
+        }
+        else if (i != First && Report.Bytes[i] > Report.Bytes[Second])
+        {
+            Second = i;
+        }
+    }
+    UE_LOG(LogGaiaPTP, Warning, TEXT("PTP: %s uses %.1f MB, over the %.1f MB budget (largest: %s %.1f MB, %s %.1f MB)"),
+        *Owner, ToMB(Total), ToMB(Budget),
+        GetBucketName((EPTPMemoryBucket)First), ToMB(Report.Bytes[First]),
+        GetBucketName((EPTPMemoryBucket)Second), ToMB(Report.Bytes[Second]));
+    return false;
+}
+
+void FPTPMemory::LogReport(const FPTPMemoryReport& Report, int32 NumSamples)
+{
+    for (int32 i = 0; i < (int32)EPTPMemoryBucket::Num; ++i)
+    {
+        UE_LOG(LogGaiaPTP, Log, TEXT("  %-14s %9.2f MB  %7.1f B/sample"), GetBucketName((EPTPMemoryBucket)i), ToMB(Report.Bytes[i]),
+            NumSamples > 0 ? double(Report.Bytes[i]) / NumSamples : 0.0);
+    }
+    UE_LOG(LogGaiaPTP, Log, TEXT("  %-14s %9.2f MB  %7.1f B/sample"), TEXT("Total"), ToMB(Report.GetTotal()),
+        NumSamples > 0 ? double(Report.GetTotal()) / NumSamples : 0.0);
+}
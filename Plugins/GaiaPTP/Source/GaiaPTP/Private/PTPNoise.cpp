@@ -0,0 +1,432 @@
+#include "PTPNoise.h"
+#include "Async/ParallelFor.h"
+#include "Math/RandomStream.h"
+#include "PTPProfiling.h"
+#include "PTPSimd.h"
+
+namespace
+{
+    constexpr float F3 = 1.0f / 3.0f;
+    constexpr float G3 = 1.0f / 6.0f;
+    constexpr float OutputScale = 32.0f;
+
+    /** Noise is compute bound; smaller chunks balance better than the streaming ChunkSize. */
+    constexpr int32 NoiseChunkSize = 1024;
+
+    // Cube-edge gradients (Perlin 2002)
+    const float Grad3[12][3] = {
+        { 1, 1, 0 }, { -1, 1, 0 }, { 1, -1, 0 }, { -1, -1, 0 },
+        { 1, 0, 1 }, { -1, 0, 1 }, { 1, 0, -1 }, { -1, 0, -1 },
+        { 0, 1, 1 }, { 0, -1, 1 }, { 0, 1, -1 }, { 0, -1, -1 }
+    };
+
+    // Per-octave / per-warp-axis offsets decorrelate layers sharing one permutation table
+    FORCEINLINE FVector3f OctaveOffset(int32 Octave) { return FVector3f(Octave * 17.13f, Octave * -31.71f, Octave * 23.57f); }
+    const FVector3f WarpOffsets[3] = { FVector3f(5.2f, 1.3f, 7.7f), FVector3f(-9.1f, 2.8f, 4.4f), FVector3f(3.6f, -6.5f, 8.9f) };
+
+    FORCEINLINE int32 GradientIndex(const uint8* Perm, int32 I, int32 J, int32 K)
+    {
+        return Perm[(I & 255) + Perm[(J & 255) + Perm[K & 255]]] % 12;
+    }
+
+    /** Four positions in SoA registers. */
+    struct FLanes3
+    {
+        VectorRegister4Float X, Y, Z;
+    };
+
+    FORCEINLINE VectorRegister4Float Splat(float V) { return VectorSetFloat1(V); }
+
+    /** Contribution of one simplex corner (scalar). */
+    FORCEINLINE float Corner(float X, float Y, float Z, const float* G, FVector3f& InOutGradient)
+    {
+        const float T = FMath::Max(0.6f - (X * X + Y * Y + Z * Z), 0.0f);
+        const float T2 = T * T;
+        const float T4 = T2 * T2;
+        const float GDot = G[0] * X + G[1] * Y + G[2] * Z;
+        const float DT = -8.0f * T2 * T * GDot;
+        InOutGradient.X += DT * X + T4 * G[0];
+        InOutGradient.Y += DT * Y + T4 * G[1];
+        InOutGradient.Z += DT * Z + T4 * G[2];
+        return T4 * GDot;
+    }
+
+    /** Contribution of one simplex corner (4 lanes). */
+    FORCEINLINE VectorRegister4Float CornerLanes(const FLanes3& C, const FLanes3& G, FLanes3& InOutGradient)
+    {
+        const VectorRegister4Float R2 = VectorAdd(VectorAdd(VectorMultiply(C.X, C.X), VectorMultiply(C.Y, C.Y)), VectorMultiply(C.Z, C.Z));
+        const VectorRegister4Float T = VectorMax(VectorSubtract(Splat(0.6f), R2), VectorZeroFloat());
+        const VectorRegister4Float T2 = VectorMultiply(T, T);
+        const VectorRegister4Float T4 = VectorMultiply(T2, T2);
+        const VectorRegister4Float GDot = VectorAdd(VectorAdd(VectorMultiply(G.X, C.X), VectorMultiply(G.Y, C.Y)), VectorMultiply(G.Z, C.Z));
+        const VectorRegister4Float DT = VectorMultiply(VectorMultiply(VectorMultiply(Splat(-8.0f), T2), T), GDot);
+        InOutGradient.X = VectorAdd(InOutGradient.X, VectorAdd(VectorMultiply(DT, C.X), VectorMultiply(T4, G.X)));
+        InOutGradient.Y = VectorAdd(InOutGradient.Y, VectorAdd(VectorMultiply(DT, C.Y), VectorMultiply(T4, G.Y)));
+        InOutGradient.Z = VectorAdd(InOutGradient.Z, VectorAdd(VectorMultiply(DT, C.Z), VectorMultiply(T4, G.Z)));
+        return VectorMultiply(T4, GDot);
+    }
+
+    /** Gather one corner's gradient vectors for all lanes (hash lookups are per lane). */
+    FORCEINLINE FLanes3 GatherGradients(const uint8* Perm, const float* Fi, const float* Fj, const float* Fk,
+                                        const float* Di, const float* Dj, const float* Dk)
+    {
+        float Gx[4], Gy[4], Gz[4];
+        for (int32 L = 0; L < PTPSimd::Lanes; ++L)
+        {
+            const int32 I = (int32)Fi[L] + (int32)Di[L];
+            const int32 J = (int32)Fj[L] + (int32)Dj[L];
+            const int32 K = (int32)Fk[L] + (int32)Dk[L];
+            const float* G = Grad3[GradientIndex(Perm, I, J, K)];
+            Gx[L] = G[0]; Gy[L] = G[1]; Gz[L] = G[2];
+        }
+        return { VectorLoad(Gx), VectorLoad(Gy), VectorLoad(Gz) };
+    }
+
+    /** 4-lane simplex noise; mirrors FPTPNoise::Simplex operation for operation. */
+    VectorRegister4Float SimplexLanes(const uint8* Perm, const FLanes3& P, FLanes3& OutGradient)
+    {
+        const VectorRegister4Float Zero = VectorZeroFloat();
+        const VectorRegister4Float One = VectorOneFloat();
+
+        const VectorRegister4Float S = VectorMultiply(VectorAdd(VectorAdd(P.X, P.Y), P.Z), Splat(F3));
+        const VectorRegister4Float Fi = VectorFloor(VectorAdd(P.X, S));
+        const VectorRegister4Float Fj = VectorFloor(VectorAdd(P.Y, S));
+        const VectorRegister4Float Fk = VectorFloor(VectorAdd(P.Z, S));
+        const VectorRegister4Float T = VectorMultiply(VectorAdd(VectorAdd(Fi, Fj), Fk), Splat(G3));
+
+        FLanes3 C0;
+        C0.X = VectorSubtract(P.X, VectorSubtract(Fi, T));
+        C0.Y = VectorSubtract(P.Y, VectorSubtract(Fj, T));
+        C0.Z = VectorSubtract(P.Z, VectorSubtract(Fk, T));
+
+        // Branch-free simplex corner ordering (same truth table as the scalar path)
+        const VectorRegister4Float XY = VectorCompareGE(C0.X, C0.Y);
+        const VectorRegister4Float YZ = VectorCompareGE(C0.Y, C0.Z);
+        const VectorRegister4Float XZ = VectorCompareGE(C0.X, C0.Z);
+        const VectorRegister4Float I1 = VectorSelect(VectorBitwiseAnd(XY, XZ), One, Zero);
+        const VectorRegister4Float J1 = VectorSelect(YZ, VectorSelect(XY, Zero, One), Zero);
+        const VectorRegister4Float K1 = VectorSelect(XZ, Zero, VectorSelect(YZ, Zero, One));
+        const VectorRegister4Float I2 = VectorSelect(VectorBitwiseOr(XY, XZ), One, Zero);
+        const VectorRegister4Float J2 = VectorSelect(YZ, One, VectorSelect(XY, Zero, One));
+        const VectorRegister4Float K2 = VectorSelect(VectorBitwiseAnd(XZ, YZ), Zero, One);
+
+        FLanes3 C1, C2, C3;
+        C1.X = VectorAdd(VectorSubtract(C0.X, I1), Splat(G3));
+        C1.Y = VectorAdd(VectorSubtract(C0.Y, J1), Splat(G3));
+        C1.Z = VectorAdd(VectorSubtract(C0.Z, K1), Splat(G3));
+        C2.X = VectorAdd(VectorSubtract(C0.X, I2), Splat(2.0f * G3));
+        C2.Y = VectorAdd(VectorSubtract(C0.Y, J2), Splat(2.0f * G3));
+        C2.Z = VectorAdd(VectorSubtract(C0.Z, K2), Splat(2.0f * G3));
+        C3.X = VectorAdd(VectorSubtract(C0.X, One), Splat(3.0f * G3));
+        C3.Y = VectorAdd(VectorSubtract(C0.Y, One), Splat(3.0f * G3));
+        C3.Z = VectorAdd(VectorSubtract(C0.Z, One), Splat(3.0f * G3));
+
+        alignas(16) float AFi[4], AFj[4], AFk[4], AI1[4], AJ1[4], AK1[4], AI2[4], AJ2[4], AK2[4];
+        const float ZeroOff[4] = { 0, 0, 0, 0 };
+        const float OneOff[4] = { 1, 1, 1, 1 };
+        VectorStoreAligned(Fi, AFi); VectorStoreAligned(Fj, AFj); VectorStoreAligned(Fk, AFk);
+        VectorStoreAligned(I1, AI1); VectorStoreAligned(J1, AJ1); VectorStoreAligned(K1, AK1);
+        VectorStoreAligned(I2, AI2); VectorStoreAligned(J2, AJ2); VectorStoreAligned(K2, AK2);
+
+        const FLanes3 G0 = GatherGradients(Perm, AFi, AFj, AFk, ZeroOff, ZeroOff, ZeroOff);
+        const FLanes3 G1 = GatherGradients(Perm, AFi, AFj, AFk, AI1, AJ1, AK1);
+        const FLanes3 G2 = GatherGradients(Perm, AFi, AFj, AFk, AI2, AJ2, AK2);
+        const FLanes3 G3v = GatherGradients(Perm, AFi, AFj, AFk, OneOff, OneOff, OneOff);
+
+        FLanes3 Grad = { Zero, Zero, Zero };
+        const VectorRegister4Float N0 = CornerLanes(C0, G0, Grad);
+        const VectorRegister4Float N1 = CornerLanes(C1, G1, Grad);
+        const VectorRegister4Float N2 = CornerLanes(C2, G2, Grad);
+        const VectorRegister4Float N3 = CornerLanes(C3, G3v, Grad);
+
+        const VectorRegister4Float Scale = Splat(OutputScale);
+        OutGradient.X = VectorMultiply(Grad.X, Scale);
+        OutGradient.Y = VectorMultiply(Grad.Y, Scale);
+        OutGradient.Z = VectorMultiply(Grad.Z, Scale);
+        return VectorMultiply(VectorAdd(VectorAdd(VectorAdd(N0, N1), N2), N3), Scale);
+    }
+
+    FORCEINLINE FLanes3 ScaleOffset(const FLanes3& P, float Scale, const FVector3f& Offset)
+    {
+        const VectorRegister4Float S = Splat(Scale);
+        return { VectorAdd(VectorMultiply(P.X, S), Splat(Offset.X)),
+                 VectorAdd(VectorMultiply(P.Y, S), Splat(Offset.Y)),
+                 VectorAdd(VectorMultiply(P.Z, S), Splat(Offset.Z)) };
+    }
+
+    /** 4-lane octave sum; mirrors FPTPNoise::Octaves. */
+    VectorRegister4Float OctavesLanes(const uint8* Perm, EPTPNoiseType Type, const FLanes3& P, const FPTPNoiseSettings& Settings, FLanes3& OutGradient)
+    {
+        const VectorRegister4Float Zero = VectorZeroFloat();
+        const VectorRegister4Float One = VectorOneFloat();
+
+        if (Type == EPTPNoiseType::Simplex)
+        {
+            FLanes3 G;
+            const VectorRegister4Float N = SimplexLanes(Perm, ScaleOffset(P, Settings.Frequency, FVector3f::ZeroVector), G);
+            const VectorRegister4Float F = Splat(Settings.Frequency);
+            OutGradient = { VectorMultiply(G.X, F), VectorMultiply(G.Y, F), VectorMultiply(G.Z, F) };
+            return N;
+        }
+
+        VectorRegister4Float Sum = Zero;
+        FLanes3 Grad = { Zero, Zero, Zero };
+        float Amp = 1.0f;
+        float Freq = Settings.Frequency;
+        float Norm = 0.0f;
+        for (int32 Octave = 0; Octave < FMath::Max(1, Settings.Octaves); ++Octave)
+        {
+            FLanes3 G;
+            const VectorRegister4Float N = SimplexLanes(Perm, ScaleOffset(P, Freq, OctaveOffset(Octave)), G);
+            if (Type == EPTPNoiseType::Fbm)
+            {
+                Sum = VectorAdd(Sum, VectorMultiply(Splat(Amp), N));
+                const VectorRegister4Float W = Splat(Amp * Freq);
+                Grad.X = VectorAdd(Grad.X, VectorMultiply(G.X, W));
+                Grad.Y = VectorAdd(Grad.Y, VectorMultiply(G.Y, W));
+                Grad.Z = VectorAdd(Grad.Z, VectorMultiply(G.Z, W));
+            }
+            else
+            {
+                const VectorRegister4Float A = VectorSubtract(One, VectorAbs(N));
+                Sum = VectorAdd(Sum, VectorMultiply(Splat(Amp), VectorMultiply(A, A)));
+                const VectorRegister4Float Sign = VectorSelect(VectorCompareGE(N, Zero), One, Splat(-1.0f));
+                const VectorRegister4Float W = VectorMultiply(VectorMultiply(Splat(-2.0f * Amp * Freq), A), Sign);
+                Grad.X = VectorAdd(Grad.X, VectorMultiply(G.X, W));
+                Grad.Y = VectorAdd(Grad.Y, VectorMultiply(G.Y, W));
+                Grad.Z = VectorAdd(Grad.Z, VectorMultiply(G.Z, W));
+            }
+            Norm += Amp;
+            Amp *= Settings.Gain;
+            Freq *= Settings.Lacunarity;
+        }
+
+        const VectorRegister4Float InvNorm = Splat(1.0f / Norm);
+        OutGradient = { VectorMultiply(Grad.X, InvNorm), VectorMultiply(Grad.Y, InvNorm), VectorMultiply(Grad.Z, InvNorm) };
+        return VectorMultiply(Sum, InvNorm);
+    }
+}
+
+FPTPNoise::FPTPNoise(int32 Seed)
+{
+    FRandomStream Rand(Seed);
+    uint8 Base[256];
+    for (int32 i = 0; i < 256; ++i)
+    {
+        Base[i] = static_cast<uint8>(i);
+    }
+    // Fisher-Yates shuffle for a seed-dependent permutation
+    for (int32 i = 255; i > 0; --i)
+    {
+        const int32 j = Rand.RandRange(0, i);
+        Swap(Base[i], Base[j]);
+    }
+    for (int32 i = 0; i < 512; ++i)
+    {
+        Perm[i] = Base[i & 255];
+    }
+}
+
+float FPTPNoise::Simplex(const FVector3f& P, FVector3f* OutGradient) const
+{
+    const float S = ((P.X + P.Y) + P.Z) * F3;
+    const float Fi = FMath::FloorToFloat(P.X + S);
+    const float Fj = FMath::FloorToFloat(P.Y + S);
+    const float Fk = FMath::FloorToFloat(P.Z + S);
+    const float T = ((Fi + Fj) + Fk) * G3;
+
+    const float X0 = P.X - (Fi - T);
+    const float Y0 = P.Y - (Fj - T);
+    const float Z0 = P.Z - (Fk - T);
+
+    const bool XY = X0 >= Y0;
+    const bool YZ = Y0 >= Z0;
+    const bool XZ = X0 >= Z0;
+    const float I1 = (XY && XZ) ? 1.0f : 0.0f;
+    const float J1 = (!XY && YZ) ? 1.0f : 0.0f;
+    const float K1 = (!XZ && !YZ) ? 1.0f : 0.0f;
+    const float I2 = (XY || XZ) ? 1.0f : 0.0f;
+    const float J2 = (!XY || YZ) ? 1.0f : 0.0f;
+    const float K2 = (XZ && YZ) ? 0.0f : 1.0f;
+
+    const int32 I = (int32)Fi;
+    const int32 J = (int32)Fj;
+    const int32 K = (int32)Fk;
+
+    FVector3f Grad = FVector3f::ZeroVector;
+    const float N0 = Corner(X0, Y0, Z0, Grad3[GradientIndex(Perm, I, J, K)], Grad);
+    const float N1 = Corner((X0 - I1) + G3, (Y0 - J1) + G3, (Z0 - K1) + G3,
+                            Grad3[GradientIndex(Perm, I + (int32)I1, J + (int32)J1, K + (int32)K1)], Grad);
+    const float N2 = Corner((X0 - I2) + 2.0f * G3, (Y0 - J2) + 2.0f * G3, (Z0 - K2) + 2.0f * G3,
+                            Grad3[GradientIndex(Perm, I + (int32)I2, J + (int32)J2, K + (int32)K2)], Grad);
+    const float N3 = Corner((X0 - 1.0f) + 3.0f * G3, (Y0 - 1.0f) + 3.0f * G3, (Z0 - 1.0f) + 3.0f * G3,
+                            Grad3[GradientIndex(Perm, I + 1, J + 1, K + 1)], Grad);
+
+    if (OutGradient)
+    {
+        *OutGradient = Grad * OutputScale;
+    }
+    return (((N0 + N1) + N2) + N3) * OutputScale;
+}
+
+float FPTPNoise::Octaves(EPTPNoiseType Type, const FVector3f& P, const FPTPNoiseSettings& Settings, FVector3f& OutGradient) const
+{
+    if (Type == EPTPNoiseType::Simplex)
+    {
+        FVector3f G;
+        const float N = Simplex(P * Settings.Frequency, &G);
+        OutGradient = G * Settings.Frequency;
+        return N;
+    }
+
+    float Sum = 0.0f;
+    FVector3f Grad = FVector3f::ZeroVector;
+    float Amp = 1.0f;
+    float Freq = Settings.Frequency;
+    float Norm = 0.0f;
+    for (int32 Octave = 0; Octave < FMath::Max(1, Settings.Octaves); ++Octave)
+    {
+        FVector3f G;
+        const FVector3f Offset = OctaveOffset(Octave);
+        const float N = Simplex(FVector3f(P.X * Freq + Offset.X, P.Y * Freq + Offset.Y, P.Z * Freq + Offset.Z), &G);
+        if (Type == EPTPNoiseType::Fbm)
+        {
+            Sum += Amp * N;
+            Grad += G * (Amp * Freq);
+        }
+        else
+        {
+            // Ridged: (1 - |n|)^2, d/dp = -2 (1 - |n|) sign(n) dn/dp
+            const float A = 1.0f - FMath::Abs(N);
+            Sum += Amp * (A * A);
+            const float Sign = N >= 0.0f ? 1.0f : -1.0f;
+            Grad += G * ((-2.0f * Amp * Freq) * A * Sign);
+        }
+        Norm += Amp;
+        Amp *= Settings.Gain;
+        Freq *= Settings.Lacunarity;
+    }
+
+    const float InvNorm = 1.0f / Norm;
+    OutGradient = Grad * InvNorm;
+    return Sum * InvNorm;
+}
+
+float FPTPNoise::Evaluate(EPTPNoiseType Type, const FVector3f& P, const FPTPNoiseSettings& Settings, FVector3f* OutGradient) const
+{
+    const bool bWarp = Settings.WarpAmplitude != 0.0f;
+
+    FVector3f Q = P;
+    FVector3f WarpGrad[3];
+    if (bWarp)
+    {
+        // q = p + A * w(p * fw); warp components are independent single simplex octaves
+        float W[3];
+        for (int32 Axis = 0; Axis < 3; ++Axis)
+        {
+            const FVector3f& O = WarpOffsets[Axis];
+            W[Axis] = Simplex(FVector3f(P.X * Settings.WarpFrequency + O.X, P.Y * Settings.WarpFrequency + O.Y, P.Z * Settings.WarpFrequency + O.Z), &WarpGrad[Axis]);
+        }
+        Q = FVector3f(P.X + Settings.WarpAmplitude * W[0], P.Y + Settings.WarpAmplitude * W[1], P.Z + Settings.WarpAmplitude * W[2]);
+    }
+
+    FVector3f GradQ;
+    const float Value = Octaves(Type, Q, Settings, GradQ);
+
+    if (OutGradient)
+    {
+        FVector3f Grad = GradQ;
+        if (bWarp)
+        {
+            // Chain rule: grad_p = J^T grad_q with J = I + A * fw * dW/dp
+            const float K = Settings.WarpAmplitude * Settings.WarpFrequency;
+            Grad += (WarpGrad[0] * GradQ.X + WarpGrad[1] * GradQ.Y + WarpGrad[2] * GradQ.Z) * K;
+        }
+        *OutGradient = Grad;
+    }
+    return Value;
+}
+
+void FPTPNoise::EvaluateLanes(EPTPNoiseType Type, const FVector3f* Positions, const FPTPNoiseSettings& Settings, float* OutValues, FVector3f* OutGradients) const
+{
+    FLanes3 P;
+    P.X = MakeVectorRegister(Positions[0].X, Positions[1].X, Positions[2].X, Positions[3].X);
+    P.Y = MakeVectorRegister(Positions[0].Y, Positions[1].Y, Positions[2].Y, Positions[3].Y);
+    P.Z = MakeVectorRegister(Positions[0].Z, Positions[1].Z, Positions[2].Z, Positions[3].Z);
+
+    const bool bWarp = Settings.WarpAmplitude != 0.0f;
+    FLanes3 Q = P;
+    FLanes3 WarpGrad[3];
+    if (bWarp)
+    {
+        VectorRegister4Float W[3];
+        for (int32 Axis = 0; Axis < 3; ++Axis)
+        {
+            W[Axis] = SimplexLanes(Perm, ScaleOffset(P, Settings.WarpFrequency, WarpOffsets[Axis]), WarpGrad[Axis]);
+        }
+        const VectorRegister4Float A = Splat(Settings.WarpAmplitude);
+        Q.X = VectorAdd(P.X, VectorMultiply(A, W[0]));
+        Q.Y = VectorAdd(P.Y, VectorMultiply(A, W[1]));
+        Q.Z = VectorAdd(P.Z, VectorMultiply(A, W[2]));
+    }
+
+    FLanes3 GradQ;
+    const VectorRegister4Float Value = OctavesLanes(Perm, Type, Q, Settings, GradQ);
+    VectorStore(Value, OutValues);
+
+    if (OutGradients)
+    {
+        FLanes3 Grad = GradQ;
+        if (bWarp)
+        {
+            const VectorRegister4Float K = Splat(Settings.WarpAmplitude * Settings.WarpFrequency);
+            auto Row = [&](VectorRegister4Float FLanes3::* Axis)
+            {
+                const VectorRegister4Float Sum = VectorAdd(VectorAdd(
+                    VectorMultiply(WarpGrad[0].*Axis, GradQ.X),
+                    VectorMultiply(WarpGrad[1].*Axis, GradQ.Y)),
+                    VectorMultiply(WarpGrad[2].*Axis, GradQ.Z));
+                return VectorAdd(GradQ.*Axis, VectorMultiply(Sum, K));
+            };
+            Grad.X = Row(&FLanes3::X);
+            Grad.Y = Row(&FLanes3::Y);
+            Grad.Z = Row(&FLanes3::Z);
+        }
+
+        alignas(16) float Gx[4], Gy[4], Gz[4];
+        VectorStoreAligned(Grad.X, Gx);
+        VectorStoreAligned(Grad.Y, Gy);
+        VectorStoreAligned(Grad.Z, Gz);
+        for (int32 L = 0; L < PTPSimd::Lanes; ++L)
+        {
+            OutGradients[L] = FVector3f(Gx[L], Gy[L], Gz[L]);
+        }
+    }
+}
+
+void FPTPNoise::EvaluateBatch(EPTPNoiseType Type, TConstArrayView<FVector3f> Positions, const FPTPNoiseSettings& Settings,
+                              TArrayView<float> OutValues, TArrayView<FVector3f> OutGradients) const
+{
+    const int32 Num = Positions.Num();
+    check(OutValues.Num() == Num);
+    const bool bGradients = OutGradients.Num() > 0;
+    check(!bGradients || OutGradients.Num() == Num);
+
+    const bool bDoParallel = PTPProfiling::IsParallelEnabled();
+
+    ParallelFor(PTPSimd::NumChunks(Num, NoiseChunkSize), [&](int32 ChunkIdx)
+    {
+        const int32 Begin = ChunkIdx * NoiseChunkSize;
+        const int32 End = FMath::Min(Begin + NoiseChunkSize, Num);
+        const int32 VectorEnd = Begin + ((End - Begin) / PTPSimd::Lanes) * PTPSimd::Lanes;
+
+        for (int32 i = Begin; i < VectorEnd; i += PTPSimd::Lanes)
+        {
+            EvaluateLanes(Type, &Positions[i], Settings, &OutValues[i], bGradients ? &OutGradients[i] : nullptr);
+        }
+        for (int32 i = VectorEnd; i < End; ++i)
+        {
+            OutValues[i] = Evaluate(Type, Positions[i], Settings, bGradients ? &OutGradients[i] : nullptr);
+        }
+    }, !bDoParallel);
+}
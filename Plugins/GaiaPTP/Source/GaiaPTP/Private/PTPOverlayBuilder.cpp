@@ -0,0 +1,181 @@
+#include "PTPOverlayBuilder.h"
+#include "PTPProfiling.h"
+#include "PTPSimd.h"
+#include "PTPVisualizationLayers.h"
+#include "TectonicData.h"
+#include "Core/RealtimeMeshDataStream.h"
+#include "Core/RealtimeMeshDataTypes.h"
+
+using namespace RealtimeMesh;
+
+namespace
+{
+    /** Views over freshly sized overlay streams; every ribbon has a fixed vertex and triangle count. */
+    struct FRibbonStreams
+    {
+        TArrayView<FVector3f> Positions;
+        TArrayView<FRealtimeMeshTangentsNormalPrecision> Tangents;
+        TArrayView<FColor> Colors;
+        TArrayView<TIndex3<uint32>> Triangles;
+
+        FRibbonStreams(int32 NumVertices, int32 NumTriangles, FRealtimeMeshStreamSet& OutStreams)
+        {
+            OutStreams = FRealtimeMeshStreamSet();
+            FRealtimeMeshStream& PositionStream = OutStreams.AddStream<FVector3f>(FRealtimeMeshStreams::Position);
+            FRealtimeMeshStream& TangentStream = OutStreams.AddStream<FRealtimeMeshTangentsNormalPrecision>(FRealtimeMeshStreams::Tangents);
+            FRealtimeMeshStream& ColorStream = OutStreams.AddStream<FColor>(FRealtimeMeshStreams::Color);
+            FRealtimeMeshStream& TexCoordStream = OutStreams.AddStream<FRealtimeMeshTexCoordsNormal>(FRealtimeMeshStreams::TexCoords);
+            FRealtimeMeshStream& TriangleStream = OutStreams.AddStream<TIndex3<uint32>>(FRealtimeMeshStreams::Triangles);
+            PositionStream.SetNumUninitialized(NumVertices);
+            TangentStream.SetNumUninitialized(NumVertices);
+            ColorStream.SetNumUninitialized(NumVertices);
+            TexCoordStream.SetNumZeroed(NumVertices);
+            TriangleStream.SetNumUninitialized(NumTriangles);
+
+            Positions = PositionStream.GetArrayView<FVector3f>();
+            Tangents = TangentStream.GetArrayView<FRealtimeMeshTangentsNormalPrecision>();
+            Colors = ColorStream.GetArrayView<FColor>();
+            Triangles = TriangleStream.GetArrayView<TIndex3<uint32>>();
+        }
+    };
+}
+
+int32 FPTPOverlayBuilder::ChooseArrowStride(int32 NumPoints, double CameraDistance, double Radius, int32 TargetArrows)
+{
+    if (NumPoints <= 0 || Radius <= 0.0)
+    {
+        return 1;
+    }
+
+    // Area of the cap seen from CameraDistance over the sphere area; half the sphere from infinity
+    const double Distance = FMath::Max(CameraDistance, Radius * 1.001);
+    const double CapFraction = 0.5 * (1.0 - Radius / Distance);
+    const double Stride = NumPoints * CapFraction / FMath::Max(1, TargetArrows);
+    return Stride < 2.0 ? 1 : 1 << FMath::FloorLog2((uint32)FMath::Min(Stride, (double)NumPoints));
+}
+
+void FPTPOverlayBuilder::GatherVelocityArrows(const FPTPLayerSource& Source, int32 Stride, const FVector3f& ViewDir, float MinCos,
+                                              TArray<FPTPOverlayArrow>& OutArrows)
+{
+    OutArrows.Reset();
+    Stride = FMath::Max(1, Stride);
+    for (int32 i = 0; i < Source.Points.Num(); i += Stride)
+    {
+        const int32 PlateId = Source.PlateIds.IsValidIndex(i) ? Source.PlateIds[i] : INDEX_NONE;
+        if (!Source.Plates.IsValidIndex(PlateId))
+        {
+            continue;
+        }
+        const FVector3f& P = Source.Points[i];
+        if (MinCos > -1.0f && FVector3f::DotProduct(P.GetSafeNormal(), ViewDir) < MinCos)
+        {
+            continue;
+        }
+        OutArrows.Add({ P, FVector3f(Source.Plates[PlateId].GetVelocityAtPoint(FVector(P))) });
+    }
+}
+
+void FPTPOverlayBuilder::GatherBoundarySegments(const FPTPLayerSource& Source, const TArray<TArray<int32>>& Neighbors, TArray<FPTPOverlaySegment>& OutSegments)
+{
+    OutSegments.Reset();
+    const int32 NumPoints = FMath::Min(Source.BoundaryTypes.Num(), FMath::Min(Source.Points.Num(), Neighbors.Num()));
+    for (int32 i = 0; i < NumPoints; ++i)
+    {
+        if (Source.BoundaryTypes[i] == EPTPBoundaryType::None)
+        {
+            continue;
+        }
+        const FColor Color = FPTPVisualizationLayers::SampleColor(EPTPVisualizationLayer::BoundaryType, Source, i);
+        for (int32 n : Neighbors[i])
+        {
+            if (n > i && n < NumPoints && Source.BoundaryTypes[n] != EPTPBoundaryType::None
+                && Source.PlateIds.IsValidIndex(n) && Source.PlateIds.IsValidIndex(i) && Source.PlateIds[n] == Source.PlateIds[i])
+            {
+                OutSegments.Add({ Source.Points[i], Source.Points[n], Color });
+            }
+        }
+    }
+}
+
+void FPTPOverlayBuilder::BuildArrows(TConstArrayView<FPTPOverlayArrow> Arrows, const FPTPOverlayStyle& Style, float Scale, FRealtimeMeshStreamSet& OutStreams)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, OverlayArrows);
+
+    FRibbonStreams Out(Arrows.Num() * 7, Arrows.Num() * 3, OutStreams);
+    const float HalfWidth = Style.Width * 0.5f;
+    const float InvMaxSpeed = 1.0f / FMath::Max(Style.MaxSpeedMmPerYear, UE_SMALL_NUMBER);
+
+    PTPSimd::ForEachRange(Arrows.Num(), PTPProfiling::IsParallelEnabled(), [&](int32 Begin, int32 End)
+    {
+        for (int32 a = Begin; a < End; ++a)
+        {
+            const FPTPOverlayArrow& Arrow = Arrows[a];
+            const FVector3f Up = Arrow.Origin.GetSafeNormal();
+            const float Speed = Arrow.Velocity.Size();
+            const FVector3f Dir = Speed > UE_SMALL_NUMBER ? Arrow.Velocity / Speed : FVector3f::ZeroVector;
+            const FVector3f Side = FVector3f::CrossProduct(Up, Dir);
+            const float Length = Speed * Style.KmPerMmPerYear;
+            const FVector3f O = Arrow.Origin + Up * Style.Lift;
+            const FVector3f S = O + Dir * (Length * 0.7f);
+
+            // Shaft quad and head triangle, counter-clockwise about Up; zero speed collapses to a point
+            const int32 V = a * 7;
+            Out.Positions[V + 0] = (O - Side * HalfWidth) * Scale;
+            Out.Positions[V + 1] = (S - Side * HalfWidth) * Scale;
+            Out.Positions[V + 2] = (S + Side * HalfWidth) * Scale;
+            Out.Positions[V + 3] = (O + Side * HalfWidth) * Scale;
+            Out.Positions[V + 4] = (S - Side * Style.Width) * Scale;
+            Out.Positions[V + 5] = (O + Dir * Length) * Scale;
+            Out.Positions[V + 6] = (S + Side * Style.Width) * Scale;
+
+            const FRealtimeMeshTangentsNormalPrecision Frame(Up, Dir);
+            const FColor Color = FPTPVisualizationLayers::RampColor(Speed * InvMaxSpeed);
+            for (int32 k = 0; k < 7; ++k)
+            {
+                Out.Tangents[V + k] = Frame;
+                Out.Colors[V + k] = Color;
+            }
+
+            Out.Triangles[a * 3 + 0] = TIndex3<uint32>(V + 0, V + 1, V + 2);
+            Out.Triangles[a * 3 + 1] = TIndex3<uint32>(V + 0, V + 2, V + 3);
+            Out.Triangles[a * 3 + 2] = TIndex3<uint32>(V + 4, V + 5, V + 6);
+        }
+    });
+}
+
+void FPTPOverlayBuilder::BuildSegments(TConstArrayView<FPTPOverlaySegment> Segments, const FPTPOverlayStyle& Style, float Scale, FRealtimeMeshStreamSet& OutStreams)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, OverlaySegments);
+
+    FRibbonStreams Out(Segments.Num() * 4, Segments.Num() * 2, OutStreams);
+    const float HalfWidth = Style.Width * 0.5f;
+
+    PTPSimd::ForEachRange(Segments.Num(), PTPProfiling::IsParallelEnabled(), [&](int32 Begin, int32 End)
+    {
+        for (int32 s = Begin; s < End; ++s)
+        {
+            const FPTPOverlaySegment& Segment = Segments[s];
+            const FVector3f Up = (Segment.A + Segment.B).GetSafeNormal();
+            const FVector3f Dir = (Segment.B - Segment.A).GetSafeNormal();
+            const FVector3f Side = FVector3f::CrossProduct(Up, Dir) * HalfWidth;
+            const FVector3f A = Segment.A + Up * Style.Lift;
+            const FVector3f B = Segment.B + Up * Style.Lift;
+
+            const int32 V = s * 4;
+            Out.Positions[V + 0] = (A - Side) * Scale;
+            Out.Positions[V + 1] = (B - Side) * Scale;
+            Out.Positions[V + 2] = (B + Side) * Scale;
+            Out.Positions[V + 3] = (A + Side) * Scale;
+
+            const FRealtimeMeshTangentsNormalPrecision Frame(Up, Dir);
+            for (int32 k = 0; k < 4; ++k)
+            {
+                Out.Tangents[V + k] = Frame;
+                Out.Colors[V + k] = Segment.Color;
+            }
+
+            Out.Triangles[s * 2 + 0] = TIndex3<uint32>(V + 0, V + 1, V + 2);
+            Out.Triangles[s * 2 + 1] = TIndex3<uint32>(V + 0, V + 2, V + 3);
+        }
+    });
+}
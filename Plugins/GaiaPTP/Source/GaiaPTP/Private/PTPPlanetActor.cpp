@@ -4,25 +4,78 @@
 #include "RealtimeMeshSimple.h"
 #include "RealtimeMeshLibrary.h"
 #include "PTPProfiling.h"
-#include "IPTPAdjacencyProvider.h"
-#include "CrustInitialization.h"
+#include "PTPPlanetRebuild.h"
+#include "PTPPlanetMeshBuilder.h"
+#include "RealtimeMeshDataOptimizer.h"
+#include "Materials/MaterialInterface.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Camera/PlayerCameraManager.h"
+#include "ConvexVolume.h"
+#include "Kismet/GameplayStatics.h"
+#include "SceneManagement.h"
+#if WITH_EDITOR
+#include "Framework/Notifications/NotificationManager.h"
+#include "Widgets/Notifications/SNotificationList.h"
+#endif
 
 using namespace RealtimeMesh;
-#include "Core/RealtimeMeshBuilder.h"
+
+namespace
+{
+    FRealtimeMeshSectionGroupKey SurfaceGroupKey(int32 LODIndex = 0)
+    {
+        return FRealtimeMeshSectionGroupKey::Create(FRealtimeMeshLODKey(LODIndex), FName("PTPSurface"));
+    }
+
+    // Edge length of /Engine/BasicShapes/Plane, the instanced point marker
+    constexpr float PointQuadSize = 100.0f;
+
+    SIZE_T GetStreamBytes(const FRealtimeMeshStreamSet& Streams)
+    {
+        SIZE_T Bytes = 0;
+        Streams.ForEach([&Bytes](const FRealtimeMeshStream& Stream) { Bytes += Stream.GetAllocatedSize(); });
+        return Bytes;
+    }
+
+    int32 GetBytesPerVertex(const FRealtimeMeshStreamSet& Streams)
+    {
+        int32 Bytes = 0;
+        Streams.ForEach([&Bytes](const FRealtimeMeshStream& Stream)
+        {
+            Bytes += Stream.GetStreamType() == ERealtimeMeshStreamType::Vertex ? Stream.GetStride() : 0;
+        });
+        return Bytes;
+    }
+}
 
 APTPPlanetActor::APTPPlanetActor()
 {
-    PrimaryActorTick.bCanEverTick = false;
+    PrimaryActorTick.bCanEverTick = true;  // per-chunk culling against the player camera
     RealtimeMesh = CreateDefaultSubobject<URealtimeMeshComponent>(TEXT("RealtimeMesh"));
     SetRootComponent(RealtimeMesh);
 
-    // Disable culling - planet is huge and should always be visible
+    // No draw distance on the component: the planet stays visible from any range. Sections behind the
+    // horizon or off screen are hidden per chunk (UpdateChunkVisibility), or not at all without chunks
     RealtimeMesh->SetCullDistance(0.0f); // 0 = never cull
     RealtimeMesh->bUseAsOccluder = false;
     RealtimeMesh->CastShadow = false; // Disable shadows for performance
 
     Planet = CreateDefaultSubobject<UPTPPlanetComponent>(TEXT("Planet"));
 
+    PointInstances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("PointInstances"));
+    PointInstances->SetupAttachment(RealtimeMesh);
+    PointInstances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    PointInstances->SetCullDistances(0, 0);
+    PointInstances->CastShadow = false;
+    PointInstances->NumCustomDataFloats = FPTPVisualizationLayers::NumInstanceCustomData;
+    static ConstructorHelpers::FObjectFinder<UStaticMesh> PointQuadFinder(TEXT("/Engine/BasicShapes/Plane"));
+    if (PointQuadFinder.Succeeded())
+    {
+        PointInstances->SetStaticMesh(PointQuadFinder.Object);
+    }
+
     // Load default planet material (vertex colored)
     static ConstructorHelpers::FObjectFinder<UMaterialInterface> MaterialFinder(
         TEXT("/Game/Materials/Dev/M_DevPlanet")
@@ -45,21 +98,12 @@ void APTPPlanetActor::BeginPlay()
         return;
     }
 
-    // Smart rebuild: only regenerate if data is missing or stale
-    const bool bNeedsRebuild = (Planet->SamplePoints.Num() != Planet->NumSamplePoints);
-    const bool bNeedsAdjacency = (Planet->Triangles.Num() == 0);
-
-    if (bNeedsRebuild)
-    {
-        UE_LOG(LogTemp, Warning, TEXT("PTP: Rebuilding planet (sample count changed: %d -> %d)"),
-            Planet->SamplePoints.Num(), Planet->NumSamplePoints);
-        Planet->RebuildPlanet();
-        BuildAdjacency(); // Need new adjacency after rebuild
-    }
-    else if (bNeedsAdjacency)
+    // Smart rebuild: only the stages invalidated by changed settings rerun; the mesh follows when the rebuild lands
+    if (!Planet->IsUpToDate(true))
     {
-        UE_LOG(LogTemp, Warning, TEXT("PTP: Building missing adjacency (no triangulation data)"));
-        BuildAdjacency();
+        UE_LOG(LogTemp, Warning, TEXT("PTP: Rebuilding stale planet stages (%d points, %d triangles cached, %d points requested)"),
+            Planet->SamplePoints.Num(), Planet->Triangles.Num(), Planet->NumSamplePoints);
+        RequestRebuild();
     }
     else
     {
@@ -67,8 +111,9 @@ void APTPPlanetActor::BeginPlay()
             Planet->SamplePoints.Num(), Planet->Triangles.Num());
     }
 
-    // Always rebuild mesh (lightweight operation)
-    RebuildMesh();
+    // Cached data may carry new plate ids or elevations; geometry is only rebuilt if it is stale
+    MarkMeshDirty(EPTPMeshDirtyFlags::Color | EPTPMeshDirtyFlags::Scalar);
+    RefreshMesh();
 
     UE_LOG(LogTemp, Log, TEXT("PTPPlanetActor: BeginPlay complete - mesh should be visible"));
 }
@@ -82,252 +127,516 @@ void APTPPlanetActor::OnConstruction(const FTransform& Transform)
         return;
     }
 
-    // Smart rebuild: only regenerate if data is missing or stale
-    const bool bNeedsRebuild = (Planet->SamplePoints.Num() != Planet->NumSamplePoints);
-    const bool bNeedsAdjacency = (Planet->Triangles.Num() == 0);
+    // Smart rebuild: regenerate the invalidated stages off the game thread. Repeated construction
+    // with the same settings joins the rebuild in flight; new settings cancel it
+    if (!Planet->IsUpToDate(true))
+    {
+        RequestRebuild();
+    }
+    else
+    {
+        UE_LOG(LogTemp, Log, TEXT("PTP: OnConstruction using cached planet data (%d points, %d triangles)"),
+            Planet->SamplePoints.Num(), Planet->Triangles.Num());
+    }
+
+    // Cached data may carry new plate ids or elevations; geometry is only rebuilt if it is stale
+    MarkMeshDirty(EPTPMeshDirtyFlags::Color | EPTPMeshDirtyFlags::Scalar);
+    RefreshMesh();
+}
 
-    if (bNeedsRebuild)
+void APTPPlanetActor::RefreshMesh()
+{
+    if (!Planet || DirtyFlags == EPTPMeshDirtyFlags::None)
     {
-        UE_LOG(LogTemp, Log, TEXT("PTP: OnConstruction rebuilding planet (sample count changed: %d -> %d)"),
-            Planet->SamplePoints.Num(), Planet->NumSamplePoints);
-        Planet->RebuildPlanet();
-        BuildAdjacency(); // Need new adjacency after rebuild
+        return;
     }
-    else if (bNeedsAdjacency)
+
+    if (EnumHasAnyFlags(DirtyFlags, EPTPMeshDirtyFlags::Geometry) || !IsGeometryResident())
     {
-        UE_LOG(LogTemp, Log, TEXT("PTP: OnConstruction building missing adjacency"));
-        BuildAdjacency();
+        RebuildMesh();
     }
     else
     {
-        UE_LOG(LogTemp, Log, TEXT("PTP: OnConstruction using cached planet data (%d points, %d triangles)"),
-            Planet->SamplePoints.Num(), Planet->Triangles.Num());
+        UpdateMeshAttributes(DirtyFlags);
+        ApplyLayerMaterialParameters();
+    }
+    DirtyFlags = EPTPMeshDirtyFlags::None;
+}
+
+void APTPPlanetActor::SetVisualizationLayer(EPTPVisualizationLayer Layer)
+{
+    if (Layer == VisualizationLayer)
+    {
+        return;
     }
+    VisualizationLayer = Layer;
+    MarkMeshDirty(FPTPVisualizationLayers::IsScalar(Layer) ? EPTPMeshDirtyFlags::Scalar : EPTPMeshDirtyFlags::Color);
+    RefreshMesh();
+}
 
-    // Always rebuild mesh (lightweight operation)
-    RebuildMesh();
+void APTPPlanetActor::ApplyLayerMaterialParameters()
+{
+    if (PlanetMaterialInstance)
+    {
+        PlanetMaterialInstance->SetScalarParameterValue(FPTPVisualizationLayers::ScalarLayerParameter,
+            FPTPVisualizationLayers::IsScalar(VisualizationLayer) ? 1.0f : 0.0f);
+    }
 }
 
-void APTPPlanetActor::RebuildMesh()
+void APTPPlanetActor::FillAttributes(EPTPMeshDirtyFlags Flags, const FPTPPlanetMeshLayout& Layout, FRealtimeMeshStream* ColorStream,
+                                     FRealtimeMeshStream* TexCoordStream) const
 {
-    if (!Planet)
+    const FPTPLayerSource Source = FPTPLayerSource::FromPlanet(*Planet);
+    const bool bScalarLayer = FPTPVisualizationLayers::IsScalar(VisualizationLayer);
+
+    // The material draws scalar layers from TexCoord0.V, so the colour stream falls back to plate colours under them
+    if (EnumHasAnyFlags(Flags, EPTPMeshDirtyFlags::Color) && ColorStream)
+    {
+        FPTPVisualizationLayers::FillColors(bScalarLayer ? EPTPVisualizationLayer::PlateId : VisualizationLayer, Layout, Source, *ColorStream);
+    }
+    if (EnumHasAnyFlags(Flags, EPTPMeshDirtyFlags::Scalar) && TexCoordStream)
+    {
+        FPTPPlanetMeshBuilder::FillElevations(Layout, Planet->CrustData, *TexCoordStream);
+        FPTPVisualizationLayers::FillScalars(bScalarLayer ? VisualizationLayer : EPTPVisualizationLayer::Elevation, Layout, Source, *TexCoordStream);
+    }
+}
+
+bool APTPPlanetActor::IsGeometryResident() const
+{
+    if (ResidentLayout.NumVertices == 0 || ResidentMode != PreviewMode || ResidentGeometryHash != Planet->GetStageHashes().GetGeometryHash())
+    {
+        return false;
+    }
+
+    const int32 NumPoints = Planet->SamplePoints.Num();
+    if (PreviewMode == EPTPPreviewMode::Points)
+    {
+        const int32 Stride = FMath::Max(1, Planet->DebugDrawStride);
+        return ResidentLayout.SampleStride == Stride
+            && ResidentScale == Planet->VisualizationScale
+            && ResidentLayout.NumVertices == (NumPoints + Stride - 1) / Stride
+            && PointInstances->GetInstanceCount() == ResidentLayout.NumVertices;
+    }
+    return RealtimeMesh->GetRealtimeMeshAs<URealtimeMeshSimple>()
+        && ResidentScale == Planet->VisualizationScale
+        && ResidentLayout.NumVertices == NumPoints
+        && ResidentLayout.NumTriangles == Planet->Triangles.Num()
+        && ResidentChunkLevel == (bChunkCulling ? ChunkLevel : INDEX_NONE)
+        && ResidentSimplifiedLODs == NumSimplifiedLODs
+        && (NumSimplifiedLODs == 0 || ResidentLODPixelError == LODPixelError);
+}
+
+void APTPPlanetActor::BuildSurfaceLODs(URealtimeMeshSimple* RMSimple, const FRealtimeMeshStreamSet& Streams)
+{
+    ResidentSimplifiedLODs = NumSimplifiedLODs;
+    ResidentLODPixelError = LODPixelError;
+    if (NumSimplifiedLODs <= 0)
     {
         return;
     }
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, PreviewLODChain);
 
-        if (URealtimeMeshSimple* RMSimple = RealtimeMesh->InitializeRealtimeMesh<URealtimeMeshSimple>())
+    // Chunks are simplified independently with locked borders, so every LOD keeps one section per chunk
+    TArray<FRealtimeMeshStreamRange> Ranges;
+    TArray<int32> SectionIds;
+    if (bChunkCulling)
+    {
+        for (int32 Chunk = 0; Chunk < Chunks.GetNumChunks(); ++Chunk)
         {
-            CSV_SCOPED_TIMING_STAT(GAIA_PTP, PreviewBuild);
-            const TArray<FVector>& Pts = Planet->SamplePoints;
-            const TArray<int32>& PlateIds = Planet->PointPlateIds;
-            if (Pts.Num() == 0)
+            if (Chunks.GetChunkBegin(Chunk) != Chunks.GetChunkEnd(Chunk))
             {
-                return;
+                Ranges.Add(FRealtimeMeshStreamRange(0, ResidentLayout.NumVertices, Chunks.GetChunkBegin(Chunk) * 3, Chunks.GetChunkEnd(Chunk) * 3));
+                SectionIds.Add(Chunk);
             }
+        }
+    }
 
-            // Remove inactive preview group to avoid double rendering
-            const FRealtimeMeshSectionGroupKey PointsGroupKey = FRealtimeMeshSectionGroupKey::Create(0, FName("PTPPreview"));
-            const FRealtimeMeshSectionGroupKey SurfaceGroupKey = FRealtimeMeshSectionGroupKey::Create(0, FName("PTPSurface"));
+    FRealtimeMeshLODChainSettings Settings;
+    Settings.NumLODs = NumSimplifiedLODs;
+    Settings.MaxError = 0.02f;
+    Settings.MaxPixelError = LODPixelError;
+    Settings.NormalWeight = 0.0f;     // normals are radial; position error already covers them
+    Settings.ColorWeight = 1.0f;      // keep plate boundaries where they are
+    Settings.TexCoordWeight = 0.1f;   // elevation in km
+    const TArray<FRealtimeMeshSimplifiedLOD> LODs = URealtimeMeshDataOptimizer::GenerateLODChain(Streams, Ranges, Settings);
+    URealtimeMeshDataOptimizer::ApplyLODChain(RMSimple, SurfaceGroupKey(), Streams, LODs, SectionIds);
+
+    // Attribute refreshes write every LOD, so keep each LOD's vertex -> sample mapping
+    const int32 BytesPerVertex = GetBytesPerVertex(Streams);
+    for (const FRealtimeMeshSimplifiedLOD& LOD : LODs)
+    {
+        ResidentMeshBytes += SIZE_T(LOD.SourceVertices.Num()) * BytesPerVertex + LOD.Indices.Num() * sizeof(uint32);
+        FPTPPlanetMeshLayout& Layout = ResidentLODLayouts.AddDefaulted_GetRef();
+        Layout.NumVertices = LOD.SourceVertices.Num();
+        Layout.NumTriangles = LOD.Indices.Num() / 3;
+        Layout.VertexSamples.SetNumUninitialized(Layout.NumVertices);
+        for (int32 v = 0; v < Layout.NumVertices; ++v)
+        {
+            Layout.VertexSamples[v] = ResidentLayout.VertexToSample(LOD.SourceVertices[v]);
+        }
+        UE_LOG(LogTemp, Log, TEXT("PTP: Surface LOD %d - %d triangles, screen size %.3f"),
+            ResidentLODLayouts.Num(), Layout.NumTriangles, LOD.ScreenSize);
+    }
+}
 
-            if (PreviewMode == EPTPPreviewMode::Points)
-            {
-                RMSimple->RemoveSectionGroup(SurfaceGroupKey);
-            }
-            else
+void APTPPlanetActor::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+    UpdateChunkVisibility();
+}
+
+void APTPPlanetActor::BeginDestroy()
+{
+    FPTPMemory::UpdateStats(ReportedMemory, FPTPMemoryReport());
+    Super::BeginDestroy();
+}
+
+FPTPMemoryReport APTPPlanetActor::GetPreviewMemoryReport() const
+{
+    FPTPMemoryReport Report;
+    Report[EPTPMemoryBucket::MeshStreams] = ResidentMeshBytes;
+    Report[EPTPMemoryBucket::Chunks] = Chunks.GetAllocatedSize() + ChunkVisible.GetAllocatedSize()
+        + ResidentLayout.VertexSamples.GetAllocatedSize() + ResidentLODLayouts.GetAllocatedSize();
+    for (const FPTPPlanetMeshLayout& Layout : ResidentLODLayouts)
+    {
+        Report[EPTPMemoryBucket::Chunks] += Layout.VertexSamples.GetAllocatedSize();
+    }
+    return Report;
+}
+
+FPTPMemoryReport APTPPlanetActor::GetMemoryReport() const
+{
+    FPTPMemoryReport Report = GetPreviewMemoryReport();
+    if (Planet)
+    {
+        Report += Planet->GetMemoryReport();
+    }
+    return Report;
+}
+
+void APTPPlanetActor::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+    Super::GetResourceSizeEx(CumulativeResourceSize);
+    const FPTPMemoryReport Preview = GetPreviewMemoryReport();
+    CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Preview.GetTotal());
+    // The RMC uploads the same streams once more
+    CumulativeResourceSize.AddDedicatedVideoMemoryBytes(Preview[EPTPMemoryBucket::MeshStreams]);
+}
+
+void APTPPlanetActor::UpdateMemoryStats()
+{
+    if (HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+    {
+        return;
+    }
+    FPTPMemory::UpdateStats(ReportedMemory, GetPreviewMemoryReport());
+    FPTPMemory::CheckBudget(GetMemoryReport(), GetActorNameOrLabel());
+}
+
+void APTPPlanetActor::UpdateChunkVisibility()
+{
+    if (ResidentChunkLevel == INDEX_NONE || ResidentMode != EPTPPreviewMode::Surface || ChunkVisible.Num() != Chunks.GetNumChunks())
+    {
+        return;
+    }
+    URealtimeMeshSimple* RMSimple = RealtimeMesh->GetRealtimeMeshAs<URealtimeMeshSimple>();
+    APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(this, 0);
+    if (!RMSimple || !CameraManager)
+    {
+        return;
+    }
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, ChunkCulling);
+
+    // Bring the camera and its frustum into mesh-local space, where the chunk bounds live
+    const FMinimalViewInfo& View = CameraManager->GetCameraCacheView();
+    FMatrix ViewMatrix, ProjectionMatrix, ViewProjectionMatrix;
+    UGameplayStatics::GetViewProjectionMatrix(View, ViewMatrix, ProjectionMatrix, ViewProjectionMatrix);
+    const FTransform& LocalToWorld = RealtimeMesh->GetComponentTransform();
+    FConvexVolume FrustumLocal;
+    GetViewFrustumBounds(FrustumLocal, LocalToWorld.ToMatrixWithScale() * ViewProjectionMatrix, false);
+    const FVector CameraLocal = LocalToWorld.InverseTransformPosition(View.Location);
+
+    TBitArray<> Visible;
+    Chunks.ComputeVisibility(CameraLocal, &FrustumLocal, Visible);
+
+    // Only toggled sections are sent to the render thread; every LOD carries the same chunk sections
+    for (int32 Chunk = 0; Chunk < Visible.Num(); ++Chunk)
+    {
+        if (Visible[Chunk] != ChunkVisible[Chunk] && Chunks.GetChunkBegin(Chunk) != Chunks.GetChunkEnd(Chunk))
+        {
+            for (int32 LODIndex = 0; LODIndex <= ResidentLODLayouts.Num(); ++LODIndex)
             {
-                RMSimple->RemoveSectionGroup(PointsGroupKey);
+                RMSimple->SetSectionVisibility(FRealtimeMeshSectionKey::Create(SurfaceGroupKey(LODIndex), Chunk), Visible[Chunk]);
             }
+            ChunkVisible[Chunk] = Visible[Chunk];
+        }
+    }
+}
 
-            auto PlateColor = [](int32 PlateId) -> FColor
-            {
-                // Better hash mixing for small integers (MurmurHash3 finalizer)
-                uint32 h = PlateId;
-                h = ((h >> 16) ^ h) * 0x45d9f3b;
-                h = ((h >> 16) ^ h) * 0x45d9f3b;
-                h = (h >> 16) ^ h;
+void APTPPlanetActor::UpdateMeshAttributes(EPTPMeshDirtyFlags Flags)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, PreviewAttributeUpdate);
+
+    if (ResidentMode == EPTPPreviewMode::Points)
+    {
+        // Colour and scalar share the instance custom data
+        UpdatePointInstanceData();
+        return;
+    }
 
-                uint8 r = (uint8)((h      ) & 0xFF);
-                uint8 g = (uint8)((h >> 8 ) & 0xFF);
-                uint8 b = (uint8)((h >> 16) & 0xFF);
+    URealtimeMeshSimple* RMSimple = RealtimeMesh->GetRealtimeMeshAs<URealtimeMeshSimple>();
 
-                // Map to pastel range: 64-191 (avoids very dark and very bright)
-                return FColor(r/2 + 64, g/2 + 64, b/2 + 64, 255);
-            };
+    // Only the streams returned here are copied and sent to the render thread
+    for (int32 LODIndex = 0; LODIndex <= ResidentLODLayouts.Num(); ++LODIndex)
+    {
+        const FPTPPlanetMeshLayout& Layout = LODIndex == 0 ? ResidentLayout : ResidentLODLayouts[LODIndex - 1];
+        RMSimple->EditMeshInPlace(SurfaceGroupKey(LODIndex), [&](FRealtimeMeshStreamSet& Streams)
+        {
+            TSet<FRealtimeMeshStreamKey> Updated;
 
-            if (PreviewMode == EPTPPreviewMode::Points)
+            FRealtimeMeshStream* ColorStream = Streams.Find(FRealtimeMeshStreams::Color);
+            if (!EnumHasAnyFlags(Flags, EPTPMeshDirtyFlags::Color) || !ColorStream || ColorStream->Num() != Layout.NumVertices)
             {
-                const int32 Stride = FMath::Max(1, Planet->DebugDrawStride);
-                FRealtimeMeshStreamSet StreamSet;
-                RealtimeMesh::TRealtimeMeshBuilderLocal<uint32, FPackedNormal, FVector2DHalf, 1> Builder(StreamSet);
-                Builder.EnableTangents();
-                Builder.EnableColors();
-
-                const float Radius = Planet->PlanetRadiusKm;
-                const float Scale = Planet->VisualizationScale;
-                const float MarkerSize = Radius * 0.01f; // 1% of radius (pre-scale)
-
-                for (int32 i = 0; i < Pts.Num(); i += Stride)
-                {
-                    const FVector N = Pts[i].GetSafeNormal(); // Normal from original point
-                    const FVector P = Pts[i] * Scale; // Apply visualization scale
-                    FVector T = FVector::CrossProduct(N, FVector::UpVector);
-                    if (T.IsNearlyZero()) T = FVector::CrossProduct(N, FVector::RightVector);
-                    T.Normalize();
-                    const FVector B = FVector::CrossProduct(N, T);
-
-                    const FVector V0 = P + ( T + B) * MarkerSize * Scale * 0.5f;
-                    const FVector V1 = P + (-T + B) * MarkerSize * Scale * 0.5f;
-                    const FVector V2 = P + (-T - B) * MarkerSize * Scale * 0.5f;
-                    const FVector V3 = P + ( T - B) * MarkerSize * Scale * 0.5f;
-
-                    const FVector3f Nf = FVector3f(N);
-                    const FVector3f Tf = FVector3f(T);
-                    const FColor C = PlateIds.IsValidIndex(i) ? PlateColor(PlateIds[i]) : FColor::Cyan;
-
-                    int32 i0 = Builder.AddVertex(FVector3f(V0)).SetNormalAndTangent(Nf, Tf).SetColor(C);
-                    int32 i1 = Builder.AddVertex(FVector3f(V1)).SetNormalAndTangent(Nf, Tf).SetColor(C);
-                    int32 i2 = Builder.AddVertex(FVector3f(V2)).SetNormalAndTangent(Nf, Tf).SetColor(C);
-                    int32 i3 = Builder.AddVertex(FVector3f(V3)).SetNormalAndTangent(Nf, Tf).SetColor(C);
-
-                    // Front-facing
-                    Builder.AddTriangle(i0, i1, i2);
-                    Builder.AddTriangle(i0, i2, i3);
-                    // Back-facing (double-sided so all markers remain visible)
-                    Builder.AddTriangle(i2, i1, i0);
-                    Builder.AddTriangle(i3, i2, i0);
-                }
-
-                RMSimple->CreateSectionGroup(PointsGroupKey, StreamSet);
-
-                // Apply material
-                if (PlanetMaterial)
-                {
-                    RealtimeMesh->SetMaterial(0, PlanetMaterial);
-                }
+                ColorStream = nullptr;
             }
-            else // Surface
+            FRealtimeMeshStream* TexCoordStream = Streams.Find(FRealtimeMeshStreams::TexCoords);
+            if (!EnumHasAnyFlags(Flags, EPTPMeshDirtyFlags::Scalar) || !TexCoordStream || TexCoordStream->Num() != Layout.NumVertices)
             {
-                // Surface mode requires adjacency - use BuildAdjacency() button to generate triangulation
-                if (Planet->Triangles.Num() > 0)
-                {
-                    FRealtimeMeshStreamSet StreamSet;
-                    RealtimeMesh::TRealtimeMeshBuilderLocal<uint32, FPackedNormal, FVector2DHalf, 1> Builder(StreamSet);
-                    Builder.EnableTangents();
-                    Builder.EnableColors();
-
-                    const float Scale = Planet->VisualizationScale;
-
-                    // Build vertex buffer once (shared vertices)
-                    for (int32 i = 0; i < Pts.Num(); ++i)
-                    {
-                        const FVector N = Pts[i].GetSafeNormal(); // Normal from original point
-                        const FVector P = Pts[i] * Scale; // Apply visualization scale
-                        FVector T = FVector::CrossProduct(N, FVector::UpVector);
-                        if (T.IsNearlyZero()) T = FVector::CrossProduct(N, FVector::RightVector);
-                        T.Normalize();
-
-                        const FColor C = PlateIds.IsValidIndex(i) ? PlateColor(PlateIds[i]) : FColor::Cyan;
-
-                        Builder.AddVertex(FVector3f(P))
-                            .SetNormalAndTangent(FVector3f(N), FVector3f(T))
-                            .SetColor(C);
-                    }
-
-                    // Build index buffer (triangles reference existing vertices)
-                    for (const FIntVector& Tri : Planet->Triangles)
-                    {
-                        const int32 ia = Tri.X; const int32 ib = Tri.Y; const int32 ic = Tri.Z;
-                        if (Pts.IsValidIndex(ia) && Pts.IsValidIndex(ib) && Pts.IsValidIndex(ic))
-                        {
-                            // Front-facing
-                            Builder.AddTriangle(ia, ib, ic);
-                            // Back-facing (double-sided for preview reliability)
-                            Builder.AddTriangle(ic, ib, ia);
-                        }
-                    }
-
-                    RMSimple->CreateSectionGroup(SurfaceGroupKey, StreamSet);
-
-                    // Apply material
-                    if (PlanetMaterial)
-                    {
-                        RealtimeMesh->SetMaterial(0, PlanetMaterial);
-                    }
-
-                    UE_LOG(LogTemp, Log, TEXT("PTP: Surface rendered - %d vertices, %d triangles"),
-                        Pts.Num(), Planet->Triangles.Num());
-                }
+                TexCoordStream = nullptr;
             }
-        }
+
+            FillAttributes(Flags, Layout, ColorStream, TexCoordStream);
+            if (ColorStream)
+            {
+                Updated.Add(FRealtimeMeshStreams::Color);
+            }
+            if (TexCoordStream)
+            {
+                Updated.Add(FRealtimeMeshStreams::TexCoords);
+            }
+            return Updated;
+        });
+    }
 }
 
-void APTPPlanetActor::BuildAdjacency()
+void APTPPlanetActor::RebuildMesh()
 {
     if (!Planet)
     {
         return;
     }
+    LLM_SCOPE_BYTAG(GaiaPTP);
 
-    const int32 NumPoints = Planet->SamplePoints.Num();
-
-    // Estimate based on point count
-    FString TimeEstimate;
-    if (NumPoints < 5000)
-        TimeEstimate = TEXT("< 1 second");
-    else if (NumPoints < 20000)
-        TimeEstimate = TEXT("1-5 seconds");
-    else if (NumPoints < 100000)
-        TimeEstimate = TEXT("10-30 seconds");
-    else
-        TimeEstimate = TEXT("1-5 minutes");
+    ResidentLayout = FPTPPlanetMeshLayout();
+    ResidentMeshBytes = 0;
+    ResidentChunkLevel = INDEX_NONE;
+    ResidentSimplifiedLODs = 0;
+    ResidentLODLayouts.Reset();
+    ChunkVisible.Reset();
 
-    UE_LOG(LogTemp, Warning, TEXT("PTP: Building adjacency for %d points... (estimated: %s)"), NumPoints, *TimeEstimate);
+    if (PreviewMode == EPTPPreviewMode::Points)
+    {
+        // The markers live entirely in the instance buffer; only drop the surface when leaving it
+        if (ResidentMode != EPTPPreviewMode::Points)
+        {
+            RealtimeMesh->InitializeRealtimeMesh<URealtimeMeshSimple>();
+        }
+        RebuildPointInstances();
+        UpdateMemoryStats();
+        return;
+    }
+    PointInstances->ClearInstances();
 
-    TSharedPtr<IPTPAdjacencyProvider> Provider = CreateCGALAdjacencyProvider();
-    FPTPAdjacency Adj;
-    FString Error;
-    if (!Provider.IsValid())
+    URealtimeMeshSimple* RMSimple = RealtimeMesh->InitializeRealtimeMesh<URealtimeMeshSimple>();
+    const TArray<FVector3f>& Pts = Planet->SamplePoints;
+    if (!RMSimple || Pts.Num() == 0 || Planet->Triangles.Num() == 0)
     {
-        UE_LOG(LogTemp, Error, TEXT("PTP: No adjacency provider available."));
+        // Surface mode requires adjacency - use BuildAdjacency() button to generate triangulation
+        UpdateMemoryStats();
         return;
     }
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, PreviewBuild);
+
+    if (bChunkCulling && !Chunks.IsBuiltFor(Pts.Num(), Planet->Triangles.Num(), ChunkLevel, Planet->VisualizationScale))
+    {
+        Chunks.Build(Pts, Planet->Triangles, ChunkLevel, Planet->VisualizationScale);
+    }
+    FRealtimeMeshStreamSet StreamSet;
+    ResidentLayout = FPTPPlanetMeshBuilder::BuildSurface(Pts, Planet->Triangles, Planet->VisualizationScale, StreamSet,
+        bChunkCulling ? Chunks.GetTriangleOrder() : TConstArrayView<int32>());
+    ResidentMeshBytes = GetStreamBytes(StreamSet);
+
+    FillAttributes(EPTPMeshDirtyFlags::All, ResidentLayout, StreamSet.Find(FRealtimeMeshStreams::Color), StreamSet.Find(FRealtimeMeshStreams::TexCoords));
+    BuildSurfaceLODs(RMSimple, StreamSet);
+
+    // Streams are handed over; the section group keeps its own copy for in-place attribute edits
+    const FRealtimeMeshSectionGroupKey GroupKey = SurfaceGroupKey();
+    const bool bChunked = bChunkCulling;
+    RMSimple->CreateSectionGroup(GroupKey, MoveTemp(StreamSet), FRealtimeMeshSectionGroupConfig(), !bChunked);
+    ResidentMode = PreviewMode;
+    ResidentScale = Planet->VisualizationScale;
+    ResidentGeometryHash = Planet->GetStageHashes().GetGeometryHash();
+    ResidentChunkLevel = bChunked ? ChunkLevel : INDEX_NONE;
+
+    if (bChunked)
+    {
+        // One section per chunk over its slice of the chunk-ordered index buffer; all start visible
+        for (int32 Chunk = 0; Chunk < Chunks.GetNumChunks(); ++Chunk)
+        {
+            const int32 Begin = Chunks.GetChunkBegin(Chunk);
+            const int32 End = Chunks.GetChunkEnd(Chunk);
+            if (Begin == End)
+            {
+                continue;
+            }
+            RMSimple->CreateSection(FRealtimeMeshSectionKey::Create(GroupKey, Chunk), FRealtimeMeshSectionConfig(0),
+                FRealtimeMeshStreamRange(0, ResidentLayout.NumVertices, Begin * 3, End * 3));
+        }
+        ChunkVisible.Init(true, Chunks.GetNumChunks());
+    }
+
+    // Apply material
+    if (PlanetMaterial)
+    {
+        if (!PlanetMaterialInstance || PlanetMaterialInstance->Parent != PlanetMaterial)
+        {
+            PlanetMaterialInstance = UMaterialInstanceDynamic::Create(PlanetMaterial, this);
+        }
+        ApplyLayerMaterialParameters();
+        RealtimeMesh->SetMaterial(0, PlanetMaterialInstance);
+        if (!PlanetMaterial->IsTwoSided())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("PTP: PlanetMaterial '%s' is not two-sided; back faces of the preview mesh will be culled"),
+                *PlanetMaterial->GetName());
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("PTP: Preview rendered - %d vertices, %d triangles"),
+        ResidentLayout.NumVertices, ResidentLayout.NumTriangles);
+    UpdateMemoryStats();
+}
 
-    const double StartTime = FPlatformTime::Seconds();
-    if (!Provider->Build(Planet->SamplePoints, Adj, Error))
+void APTPPlanetActor::RebuildPointInstances()
+{
+    const TArray<FVector3f>& Pts = Planet->SamplePoints;
+    if (Pts.Num() == 0)
     {
-        UE_LOG(LogTemp, Error, TEXT("PTP: Adjacency build failed: %s"), *Error);
+        PointInstances->ClearInstances();
         return;
     }
-    const double ElapsedTime = FPlatformTime::Seconds() - StartTime;
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, PreviewBuild);
+
+    TArray<FTransform> Transforms;
+    const float MarkerSize = Planet->PlanetRadiusKm * 0.01f; // 1% of radius (pre-scale)
+    ResidentLayout = FPTPPlanetMeshBuilder::BuildPointInstances(Pts, Planet->DebugDrawStride, MarkerSize, Planet->VisualizationScale,
+        PointQuadSize, Transforms);
+
+    // A scale change keeps the instance count, so the transforms are overwritten in place
+    if (PointInstances->GetInstanceCount() == Transforms.Num())
+    {
+        PointInstances->BatchUpdateInstancesTransforms(0, Transforms, false, false);
+    }
+    else
+    {
+        PointInstances->ClearInstances();
+        PointInstances->AddInstances(Transforms, false, false);
+    }
+    if (PointMaterial)
+    {
+        PointInstances->SetMaterial(0, PointMaterial);
+    }
+    ResidentMode = EPTPPreviewMode::Points;
+    ResidentScale = Planet->VisualizationScale;
+    ResidentGeometryHash = Planet->GetStageHashes().GetGeometryHash();
+    UpdatePointInstanceData();
+
+    UE_LOG(LogTemp, Log, TEXT("PTP: Point preview rendered - %d instances (stride %d)"),
+        ResidentLayout.NumVertices, ResidentLayout.SampleStride);
+}
+
+void APTPPlanetActor::UpdatePointInstanceData()
+{
+    // Written in place and uploaded by one render state update; SetCustomData per instance would
+    // track every instance separately
+    TArray<float>& CustomData = PointInstances->PerInstanceSMCustomData;
+    CustomData.SetNumUninitialized(ResidentLayout.NumVertices * FPTPVisualizationLayers::NumInstanceCustomData);
+    FPTPVisualizationLayers::FillInstanceCustomData(VisualizationLayer, ResidentLayout, FPTPLayerSource::FromPlanet(*Planet), CustomData);
+    PointInstances->MarkRenderStateDirty();
+}
+
+void APTPPlanetActor::BuildAdjacency()
+{
+    RequestRebuild();
+}
 
-    UE_LOG(LogTemp, Warning, TEXT("PTP: Adjacency built successfully in %.2f seconds (%d triangles)"), ElapsedTime, Adj.Triangles.Num());
+void APTPPlanetActor::RequestRebuild()
+{
+    if (!Planet)
+    {
+        return;
+    }
+    if (!Planet->OnRebuildCompleted.IsBoundToObject(this))
+    {
+        Planet->OnRebuildProgress.AddUObject(this, &APTPPlanetActor::HandleRebuildProgress);
+        Planet->OnRebuildCompleted.AddUObject(this, &APTPPlanetActor::HandleRebuildCompleted);
+    }
+    Planet->RebuildPlanetAsync(true);
+}
 
-    Planet->Neighbors = MoveTemp(Adj.Neighbors);
-    Planet->Triangles = MoveTemp(Adj.Triangles);
-    Planet->NumTriangles = Planet->Triangles.Num();
+void APTPPlanetActor::HandleRebuildProgress(EPTPRebuildStage Stage, float Progress)
+{
+    const FText Text = FText::Format(NSLOCTEXT("GaiaPTP", "RebuildProgress", "Rebuilding planet: {0} ({1}%)"),
+        StaticEnum<EPTPRebuildStage>()->GetDisplayNameTextByValue((int64)Stage), FText::AsNumber(FMath::RoundToInt(Progress * 100.0f)));
+    // The notification carries progress; the log only needs it when tracing a rebuild
+    UE_LOG(LogTemp, Verbose, TEXT("PTP: %s"), *Text.ToString());
 
-    // Task 1.14: Detect plate boundaries
-    if (Planet->PointPlateIds.Num() > 0)
+#if WITH_EDITOR
+    if (!GIsEditor)
+    {
+        return;
+    }
+    if (TSharedPtr<SNotificationItem> Item = RebuildNotification.Pin())
+    {
+        Item->SetText(Text);
+        return;
+    }
+    FNotificationInfo Info(Text);
+    Info.bFireAndForget = false;
+    Info.ExpireDuration = 2.0f;
+    TSharedPtr<SNotificationItem> Item = FSlateNotificationManager::Get().AddNotification(Info);
+    if (Item.IsValid())
     {
-        FCrustInitialization::DetectPlateBoundaries(
-            Planet->PointPlateIds,
-            Planet->Neighbors,
-            Planet->IsBoundaryPoint
-        );
+        Item->SetCompletionState(SNotificationItem::CS_Pending);
+    }
+    RebuildNotification = Item;
+#endif
+}
 
-        // Count boundary points for logging
-        int32 BoundaryCount = 0;
-        for (bool bIsBoundary : Planet->IsBoundaryPoint)
+void APTPPlanetActor::HandleRebuildCompleted(bool bSucceeded)
+{
+    if (bSucceeded)
+    {
+        // Geometry is rebuilt only if samples or triangulation changed; otherwise the attribute streams are edited in place
+        HandleRebuildProgress(EPTPRebuildStage::Mesh, FPTPPlanetRebuild::GetStageProgress(EPTPRebuildStage::Mesh));
+        if (ResidentGeometryHash != Planet->GetStageHashes().GetGeometryHash())
         {
-            if (bIsBoundary) BoundaryCount++;
+            Chunks.Reset();
         }
-
-        UE_LOG(LogTemp, Log, TEXT("PTP: Detected %d boundary points (%.1f%%)"),
-            BoundaryCount, 100.0f * BoundaryCount / FMath::Max(1, NumPoints));
+        MarkMeshDirty(EPTPMeshDirtyFlags::Color | EPTPMeshDirtyFlags::Scalar);
+        RefreshMesh();
+        UE_LOG(LogTemp, Log, TEXT("PTP: Planet rebuilt (%d points, %d triangles)"), Planet->SamplePoints.Num(), Planet->Triangles.Num());
     }
 
-    // Refresh mesh to show new triangulation
-    RebuildMesh();
+#if WITH_EDITOR
+    if (TSharedPtr<SNotificationItem> Item = RebuildNotification.Pin())
+    {
+        Item->SetText(bSucceeded ? NSLOCTEXT("GaiaPTP", "RebuildDone", "Planet rebuilt")
+                                 : NSLOCTEXT("GaiaPTP", "RebuildStopped", "Planet rebuild cancelled or failed"));
+        Item->SetCompletionState(bSucceeded ? SNotificationItem::CS_Success : SNotificationItem::CS_Fail);
+        Item->ExpireAndFadeout();
+    }
+    RebuildNotification.Reset();
+#endif
 }
 
 void APTPPlanetActor::TogglePreviewMode()
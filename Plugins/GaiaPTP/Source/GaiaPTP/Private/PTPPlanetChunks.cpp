@@ -0,0 +1,137 @@
+#include "PTPPlanetChunks.h"
+#include "Async/ParallelFor.h"
+#include "ConvexVolume.h"
+#include "PTPCubeMap.h"
+#include "PTPProfiling.h"
+
+void FPTPPlanetChunks::Build(const TArray<FVector3f>& Points, const TArray<FIntVector>& Triangles, int32 Level, float Scale)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, ChunkBuild);
+
+    Reset();
+    const int32 Resolution = 1 << FMath::Clamp(Level, 0, 10);
+    const int32 NumChunks = FPTPCubeMap::NumFaces * Resolution * Resolution;
+    const int32 NumTris = Triangles.Num();
+
+    // Counting sort of triangles by the leaf holding their centroid
+    TArray<int32> TriangleChunk;
+    TriangleChunk.SetNumUninitialized(NumTris);
+    ChunkStart.Init(0, NumChunks + 1);
+    for (int32 t = 0; t < NumTris; ++t)
+    {
+        const FIntVector& Tri = Triangles[t];
+        const FVector3f Centroid(Points[Tri.X] + Points[Tri.Y] + Points[Tri.Z]);
+        TriangleChunk[t] = FPTPCubeMap::CellId(Centroid, Resolution);
+        ++ChunkStart[TriangleChunk[t] + 1];
+    }
+    for (int32 c = 0; c < NumChunks; ++c)
+    {
+        ChunkStart[c + 1] += ChunkStart[c];
+    }
+    TriangleOrder.SetNumUninitialized(NumTris);
+    TArray<int32> Cursor(ChunkStart.GetData(), NumChunks);
+    for (int32 t = 0; t < NumTris; ++t)
+    {
+        TriangleOrder[Cursor[TriangleChunk[t]]++] = t;
+    }
+
+    Radius = 0.0f;
+    for (const FVector3f& P : Points)
+    {
+        Radius = FMath::Max(Radius, (float)P.Size() * Scale);
+    }
+
+    const bool bDoParallel = PTPProfiling::IsParallelEnabled();
+
+    // Cap around the mean vertex direction; the sphere through the cap rim encloses the bulge for caps up to a hemisphere
+    Bounds.SetNum(NumChunks);
+    ParallelFor(NumChunks, [&](int32 Chunk)
+    {
+        FPTPChunkBounds& B = Bounds[Chunk];
+        FVector3f Sum = FVector3f::ZeroVector;
+        for (int32 k = ChunkStart[Chunk]; k < ChunkStart[Chunk + 1]; ++k)
+        {
+            const FIntVector& Tri = Triangles[TriangleOrder[k]];
+            Sum += FVector3f(Points[Tri.X].GetSafeNormal() + Points[Tri.Y].GetSafeNormal() + Points[Tri.Z].GetSafeNormal());
+        }
+        if (Sum.IsNearlyZero())
+        {
+            return;
+        }
+        B.Axis = Sum.GetSafeNormal();
+
+        float MinCos = 1.0f;
+        for (int32 k = ChunkStart[Chunk]; k < ChunkStart[Chunk + 1]; ++k)
+        {
+            const FIntVector& Tri = Triangles[TriangleOrder[k]];
+            for (int32 v = 0; v < 3; ++v)
+            {
+                MinCos = FMath::Min(MinCos, FVector3f::DotProduct(B.Axis, FVector3f(Points[Tri[v]].GetSafeNormal())));
+            }
+        }
+        B.CosHalfAngle = MinCos;
+        B.SinHalfAngle = FMath::Sqrt(FMath::Max(0.0f, 1.0f - MinCos * MinCos));
+        if (MinCos > 0.0f)
+        {
+            B.SphereCenter = B.Axis * (Radius * MinCos);
+            B.SphereRadius = Radius * B.SinHalfAngle;
+        }
+        else
+        {
+            B.SphereCenter = FVector3f::ZeroVector;
+            B.SphereRadius = Radius;
+        }
+    }, !bDoParallel);
+
+    BuiltLevel = Level;
+    BuiltNumPoints = Points.Num();
+    BuiltNumTriangles = NumTris;
+    BuiltScale = Scale;
+}
+
+void FPTPPlanetChunks::Reset()
+{
+    TriangleOrder.Reset();
+    ChunkStart.Reset();
+    Bounds.Reset();
+    BuiltLevel = INDEX_NONE;
+}
+
+bool FPTPPlanetChunks::IsBuiltFor(int32 NumPoints, int32 NumTriangles, int32 Level, float Scale) const
+{
+    return BuiltLevel == Level && BuiltNumPoints == NumPoints && BuiltNumTriangles == NumTriangles && BuiltScale == Scale;
+}
+
+bool FPTPPlanetChunks::IsAboveHorizon(int32 Chunk, const FVector& CameraLocal) const
+{
+    const FPTPChunkBounds& B = Bounds[Chunk];
+    const float Distance = (float)CameraLocal.Size();
+    if (Distance <= Radius)
+    {
+        return true;
+    }
+
+    // Visible iff the cap reaches within the horizon angle Alpha = acos(R / D) of the camera direction
+    const float CosAlpha = Radius / Distance;
+    const float SinAlpha = FMath::Sqrt(1.0f - CosAlpha * CosAlpha);
+    const float CosSum = B.CosHalfAngle * CosAlpha - B.SinHalfAngle * SinAlpha;
+    if (B.SinHalfAngle * CosAlpha + B.CosHalfAngle * SinAlpha < 0.0f)
+    {
+        return true;  // cap half-angle + horizon angle exceeds PI
+    }
+    return FVector3f::DotProduct(B.Axis, FVector3f(CameraLocal / Distance)) > CosSum;
+}
+
+void FPTPPlanetChunks::ComputeVisibility(const FVector& CameraLocal, const FConvexVolume* FrustumLocal, TBitArray<>& OutVisible) const
+{
+    OutVisible.Init(false, Bounds.Num());
+    for (int32 Chunk = 0; Chunk < Bounds.Num(); ++Chunk)
+    {
+        if (ChunkStart[Chunk] == ChunkStart[Chunk + 1] || !IsAboveHorizon(Chunk, CameraLocal))
+        {
+            continue;
+        }
+        const FPTPChunkBounds& B = Bounds[Chunk];
+        OutVisible[Chunk] = !FrustumLocal || FrustumLocal->IntersectSphere(FVector(B.SphereCenter), B.SphereRadius);
+    }
+}
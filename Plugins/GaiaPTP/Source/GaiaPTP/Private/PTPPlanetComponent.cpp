@@ -1,10 +1,8 @@
 #include "PTPPlanetComponent.h"
+#include "GaiaPTP.h"
 #include "GaiaPTPSettings.h"
-#include "FibonacciSphere.h"
-#include "TectonicSeeding.h"
 #include "TectonicData.h"
-#include "CrustInitialization.h"
-#include "PTPProfiling.h"
+#include "Async/Async.h"
 
 UPTPPlanetComponent::UPTPPlanetComponent()
 {
@@ -15,9 +13,11 @@ UPTPPlanetComponent::UPTPPlanetComponent()
     PlanetRadiusKm = 6370.0f;
     VisualizationScale = 100.0f;
     NumSamplePoints = 500000;
+    bSpatialReorder = true;
     DebugDrawStride = 50;
     NumPlates = 40;
     ContinentalRatio = 0.3f;
+    InitialSeed = 1337;
     HighestOceanicRidgeElevationKm = -1.0f;
     AbyssalPlainElevationKm = -6.0f;
     OceanicTrenchElevationKm = -10.0f;
@@ -42,6 +42,94 @@ void UPTPPlanetComponent::OnRegister()
     {
         ApplyDefaultsFromProjectSettings();
     }
+
+    // Samples saved in double precision do not load into the float array; regenerate everything
+    if (SamplePoints.Num() == 0)
+    {
+        StageHashes = FPTPStageHashes();
+    }
+    RestoreNeighbors();
+
+    // Data saved before plate membership was stored carries plate ids only
+    if (PlateMembership.GetNumPoints() == 0 && PointPlateIds.Num() > 0)
+    {
+        PlateMembership.Build(PointPlateIds, Plates.Num());
+    }
+    UpdateMemoryStats();
+}
+
+void UPTPPlanetComponent::OnUnregister()
+{
+    FPTPMemory::UpdateStats(ReportedMemory, FPTPMemoryReport());
+    Super::OnUnregister();
+}
+
+FPTPMemoryReport UPTPPlanetComponent::GetMemoryReport() const
+{
+    FPTPMemoryReport Report;
+    Report[EPTPMemoryBucket::SamplePoints] = SamplePoints.GetAllocatedSize() + SampleOrder.GetAllocatedSize();
+    Report[EPTPMemoryBucket::PlateIds] = PointPlateIds.GetAllocatedSize() + PlateMembership.GetAllocatedSize();
+    Report[EPTPMemoryBucket::CrustData] = CrustData.GetAllocatedSize();
+    Report[EPTPMemoryBucket::Boundaries] = IsBoundaryPoint.GetAllocatedSize() + BoundaryTypes.GetAllocatedSize() + DistanceToFrontKm.GetAllocatedSize();
+    Report[EPTPMemoryBucket::Neighbors] = FPTPMemory::GetAllocatedSize(Neighbors);
+    Report[EPTPMemoryBucket::Triangles] = Triangles.GetAllocatedSize();
+    Report[EPTPMemoryBucket::Plates] = Plates.GetAllocatedSize();
+    // A scratch shared with a rebuild in flight is being written to; it is counted once that one lands
+    Report[EPTPMemoryBucket::Scratch] = Scratch.IsValid() && Scratch.IsUnique() ? Scratch->GetCapacityBytes() : 0;
+    return Report;
+}
+
+void UPTPPlanetComponent::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+    Super::GetResourceSizeEx(CumulativeResourceSize);
+    CumulativeResourceSize.AddDedicatedSystemMemoryBytes(GetMemoryReport().GetTotal());
+}
+
+void UPTPPlanetComponent::UpdateMemoryStats()
+{
+    // Only registered components count towards the totals; class defaults and archetypes hold no planet
+    if (!IsRegistered())
+    {
+        return;
+    }
+    const FPTPMemoryReport Report = GetMemoryReport();
+    FPTPMemory::UpdateStats(ReportedMemory, Report);
+    FPTPMemory::CheckBudget(Report, GetPathName());
+}
+
+TSharedPtr<FPTPStepScratch> UPTPPlanetComponent::AcquireScratch()
+{
+    // A cancelled async rebuild can still be running on the old scratch; arenas are single-owner
+    if (!Scratch.IsValid() || !Scratch.IsUnique())
+    {
+        Scratch = MakeShared<FPTPStepScratch>();
+    }
+    return Scratch;
+}
+
+void UPTPPlanetComponent::RestoreNeighbors()
+{
+    // Neighbors are not serialized or duplicated to PIE; every triangulation edge is a neighbor pair
+    if (Triangles.Num() == 0 || Neighbors.Num() == SamplePoints.Num())
+    {
+        return;
+    }
+    LLM_SCOPE_BYTAG(GaiaPTP);
+    Neighbors.Reset();
+    Neighbors.SetNum(SamplePoints.Num());
+    for (const FIntVector& Tri : Triangles)
+    {
+        for (int32 k = 0; k < 3; ++k)
+        {
+            const int32 A = Tri[k];
+            const int32 B = Tri[(k + 1) % 3];
+            if (Neighbors.IsValidIndex(A) && Neighbors.IsValidIndex(B))
+            {
+                Neighbors[A].AddUnique(B);
+                Neighbors[B].AddUnique(A);
+            }
+        }
+    }
 }
 
 void UPTPPlanetComponent::ApplyDefaultsFromProjectSettings()
@@ -55,6 +143,7 @@ void UPTPPlanetComponent::ApplyDefaultsFromProjectSettings()
     DebugDrawStride = Settings->DebugDrawStride;
     NumPlates = Settings->NumPlates;
     ContinentalRatio = Settings->ContinentalRatio;
+    InitialSeed = Settings->InitialSeed;
     HighestOceanicRidgeElevationKm = Settings->HighestOceanicRidgeElevationKm;
     AbyssalPlainElevationKm = Settings->AbyssalPlainElevationKm;
     OceanicTrenchElevationKm = Settings->OceanicTrenchElevationKm;
@@ -69,96 +158,200 @@ void UPTPPlanetComponent::ApplyDefaultsFromProjectSettings()
     SubductionUplift = Settings->SubductionUplift;
 }
 
-uint32 UPTPPlanetComponent::ComputeSettingsHash() const
+FPTPRebuildSettings UPTPPlanetComponent::MakeRebuildSettings(bool bWithAdjacency) const
 {
-    uint32 Hash = 0;
-    Hash = HashCombine(Hash, GetTypeHash(NumSamplePoints));
-    Hash = HashCombine(Hash, GetTypeHash(NumPlates));
-    Hash = HashCombine(Hash, GetTypeHash(PlanetRadiusKm));
-    Hash = HashCombine(Hash, GetTypeHash(VisualizationScale));
-    return Hash;
+    FPTPRebuildSettings Out;
+    Out.NumSamplePoints = NumSamplePoints;
+    Out.PlanetRadiusKm = PlanetRadiusKm;
+    Out.NumPlates = NumPlates;
+    Out.ContinentalRatio = ContinentalRatio;
+    Out.MaxPlateSpeedMmPerYear = MaxPlateSpeedMmPerYear;
+    Out.AbyssalPlainElevationKm = AbyssalPlainElevationKm;
+    Out.HighestOceanicRidgeElevationKm = HighestOceanicRidgeElevationKm;
+    Out.InitialSeed = InitialSeed;
+    Out.bSpatialReorder = bSpatialReorder;
+    Out.bBuildAdjacency = bWithAdjacency;
+    return Out;
 }
 
-void UPTPPlanetComponent::RebuildPlanet()
+FPTPPlanetState UPTPPlanetComponent::MakeRebuildInput(const FPTPRebuildSettings& Settings) const
 {
-    // Skip rebuild if settings haven't changed (optimization for OnConstruction spam)
-    const uint32 CurrentHash = ComputeSettingsHash();
-    if (CurrentHash == CachedSettingsHash && SamplePoints.Num() > 0)
+    // Copy only the clean outputs that dirty stages read; everything else stays put and is not swapped
+    const EPTPStageMask Dirty = FPTPPlanetRebuild::ComputeStageHashes(Settings).Diff(StageHashes);
+    const EPTPStageMask Reads = FPTPPlanetRebuild::GetRequiredInputs(Dirty, Settings.bBuildAdjacency, Settings.bSpatialReorder);
+
+    FPTPPlanetState State;
+    State.Hashes = StageHashes;
+    if (EnumHasAnyFlags(Reads, EPTPStageMask::Sample))
     {
-        // Data already generated and settings unchanged - skip rebuild
-        return;
+        State.SamplePoints = SamplePoints;
+        State.SampleOrder = SampleOrder;
     }
+    if (EnumHasAnyFlags(Reads, EPTPStageMask::Adjacency))
+    {
+        State.Neighbors = Neighbors;
+        State.Triangles = Triangles;
+    }
+    if (EnumHasAnyFlags(Reads, EPTPStageMask::Seed | EPTPStageMask::Dynamics))
+    {
+        State.Plates = Plates;
+    }
+    if (EnumHasAnyFlags(Reads, EPTPStageMask::Assign))
+    {
+        State.PointPlateIds = PointPlateIds;
+        State.Membership = PlateMembership;
+    }
+    return State;
+}
 
+void UPTPPlanetComponent::ApplyState(FPTPPlanetState&& State)
+{
+    const EPTPStageMask Recomputed = State.Recomputed;
+    if (EnumHasAnyFlags(Recomputed, EPTPStageMask::Sample))
     {
-        CSV_SCOPED_TIMING_STAT(GAIA_PTP, Sampling);
-        SamplePoints.Reset();
-        FFibonacciSphere::GeneratePoints(NumSamplePoints, PlanetRadiusKm, SamplePoints);
+        SamplePoints = MoveTemp(State.SamplePoints);
+        SampleOrder = MoveTemp(State.SampleOrder);
     }
-    NumGeneratedPoints = SamplePoints.Num();
+    if (EnumHasAnyFlags(Recomputed, EPTPStageMask::Adjacency))
+    {
+        Neighbors = MoveTemp(State.Neighbors);
+        Triangles = MoveTemp(State.Triangles);
+    }
+    if (EnumHasAnyFlags(Recomputed, EPTPStageMask::Seed | EPTPStageMask::Dynamics))
+    {
+        Plates = MoveTemp(State.Plates);
+    }
+    if (EnumHasAnyFlags(Recomputed, EPTPStageMask::Assign))
+    {
+        PointPlateIds = MoveTemp(State.PointPlateIds);
+        PlateMembership = MoveTemp(State.Membership);
+    }
+    if (EnumHasAnyFlags(Recomputed, EPTPStageMask::Crust))
+    {
+        CrustData = MoveTemp(State.CrustData);
+    }
+    if (EnumHasAnyFlags(Recomputed, EPTPStageMask::Boundaries))
+    {
+        IsBoundaryPoint = MoveTemp(State.IsBoundaryPoint);
+        BoundaryTypes = MoveTemp(State.BoundaryTypes);
+        DistanceToFrontKm = MoveTemp(State.DistanceToFrontKm);
+    }
+    StageHashes = State.Hashes;
 
-    // Update cached hash
-    CachedSettingsHash = CurrentHash;
+    NumGeneratedPoints = SamplePoints.Num();
+    NumTriangles = Triangles.Num();
+    NumPlatesGenerated = Plates.Num();
+    UpdateMemoryStats();
+}
 
-    // Optional: seed plates immediately using simple Voronoi on sphere
-    TArray<FVector> Seeds;
+bool UPTPPlanetComponent::IsUpToDate(bool bWithAdjacency) const
+{
+    EPTPStageMask Dirty = FPTPPlanetRebuild::ComputeStageHashes(MakeRebuildSettings(bWithAdjacency)).Diff(StageHashes);
+    if (!bWithAdjacency)
     {
-        CSV_SCOPED_TIMING_STAT(GAIA_PTP, Seeding);
-        FTectonicSeeding::GeneratePlateSeeds(NumPlates, Seeds);
+        Dirty &= ~(EPTPStageMask::Adjacency | EPTPStageMask::Boundaries);
     }
+    return Dirty == EPTPStageMask::None;
+}
 
-    TArray<int32> PointToPlate;
-    TArray<TArray<int32>> PlateToPoints;
+void UPTPPlanetComponent::RebuildPlanet()
+{
+    // Skip rebuild if settings haven't changed (optimization for OnConstruction spam)
+    if (IsUpToDate(false))
     {
-        CSV_SCOPED_TIMING_STAT(GAIA_PTP, SeedingAssign);
-        FTectonicSeeding::AssignPointsToSeeds(SamplePoints, Seeds, PointToPlate, PlateToPoints);
+        return;
     }
+    CancelRebuild();
 
-    // Build plate structs
-    TArray<FTectonicPlate> NewPlates;
-    NewPlates.SetNum(NumPlates);
-    for (int32 p = 0; p < NumPlates; ++p)
+    const FPTPRebuildSettings Settings = MakeRebuildSettings(false);
+    FPTPPlanetState State = MakeRebuildInput(Settings);
+    State.Scratch = AcquireScratch();
+    FString Error;
+    if (FPTPPlanetRebuild::Run(Settings, State, [](EPTPRebuildStage) {}, []() { return false; }, Error))
     {
-        NewPlates[p].PlateId = p;
-        NewPlates[p].PointIndices = PlateToPoints[p];
-        NewPlates[p].CentroidDir = Seeds.IsValidIndex(p) ? Seeds[p] : FVector::ZeroVector;
+        ApplyState(MoveTemp(State));
     }
+}
 
-    // Task 1.11-1.12: Initialize crust data
-    TArray<FCrustData> NewCrustData;
+TSharedFuture<bool> UPTPPlanetComponent::RebuildPlanetAsync(bool bWithAdjacency)
+{
+    const FPTPRebuildSettings Settings = MakeRebuildSettings(bWithAdjacency);
+    const FPTPStageHashes Want = FPTPPlanetRebuild::ComputeStageHashes(Settings);
+    const uint32 Hash = HashCombine(Want.Boundaries, Want.Crust);   // folds in every node
+    if (IsRebuilding() && Hash == InFlightHash && (bInFlightAdjacency || !bWithAdjacency))
     {
-        CSV_SCOPED_TIMING_STAT(GAIA_PTP, CrustInit);
-
-        const UGaiaPTPSettings* Settings = GetDefault<UGaiaPTPSettings>();
-        FCrustInitialization::InitializeCrustData(
-            SamplePoints,
-            PlateToPoints,
-            ContinentalRatio,
-            Settings->AbyssalPlainElevationKm,
-            Settings->HighestOceanicRidgeElevationKm,
-            Settings->InitialSeed,
-            NewCrustData
-        );
+        return InFlightFuture;
+    }
+    if (!IsRebuilding() && IsUpToDate(bWithAdjacency))
+    {
+        return MakeFulfilledPromise<bool>(true).GetFuture().Share();
     }
 
-    // Task 1.13: Initialize plate dynamics
+    // A new generation cancels whatever is in flight; its results are dropped on arrival
+    const int32 Generation = RebuildGeneration->Increment();
+    TSharedRef<FPTPPlanetState> State = MakeShared<FPTPPlanetState>(MakeRebuildInput(Settings));
+    State->Scratch = AcquireScratch();
+    TSharedRef<FThreadSafeCounter> Counter = RebuildGeneration;
+    TWeakObjectPtr<UPTPPlanetComponent> WeakThis(this);
+    TSharedRef<TPromise<bool>> Promise = MakeShared<TPromise<bool>>();
+
+    InFlightGeneration = Generation;
+    InFlightHash = Hash;
+    bInFlightAdjacency = bWithAdjacency;
+    InFlightFuture = Promise->GetFuture().Share();
+
+    UE_LOG(LogGaiaPTP, Log, TEXT("PTP: Rebuilding planet asynchronously (%d points, %d plates%s)"),
+        Settings.NumSamplePoints, Settings.NumPlates, bWithAdjacency ? TEXT(", with adjacency") : TEXT(""));
+
+    Async(EAsyncExecution::ThreadPool, [Settings, State, Counter, Generation, WeakThis, Promise]()
     {
-        CSV_SCOPED_TIMING_STAT(GAIA_PTP, PlateDynamics);
+        auto IsCancelled = [&Counter, Generation]() { return Counter->GetValue() != Generation; };
+        auto OnStage = [&Counter, Generation, WeakThis](EPTPRebuildStage Stage)
+        {
+            AsyncTask(ENamedThreads::GameThread, [Counter, Generation, WeakThis, Stage]()
+            {
+                if (WeakThis.IsValid() && Counter->GetValue() == Generation)
+                {
+                    WeakThis->OnRebuildProgress.Broadcast(Stage, FPTPPlanetRebuild::GetStageProgress(Stage));
+                }
+            });
+        };
 
-        const UGaiaPTPSettings* Settings = GetDefault<UGaiaPTPSettings>();
-        FCrustInitialization::InitializePlateDynamics(
-            NumPlates,
-            PlanetRadiusKm,
-            MaxPlateSpeedMmPerYear,
-            Settings->InitialSeed + 100, // Offset seed
-            NewPlates
-        );
-    }
+        FString Error;
+        const bool bBuilt = FPTPPlanetRebuild::Run(Settings, *State, OnStage, IsCancelled, Error);
+        if (!bBuilt && !Error.IsEmpty())
+        {
+            UE_LOG(LogGaiaPTP, Error, TEXT("PTP: Planet rebuild failed: %s"), *Error);
+        }
 
-    // Store on component (transient preview only for Phase 1)
-    Plates = MoveTemp(NewPlates);
-    PointPlateIds = MoveTemp(PointToPlate);
-    CrustData = MoveTemp(NewCrustData);
-    NumPlatesGenerated = Plates.Num();
+        // Swap on the game thread so readers never see a half-replaced planet
+        AsyncTask(ENamedThreads::GameThread, [Counter, Generation, WeakThis, Promise, State, bBuilt]()
+        {
+            UPTPPlanetComponent* This = WeakThis.Get();
+            if (!This || Counter->GetValue() != Generation)
+            {
+                Promise->SetValue(false);
+                return;
+            }
+            This->InFlightGeneration = 0;
+            if (bBuilt)
+            {
+                This->ApplyState(MoveTemp(*State));
+            }
+            This->OnRebuildCompleted.Broadcast(bBuilt);
+            Promise->SetValue(bBuilt);
+        });
+    });
+    return InFlightFuture;
 }
 
-// Adjacency building will be added in a later step using the CGAL module.
+void UPTPPlanetComponent::CancelRebuild()
+{
+    if (!IsRebuilding())
+    {
+        return;
+    }
+    RebuildGeneration->Increment();
+    InFlightGeneration = 0;
+    OnRebuildCompleted.Broadcast(false);
+}
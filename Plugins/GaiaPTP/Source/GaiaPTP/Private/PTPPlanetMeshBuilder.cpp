@@ -0,0 +1,168 @@
+#include "PTPPlanetMeshBuilder.h"
+#include "PTPProfiling.h"
+#include "PTPSimd.h"
+#include "TectonicData.h"
+#include "Core/RealtimeMeshDataStream.h"
+#include "Core/RealtimeMeshDataTypes.h"
+
+using namespace RealtimeMesh;
+
+namespace
+{
+    static_assert(sizeof(FRealtimeMeshTangentsNormalPrecision) == 2 * sizeof(FPackedNormal), "Tangent stream is packed (tangent, normal) pairs");
+
+    /**
+     * Outward frame at a sample: unit normal N and a tangent perpendicular to N (N x Up, or N x Right
+     * at the poles). Normal.W = 1 is the binormal sign expected by the packed tangent stream.
+     */
+    FORCEINLINE void TangentFrame(const FVector3f& P, VectorRegister4Float& OutN, VectorRegister4Float& OutT)
+    {
+        const VectorRegister4Float Up = MakeVectorRegisterFloat(0.0f, 0.0f, 1.0f, 0.0f);
+        const VectorRegister4Float Right = MakeVectorRegisterFloat(0.0f, 1.0f, 0.0f, 0.0f);
+
+        const VectorRegister4Float N = VectorNormalizeSafe(VectorLoadFloat3_W0(&P.X), Up);
+        VectorRegister4Float T = VectorCross(N, Up);
+        if (VectorMaskBits(VectorCompareLT(VectorDot3(T, T), VectorSetFloat1(1e-8f))))
+        {
+            T = VectorCross(N, Right);
+        }
+        OutN = VectorSet_W1(N);
+        OutT = VectorNormalize(T);
+    }
+
+    void AddAttributeStreams(int32 NumVertices, FRealtimeMeshStreamSet& Streams)
+    {
+        Streams.AddStream<FColor>(FRealtimeMeshStreams::Color).SetNumUninitialized(NumVertices);
+        // Zeroed: FillElevations only writes U, V holds the scalar visualization layer once one is filled
+        Streams.AddStream<FRealtimeMeshTexCoordsNormal>(FRealtimeMeshStreams::TexCoords).SetNumZeroed(NumVertices);
+    }
+}
+
+FPTPPlanetMeshLayout FPTPPlanetMeshBuilder::BuildSurface(const TArray<FVector3f>& Points, const TArray<FIntVector>& Triangles, float Scale,
+                                                         FRealtimeMeshStreamSet& OutStreams, TConstArrayView<int32> TriangleOrder)
+{
+    check(TriangleOrder.Num() == 0 || TriangleOrder.Num() == Triangles.Num());
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, PreviewMeshFill);
+
+    FPTPPlanetMeshLayout Layout;
+    Layout.NumVertices = Points.Num();
+    Layout.NumTriangles = Triangles.Num();
+
+    OutStreams = FRealtimeMeshStreamSet();
+    FRealtimeMeshStream& PositionStream = OutStreams.AddStream<FVector3f>(FRealtimeMeshStreams::Position);
+    FRealtimeMeshStream& TangentStream = OutStreams.AddStream<FRealtimeMeshTangentsNormalPrecision>(FRealtimeMeshStreams::Tangents);
+    FRealtimeMeshStream& TriangleStream = OutStreams.AddStream<TIndex3<uint32>>(FRealtimeMeshStreams::Triangles);
+    PositionStream.SetNumUninitialized(Layout.NumVertices);
+    TangentStream.SetNumUninitialized(Layout.NumVertices);
+    TriangleStream.SetNumUninitialized(Layout.NumTriangles);
+    AddAttributeStreams(Layout.NumVertices, OutStreams);
+
+    TArrayView<FVector3f> Positions = PositionStream.GetArrayView<FVector3f>();
+    FPackedNormal* Packed = reinterpret_cast<FPackedNormal*>(TangentStream.GetArrayView<FRealtimeMeshTangentsNormalPrecision>().GetData());
+    TArrayView<TIndex3<uint32>> Indices = TriangleStream.GetArrayView<TIndex3<uint32>>();
+    const bool bDoParallel = PTPProfiling::IsParallelEnabled();
+
+    PTPSimd::ForEachRange(Layout.NumVertices, bDoParallel, [&](int32 Begin, int32 End)
+    {
+        for (int32 i = Begin; i < End; ++i)
+        {
+            const FVector3f& P = Points[i];
+            VectorRegister4Float N, T;
+            TangentFrame(P, N, T);
+            Positions[i] = P * Scale;
+            Packed[2 * i] = T;
+            Packed[2 * i + 1] = N;
+        }
+    });
+
+    const int32 NumPoints = Points.Num();
+    PTPSimd::ForEachRange(Layout.NumTriangles, bDoParallel, [&](int32 Begin, int32 End)
+    {
+        for (int32 t = Begin; t < End; ++t)
+        {
+            const FIntVector& Tri = Triangles[TriangleOrder.Num() > 0 ? TriangleOrder[t] : t];
+            if (!(Tri.X >= 0 && Tri.X < NumPoints && Tri.Y >= 0 && Tri.Y < NumPoints && Tri.Z >= 0 && Tri.Z < NumPoints))
+            {
+                Indices[t] = TIndex3<uint32>(0, 0, 0);
+                continue;
+            }
+
+            // Single outward-wound copy; the two-sided material covers the back face
+            const FVector3f& A = Points[Tri.X];
+            const FVector3f& B = Points[Tri.Y];
+            const FVector3f& C = Points[Tri.Z];
+            const bool bInward = FVector3f::DotProduct(FVector3f::CrossProduct(B - A, C - A), A + B + C) < 0.0f;
+            Indices[t] = bInward ? TIndex3<uint32>(Tri.X, Tri.Z, Tri.Y) : TIndex3<uint32>(Tri.X, Tri.Y, Tri.Z);
+        }
+    });
+
+    return Layout;
+}
+
+FPTPPlanetMeshLayout FPTPPlanetMeshBuilder::BuildPointInstances(const TArray<FVector3f>& Points, int32 Stride, float MarkerSize, float Scale, float QuadSize,
+                                                               TArray<FTransform>& OutTransforms)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, PreviewPointInstances);
+
+    FPTPPlanetMeshLayout Layout;
+    Layout.SampleStride = FMath::Max(1, Stride);
+    Layout.NumVertices = (Points.Num() + Layout.SampleStride - 1) / Layout.SampleStride;
+
+    const FVector MarkerScale(MarkerSize * Scale / FMath::Max(QuadSize, UE_SMALL_NUMBER));
+    OutTransforms.SetNumUninitialized(Layout.NumVertices);
+    PTPSimd::ForEachRange(Layout.NumVertices, PTPProfiling::IsParallelEnabled(), [&](int32 Begin, int32 End)
+    {
+        for (int32 m = Begin; m < End; ++m)
+        {
+            const FVector P(Points[m * Layout.SampleStride]);
+            const FQuat Facing = FQuat::FindBetweenNormals(FVector::ZAxisVector, P.GetSafeNormal(UE_SMALL_NUMBER, FVector::ZAxisVector));
+            OutTransforms[m] = FTransform(Facing, P * Scale, MarkerScale);
+        }
+    });
+
+    return Layout;
+}
+
+void FPTPPlanetMeshBuilder::FillColors(const FPTPPlanetMeshLayout& Layout, TConstArrayView<int32> PlateIds, FRealtimeMeshStream& ColorStream)
+{
+    check(ColorStream.Num() == Layout.NumVertices);
+    TArrayView<FColor> Colors = ColorStream.GetArrayView<FColor>();
+    PTPSimd::ForEachRange(Layout.NumVertices, PTPProfiling::IsParallelEnabled(), [&](int32 Begin, int32 End)
+    {
+        for (int32 v = Begin; v < End; ++v)
+        {
+            const int32 i = Layout.VertexToSample(v);
+            Colors[v] = PlateIds.IsValidIndex(i) ? PlateColor(PlateIds[i]) : FColor::Cyan;
+        }
+    });
+}
+
+void FPTPPlanetMeshBuilder::FillElevations(const FPTPPlanetMeshLayout& Layout, TConstArrayView<FCrustData> Crust, FRealtimeMeshStream& TexCoordStream)
+{
+    check(TexCoordStream.Num() == Layout.NumVertices);
+    TArrayView<FRealtimeMeshTexCoordsNormal> TexCoords = TexCoordStream.GetArrayView<FRealtimeMeshTexCoordsNormal>();
+    PTPSimd::ForEachRange(Layout.NumVertices, PTPProfiling::IsParallelEnabled(), [&](int32 Begin, int32 End)
+    {
+        for (int32 v = Begin; v < End; ++v)
+        {
+            const int32 i = Layout.VertexToSample(v);
+            TexCoords[v][0].X = FFloat16(Crust.IsValidIndex(i) ? Crust[i].Elevation : 0.0f);
+        }
+    });
+}
+
+FColor FPTPPlanetMeshBuilder::PlateColor(int32 PlateId)
+{
+    // Better hash mixing for small integers (MurmurHash3 finalizer)
+    uint32 h = PlateId;
+    h = ((h >> 16) ^ h) * 0x45d9f3b;
+    h = ((h >> 16) ^ h) * 0x45d9f3b;
+    h = (h >> 16) ^ h;
+
+    uint8 r = (uint8)((h      ) & 0xFF);
+    uint8 g = (uint8)((h >> 8 ) & 0xFF);
+    uint8 b = (uint8)((h >> 16) & 0xFF);
+
+    // Map to pastel range: 64-191 (avoids very dark and very bright)
+    return FColor(r/2 + 64, g/2 + 64, b/2 + 64, 255);
+}
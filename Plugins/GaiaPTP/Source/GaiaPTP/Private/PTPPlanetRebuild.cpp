@@ -0,0 +1,299 @@
+#include "PTPPlanetRebuild.h"
+#include "CrustInitialization.h"
+#include "FibonacciSphere.h"
+#include "GaiaPTP.h"
+#include "IPTPAdjacencyProvider.h"
+#include "PTPArena.h"
+#include "PTPMemory.h"
+#include "PTPPrecision.h"
+#include "PTPProfiling.h"
+#include "PTPSpatialOrder.h"
+#include "TectonicSeeding.h"
+
+EPTPStageMask FPTPStageHashes::Diff(const FPTPStageHashes& Other) const
+{
+    EPTPStageMask Mask = EPTPStageMask::None;
+    Mask |= Sample != Other.Sample ? EPTPStageMask::Sample : EPTPStageMask::None;
+    Mask |= Adjacency != Other.Adjacency ? EPTPStageMask::Adjacency : EPTPStageMask::None;
+    Mask |= Seed != Other.Seed ? EPTPStageMask::Seed : EPTPStageMask::None;
+    Mask |= Assign != Other.Assign ? EPTPStageMask::Assign : EPTPStageMask::None;
+    Mask |= Crust != Other.Crust ? EPTPStageMask::Crust : EPTPStageMask::None;
+    Mask |= Dynamics != Other.Dynamics ? EPTPStageMask::Dynamics : EPTPStageMask::None;
+    Mask |= Boundaries != Other.Boundaries ? EPTPStageMask::Boundaries : EPTPStageMask::None;
+    return Mask;
+}
+
+FPTPStageHashes FPTPPlanetRebuild::ComputeStageHashes(const FPTPRebuildSettings& Settings)
+{
+    FPTPStageHashes H;
+    H.Sample = HashCombine(GetTypeHash(Settings.NumSamplePoints), GetTypeHash(Settings.PlanetRadiusKm));
+    H.Sample = HashCombine(H.Sample, GetTypeHash(Settings.bSpatialReorder));
+    // The Fibonacci lattice's directions (and their Hilbert order) depend on N only, so a radius change keeps the triangulation
+    H.Adjacency = HashCombine(GetTypeHash(Settings.NumSamplePoints), GetTypeHash(TEXT("Adjacency")));
+    H.Adjacency = HashCombine(H.Adjacency, GetTypeHash(Settings.bSpatialReorder));
+    H.Seed = HashCombine(GetTypeHash(Settings.NumPlates), GetTypeHash(TEXT("Seed")));
+    H.Assign = HashCombine(H.Sample, H.Seed);
+
+    H.Crust = H.Assign;
+    H.Crust = HashCombine(H.Crust, GetTypeHash(Settings.ContinentalRatio));
+    H.Crust = HashCombine(H.Crust, GetTypeHash(Settings.AbyssalPlainElevationKm));
+    H.Crust = HashCombine(H.Crust, GetTypeHash(Settings.HighestOceanicRidgeElevationKm));
+    H.Crust = HashCombine(H.Crust, GetTypeHash(Settings.InitialSeed));
+
+    H.Dynamics = H.Seed;
+    H.Dynamics = HashCombine(H.Dynamics, GetTypeHash(Settings.PlanetRadiusKm));
+    H.Dynamics = HashCombine(H.Dynamics, GetTypeHash(Settings.MaxPlateSpeedMmPerYear));
+    H.Dynamics = HashCombine(H.Dynamics, GetTypeHash(Settings.InitialSeed));
+
+    H.Boundaries = HashCombine(HashCombine(H.Adjacency, H.Assign), H.Dynamics);
+    return H;
+}
+
+EPTPStageMask FPTPPlanetRebuild::GetRequiredInputs(EPTPStageMask Dirty, bool bBuildAdjacency, bool bSpatialReorder)
+{
+    EPTPStageMask Reads = EPTPStageMask::None;
+    if (bBuildAdjacency && EnumHasAnyFlags(Dirty, EPTPStageMask::Adjacency))
+    {
+        Reads |= EPTPStageMask::Sample;
+    }
+    if (EnumHasAnyFlags(Dirty, EPTPStageMask::Assign))
+    {
+        Reads |= EPTPStageMask::Sample | EPTPStageMask::Seed;
+        // Regrouping the samples by plate rewrites the triangulation's indices
+        Reads |= bSpatialReorder ? EPTPStageMask::Adjacency : EPTPStageMask::None;
+    }
+    if (EnumHasAnyFlags(Dirty, EPTPStageMask::Crust))
+    {
+        Reads |= EPTPStageMask::Sample | EPTPStageMask::Assign;
+    }
+    if (EnumHasAnyFlags(Dirty, EPTPStageMask::Dynamics))
+    {
+        Reads |= EPTPStageMask::Seed;
+    }
+    if (EnumHasAnyFlags(Dirty, EPTPStageMask::Boundaries))
+    {
+        Reads |= EPTPStageMask::Sample | EPTPStageMask::Adjacency | EPTPStageMask::Assign | EPTPStageMask::Seed | EPTPStageMask::Dynamics;
+    }
+    // Seed and Dynamics share the Plates array: rewriting one part keeps the other
+    Reads &= ~Dirty;
+
+    // A resample that keeps the triangulation regathers the lattice through the cached sample order
+    if (bSpatialReorder && EnumHasAnyFlags(Dirty, EPTPStageMask::Sample) && !EnumHasAnyFlags(Dirty, EPTPStageMask::Adjacency))
+    {
+        Reads |= EPTPStageMask::Sample;
+    }
+    return Reads;
+}
+
+bool FPTPPlanetRebuild::Run(const FPTPRebuildSettings& Settings, FPTPPlanetState& InOutState, TFunctionRef<void(EPTPRebuildStage)> OnStage,
+                            TFunctionRef<bool()> IsCancelled, FString& OutError)
+{
+    LLM_SCOPE_BYTAG(GaiaPTP);
+    OutError.Reset();
+    FPTPPlanetState& State = InOutState;
+    const FPTPStageHashes Want = ComputeStageHashes(Settings);
+
+    if (State.Hashes.Sample != Want.Sample)
+    {
+        OnStage(EPTPRebuildStage::Sampling);
+        CSV_SCOPED_TIMING_STAT(GAIA_PTP, Sampling);
+        State.SamplePoints.Reset();
+        FFibonacciSphere::GeneratePoints(Settings.NumSamplePoints, Settings.PlanetRadiusKm, State.SamplePoints);
+        if (!Settings.bSpatialReorder)
+        {
+            State.SampleOrder.Reset();
+        }
+        else if (State.Hashes.Adjacency == Want.Adjacency && State.SampleOrder.Num() == State.SamplePoints.Num())
+        {
+            // The kept triangulation indexes the plate-major order of the last assignment, which N alone does not give
+            FPTPSpatialOrder::Permute(State.SamplePoints, State.SampleOrder);
+        }
+        else
+        {
+            // Every later stage, the triangulation included, sees the Hilbert order until assignment groups it by plate
+            State.SampleOrder.Reset();
+            FPTPSpatialOrder::ComputeHilbertOrder(State.SamplePoints, State.SampleOrder);
+            FPTPSpatialOrder::Permute(State.SamplePoints, State.SampleOrder);
+        }
+        State.Hashes.Sample = Want.Sample;
+        State.Recomputed |= EPTPStageMask::Sample;
+    }
+    if (IsCancelled())
+    {
+        return false;
+    }
+
+    // Without a rebuild a stale triangulation is dropped (the surface preview waits for BuildAdjacency); a missing one stays missing
+    if (State.Hashes.Adjacency != Want.Adjacency && (Settings.bBuildAdjacency || State.Hashes.Adjacency != 0))
+    {
+        State.Neighbors.Reset();
+        State.Triangles.Reset();
+        State.Hashes.Adjacency = 0;
+        State.Recomputed |= EPTPStageMask::Adjacency;
+
+        if (Settings.bBuildAdjacency)
+        {
+            OnStage(EPTPRebuildStage::Adjacency);
+            CSV_SCOPED_TIMING_STAT(GAIA_PTP, Adjacency);
+
+            TSharedPtr<IPTPAdjacencyProvider> Provider = CreateCGALAdjacencyProvider();
+            if (!Provider.IsValid())
+            {
+                OutError = TEXT("No adjacency provider available");
+                return false;
+            }
+            // CGAL's exact predicates run on doubles; the widened copy lives for this stage only
+            TArray<FVector> Points;
+            PTPPrecision::ToDouble(State.SamplePoints, Points);
+            FPTPAdjacency Adj;
+            const double StartTime = FPlatformTime::Seconds();
+            if (!Provider->Build(Points, Adj, OutError))
+            {
+                return false;
+            }
+            UE_LOG(LogGaiaPTP, Log, TEXT("PTP: Adjacency built in %.2f seconds (%d triangles)"),
+                FPlatformTime::Seconds() - StartTime, Adj.Triangles.Num());
+            State.Neighbors = MoveTemp(Adj.Neighbors);
+            State.Triangles = MoveTemp(Adj.Triangles);
+            State.Hashes.Adjacency = Want.Adjacency;
+        }
+        if (IsCancelled())
+        {
+            return false;
+        }
+    }
+
+    const bool bSeed = State.Hashes.Seed != Want.Seed;
+    const bool bAssign = State.Hashes.Assign != Want.Assign;
+    if (bSeed || bAssign)
+    {
+        OnStage(EPTPRebuildStage::Seeding);
+    }
+    if (bSeed)
+    {
+        CSV_SCOPED_TIMING_STAT(GAIA_PTP, Seeding);
+        TArray<FVector> Seeds;
+        FTectonicSeeding::GeneratePlateSeeds(Settings.NumPlates, Seeds);
+        State.Plates.SetNum(Settings.NumPlates);
+        for (int32 p = 0; p < Settings.NumPlates; ++p)
+        {
+            State.Plates[p].PlateId = p;
+            State.Plates[p].CentroidDir = Seeds.IsValidIndex(p) ? Seeds[p] : FVector::ZeroVector;
+        }
+        State.Hashes.Seed = Want.Seed;
+        State.Recomputed |= EPTPStageMask::Seed;
+    }
+    if (bAssign)
+    {
+        CSV_SCOPED_TIMING_STAT(GAIA_PTP, SeedingAssign);
+        TArray<FVector> Seeds;
+        Seeds.Reserve(State.Plates.Num());
+        for (const FTectonicPlate& Plate : State.Plates)
+        {
+            Seeds.Add(Plate.CentroidDir);
+        }
+        FTectonicSeeding::AssignPointsToSeeds(State.SamplePoints, Seeds, State.PointPlateIds, State.Membership);
+        State.Hashes.Assign = Want.Assign;
+        State.Recomputed |= EPTPStageMask::Assign;
+
+        if (Settings.bSpatialReorder)
+        {
+            // Store samples plate by plate, Hilbert order within each plate, so every plate range is one span;
+            // Reorder remaps the triangulation and sample ids, and the sample and adjacency outputs are swapped in again
+            TArray<int32> NewToOld;
+            FPTPSpatialOrder::ComputePlateHilbertOrder(State.SamplePoints, State.PointPlateIds, NewToOld);
+            if (!FPTPSpatialOrder::IsIdentity(NewToOld))
+            {
+                FPTPSpatialOrder::Reorder(State, NewToOld);
+                State.Recomputed |= EPTPStageMask::Sample;
+                State.Recomputed |= State.Hashes.Adjacency != 0 ? EPTPStageMask::Adjacency : EPTPStageMask::None;
+            }
+        }
+    }
+    if (IsCancelled())
+    {
+        return false;
+    }
+
+    const bool bCrust = State.Hashes.Crust != Want.Crust;
+    const bool bDynamics = State.Hashes.Dynamics != Want.Dynamics;
+    const bool bBoundaries = State.Hashes.Boundaries != Want.Boundaries
+        && (State.Hashes.Adjacency == Want.Adjacency || State.Hashes.Boundaries != 0);
+    if (bCrust || bDynamics || bBoundaries)
+    {
+        OnStage(EPTPRebuildStage::Crust);
+    }
+    if (bCrust)
+    {
+        CSV_SCOPED_TIMING_STAT(GAIA_PTP, CrustInit);
+        FCrustInitialization::InitializeCrustData(
+            State.SamplePoints,
+            State.Membership,
+            Settings.ContinentalRatio,
+            Settings.AbyssalPlainElevationKm,
+            Settings.HighestOceanicRidgeElevationKm,
+            Settings.InitialSeed,
+            State.CrustData
+        );
+        State.Hashes.Crust = Want.Crust;
+        State.Recomputed |= EPTPStageMask::Crust;
+    }
+    if (bDynamics)
+    {
+        CSV_SCOPED_TIMING_STAT(GAIA_PTP, PlateDynamics);
+        FCrustInitialization::InitializePlateDynamics(
+            Settings.NumPlates,
+            Settings.PlanetRadiusKm,
+            Settings.MaxPlateSpeedMmPerYear,
+            Settings.InitialSeed + 100, // Offset seed
+            State.Plates
+        );
+        State.Hashes.Dynamics = Want.Dynamics;
+        State.Recomputed |= EPTPStageMask::Dynamics;
+    }
+    if (IsCancelled())
+    {
+        return false;
+    }
+
+    if (bBoundaries)
+    {
+        CSV_SCOPED_TIMING_STAT(GAIA_PTP, Boundaries);
+        State.IsBoundaryPoint.Reset();
+        State.BoundaryTypes.Reset();
+        State.DistanceToFrontKm.Reset();
+        State.Hashes.Boundaries = 0;
+
+        // Boundaries need the triangulation; without it they stay empty until adjacency is built
+        if (State.Hashes.Adjacency == Want.Adjacency && State.Neighbors.Num() == State.SamplePoints.Num())
+        {
+            // The boundary stage is the step: its kernels share one scratch, released wholesale at the end
+            TOptional<FPTPStepScratch> LocalScratch;
+            FPTPStepScratch& Scratch = State.Scratch.IsValid() ? *State.Scratch : LocalScratch.Emplace();
+
+            FCrustInitialization::DetectPlateBoundaries(State.PointPlateIds, State.Neighbors, State.IsBoundaryPoint);
+            FCrustInitialization::ClassifyPlateBoundaries(State.SamplePoints, State.PointPlateIds, State.Plates,
+                State.Neighbors, State.BoundaryTypes, &Scratch);
+            FCrustInitialization::ComputeDistanceToFront(State.SamplePoints, State.Neighbors, State.BoundaryTypes,
+                State.DistanceToFrontKm, &Scratch);
+            Scratch.EndStep();
+            State.Hashes.Boundaries = Want.Boundaries;
+        }
+        State.Recomputed |= EPTPStageMask::Boundaries;
+    }
+    return !IsCancelled();
+}
+
+float FPTPPlanetRebuild::GetStageProgress(EPTPRebuildStage Stage)
+{
+    // Rough shares of a full 100k-point rebuild; the triangulation dominates
+    switch (Stage)
+    {
+    case EPTPRebuildStage::Sampling:  return 0.0f;
+    case EPTPRebuildStage::Adjacency: return 0.05f;
+    case EPTPRebuildStage::Seeding:   return 0.65f;
+    case EPTPRebuildStage::Crust:     return 0.75f;
+    case EPTPRebuildStage::Mesh:      return 0.85f;
+    default:                          return 1.0f;
+    }
+}
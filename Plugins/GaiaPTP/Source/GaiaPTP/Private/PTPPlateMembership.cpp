@@ -0,0 +1,132 @@
+#include "PTPPlateMembership.h"
+#include "PTPProfiling.h"
+
+void FPTPPlateMembership::Build(TConstArrayView<int32> PointPlateIds, int32 NumPlates)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, PlateMembership);
+    const int32 NumPoints = PointPlateIds.Num();
+
+    Offsets.Reset(NumPlates + 1);
+    Offsets.AddZeroed(FMath::Max(NumPlates, 0) + 1);
+    for (int32 Plate : PointPlateIds)
+    {
+        if (Plate >= 0 && Plate < NumPlates)
+        {
+            ++Offsets[Plate + 1];
+        }
+    }
+    for (int32 p = 0; p < NumPlates; ++p)
+    {
+        Offsets[p + 1] += Offsets[p];
+    }
+
+    // Scatter in index order so every range comes out ascending
+    Points.SetNumUninitialized(Offsets.Last());
+    Slots.Init(INDEX_NONE, NumPoints);
+    TArray<int32> Cursor(Offsets.GetData(), FMath::Max(NumPlates, 0));
+    for (int32 i = 0; i < NumPoints; ++i)
+    {
+        const int32 Plate = PointPlateIds[i];
+        if (Plate >= 0 && Plate < NumPlates)
+        {
+            const int32 Slot = Cursor[Plate]++;
+            Points[Slot] = i;
+            Slots[i] = Slot;
+        }
+    }
+}
+
+void FPTPPlateMembership::ApplyTransfers(TConstArrayView<FPTPPlateTransfer> Transfers, TArray<int32>& InOutPointPlateIds)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, PlateTransfers);
+    const int32 NumPlates = GetNumPlates();
+    check(Slots.Num() == InOutPointPlateIds.Num());
+
+    int32 Lo = NumPlates;
+    int32 Hi = -1;
+    bool bUnassigned = false;
+    for (const FPTPPlateTransfer& Move : Transfers)
+    {
+        if (!InOutPointPlateIds.IsValidIndex(Move.Point) || Move.ToPlate < 0 || Move.ToPlate >= NumPlates)
+        {
+            continue;
+        }
+        int32& Plate = InOutPointPlateIds[Move.Point];
+        if (Plate == Move.ToPlate)
+        {
+            continue;
+        }
+        bUnassigned |= Slots[Move.Point] == INDEX_NONE;
+        Lo = FMath::Min(Lo, FMath::Min(Plate, Move.ToPlate));
+        Hi = FMath::Max(Hi, FMath::Max(Plate, Move.ToPlate));
+        Plate = Move.ToPlate;
+    }
+    if (Hi < 0)
+    {
+        return;
+    }
+    if (bUnassigned)
+    {
+        // A point joining the partition changes its size; start over
+        Build(InOutPointPlateIds, NumPlates);
+        return;
+    }
+
+    // Every moved point left and joined a plate in [Lo, Hi], so that span of Points keeps its size
+    const int32 Begin = Offsets[Lo];
+    const int32 End = Offsets[Hi + 1];
+    TArray<int32> Span(Points.GetData() + Begin, End - Begin);
+    Span.Sort();
+
+    for (int32 p = Lo; p <= Hi; ++p)
+    {
+        Offsets[p + 1] = 0;
+    }
+    for (int32 Point : Span)
+    {
+        ++Offsets[InOutPointPlateIds[Point] + 1];
+    }
+    for (int32 p = Lo; p <= Hi; ++p)
+    {
+        Offsets[p + 1] += Offsets[p];
+    }
+    check(Offsets[Hi + 1] == End);
+
+    TArray<int32> Cursor(Offsets.GetData() + Lo, Hi - Lo + 1);
+    for (int32 Point : Span)
+    {
+        const int32 Slot = Cursor[InOutPointPlateIds[Point] - Lo]++;
+        Points[Slot] = Point;
+        Slots[Point] = Slot;
+    }
+}
+
+bool FPTPPlateMembership::IsConsistent(TConstArrayView<int32> PointPlateIds) const
+{
+    if (Slots.Num() != PointPlateIds.Num() || Offsets.Num() == 0 || Offsets.Last() != Points.Num())
+    {
+        return false;
+    }
+    int32 NumAssigned = 0;
+    for (int32 Plate : PointPlateIds)
+    {
+        NumAssigned += Plate >= 0 && Plate < GetNumPlates() ? 1 : 0;
+    }
+    if (NumAssigned != Points.Num())
+    {
+        return false;
+    }
+    for (int32 p = 0; p < GetNumPlates(); ++p)
+    {
+        const TConstArrayView<int32> Members = GetPlatePoints(p);
+        for (int32 k = 0; k < Members.Num(); ++k)
+        {
+            const int32 Point = Members[k];
+            if (PointPlateIds[Point] != p || Slots[Point] != Offsets[p] + k || (k > 0 && Members[k - 1] >= Point))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,51 @@
+#include "PTPPlatePartition.h"
+#include "Async/ParallelFor.h"
+#include "PTPPlateMembership.h"
+#include "PTPProfiling.h"
+
+void FPTPPlatePartition::Build(int32 NumPlates, TFunctionRef<int32(int32)> GetPlateSize, int32 ItemSize)
+{
+    ItemSize = FMath::Max(ItemSize, 1);
+    NumPlates = FMath::Max(NumPlates, 0);
+
+    Items.Reset();
+    PlateItems.Reset(NumPlates + 1);
+    PlateItems.Add(0);
+    for (int32 Plate = 0; Plate < NumPlates; ++Plate)
+    {
+        // Even split rather than ItemSize-then-remainder, so a plate never ends in a sliver
+        const int32 Size = FMath::Max(GetPlateSize(Plate), 0);
+        // Not DivideAndRoundUp: Size + ItemSize - 1 overflows for the MAX_int32 one-item-per-plate mode
+        const int32 NumPlateItems = Size > 0 ? 1 + (Size - 1) / ItemSize : 0;
+        for (int32 i = 0; i < NumPlateItems; ++i)
+        {
+            FPTPPlateWorkItem& Item = Items.AddDefaulted_GetRef();
+            Item.Plate = Plate;
+            Item.Begin = int32(int64(Size) * i / NumPlateItems);
+            Item.End = int32(int64(Size) * (i + 1) / NumPlateItems);
+        }
+        PlateItems.Add(Items.Num());
+    }
+}
+
+void FPTPPlatePartition::Build(const FPTPPlateMembership& Membership, int32 ItemSize)
+{
+    Build(Membership.GetNumPlates(), [&Membership](int32 Plate) { return Membership.GetPlateCount(Plate); }, ItemSize);
+}
+
+void FPTPPlatePartition::Dispatch(
+    TFunctionRef<void(int32 Plate)> Prologue,
+    TFunctionRef<void(int32 ItemIdx, const FPTPPlateWorkItem& Item)> Work,
+    TFunctionRef<void(int32 Plate)> Epilogue,
+    bool bForceSingleThread) const
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, PlatePartitionDispatch);
+    ParallelFor(GetNumPlates(), [&](int32 Plate) { Prologue(Plate); }, bForceSingleThread);
+    Dispatch(Work, bForceSingleThread);
+    ParallelFor(GetNumPlates(), [&](int32 Plate) { Epilogue(Plate); }, bForceSingleThread);
+}
+
+void FPTPPlatePartition::Dispatch(TFunctionRef<void(int32 ItemIdx, const FPTPPlateWorkItem& Item)> Work, bool bForceSingleThread) const
+{
+    ParallelFor(Items.Num(), [&](int32 ItemIdx) { Work(ItemIdx, Items[ItemIdx]); }, bForceSingleThread);
+}
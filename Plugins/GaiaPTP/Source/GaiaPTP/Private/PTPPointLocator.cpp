@@ -0,0 +1,248 @@
+#include "PTPPointLocator.h"
+#include "Async/ParallelFor.h"
+#include "GaiaPTP.h"
+#include "PTPCubeMap.h"
+#include "PTPProfiling.h"
+
+namespace
+{
+    /** Queries per ParallelFor task in LocateBatch. */
+    constexpr int32 QueryChunkSize = 4096;
+
+    FORCEINLINE uint64 EdgeKey(int32 From, int32 To)
+    {
+        return (static_cast<uint64>(static_cast<uint32>(From)) << 32) | static_cast<uint32>(To);
+    }
+}
+
+bool FPTPPointLocator::Build(TConstArrayView<FVector3f> Points, const TArray<FIntVector>& InTriangles, int32 GridResolution)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, PointLocatorBuild);
+
+    Vertices.Reset();
+    Triangles.Reset();
+    EdgeNormals.Reset();
+    Adjacent.Reset();
+    CellSeeds.Reset();
+    NumFallbacks = 0;
+
+    const int32 NumTris = InTriangles.Num();
+    if (NumTris == 0 || Points.Num() < 4)
+    {
+        return false;
+    }
+
+    Vertices.SetNumUninitialized(Points.Num());
+    for (int32 i = 0; i < Points.Num(); ++i)
+    {
+        Vertices[i] = Points[i].GetSafeNormal();
+    }
+
+    // Re-wind outward so every edge test below has the same sign convention
+    Triangles.SetNumUninitialized(NumTris);
+    EdgeNormals.SetNumUninitialized(NumTris * 3);
+    TMap<uint64, int32> DirectedEdges;
+    DirectedEdges.Reserve(NumTris * 3);
+    for (int32 t = 0; t < NumTris; ++t)
+    {
+        FIntVector Tri = InTriangles[t];
+        const FVector3f& A = Vertices[Tri.X];
+        const FVector3f& B = Vertices[Tri.Y];
+        const FVector3f& C = Vertices[Tri.Z];
+        if (FVector3f::DotProduct(FVector3f::CrossProduct(B - A, C - A), A + B + C) < 0.0f)
+        {
+            Swap(Tri.Y, Tri.Z);
+        }
+        Triangles[t] = Tri;
+
+        for (int32 k = 0; k < 3; ++k)
+        {
+            const int32 V1 = Tri[(k + 1) % 3];
+            const int32 V2 = Tri[(k + 2) % 3];
+            EdgeNormals[t * 3 + k] = FVector3f::CrossProduct(Vertices[V1], Vertices[V2]);
+            DirectedEdges.Add(EdgeKey(V1, V2), t * 3 + k);
+        }
+    }
+
+    // Neighbour across each edge is the triangle holding the reversed directed edge
+    Adjacent.SetNumUninitialized(NumTris);
+    for (int32 t = 0; t < NumTris; ++t)
+    {
+        for (int32 k = 0; k < 3; ++k)
+        {
+            const int32 V1 = Triangles[t][(k + 1) % 3];
+            const int32 V2 = Triangles[t][(k + 2) % 3];
+            const int32* Twin = DirectedEdges.Find(EdgeKey(V2, V1));
+            if (!Twin)
+            {
+                UE_LOG(LogGaiaPTP, Warning, TEXT("Point locator: triangulation is not closed (edge %d-%d has no twin)"), V1, V2);
+                Triangles.Reset();
+                return false;
+            }
+            Adjacent[t][k] = *Twin / 3;
+        }
+    }
+
+    MaxWalkSteps = FMath::Max(64, 4 * FMath::CeilToInt(FMath::Sqrt((float)NumTris)));
+    Resolution = GridResolution > 0 ? GridResolution : FMath::Max(1, FMath::FloorToInt(FMath::Sqrt(NumTris / 12.0f)));
+    const int32 NumCells = FPTPCubeMap::NumFaces * Resolution * Resolution;
+
+    // Rough seeds from triangle centroids, then refine each to the triangle containing the cell centre
+    CellSeeds.Init(INDEX_NONE, NumCells);
+    for (int32 t = 0; t < NumTris; ++t)
+    {
+        const FVector3f Centroid = Vertices[Triangles[t].X] + Vertices[Triangles[t].Y] + Vertices[Triangles[t].Z];
+        int32& Seed = CellSeeds[FPTPCubeMap::CellId(Centroid, Resolution)];
+        if (Seed == INDEX_NONE)
+        {
+            Seed = t;
+        }
+    }
+
+    const bool bDoParallel = PTPProfiling::IsParallelEnabled();
+
+    // One task per cube-face row; empty cells start from the previous cell in the row
+    ParallelFor(FPTPCubeMap::NumFaces * Resolution, [&](int32 Row)
+    {
+        const int32 Face = Row / Resolution;
+        const int32 Y = Row % Resolution;
+        int32 Previous = INDEX_NONE;
+        for (int32 X = 0; X < Resolution; ++X)
+        {
+            const int32 Cell = (Face * Resolution + Y) * Resolution + X;
+            const int32 Start = CellSeeds[Cell] != INDEX_NONE ? CellSeeds[Cell] : (Previous != INDEX_NONE ? Previous : 0);
+            CellSeeds[Cell] = Walk(FPTPCubeMap::CellCenter(Face, X, Y, Resolution), Start);
+            Previous = CellSeeds[Cell];
+        }
+    }, !bDoParallel);
+
+    UE_LOG(LogGaiaPTP, Log, TEXT("Point locator: %d triangles, %d seed cells (%d per face edge), %d fallbacks"),
+        NumTris, NumCells, Resolution, GetNumFallbacks());
+    return true;
+}
+
+int32 FPTPPointLocator::Walk(const FVector3f& P, int32 Start) const
+{
+    int32 T = Start;
+    for (int32 Step = 0; Step < MaxWalkSteps; ++Step)
+    {
+        const FVector3f* E = &EdgeNormals[T * 3];
+        const float D0 = FVector3f::DotProduct(E[0], P);
+        const float D1 = FVector3f::DotProduct(E[1], P);
+        const float D2 = FVector3f::DotProduct(E[2], P);
+
+        // Step across the edge P is furthest outside of
+        const int32 K = D0 <= D1 ? (D0 <= D2 ? 0 : 2) : (D1 <= D2 ? 1 : 2);
+        const float DMin = K == 0 ? D0 : (K == 1 ? D1 : D2);
+        if (DMin >= 0.0f)
+        {
+            return T;
+        }
+        T = Adjacent[T][K];
+    }
+
+    // Cycles are possible on badly shaped triangles; a scan always terminates
+    NumFallbacks.fetch_add(1, std::memory_order_relaxed);
+    return BruteForce(P);
+}
+
+int32 FPTPPointLocator::BruteForce(const FVector3f& P) const
+{
+    int32 Best = 0;
+    float BestScore = -MAX_flt;
+    for (int32 T = 0; T < Triangles.Num(); ++T)
+    {
+        const FVector3f* E = &EdgeNormals[T * 3];
+        const float Score = FMath::Min3(FVector3f::DotProduct(E[0], P), FVector3f::DotProduct(E[1], P), FVector3f::DotProduct(E[2], P));
+        if (Score > BestScore)
+        {
+            BestScore = Score;
+            Best = T;
+        }
+    }
+    return Best;
+}
+
+FPTPLocation FPTPPointLocator::MakeLocation(const FVector3f& P, int32 Triangle) const
+{
+    // Edge-normal dot products are proportional to the barycentrics of P's central projection
+    const FVector3f* E = &EdgeNormals[Triangle * 3];
+    FVector3f W(
+        FMath::Max(FVector3f::DotProduct(E[0], P), 0.0f),
+        FMath::Max(FVector3f::DotProduct(E[1], P), 0.0f),
+        FMath::Max(FVector3f::DotProduct(E[2], P), 0.0f));
+    const float Sum = W.X + W.Y + W.Z;
+
+    FPTPLocation Out;
+    Out.Triangle = Triangle;
+    Out.Barycentrics = Sum > 0.0f ? W / Sum : FVector3f(1.0f / 3.0f);
+    return Out;
+}
+
+FPTPLocation FPTPPointLocator::Locate(const FVector3f& Direction, int32 HintTriangle) const
+{
+    check(IsBuilt());
+    const int32 Start = HintTriangle != INDEX_NONE ? HintTriangle : CellSeeds[FPTPCubeMap::CellId(Direction, Resolution)];
+    return MakeLocation(Direction, Walk(Direction, Start));
+}
+
+void FPTPPointLocator::LocateBatch(TConstArrayView<FVector3f> Directions, TArrayView<FPTPLocation> OutLocations) const
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, PointLocatorBatch);
+    check(IsBuilt());
+
+    const int32 Num = Directions.Num();
+    check(OutLocations.Num() == Num);
+    if (Num == 0)
+    {
+        return;
+    }
+
+    const bool bDoParallel = PTPProfiling::IsParallelEnabled();
+    const int32 NumChunks = (Num + QueryChunkSize - 1) / QueryChunkSize;
+
+    TArray<int32> Cells;
+    Cells.SetNumUninitialized(Num);
+    ParallelFor(NumChunks, [&](int32 ChunkIdx)
+    {
+        const int32 End = FMath::Min((ChunkIdx + 1) * QueryChunkSize, Num);
+        for (int32 i = ChunkIdx * QueryChunkSize; i < End; ++i)
+        {
+            Cells[i] = FPTPCubeMap::CellId(Directions[i], Resolution);
+        }
+    }, !bDoParallel);
+
+    // Counting sort by cell: queries in the same cell walk from each other's results
+    TArray<int32> CellStart;
+    CellStart.Init(0, CellSeeds.Num() + 1);
+    for (const int32 Cell : Cells)
+    {
+        ++CellStart[Cell + 1];
+    }
+    for (int32 c = 0; c < CellSeeds.Num(); ++c)
+    {
+        CellStart[c + 1] += CellStart[c];
+    }
+    TArray<int32> Order;
+    Order.SetNumUninitialized(Num);
+    for (int32 i = 0; i < Num; ++i)
+    {
+        Order[CellStart[Cells[i]]++] = i;
+    }
+
+    ParallelFor(NumChunks, [&](int32 ChunkIdx)
+    {
+        const int32 End = FMath::Min((ChunkIdx + 1) * QueryChunkSize, Num);
+        int32 PreviousCell = INDEX_NONE;
+        int32 PreviousTriangle = INDEX_NONE;
+        for (int32 k = ChunkIdx * QueryChunkSize; k < End; ++k)
+        {
+            const int32 Query = Order[k];
+            const int32 Cell = Cells[Query];
+            const int32 Start = Cell == PreviousCell ? PreviousTriangle : CellSeeds[Cell];
+            PreviousTriangle = Walk(Directions[Query], Start);
+            PreviousCell = Cell;
+            OutLocations[Query] = MakeLocation(Directions[Query], PreviousTriangle);
+        }
+    }, !bDoParallel);
+}
@@ -0,0 +1,18 @@
+#include "PTPPrecisionLibrary.h"
+#include "PTPPlanetComponent.h"
+#include "PTPPrecision.h"
+
+TArray<FVector> UPTPPrecisionLibrary::GetSamplePoints(const UPTPPlanetComponent* Planet)
+{
+    TArray<FVector> Out;
+    if (Planet)
+    {
+        PTPPrecision::ToDouble(Planet->SamplePoints, Out);
+    }
+    return Out;
+}
+
+FVector UPTPPrecisionLibrary::GetSamplePoint(const UPTPPlanetComponent* Planet, int32 Index)
+{
+    return Planet && Planet->SamplePoints.IsValidIndex(Index) ? FVector(Planet->SamplePoints[Index]) : FVector::ZeroVector;
+}
@@ -3,6 +3,21 @@
 #include "GaiaPTP.h"
 #include "ProfilingDebugging/CsvProfiler.h"
 #include "PTPPlanetComponent.h"
+#include "CrustInitialization.h"
+#include "GaiaPTPSettings.h"
+#include "PTPAdaptiveSubdivider.h"
+#include "PTPAdjacency.h"
+#include "PTPCraterCatalog.h"
+#include "PTPCrustSample.h"
+#include "PTPHydrology.h"
+#include "PTPMemory.h"
+#include "PTPPlanetActor.h"
+#include "PTPPlanetRebuild.h"
+#include "PTPPlatePartition.h"
+#include "PTPRandom.h"
+#include "PTPSpatialOrder.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "UObject/UObjectIterator.h"
 
 CSV_DEFINE_CATEGORY(GAIA_PTP, true);
 
@@ -25,11 +40,11 @@ namespace
         }
     }
 
-    // CVar to control parallelization in init paths
+    // CVar to control parallelization in PTP kernels; read through PTPProfiling::IsParallelEnabled
     static TAutoConsoleVariable<int32> CVarPTPParallel(
         TEXT("ptp.parallel"),
         1,
-        TEXT("Enable (1) or disable (0) ParallelFor in PTP initialization"),
+        TEXT("Enable (1) or disable (0) ParallelFor in PTP kernels"),
         ECVF_Default);
 
     FAutoConsoleCommand CmdProfileStart(
@@ -81,10 +96,371 @@ namespace
         TEXT("ptp.bench.rebuild_np"),
         TEXT("Rebuilds a PTP planet with NumSamplePoints=ptp.bench.numPoints and NumPlates=ptp.bench.numPlates"),
         FConsoleCommandDelegate::CreateStatic(&PTPBenchRebuildNP));
+
+    // Best of three runs of the neighbour-walking boundary passes, in ms
+    double TimeBoundaryPasses(FPTPPlanetState& State)
+    {
+        double Best = TNumericLimits<double>::Max();
+        for (int32 Run = 0; Run < 3; ++Run)
+        {
+            const double Start = FPlatformTime::Seconds();
+            FCrustInitialization::DetectPlateBoundaries(State.PointPlateIds, State.Neighbors, State.IsBoundaryPoint);
+            FCrustInitialization::ClassifyPlateBoundaries(State.SamplePoints, State.PointPlateIds, State.Plates,
+                State.Neighbors, State.BoundaryTypes);
+            FCrustInitialization::ComputeDistanceToFront(State.SamplePoints, State.Neighbors, State.BoundaryTypes,
+                State.DistanceToFrontKm);
+            Best = FMath::Min(Best, (FPlatformTime::Seconds() - Start) * 1000.0);
+        }
+        return Best;
+    }
+
+    // Boundary passes on the same planet in Fibonacci order and in Hilbert order.
+    // Usage: ptp.bench.reorder (uses ptp.bench.numPoints / ptp.bench.numPlates)
+    void PTPBenchReorder()
+    {
+        const UGaiaPTPSettings* Defaults = GetDefault<UGaiaPTPSettings>();
+        FPTPRebuildSettings Settings;
+        Settings.NumSamplePoints = CVarPTPBenchNumPoints.GetValueOnAnyThread();
+        Settings.NumPlates = CVarPTPBenchNumPlates.GetValueOnAnyThread();
+        Settings.PlanetRadiusKm = Defaults->PlanetRadiusKm;
+        Settings.ContinentalRatio = Defaults->ContinentalRatio;
+        Settings.MaxPlateSpeedMmPerYear = Defaults->MaxPlateSpeedMmPerYear;
+        Settings.AbyssalPlainElevationKm = Defaults->AbyssalPlainElevationKm;
+        Settings.HighestOceanicRidgeElevationKm = Defaults->HighestOceanicRidgeElevationKm;
+        Settings.InitialSeed = Defaults->InitialSeed;
+        Settings.bSpatialReorder = false;
+        Settings.bBuildAdjacency = true;
+
+        FPTPPlanetState Lattice;
+        FString Error;
+        if (!FPTPPlanetRebuild::Run(Settings, Lattice, [](EPTPRebuildStage) {}, []() { return false; }, Error))
+        {
+            UE_LOG(LogGaiaPTP, Error, TEXT("ptp.bench.reorder: rebuild failed: %s"), *Error);
+            return;
+        }
+
+        // Reorder a copy so both runs share one triangulation and plate assignment
+        FPTPPlanetState Hilbert = Lattice;
+        TArray<int32> NewToOld;
+        FPTPSpatialOrder::ComputeHilbertOrder(Hilbert.SamplePoints, NewToOld);
+        FPTPSpatialOrder::Reorder(Hilbert, NewToOld);
+
+        const double LatticeMs = TimeBoundaryPasses(Lattice);
+        const double HilbertMs = TimeBoundaryPasses(Hilbert);
+        UE_LOG(LogGaiaPTP, Log, TEXT("ptp.bench.reorder: N=%d plates=%d"), Settings.NumSamplePoints, Settings.NumPlates);
+        UE_LOG(LogGaiaPTP, Log, TEXT("  Fibonacci order: %.2f ms, %.1f%% of neighbours within 32 indices"),
+            LatticeMs, 100.0f * FPTPSpatialOrder::ComputeNeighborLocality(Lattice.Neighbors, 32));
+        UE_LOG(LogGaiaPTP, Log, TEXT("  Hilbert order:   %.2f ms, %.1f%% of neighbours within 32 indices"),
+            HilbertMs, 100.0f * FPTPSpatialOrder::ComputeNeighborLocality(Hilbert.Neighbors, 32));
+    }
+
+    FAutoConsoleCommand CmdBenchReorder(
+        TEXT("ptp.bench.reorder"),
+        TEXT("Times boundary detection and distance-to-front in Fibonacci vs Hilbert sample order"),
+        FConsoleCommandDelegate::CreateStatic(&PTPBenchReorder));
+
+    // Best of three runs of a per-point kernel (a few dozen hash rounds per point) over a partition, in ms
+    double TimePartition(const FPTPPlateMembership& Membership, const FPTPPlatePartition& Partition, bool bSingleThread, TArray<uint32>& Out)
+    {
+        double Best = TNumericLimits<double>::Max();
+        for (int32 Run = 0; Run < 3; ++Run)
+        {
+            const double Start = FPlatformTime::Seconds();
+            Partition.Dispatch([&](int32 ItemIdx, const FPTPPlateWorkItem& Item)
+            {
+                for (int32 PointIdx : Item.Slice(Membership.GetPlatePoints(Item.Plate)))
+                {
+                    uint32 H = (uint32)PointIdx;
+                    for (int32 Round = 0; Round < 32; ++Round)
+                    {
+                        H = FPTPHash::Hash(H, (uint32)Item.Plate, (uint32)Round);
+                    }
+                    Out[PointIdx] = H;
+                }
+            }, bSingleThread);
+            Best = FMath::Min(Best, (FPlatformTime::Seconds() - Start) * 1000.0);
+        }
+        return Best;
+    }
+
+    // Per-plate kernel scaling: one item per plate (plain ParallelFor over plates) vs the balanced partition.
+    // Usage: ptp.bench.partition (uses ptp.bench.numPoints / ptp.bench.numPlates)
+    void PTPBenchPartition()
+    {
+        const UGaiaPTPSettings* Defaults = GetDefault<UGaiaPTPSettings>();
+        FPTPRebuildSettings Settings;
+        Settings.NumSamplePoints = CVarPTPBenchNumPoints.GetValueOnAnyThread();
+        Settings.NumPlates = CVarPTPBenchNumPlates.GetValueOnAnyThread();
+        Settings.PlanetRadiusKm = Defaults->PlanetRadiusKm;
+        Settings.ContinentalRatio = Defaults->ContinentalRatio;
+        Settings.MaxPlateSpeedMmPerYear = Defaults->MaxPlateSpeedMmPerYear;
+        Settings.AbyssalPlainElevationKm = Defaults->AbyssalPlainElevationKm;
+        Settings.HighestOceanicRidgeElevationKm = Defaults->HighestOceanicRidgeElevationKm;
+        Settings.InitialSeed = Defaults->InitialSeed;
+        Settings.bBuildAdjacency = false;
+
+        FPTPPlanetState State;
+        FString Error;
+        if (!FPTPPlanetRebuild::Run(Settings, State, [](EPTPRebuildStage) {}, []() { return false; }, Error))
+        {
+            UE_LOG(LogGaiaPTP, Error, TEXT("ptp.bench.partition: rebuild failed: %s"), *Error);
+            return;
+        }
+        const FPTPPlateMembership& Membership = State.Membership;
+
+        int32 Largest = 0;
+        for (int32 p = 0; p < Membership.GetNumPlates(); ++p)
+        {
+            Largest = FMath::Max(Largest, Membership.GetPlateCount(p));
+        }
+
+        const FPTPPlatePartition PerPlate(Membership, MAX_int32);
+        const FPTPPlatePartition Balanced(Membership);
+        TArray<uint32> Out;
+        Out.SetNumUninitialized(State.SamplePoints.Num());
+
+        const int32 NumWorkers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+        const double SerialMs = TimePartition(Membership, Balanced, true, Out);
+        const double PerPlateMs = TimePartition(Membership, PerPlate, false, Out);
+        const double BalancedMs = TimePartition(Membership, Balanced, false, Out);
+        UE_LOG(LogGaiaPTP, Log, TEXT("ptp.bench.partition: N=%d plates=%d threads=%d, largest plate %.1f%% of points"),
+            Membership.GetNumPoints(), Membership.GetNumPlates(), NumWorkers,
+            100.0 * Largest / FMath::Max(Membership.GetNumPoints(), 1));
+        UE_LOG(LogGaiaPTP, Log, TEXT("  Single thread:          %8.2f ms"), SerialMs);
+        UE_LOG(LogGaiaPTP, Log, TEXT("  Per plate (%5d items): %8.2f ms, %5.1fx, %3.0f%% efficiency"),
+            PerPlate.GetNumItems(), PerPlateMs, SerialMs / PerPlateMs, 100.0 * SerialMs / PerPlateMs / NumWorkers);
+        UE_LOG(LogGaiaPTP, Log, TEXT("  Balanced  (%5d items): %8.2f ms, %5.1fx, %3.0f%% efficiency"),
+            Balanced.GetNumItems(), BalancedMs, SerialMs / BalancedMs, 100.0 * SerialMs / BalancedMs / NumWorkers);
+    }
+
+    FAutoConsoleCommand CmdBenchPartition(
+        TEXT("ptp.bench.partition"),
+        TEXT("Times a per-plate kernel dispatched per plate vs over the load-balanced plate partition"),
+        FConsoleCommandDelegate::CreateStatic(&PTPBenchPartition));
+
+    // Catalogue generation and "craters affecting p" queries on a Moon-sized body.
+    // Usage: ptp.bench.craters [NumCraters=1000000] [NumQueries=100000]
+    void PTPBenchCraters(const TArray<FString>& Args)
+    {
+        FPTPCraterParams Params;
+        Params.Seed = GetDefault<UGaiaPTPSettings>()->InitialSeed;
+        Params.NumCraters = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000000;
+        const int32 NumQueries = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 100000;
+
+        FPTPCraterCatalog Catalog;
+        double StartTime = FPlatformTime::Seconds();
+        Catalog.Generate(Params);
+        const double GenerateMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+        int64 NumHits = 0;
+        StartTime = FPlatformTime::Seconds();
+        for (int32 q = 0; q < NumQueries; ++q)
+        {
+            const float Z = 2.0f * FPTPHash::UnitFloat(FPTPHash::Hash(7u, q, 0u)) - 1.0f;
+            const float Phi = 2.0f * PI * FPTPHash::UnitFloat(FPTPHash::Hash(7u, q, 1u));
+            const float R = FMath::Sqrt(FMath::Max(1.0f - Z * Z, 0.0f));
+            Catalog.ForEachCraterAffecting(FVector3f(R * FMath::Cos(Phi), R * FMath::Sin(Phi), Z), [&NumHits](int32) { ++NumHits; });
+        }
+        const double QueryMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+        UE_LOG(LogGaiaPTP, Log, TEXT("ptp.bench.craters: %d craters, %d size classes, %.1f bytes/crater"),
+            Catalog.Num(), Catalog.GetNumSizeClasses(), double(Catalog.GetAllocatedSize()) / FMath::Max(Catalog.Num(), 1));
+        UE_LOG(LogGaiaPTP, Log, TEXT("  Generate: %8.2f ms"), GenerateMs);
+        UE_LOG(LogGaiaPTP, Log, TEXT("  Query:    %8.2f ms for %d points, %.3f us/point, %.1f craters/point"),
+            QueryMs, NumQueries, 1000.0 * QueryMs / FMath::Max(NumQueries, 1), double(NumHits) / FMath::Max(NumQueries, 1));
+    }
+
+    FAutoConsoleCommand CmdBenchCraters(
+        TEXT("ptp.bench.craters"),
+        TEXT("Generates a crater catalogue and times point queries against its spatial hash"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&PTPBenchCraters));
+
+    // Drainage of a freshly built planet: depression filling, receivers, accumulation and reaches.
+    // Usage: ptp.bench.hydrology [RiverThreshold=100] (uses ptp.bench.numPoints / ptp.bench.numPlates)
+    void PTPBenchHydrology(const TArray<FString>& Args)
+    {
+        const UGaiaPTPSettings* Defaults = GetDefault<UGaiaPTPSettings>();
+        FPTPRebuildSettings Settings;
+        Settings.NumSamplePoints = CVarPTPBenchNumPoints.GetValueOnAnyThread();
+        Settings.NumPlates = CVarPTPBenchNumPlates.GetValueOnAnyThread();
+        Settings.PlanetRadiusKm = Defaults->PlanetRadiusKm;
+        Settings.ContinentalRatio = Defaults->ContinentalRatio;
+        Settings.MaxPlateSpeedMmPerYear = Defaults->MaxPlateSpeedMmPerYear;
+        Settings.AbyssalPlainElevationKm = Defaults->AbyssalPlainElevationKm;
+        Settings.HighestOceanicRidgeElevationKm = Defaults->HighestOceanicRidgeElevationKm;
+        Settings.InitialSeed = Defaults->InitialSeed;
+        Settings.bBuildAdjacency = true;
+
+        FPTPPlanetState State;
+        FString Error;
+        if (!FPTPPlanetRebuild::Run(Settings, State, [](EPTPRebuildStage) {}, []() { return false; }, Error))
+        {
+            UE_LOG(LogGaiaPTP, Error, TEXT("ptp.bench.hydrology: rebuild failed: %s"), *Error);
+            return;
+        }
+
+        TArray<float> ElevationKm;
+        ElevationKm.SetNumUninitialized(State.CrustData.Num());
+        for (int32 i = 0; i < State.CrustData.Num(); ++i)
+        {
+            ElevationKm[i] = State.CrustData[i].Elevation;
+        }
+
+        double StartTime = FPlatformTime::Seconds();
+        FPTPAdjacency Adjacency;
+        Adjacency.Build(State.Neighbors);
+        const double AdjacencyMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+        FPTPHydrologyParams Params;
+        Params.RiverThreshold = Args.Num() > 0 ? FCString::Atof(*Args[0]) : Params.RiverThreshold;
+        FPTPDrainage Drainage;
+        StartTime = FPlatformTime::Seconds();
+        FPTPHydrology::Compute(Adjacency, State.SamplePoints, ElevationKm, {}, Params, Drainage);
+        const double DrainageMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+        int32 MaxOrder = 0;
+        for (const FPTPRiverReach& Reach : Drainage.Reaches)
+        {
+            MaxOrder = FMath::Max(MaxOrder, Reach.StrahlerOrder);
+        }
+        UE_LOG(LogGaiaPTP, Log, TEXT("ptp.bench.hydrology: N=%d, %d filled, %d reaches, Strahler order up to %d, %.1f bytes/vertex"),
+            ElevationKm.Num(), Drainage.NumFilledVertices, Drainage.Reaches.Num(), MaxOrder,
+            double(Drainage.GetAllocatedSize() + Adjacency.GetAllocatedSize()) / FMath::Max(ElevationKm.Num(), 1));
+        UE_LOG(LogGaiaPTP, Log, TEXT("  CSR adjacency: %8.2f ms"), AdjacencyMs);
+        UE_LOG(LogGaiaPTP, Log, TEXT("  Drainage:      %8.2f ms"), DrainageMs);
+    }
+
+    FAutoConsoleCommand CmdBenchHydrology(
+        TEXT("ptp.bench.hydrology"),
+        TEXT("Builds a planet and times depression filling, flow accumulation and river extraction on it"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&PTPBenchHydrology));
+
+    // Flies a query point down to the surface and along it over a benchmark planet, timing
+    // incremental refinement. Usage: ptp.bench.subdivision [MaxLevel] [Frames]
+    void PTPBenchSubdivision(const TArray<FString>& Args)
+    {
+        const UGaiaPTPSettings* Defaults = GetDefault<UGaiaPTPSettings>();
+        FPTPRebuildSettings Settings;
+        Settings.NumSamplePoints = CVarPTPBenchNumPoints.GetValueOnAnyThread();
+        Settings.NumPlates = CVarPTPBenchNumPlates.GetValueOnAnyThread();
+        Settings.PlanetRadiusKm = Defaults->PlanetRadiusKm;
+        Settings.ContinentalRatio = Defaults->ContinentalRatio;
+        Settings.MaxPlateSpeedMmPerYear = Defaults->MaxPlateSpeedMmPerYear;
+        Settings.AbyssalPlainElevationKm = Defaults->AbyssalPlainElevationKm;
+        Settings.HighestOceanicRidgeElevationKm = Defaults->HighestOceanicRidgeElevationKm;
+        Settings.InitialSeed = Defaults->InitialSeed;
+        Settings.bBuildAdjacency = true;
+
+        FPTPPlanetState State;
+        FString Error;
+        if (!FPTPPlanetRebuild::Run(Settings, State, [](EPTPRebuildStage) {}, []() { return false; }, Error))
+        {
+            UE_LOG(LogGaiaPTP, Error, TEXT("ptp.bench.subdivision: rebuild failed: %s"), *Error);
+            return;
+        }
+
+        FPTPSubdivisionSettings SubdivisionSettings;
+        SubdivisionSettings.PlanetRadiusKm = Settings.PlanetRadiusKm;
+        SubdivisionSettings.MaxLevel = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : SubdivisionSettings.MaxLevel;
+        const int32 NumFrames = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 600;
+
+        double StartTime = FPlatformTime::Seconds();
+        FPTPAdaptiveSubdivider Subdivider;
+        Subdivider.Build(State.SamplePoints, State.Triangles, SubdivisionSettings, FPTPHeightSources::MakeCoarsePoints(
+            FPTPCrustSampling::MakeBarycentricSampler(State.SamplePoints, State.Triangles, State.CrustData)));
+        const double BuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+        // Descend from orbit over the first half, then skim the surface at 1 km
+        const double RadiusKm = Settings.PlanetRadiusKm;
+        FPTPSubdivisionDelta Delta;
+        double TotalMs = 0.0;
+        double WorstMs = 0.0;
+        int64 NumSplits = 0;
+        int64 NumMerges = 0;
+        int64 NumPatches = 0;
+        int32 MaxPatches = 0;
+        for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            const double T = double(Frame) / NumFrames;
+            const double Altitude = T < 0.5 ? FMath::Lerp(RadiusKm, 1.0, 2.0 * T) : 1.0;
+            const double Angle = T * 0.2;
+            const FVector Query = FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.3).GetSafeNormal() * (RadiusKm + Altitude);
+
+            StartTime = FPlatformTime::Seconds();
+            Subdivider.Update(Query, Delta);
+            const double FrameMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+            TotalMs += FrameMs;
+            WorstMs = FMath::Max(WorstMs, FrameMs);
+            NumSplits += Delta.NumSplits;
+            NumMerges += Delta.NumMerges;
+            NumPatches += Delta.Patches.Num();
+            MaxPatches = FMath::Max(MaxPatches, Delta.Patches.Num());
+        }
+
+        UE_LOG(LogGaiaPTP, Log, TEXT("ptp.bench.subdivision: N=%d, %d base triangles -> %d leaves, %d vertices, depth %d, %d patches, %.1f MB"),
+            State.SamplePoints.Num(), State.Triangles.Num(), Subdivider.GetNumLeaves(), Subdivider.GetNumVertices(), Subdivider.GetMaxDepth(),
+            Subdivider.GetNumPatches(), Subdivider.GetAllocatedSize() / (1024.0 * 1024.0));
+        UE_LOG(LogGaiaPTP, Log, TEXT("  Build:          %8.2f ms"), BuildMs);
+        UE_LOG(LogGaiaPTP, Log, TEXT("  Update (mean):  %8.3f ms over %d frames, worst %.2f ms"), TotalMs / NumFrames, NumFrames, WorstMs);
+        UE_LOG(LogGaiaPTP, Log, TEXT("  Per frame:      %.1f splits, %.1f merges, %.1f patches out (max %d)"),
+            double(NumSplits) / NumFrames, double(NumMerges) / NumFrames, double(NumPatches) / NumFrames, MaxPatches);
+    }
+
+    FAutoConsoleCommand CmdBenchSubdivision(
+        TEXT("ptp.bench.subdivision"),
+        TEXT("Builds a planet and times CPU adaptive subdivision along a descending flight: ptp.bench.subdivision [MaxLevel] [Frames]"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&PTPBenchSubdivision));
+
+    // Per-array bytes of every live planet, with the preview mesh when hosted by APTPPlanetActor.
+    // Usage: ptp.mem.report
+    void PTPMemReport()
+    {
+        const SIZE_T Budget = FPTPMemory::GetBudgetBytes();
+        FPTPMemoryReport Total;
+        int32 NumPlanets = 0;
+        for (TObjectIterator<UPTPPlanetComponent> It; It; ++It)
+        {
+            if (It->IsTemplate() || !It->IsRegistered())
+            {
+                continue;
+            }
+            const APTPPlanetActor* Actor = Cast<APTPPlanetActor>(It->GetOwner());
+            const FPTPMemoryReport Report = Actor ? Actor->GetMemoryReport() : It->GetMemoryReport();
+            UE_LOG(LogGaiaPTP, Log, TEXT("ptp.mem.report: %s - %d samples, %d triangles, budget %s"),
+                Actor ? *Actor->GetActorNameOrLabel() : *It->GetPathName(), It->SamplePoints.Num(), It->Triangles.Num(),
+                Budget > 0 ? *FString::Printf(TEXT("%.0f%%"), 100.0 * double(Report.GetTotal()) / double(Budget)) : TEXT("off"));
+            FPTPMemory::LogReport(Report, It->SamplePoints.Num());
+            if (const FPTPStepScratch* Scratch = It->GetScratch())
+            {
+                Scratch->LogKernelPeaks();
+            }
+            Total += Report;
+            ++NumPlanets;
+        }
+        if (NumPlanets == 0)
+        {
+            UE_LOG(LogGaiaPTP, Log, TEXT("ptp.mem.report: no registered planets"));
+        }
+        else if (NumPlanets > 1)
+        {
+            UE_LOG(LogGaiaPTP, Log, TEXT("ptp.mem.report: all %d planets"), NumPlanets);
+            FPTPMemory::LogReport(Total, 0);
+        }
+    }
+
+    FAutoConsoleCommand CmdMemReport(
+        TEXT("ptp.mem.report"),
+        TEXT("Logs the bytes each PTP planet holds per array and preview mesh, against the per-planet budget"),
+        FConsoleCommandDelegate::CreateStatic(&PTPMemReport));
 }
 
 namespace PTPProfiling
 {
     void RegisterConsoleCommands() {}
     void UnregisterConsoleCommands() {}
+
+    bool IsParallelEnabled()
+    {
+        return CVarPTPParallel.GetValueOnAnyThread() != 0;
+    }
 }
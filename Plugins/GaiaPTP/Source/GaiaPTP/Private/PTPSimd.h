@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/ParallelFor.h"
+#include "Math/VectorRegister.h"
+
+/**
+ * Small helpers on top of UE's portable VectorRegister4Float (SSE on x64, NEON on arm64).
+ * Kernels process PTPSimd::Lanes samples per iteration and fall back to their scalar
+ * reference for the tail so both paths share one formula.
+ */
+namespace PTPSimd
+{
+    constexpr int32 Lanes = 4;
+
+    /** Samples per ParallelFor task for streaming kernels: 16K floats = 64KB per array, L2-sized. */
+    constexpr int32 ChunkSize = 16 * 1024;
+
+    /** Build a lane mask (all bits set where Bytes[i] == Value) from four consecutive bytes. */
+    FORCEINLINE VectorRegister4Float LoadByteMask(const uint8* Bytes, uint8 Value)
+    {
+        const VectorRegister4Float Lane = MakeVectorRegister(
+            (float)Bytes[0], (float)Bytes[1], (float)Bytes[2], (float)Bytes[3]);
+        return VectorCompareEQ(Lane, VectorSetFloat1((float)Value));
+    }
+
+    /** Build a lane mask (all bits set where Bytes[i] != 0) from four consecutive bytes. */
+    FORCEINLINE VectorRegister4Float LoadByteFlag(const uint8* Bytes)
+    {
+        const VectorRegister4Float Lane = MakeVectorRegister(
+            (float)Bytes[0], (float)Bytes[1], (float)Bytes[2], (float)Bytes[3]);
+        return VectorCompareNE(Lane, VectorZeroFloat());
+    }
+
+    FORCEINLINE VectorRegister4Float Clamp(const VectorRegister4Float& X, const VectorRegister4Float& Lo, const VectorRegister4Float& Hi)
+    {
+        return VectorMin(VectorMax(X, Lo), Hi);
+    }
+
+    /** Number of chunks needed to cover Num samples. */
+    FORCEINLINE int32 NumChunks(int32 Num, int32 InChunkSize = ChunkSize)
+    {
+        return (Num + InChunkSize - 1) / InChunkSize;
+    }
+
+    /** Run Fn(Begin, End) over ChunkSize ranges of [0, Num), on the task graph when bDoParallel. */
+    template <typename FnType>
+    void ForEachRange(int32 Num, bool bDoParallel, FnType&& Fn)
+    {
+        ParallelFor(NumChunks(Num), [&](int32 ChunkIdx)
+        {
+            const int32 Begin = ChunkIdx * ChunkSize;
+            Fn(Begin, FMath::Min(Begin + ChunkSize, Num));
+        }, !bDoParallel);
+    }
+}
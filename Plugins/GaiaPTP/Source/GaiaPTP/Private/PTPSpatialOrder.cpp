@@ -0,0 +1,177 @@
+#include "PTPSpatialOrder.h"
+#include "Algo/Sort.h"
+#include "Async/ParallelFor.h"
+#include "PTPCubeMap.h"
+#include "PTPPlanetRebuild.h"
+#include "PTPProfiling.h"
+
+namespace
+{
+    constexpr int32 HilbertBits = 16;
+
+    /** Index of cell (X, Y) along the Hilbert curve filling a 2^HilbertBits square. */
+    uint32 HilbertIndex(uint32 X, uint32 Y)
+    {
+        uint32 D = 0;
+        for (uint32 S = 1u << (HilbertBits - 1); S > 0; S >>= 1)
+        {
+            const uint32 RX = (X & S) ? 1 : 0;
+            const uint32 RY = (Y & S) ? 1 : 0;
+            D += S * S * ((3 * RX) ^ RY);
+            // Rotate the quadrant so the sub-curve enters and leaves where its neighbours expect
+            if (RY == 0)
+            {
+                if (RX == 1)
+                {
+                    X = S - 1 - X;
+                    Y = S - 1 - Y;
+                }
+                Swap(X, Y);
+            }
+        }
+        return D;
+    }
+}
+
+uint64 FPTPSpatialOrder::HilbertKey(const FVector3f& Dir)
+{
+    int32 Face;
+    float S, T;
+    FPTPCubeMap::DirectionToFace(Dir, Face, S, T);
+    const float Cells = float(1 << HilbertBits);
+    const uint32 X = (uint32)FMath::Clamp(int32((S + 1.0f) * 0.5f * Cells), 0, (1 << HilbertBits) - 1);
+    const uint32 Y = (uint32)FMath::Clamp(int32((T + 1.0f) * 0.5f * Cells), 0, (1 << HilbertBits) - 1);
+    return (uint64(Face) << 32) | HilbertIndex(X, Y);
+}
+
+namespace
+{
+    /** Stable sort of point indices by a 64-bit key. */
+    template <typename KeyFunc>
+    void SortByKey(int32 Num, KeyFunc&& GetKey, TArray<int32>& OutNewToOld)
+    {
+        struct FKeyed
+        {
+            uint64 Key;
+            int32 Index;
+        };
+        TArray<FKeyed> Keyed;
+        Keyed.SetNumUninitialized(Num);
+        ParallelFor(Num, [&](int32 i)
+        {
+            Keyed[i] = { GetKey(i), i };
+        });
+        Algo::Sort(Keyed, [](const FKeyed& A, const FKeyed& B) { return A.Key != B.Key ? A.Key < B.Key : A.Index < B.Index; });
+
+        OutNewToOld.SetNumUninitialized(Num);
+        for (int32 i = 0; i < Keyed.Num(); ++i)
+        {
+            OutNewToOld[i] = Keyed[i].Index;
+        }
+    }
+
+    template <typename VectorType>
+    void SortByHilbertKey(TConstArrayView<VectorType> Points, TArray<int32>& OutNewToOld)
+    {
+        CSV_SCOPED_TIMING_STAT(GAIA_PTP, HilbertOrder);
+        SortByKey(Points.Num(), [&](int32 i) { return FPTPSpatialOrder::HilbertKey(FVector3f(Points[i])); }, OutNewToOld);
+    }
+}
+
+void FPTPSpatialOrder::ComputeHilbertOrder(TConstArrayView<FVector> Points, TArray<int32>& OutNewToOld)
+{
+    SortByHilbertKey(Points, OutNewToOld);
+}
+
+void FPTPSpatialOrder::ComputeHilbertOrder(TConstArrayView<FVector3f> Points, TArray<int32>& OutNewToOld)
+{
+    SortByHilbertKey(Points, OutNewToOld);
+}
+
+void FPTPSpatialOrder::ComputePlateHilbertOrder(TConstArrayView<FVector3f> Points, TConstArrayView<int32> PointPlateIds, TArray<int32>& OutNewToOld)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, HilbertOrder);
+    check(Points.Num() == PointPlateIds.Num());
+    // Plate above the 35 key bits; INDEX_NONE maps to 0 so unassigned samples lead
+    SortByKey(Points.Num(), [&](int32 i) { return (uint64(uint32(PointPlateIds[i] + 1)) << 35) | HilbertKey(Points[i]); }, OutNewToOld);
+}
+
+bool FPTPSpatialOrder::IsIdentity(TConstArrayView<int32> NewToOld)
+{
+    for (int32 i = 0; i < NewToOld.Num(); ++i)
+    {
+        if (NewToOld[i] != i)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FPTPSpatialOrder::InvertPermutation(TConstArrayView<int32> NewToOld, TArray<int32>& OutOldToNew)
+{
+    OutOldToNew.SetNumUninitialized(NewToOld.Num());
+    for (int32 New = 0; New < NewToOld.Num(); ++New)
+    {
+        OutOldToNew[NewToOld[New]] = New;
+    }
+}
+
+float FPTPSpatialOrder::ComputeNeighborLocality(const TArray<TArray<int32>>& Neighbors, int32 Window)
+{
+    int64 Links = 0;
+    int64 Near = 0;
+    for (int32 i = 0; i < Neighbors.Num(); ++i)
+    {
+        for (int32 n : Neighbors[i])
+        {
+            ++Links;
+            Near += FMath::Abs(n - i) <= Window ? 1 : 0;
+        }
+    }
+    return Links > 0 ? float(double(Near) / double(Links)) : 0.0f;
+}
+
+void FPTPSpatialOrder::Reorder(FPTPPlanetState& State, TConstArrayView<int32> NewToOld)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, Reorder);
+    check(State.SamplePoints.Num() == NewToOld.Num());
+
+    TArray<int32> OldToNew;
+    InvertPermutation(NewToOld, OldToNew);
+
+    Permute(State.SamplePoints, NewToOld);
+    Permute(State.PointPlateIds, NewToOld);
+    Permute(State.CrustData, NewToOld);
+    Permute(State.IsBoundaryPoint, NewToOld);
+    Permute(State.BoundaryTypes, NewToOld);
+    Permute(State.DistanceToFrontKm, NewToOld);
+
+    // Original ids compose: the sample now at i was at NewToOld[i], which had id SampleOrder[NewToOld[i]]
+    if (State.SampleOrder.Num() == NewToOld.Num())
+    {
+        Permute(State.SampleOrder, NewToOld);
+    }
+    else
+    {
+        State.SampleOrder = TArray<int32>(NewToOld.GetData(), NewToOld.Num());
+    }
+
+    Permute(State.Neighbors, NewToOld);
+    ParallelFor(State.Neighbors.Num(), [&](int32 i)
+    {
+        for (int32& n : State.Neighbors[i])
+        {
+            n = OldToNew[n];
+        }
+    });
+    for (FIntVector& Tri : State.Triangles)
+    {
+        Tri = FIntVector(OldToNew[Tri.X], OldToNew[Tri.Y], OldToNew[Tri.Z]);
+    }
+    // Ranges must stay ascending, so the partition is rebuilt from the permuted plate ids
+    if (State.Membership.GetNumPoints() > 0)
+    {
+        State.Membership.Build(State.PointPlateIds, State.Membership.GetNumPlates());
+    }
+}
@@ -0,0 +1,358 @@
+#include "PTPVisualizationLayers.h"
+#include "GaiaPTP.h"
+#include "ImageUtils.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "PTPPlanetActor.h"
+#include "PTPPlanetComponent.h"
+#include "PTPPlanetMeshBuilder.h"
+#include "PTPPointLocator.h"
+#include "PTPProfiling.h"
+#include "PTPSimd.h"
+#include "TectonicData.h"
+#include "Core/RealtimeMeshDataStream.h"
+#include "Core/RealtimeMeshDataTypes.h"
+#include "UObject/UObjectIterator.h"
+
+using namespace RealtimeMesh;
+
+const FName FPTPVisualizationLayers::ScalarLayerParameter(TEXT("PTPScalarLayer"));
+
+namespace
+{
+    const FPTPLayerInfo LayerInfos[] =
+    {
+        { TEXT("PlateId"),           EPTPLayerEncoding::Color,  TEXT("") },
+        { TEXT("Elevation"),         EPTPLayerEncoding::Scalar, TEXT("km") },
+        { TEXT("CrustType"),         EPTPLayerEncoding::Color,  TEXT("") },
+        { TEXT("OceanicAge"),        EPTPLayerEncoding::Scalar, TEXT("My") },
+        { TEXT("OrogenyAge"),        EPTPLayerEncoding::Scalar, TEXT("My") },
+        { TEXT("BoundaryType"),      EPTPLayerEncoding::Color,  TEXT("") },
+        { TEXT("VelocityMagnitude"), EPTPLayerEncoding::Scalar, TEXT("mm/yr") },
+        { TEXT("DistanceToFront"),   EPTPLayerEncoding::Scalar, TEXT("km") },
+    };
+    static_assert(UE_ARRAY_COUNT(LayerInfos) == (int32)EPTPVisualizationLayer::DistanceToFront + 1, "One info per layer");
+
+    // Stops of the scalar colour ramp, evenly spaced over [0, 1]
+    const FColor RampStops[] =
+    {
+        FColor(48, 18, 59), FColor(40, 120, 230), FColor(60, 210, 130), FColor(240, 200, 40), FColor(180, 20, 20)
+    };
+}
+
+FPTPLayerSource FPTPLayerSource::FromPlanet(const UPTPPlanetComponent& Planet)
+{
+    FPTPLayerSource Source;
+    Source.Points = Planet.SamplePoints;
+    Source.PlateIds = Planet.PointPlateIds;
+    Source.Crust = Planet.CrustData;
+    Source.Plates = Planet.Plates;
+    Source.BoundaryTypes = Planet.BoundaryTypes;
+    Source.DistanceToFrontKm = Planet.DistanceToFrontKm;
+    Source.ElevationRangeKm = FVector2f(Planet.OceanicTrenchElevationKm, Planet.HighestContinentalAltitudeKm);
+    Source.MaxPlateSpeedMmPerYear = Planet.MaxPlateSpeedMmPerYear;
+    Source.FrontRangeKm = Planet.CollisionDistanceKm;
+    return Source;
+}
+
+const FPTPLayerInfo& FPTPVisualizationLayers::GetInfo(EPTPVisualizationLayer Layer)
+{
+    return LayerInfos[FMath::Clamp((int32)Layer, 0, (int32)UE_ARRAY_COUNT(LayerInfos) - 1)];
+}
+
+bool FPTPVisualizationLayers::FindLayer(const FString& NameOrIndex, EPTPVisualizationLayer& OutLayer)
+{
+    const FString Trimmed = NameOrIndex.TrimStartAndEnd();
+    if (Trimmed.IsNumeric())
+    {
+        const int32 Index = FCString::Atoi(*Trimmed);
+        if (Index >= 0 && Index < (int32)UE_ARRAY_COUNT(LayerInfos))
+        {
+            OutLayer = (EPTPVisualizationLayer)Index;
+            return true;
+        }
+        return false;
+    }
+    for (int32 Index = 0; Index < (int32)UE_ARRAY_COUNT(LayerInfos); ++Index)
+    {
+        if (Trimmed.Equals(LayerInfos[Index].Name, ESearchCase::IgnoreCase))
+        {
+            OutLayer = (EPTPVisualizationLayer)Index;
+            return true;
+        }
+    }
+    return false;
+}
+
+float FPTPVisualizationLayers::SampleScalar(EPTPVisualizationLayer Layer, const FPTPLayerSource& Source, int32 Sample)
+{
+    switch (Layer)
+    {
+    case EPTPVisualizationLayer::Elevation:
+        return Source.Crust.IsValidIndex(Sample) ? Source.Crust[Sample].Elevation : 0.0f;
+    case EPTPVisualizationLayer::OceanicAge:
+        return Source.Crust.IsValidIndex(Sample) ? Source.Crust[Sample].OceanicAge : 0.0f;
+    case EPTPVisualizationLayer::OrogenyAge:
+        return Source.Crust.IsValidIndex(Sample) ? Source.Crust[Sample].OrogenyAge : 0.0f;
+    case EPTPVisualizationLayer::VelocityMagnitude:
+    {
+        // Points are in km and angular velocity in rad/My, so km/My == mm/yr
+        const int32 PlateId = Source.PlateIds.IsValidIndex(Sample) ? Source.PlateIds[Sample] : INDEX_NONE;
+        return Source.Plates.IsValidIndex(PlateId) && Source.Points.IsValidIndex(Sample)
+            ? (float)Source.Plates[PlateId].GetVelocityAtPoint(FVector(Source.Points[Sample])).Size()
+            : 0.0f;
+    }
+    case EPTPVisualizationLayer::DistanceToFront:
+        return Source.DistanceToFrontKm.IsValidIndex(Sample) ? Source.DistanceToFrontKm[Sample] : 0.0f;
+    default:
+        return 0.0f;
+    }
+}
+
+FVector2f FPTPVisualizationLayers::GetScalarRange(EPTPVisualizationLayer Layer, const FPTPLayerSource& Source)
+{
+    switch (Layer)
+    {
+    case EPTPVisualizationLayer::Elevation:         return Source.ElevationRangeKm;
+    case EPTPVisualizationLayer::OceanicAge:        return FVector2f(0.0f, 200.0f);    // ridge to oldest sea floor
+    case EPTPVisualizationLayer::OrogenyAge:        return FVector2f(0.0f, 3000.0f);   // initial continental ages reach 3000 My
+    case EPTPVisualizationLayer::VelocityMagnitude: return FVector2f(0.0f, Source.MaxPlateSpeedMmPerYear);
+    case EPTPVisualizationLayer::DistanceToFront:   return FVector2f(0.0f, Source.FrontRangeKm);
+    default:                                        return FVector2f(0.0f, 1.0f);
+    }
+}
+
+FColor FPTPVisualizationLayers::SampleColor(EPTPVisualizationLayer Layer, const FPTPLayerSource& Source, int32 Sample)
+{
+    switch (Layer)
+    {
+    case EPTPVisualizationLayer::PlateId:
+        return Source.PlateIds.IsValidIndex(Sample) ? FPTPPlanetMeshBuilder::PlateColor(Source.PlateIds[Sample]) : FColor::Cyan;
+    case EPTPVisualizationLayer::CrustType:
+        if (!Source.Crust.IsValidIndex(Sample))
+        {
+            return FColor::Cyan;
+        }
+        return Source.Crust[Sample].Type == ECrustType::Oceanic ? FColor(30, 60, 160) : FColor(150, 120, 70);
+    case EPTPVisualizationLayer::BoundaryType:
+        if (!Source.BoundaryTypes.IsValidIndex(Sample))
+        {
+            return FColor::Cyan;
+        }
+        switch (Source.BoundaryTypes[Sample])
+        {
+        case EPTPBoundaryType::Convergent: return FColor(220, 50, 40);
+        case EPTPBoundaryType::Divergent:  return FColor(40, 120, 230);
+        case EPTPBoundaryType::Transform:  return FColor(240, 200, 40);
+        default:                           return FColor(40, 40, 40);
+        }
+    default:
+        {
+            const FVector2f Range = GetScalarRange(Layer, Source);
+            return RampColor((SampleScalar(Layer, Source, Sample) - Range.X) / FMath::Max(Range.Y - Range.X, UE_SMALL_NUMBER));
+        }
+    }
+}
+
+void FPTPVisualizationLayers::FillColors(EPTPVisualizationLayer Layer, const FPTPPlanetMeshLayout& Layout, const FPTPLayerSource& Source,
+                                         FRealtimeMeshStream& ColorStream)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, VizLayerColor);
+    check(ColorStream.Num() == Layout.NumVertices);
+    TArrayView<FColor> Colors = ColorStream.GetArrayView<FColor>();
+    PTPSimd::ForEachRange(Layout.NumVertices, PTPProfiling::IsParallelEnabled(), [&](int32 Begin, int32 End)
+    {
+        for (int32 v = Begin; v < End; ++v)
+        {
+            Colors[v] = SampleColor(Layer, Source, Layout.VertexToSample(v));
+        }
+    });
+}
+
+void FPTPVisualizationLayers::FillScalars(EPTPVisualizationLayer Layer, const FPTPPlanetMeshLayout& Layout, const FPTPLayerSource& Source,
+                                          FRealtimeMeshStream& TexCoordStream)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, VizLayerScalar);
+    check(TexCoordStream.Num() == Layout.NumVertices);
+    TArrayView<FRealtimeMeshTexCoordsNormal> TexCoords = TexCoordStream.GetArrayView<FRealtimeMeshTexCoordsNormal>();
+    const FVector2f Range = GetScalarRange(Layer, Source);
+    const float InvExtent = 1.0f / FMath::Max(Range.Y - Range.X, UE_SMALL_NUMBER);
+    PTPSimd::ForEachRange(Layout.NumVertices, PTPProfiling::IsParallelEnabled(), [&](int32 Begin, int32 End)
+    {
+        for (int32 v = Begin; v < End; ++v)
+        {
+            const float Value = SampleScalar(Layer, Source, Layout.VertexToSample(v));
+            TexCoords[v][0].Y = FFloat16(FMath::Clamp((Value - Range.X) * InvExtent, 0.0f, 1.0f));
+        }
+    });
+}
+
+void FPTPVisualizationLayers::FillInstanceCustomData(EPTPVisualizationLayer Layer, const FPTPPlanetMeshLayout& Layout, const FPTPLayerSource& Source,
+                                                     TArrayView<float> OutCustomData)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, VizLayerInstances);
+    check(OutCustomData.Num() == Layout.NumVertices * NumInstanceCustomData);
+    const bool bScalar = IsScalar(Layer);
+    const FVector2f Range = GetScalarRange(Layer, Source);
+    const float InvExtent = 1.0f / FMath::Max(Range.Y - Range.X, UE_SMALL_NUMBER);
+    PTPSimd::ForEachRange(Layout.NumVertices, PTPProfiling::IsParallelEnabled(), [&](int32 Begin, int32 End)
+    {
+        for (int32 m = Begin; m < End; ++m)
+        {
+            const int32 i = Layout.VertexToSample(m);
+            const float Value = bScalar ? FMath::Clamp((SampleScalar(Layer, Source, i) - Range.X) * InvExtent, 0.0f, 1.0f) : 0.0f;
+            const FColor Color = bScalar ? RampColor(Value) : SampleColor(Layer, Source, i);
+            float* Data = &OutCustomData[m * NumInstanceCustomData];
+            Data[0] = Color.R / 255.0f;
+            Data[1] = Color.G / 255.0f;
+            Data[2] = Color.B / 255.0f;
+            Data[3] = Value;
+        }
+    });
+}
+
+FColor FPTPVisualizationLayers::RampColor(float Normalized)
+{
+    const float T = FMath::Clamp(Normalized, 0.0f, 1.0f) * (UE_ARRAY_COUNT(RampStops) - 1);
+    const int32 Stop = FMath::Min((int32)T, (int32)UE_ARRAY_COUNT(RampStops) - 2);
+    const float Alpha = T - Stop;
+    const FColor& A = RampStops[Stop];
+    const FColor& B = RampStops[Stop + 1];
+    return FColor(
+        (uint8)FMath::RoundToInt(FMath::Lerp((float)A.R, (float)B.R, Alpha)),
+        (uint8)FMath::RoundToInt(FMath::Lerp((float)A.G, (float)B.G, Alpha)),
+        (uint8)FMath::RoundToInt(FMath::Lerp((float)A.B, (float)B.B, Alpha)),
+        255);
+}
+
+bool FPTPVisualizationLayers::RenderEquirectangular(EPTPVisualizationLayer Layer, const FPTPLayerSource& Source, const TArray<FIntVector>& Triangles,
+                                                    int32 Width, TArray<FColor>& OutPixels)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, VizLayerCapture);
+
+    FPTPPointLocator Locator;
+    if (Width < 2 || !Locator.Build(Source.Points, Triangles))
+    {
+        return false;
+    }
+
+    const int32 Height = Width / 2;
+    TArray<FVector3f> Directions;
+    Directions.SetNumUninitialized(Width * Height);
+    for (int32 y = 0; y < Height; ++y)
+    {
+        const float Polar = PI * (y + 0.5f) / Height;
+        for (int32 x = 0; x < Width; ++x)
+        {
+            const float Azimuth = 2.0f * PI * (x + 0.5f) / Width - PI;
+            Directions[y * Width + x] = FVector3f(
+                FMath::Sin(Polar) * FMath::Cos(Azimuth),
+                FMath::Sin(Polar) * FMath::Sin(Azimuth),
+                FMath::Cos(Polar));
+        }
+    }
+
+    TArray<FPTPLocation> Locations;
+    Locations.SetNumUninitialized(Directions.Num());
+    Locator.LocateBatch(Directions, Locations);
+
+    // Nearest sample rather than interpolation, so categorical layers keep their colours
+    OutPixels.SetNumUninitialized(Directions.Num());
+    PTPSimd::ForEachRange(Directions.Num(), PTPProfiling::IsParallelEnabled(), [&](int32 Begin, int32 End)
+    {
+        for (int32 p = Begin; p < End; ++p)
+        {
+            const FPTPLocation& Loc = Locations[p];
+            if (Loc.Triangle == INDEX_NONE)
+            {
+                OutPixels[p] = FColor::Black;
+                continue;
+            }
+            const FVector3f& W = Loc.Barycentrics;
+            const int32 Corner = (W.X >= W.Y && W.X >= W.Z) ? 0 : (W.Y >= W.Z ? 1 : 2);
+            OutPixels[p] = SampleColor(Layer, Source, Locator.GetTriangle(Loc.Triangle)[Corner]);
+        }
+    });
+    return true;
+}
+
+namespace
+{
+    // Usage: ptp.viz.layer <name|index>
+    void PTPVizLayer(const TArray<FString>& Args)
+    {
+        EPTPVisualizationLayer Layer;
+        if (Args.Num() < 1 || !FPTPVisualizationLayers::FindLayer(Args[0], Layer))
+        {
+            UE_LOG(LogGaiaPTP, Warning, TEXT("ptp.viz.layer: expected a layer name or index (e.g. PlateId, Elevation, 3)"));
+            return;
+        }
+        int32 NumActors = 0;
+        for (TObjectIterator<APTPPlanetActor> It; It; ++It)
+        {
+            if (!It->IsTemplate() && It->GetWorld())
+            {
+                It->SetVisualizationLayer(Layer);
+                ++NumActors;
+            }
+        }
+        UE_LOG(LogGaiaPTP, Log, TEXT("ptp.viz.layer: %s on %d planet actor(s)"), FPTPVisualizationLayers::GetInfo(Layer).Name, NumActors);
+    }
+
+    // Usage: ptp.viz.capture <name|index> [width]
+    void PTPVizCapture(const TArray<FString>& Args)
+    {
+        EPTPVisualizationLayer Layer;
+        if (Args.Num() < 1 || !FPTPVisualizationLayers::FindLayer(Args[0], Layer))
+        {
+            UE_LOG(LogGaiaPTP, Warning, TEXT("ptp.viz.capture: expected a layer name or index, optionally followed by the image width"));
+            return;
+        }
+        const int32 Width = Args.Num() > 1 ? FMath::Clamp(FCString::Atoi(*Args[1]), 16, 16384) : 2048;
+
+        const UPTPPlanetComponent* Planet = nullptr;
+        for (TObjectIterator<UPTPPlanetComponent> It; It; ++It)
+        {
+            if (!It->IsTemplate() && It->SamplePoints.Num() > 0 && It->Triangles.Num() > 0)
+            {
+                Planet = *It;
+                break;
+            }
+        }
+        if (!Planet)
+        {
+            UE_LOG(LogGaiaPTP, Warning, TEXT("ptp.viz.capture: no planet with triangulation data"));
+            return;
+        }
+
+        TArray<FColor> Pixels;
+        if (!FPTPVisualizationLayers::RenderEquirectangular(Layer, FPTPLayerSource::FromPlanet(*Planet), Planet->Triangles, Width, Pixels))
+        {
+            UE_LOG(LogGaiaPTP, Warning, TEXT("ptp.viz.capture: planet triangulation is not closed"));
+            return;
+        }
+
+        TArray64<uint8> Png;
+        FImageUtils::PNGCompressImageArray(Width, Width / 2, Pixels, Png);
+        const FString Path = FPaths::ProjectSavedDir() / TEXT("PTP/Captures")
+            / FString::Printf(TEXT("%s_%s.png"), FPTPVisualizationLayers::GetInfo(Layer).Name, *FDateTime::Now().ToString());
+        if (FFileHelper::SaveArrayToFile(Png, *Path))
+        {
+            UE_LOG(LogGaiaPTP, Log, TEXT("ptp.viz.capture: wrote %s"), *Path);
+        }
+        else
+        {
+            UE_LOG(LogGaiaPTP, Warning, TEXT("ptp.viz.capture: failed to write %s"), *Path);
+        }
+    }
+
+    FAutoConsoleCommand CmdVizLayer(
+        TEXT("ptp.viz.layer"),
+        TEXT("Show a visualization layer on all PTP planet actors: ptp.viz.layer <name|index>"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&PTPVizLayer));
+
+    FAutoConsoleCommand CmdVizCapture(
+        TEXT("ptp.viz.capture"),
+        TEXT("Write an equirectangular PNG of a visualization layer to Saved/PTP/Captures: ptp.viz.capture <name|index> [width]"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&PTPVizCapture));
+}
@@ -0,0 +1,178 @@
+#include "SurfaceProcessing.h"
+#include "Async/ParallelFor.h"
+#include "GaiaPTP.h"
+#include "GaiaPTPSettings.h"
+#include "PTPPlanetComponent.h"
+#include "PTPNoise.h"
+#include "PTPProfiling.h"
+#include "PTPSimd.h"
+
+void FPTPCrustSurfaceSoA::Gather(const TArray<FCrustData>& Crust)
+{
+    const int32 N = Crust.Num();
+    CrustType.SetNumUninitialized(N);
+    Elevation.SetNumUninitialized(N);
+    OceanicAge.SetNumUninitialized(N);
+    OrogenyAge.SetNumUninitialized(N);
+    for (int32 i = 0; i < N; ++i)
+    {
+        const FCrustData& C = Crust[i];
+        CrustType[i] = static_cast<uint8>(C.Type);
+        Elevation[i] = C.Elevation;
+        OceanicAge[i] = C.OceanicAge;
+        OrogenyAge[i] = C.OrogenyAge;
+    }
+}
+
+void FPTPCrustSurfaceSoA::Scatter(TArray<FCrustData>& Crust) const
+{
+    check(Crust.Num() == Num());
+    for (int32 i = 0; i < Crust.Num(); ++i)
+    {
+        FCrustData& C = Crust[i];
+        C.Elevation = Elevation[i];
+        C.OceanicAge = OceanicAge[i];
+        C.OrogenyAge = OrogenyAge[i];
+    }
+}
+
+void FSurfaceProcessing::ApplyScalar(const FPTPSurfaceProcessParams& Params, FPTPCrustSurfaceSoA& Fields, int32 Begin, int32 End)
+{
+    const float Dt = Params.TimeStepMy;
+    const float ErosionPerKm = Params.ContinentalErosion * Dt / Params.HighestContinentalAltitudeKm;
+    const float Dampening = Params.OceanicElevationDampening * Dt;
+    const float InvTrenchKm = 1.0f / Params.OceanicTrenchElevationKm;
+    const float TrenchKm = Params.OceanicTrenchElevationKm;
+    const float Accretion = Params.SedimentAccretion * Dt;
+    const bool bHasTrenches = Fields.TrenchMask.Num() == Fields.Num();
+    const uint8 Continental = static_cast<uint8>(ECrustType::Continental);
+
+    for (int32 i = Begin; i < End; ++i)
+    {
+        const float Z = Fields.Elevation[i];
+        const bool bContinental = Fields.CrustType[i] == Continental;
+
+        // z(t+δt) = z - (z/zc)·εc·δt, erosion only above sea level
+        const float Eroded = FMath::Max(Z - FMath::Max(Z, 0.0f) * ErosionPerKm, FMath::Min(Z, 0.0f));
+
+        // z(t+δt) = z - (1 - z/zt)·εo·δt, floored at the trench depth
+        const float Factor = FMath::Clamp(1.0f - Z * InvTrenchKm, 0.0f, 1.0f);
+        float Damped = FMath::Max(Z - Factor * Dampening, TrenchKm);
+
+        // z(t+δt) = z + εf·δt on trench samples
+        Damped += (bHasTrenches && Fields.TrenchMask[i] != 0) ? Accretion : 0.0f;
+
+        Fields.Elevation[i] = bContinental ? Eroded : Damped;
+        Fields.OceanicAge[i] += bContinental ? 0.0f : Dt;
+        Fields.OrogenyAge[i] += bContinental ? Dt : 0.0f;
+    }
+}
+
+void FSurfaceProcessing::Apply(const FPTPSurfaceProcessParams& Params, FPTPCrustSurfaceSoA& Fields)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, SurfaceProcesses);
+
+    const int32 NumPoints = Fields.Num();
+    if (NumPoints == 0)
+    {
+        return;
+    }
+    check(Fields.CrustType.Num() == NumPoints && Fields.OceanicAge.Num() == NumPoints && Fields.OrogenyAge.Num() == NumPoints);
+
+    const bool bHasTrenches = Fields.TrenchMask.Num() == NumPoints;
+    const float Dt = Params.TimeStepMy;
+
+    const VectorRegister4Float Zero = VectorZeroFloat();
+    const VectorRegister4Float One = VectorOneFloat();
+    const VectorRegister4Float DtV = VectorSetFloat1(Dt);
+    const VectorRegister4Float ErosionPerKm = VectorSetFloat1(Params.ContinentalErosion * Dt / Params.HighestContinentalAltitudeKm);
+    const VectorRegister4Float Dampening = VectorSetFloat1(Params.OceanicElevationDampening * Dt);
+    const VectorRegister4Float InvTrenchKm = VectorSetFloat1(1.0f / Params.OceanicTrenchElevationKm);
+    const VectorRegister4Float TrenchKm = VectorSetFloat1(Params.OceanicTrenchElevationKm);
+    const VectorRegister4Float Accretion = VectorSetFloat1(Params.SedimentAccretion * Dt);
+    const uint8 Continental = static_cast<uint8>(ECrustType::Continental);
+
+    const uint8* Types = Fields.CrustType.GetData();
+    const uint8* Trench = bHasTrenches ? Fields.TrenchMask.GetData() : nullptr;
+    float* Elevation = Fields.Elevation.GetData();
+    float* OceanicAge = Fields.OceanicAge.GetData();
+    float* OrogenyAge = Fields.OrogenyAge.GetData();
+
+    auto WorkPerChunk = [&](int32 ChunkIdx)
+    {
+        const int32 Begin = ChunkIdx * PTPSimd::ChunkSize;
+        const int32 End = FMath::Min(Begin + PTPSimd::ChunkSize, NumPoints);
+        const int32 VectorEnd = Begin + ((End - Begin) / PTPSimd::Lanes) * PTPSimd::Lanes;
+
+        for (int32 i = Begin; i < VectorEnd; i += PTPSimd::Lanes)
+        {
+            const VectorRegister4Float Z = VectorLoad(Elevation + i);
+            const VectorRegister4Float IsContinental = PTPSimd::LoadByteMask(Types + i, Continental);
+
+            const VectorRegister4Float Eroded = VectorMax(
+                VectorSubtract(Z, VectorMultiply(VectorMax(Z, Zero), ErosionPerKm)),
+                VectorMin(Z, Zero));
+
+            const VectorRegister4Float Factor = PTPSimd::Clamp(VectorSubtract(One, VectorMultiply(Z, InvTrenchKm)), Zero, One);
+            VectorRegister4Float Damped = VectorMax(VectorSubtract(Z, VectorMultiply(Factor, Dampening)), TrenchKm);
+            if (Trench)
+            {
+                Damped = VectorAdd(Damped, VectorSelect(PTPSimd::LoadByteFlag(Trench + i), Accretion, Zero));
+            }
+
+            VectorStore(VectorSelect(IsContinental, Eroded, Damped), Elevation + i);
+            VectorStore(VectorAdd(VectorLoad(OceanicAge + i), VectorSelect(IsContinental, Zero, DtV)), OceanicAge + i);
+            VectorStore(VectorAdd(VectorLoad(OrogenyAge + i), VectorSelect(IsContinental, DtV, Zero)), OrogenyAge + i);
+        }
+
+        if (VectorEnd < End)
+        {
+            ApplyScalar(Params, Fields, VectorEnd, End);
+        }
+    };
+
+    const bool bDoParallel = PTPProfiling::IsParallelEnabled();
+
+    const int32 NumChunks = PTPSimd::NumChunks(NumPoints);
+    const double StartTime = FPlatformTime::Seconds();
+    ParallelFor(NumChunks, WorkPerChunk, !bDoParallel);
+    const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    UE_LOG(LogGaiaPTP, Verbose, TEXT("Surface processes: %d points in %d chunks in %.2fms"), NumPoints, NumChunks, ElapsedMs);
+}
+
+void FSurfaceProcessing::ApplyLowFrequencyNoise(const TArray<FVector3f>& SamplePoints, const FPTPNoise& Noise, const FPTPNoiseSettings& Settings,
+                                                float AmplitudeKm, FPTPCrustSurfaceSoA& Fields)
+{
+    CSV_SCOPED_TIMING_STAT(GAIA_PTP, LowFrequencyNoise);
+
+    const int32 NumPoints = Fields.Num();
+    check(SamplePoints.Num() == NumPoints);
+
+    TArray<FVector3f> Directions;
+    Directions.SetNumUninitialized(NumPoints);
+    for (int32 i = 0; i < NumPoints; ++i)
+    {
+        Directions[i] = SamplePoints[i].GetSafeNormal();
+    }
+
+    TArray<float> Values;
+    Values.SetNumUninitialized(NumPoints);
+    Noise.EvaluateBatch(EPTPNoiseType::Fbm, Directions, Settings, Values);
+
+    for (int32 i = 0; i < NumPoints; ++i)
+    {
+        Fields.Elevation[i] += Values[i] * AmplitudeKm;
+    }
+}
+
+FPTPSurfaceProcessParams FSurfaceProcessing::MakeParams(const UPTPPlanetComponent& Planet)
+{
+    FPTPSurfaceProcessParams Params;
+    Params.TimeStepMy = GetDefault<UGaiaPTPSettings>()->TimeStepMy;
+    Params.ContinentalErosion = Planet.ContinentalErosion;
+    Params.OceanicElevationDampening = Planet.OceanicElevationDampening;
+    Params.SedimentAccretion = Planet.SedimentAccretion;
+    Params.HighestContinentalAltitudeKm = Planet.HighestContinentalAltitudeKm;
+    Params.OceanicTrenchElevationKm = Planet.OceanicTrenchElevationKm;
+    return Params;
+}
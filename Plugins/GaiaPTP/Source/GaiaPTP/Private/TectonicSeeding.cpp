@@ -19,34 +19,62 @@ void FTectonicSeeding::GeneratePlateSeeds(int32 NumPlates, TArray<FVector>& OutS
     }
 }
 
-void FTectonicSeeding::AssignPointsToSeeds(const TArray<FVector>& Points,
-                                           const TArray<FVector>& Seeds,
-                                           TArray<int32>& OutPointToPlate,
-                                           TArray<TArray<int32>>& OutPlateToPoints)
+namespace
 {
-    const int32 N = Points.Num();
-    const int32 M = Seeds.Num();
-    OutPointToPlate.SetNumUninitialized(N);
-    OutPlateToPoints.SetNum(M);
-    for (int32 j = 0; j < M; ++j) OutPlateToPoints[j].Reset();
-
     // Assign by maximizing the dot product with normalized seed direction (equivalent to minimizing great-circle distance)
-    for (int32 i = 0; i < N; ++i)
+    template <typename VectorType>
+    void AssignNearestSeed(const TArray<VectorType>& Points, const TArray<FVector>& Seeds, TArray<int32>& OutPointToPlate)
     {
-        const FVector Pn = Points[i].GetSafeNormal();
-        int32 BestIdx = 0;
-        float BestDot = -FLT_MAX;
-        for (int32 j = 0; j < M; ++j)
+        const int32 N = Points.Num();
+        const int32 M = Seeds.Num();
+        OutPointToPlate.SetNumUninitialized(N);
+        for (int32 i = 0; i < N; ++i)
         {
-            const float D = FVector::DotProduct(Pn, Seeds[j]);
-            if (D > BestDot)
+            const FVector Pn = FVector(Points[i]).GetSafeNormal();
+            int32 BestIdx = 0;
+            float BestDot = -FLT_MAX;
+            for (int32 j = 0; j < M; ++j)
             {
-                BestDot = D;
-                BestIdx = j;
+                const float D = FVector::DotProduct(Pn, Seeds[j]);
+                if (D > BestDot)
+                {
+                    BestDot = D;
+                    BestIdx = j;
+                }
             }
+            OutPointToPlate[i] = BestIdx;
         }
-        OutPointToPlate[i] = BestIdx;
-        OutPlateToPoints[BestIdx].Add(i);
     }
 }
 
+void FTectonicSeeding::AssignPointsToSeeds(const TArray<FVector>& Points,
+                                           const TArray<FVector>& Seeds,
+                                           TArray<int32>& OutPointToPlate,
+                                           TArray<TArray<int32>>& OutPlateToPoints)
+{
+    AssignNearestSeed(Points, Seeds, OutPointToPlate);
+    OutPlateToPoints.SetNum(Seeds.Num());
+    for (int32 j = 0; j < Seeds.Num(); ++j) OutPlateToPoints[j].Reset();
+    for (int32 i = 0; i < OutPointToPlate.Num(); ++i)
+    {
+        OutPlateToPoints[OutPointToPlate[i]].Add(i);
+    }
+}
+
+void FTectonicSeeding::AssignPointsToSeeds(const TArray<FVector>& Points,
+                                           const TArray<FVector>& Seeds,
+                                           TArray<int32>& OutPointToPlate,
+                                           FPTPPlateMembership& OutMembership)
+{
+    AssignNearestSeed(Points, Seeds, OutPointToPlate);
+    OutMembership.Build(OutPointToPlate, Seeds.Num());
+}
+
+void FTectonicSeeding::AssignPointsToSeeds(const TArray<FVector3f>& Points,
+                                           const TArray<FVector>& Seeds,
+                                           TArray<int32>& OutPointToPlate,
+                                           FPTPPlateMembership& OutMembership)
+{
+    AssignNearestSeed(Points, Seeds, OutPointToPlate);
+    OutMembership.Build(OutPointToPlate, Seeds.Num());
+}
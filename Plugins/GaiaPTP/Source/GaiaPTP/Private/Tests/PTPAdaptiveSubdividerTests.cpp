@@ -0,0 +1,213 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "PTPAdaptiveSubdivider.h"
+#include "PTPTestMeshes.h"
+
+namespace
+{
+    constexpr float TestRadiusKm = 1000.0f;
+
+    void BuildSubdivider(FPTPAdaptiveSubdivider& Subdivider, int32 PatchLevels, int32 MaxSplitsPerUpdate = 4096)
+    {
+        TArray<FVector3f> Points;
+        TArray<FIntVector> Triangles;
+        PTPTestMeshes::MakeIcosphere(1, false, Points, Triangles);
+
+        FPTPSubdivisionSettings Settings;
+        Settings.PlanetRadiusKm = TestRadiusKm;
+        Settings.SplitRatio = 0.5f;
+        Settings.MaxLevel = 7;
+        Settings.PatchLevels = PatchLevels;
+        Settings.RootPatchLevel = 0;
+        Settings.MaxReliefKm = 3.0f;
+        Settings.MaxSplitsPerUpdate = MaxSplitsPerUpdate;
+        Subdivider.Build(Points, Triangles, Settings, [](TConstArrayView<FVector3f> Directions, TArrayView<float> OutElevationKm)
+        {
+            for (int32 i = 0; i < Directions.Num(); ++i)
+            {
+                OutElevationKm[i] = 2.0f * FMath::Sin(5.0f * Directions[i].X) * FMath::Cos(3.0f * Directions[i].Y);
+            }
+        });
+    }
+
+    /** Query points skimming the surface, climbing and diving so both splits and merges happen every few steps. */
+    FVector FlightPoint(int32 Step)
+    {
+        const FVector Direction = FVector(10.0, 300.0 * FMath::Sin(Step * 0.07), 300.0 * FMath::Cos(Step * 0.05)).GetSafeNormal();
+        return Direction * (TestRadiusKm * 1.01 + 50.0 * FMath::Sin(Step * 0.1));
+    }
+
+    /** Patch meshes as a section-group consumer would hold them. */
+    struct FUploadedPatches
+    {
+        TMap<int32, TArray<FVector3f>> Triangles;   // three positions per triangle
+        bool bConsistent = true;
+
+        void Apply(const FPTPSubdivisionDelta& Delta)
+        {
+            for (const int32 Id : Delta.RemovedPatches)
+            {
+                bConsistent &= Triangles.Remove(Id) == 1;
+            }
+            for (const FPTPSubdivisionPatch& Patch : Delta.Patches)
+            {
+                bConsistent &= Patch.bCreated == !Triangles.Contains(Patch.Id);
+                TArray<FVector3f>& Corners = Triangles.FindOrAdd(Patch.Id);
+                Corners.Reset();
+                for (const FIntVector& Tri : Patch.Triangles)
+                {
+                    Corners.Add(Patch.Positions[Tri.X]);
+                    Corners.Add(Patch.Positions[Tri.Y]);
+                    Corners.Add(Patch.Positions[Tri.Z]);
+                }
+            }
+        }
+    };
+
+    /** Order-independent triangle hashes from three positions each. */
+    TArray<uint32> HashTriangles(TConstArrayView<FVector3f> Corners)
+    {
+        TArray<uint32> Hashes;
+        for (int32 t = 0; t + 2 < Corners.Num(); t += 3)
+        {
+            const uint32 A = GetTypeHash(Corners[t]);
+            const uint32 B = GetTypeHash(Corners[t + 1]);
+            const uint32 C = GetTypeHash(Corners[t + 2]);
+            Hashes.Add(HashCombine(HashCombine(FMath::Min3(A, B, C), FMath::Max3(A, B, C)), A ^ B ^ C));
+        }
+        Hashes.Sort();
+        return Hashes;
+    }
+
+    /** Every directed edge once and its reverse present: a closed, consistently wound surface without T-junctions. */
+    bool IsWatertight(const TArray<FIntVector>& Triangles)
+    {
+        TSet<uint64> Directed;
+        for (const FIntVector& Tri : Triangles)
+        {
+            for (int32 k = 0; k < 3; ++k)
+            {
+                bool bAlreadyInSet = false;
+                Directed.Add((uint64(uint32(Tri[k])) << 32) | uint32(Tri[(k + 1) % 3]), &bAlreadyInSet);
+                if (bAlreadyInSet)
+                {
+                    return false;
+                }
+            }
+        }
+        for (const uint64 Edge : Directed)
+        {
+            if (!Directed.Contains((Edge << 32) | (Edge >> 32)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPAdaptiveSubdividerCrackFreeTest, "GaiaPTP.AdaptiveSubdivision.CrackFree",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPAdaptiveSubdividerCrackFreeTest::RunTest(const FString& Parameters)
+{
+    FPTPAdaptiveSubdivider Subdivider;
+    BuildSubdivider(Subdivider, 2);
+
+    FUploadedPatches Uploaded;
+    bool bWatertight = true;
+    bool bRestricted = true;
+    bool bOutward = true;
+    bool bPatchesMatch = true;
+    int32 NumSplits = 0;
+    int32 NumMerges = 0;
+    for (int32 Step = 0; Step < 120; ++Step)
+    {
+        FPTPSubdivisionDelta Delta;
+        Subdivider.Update(FlightPoint(Step), Delta);
+        Uploaded.Apply(Delta);
+        NumSplits += Delta.NumSplits;
+        NumMerges += Delta.NumMerges;
+
+        TArray<FVector3f> Positions;
+        TArray<FIntVector> Triangles;
+        Subdivider.GetMesh(Positions, Triangles);
+        bWatertight &= IsWatertight(Triangles);
+        bRestricted &= Subdivider.IsRestricted();
+
+        TArray<FVector3f> Corners;
+        for (const FIntVector& Tri : Triangles)
+        {
+            const FVector3f& A = Positions[Tri.X];
+            const FVector3f& B = Positions[Tri.Y];
+            const FVector3f& C = Positions[Tri.Z];
+            bOutward &= FVector3f::DotProduct(FVector3f::CrossProduct(B - A, C - A), A + B + C) > 0.0f;
+            Corners.Append({ A, B, C });
+        }
+
+        // Patches re-emitted so far add up to the whole current surface
+        TArray<FVector3f> PatchCorners;
+        for (const TPair<int32, TArray<FVector3f>>& Pair : Uploaded.Triangles)
+        {
+            PatchCorners.Append(Pair.Value);
+        }
+        bPatchesMatch &= HashTriangles(PatchCorners) == HashTriangles(Corners);
+    }
+
+    TestTrue(TEXT("Flight refines and coarsens"), NumSplits > 0 && NumMerges > 0);
+    TestTrue(TEXT("Leaf triangulation is watertight"), bWatertight);
+    TestTrue(TEXT("Neighbouring leaves stay within one level"), bRestricted);
+    TestTrue(TEXT("Triangles are wound outward"), bOutward);
+    TestTrue(TEXT("Creates and removals pair up"), Uploaded.bConsistent);
+    TestTrue(TEXT("Changed patches keep the uploaded mesh current"), bPatchesMatch);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPAdaptiveSubdividerIncrementalTest, "GaiaPTP.AdaptiveSubdivision.Incremental",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPAdaptiveSubdividerIncrementalTest::RunTest(const FString& Parameters)
+{
+    FPTPAdaptiveSubdivider Subdivider;
+    BuildSubdivider(Subdivider, 3);
+    const int32 BaseLeaves = Subdivider.GetNumLeaves();
+    const int32 BaseVertices = Subdivider.GetNumVertices();
+    const int32 BasePatches = Subdivider.GetNumPatches();
+
+    FPTPSubdivisionDelta Delta;
+    const FVector Near(TestRadiusKm * 1.005, 0.0, 0.0);
+    Subdivider.Update(Near, Delta);
+    TestTrue(TEXT("Refines near the query point"), Subdivider.GetMaxDepth() == 7);
+    TestEqual(TEXT("First update emits every patch"), Delta.Patches.Num(), Subdivider.GetNumPatches());
+    const int32 NearLeaves = Subdivider.GetNumLeaves();
+
+    // A still query point has nothing due
+    Subdivider.Update(Near, Delta);
+    TestEqual(TEXT("No checks without movement"), Delta.NumChecks, 0);
+    TestEqual(TEXT("No patches without movement"), Delta.Patches.Num(), 0);
+
+    // A short step only revisits nodes whose outcome could have changed
+    Subdivider.Update(Near + FVector(0.0, 2.0, 0.0), Delta);
+    TestTrue(TEXT("Short step checks a fraction of the nodes"), Delta.NumChecks * 4 < Subdivider.GetNumNodes());
+    TestTrue(TEXT("Short step re-emits a fraction of the patches"), Delta.Patches.Num() * 4 < Subdivider.GetNumPatches());
+
+    // Leaving coarsens all the way back to the base mesh
+    Subdivider.Update(FVector(TestRadiusKm * 1000.0, 0.0, 0.0), Delta);
+    TestTrue(TEXT("Far query point merges"), Delta.NumMerges > 0 && Delta.RemovedPatches.Num() > 0);
+    TestEqual(TEXT("Back to the base leaves"), Subdivider.GetNumLeaves(), BaseLeaves);
+    TestEqual(TEXT("Back to the base vertices"), Subdivider.GetNumVertices(), BaseVertices);
+    TestEqual(TEXT("Back to the root patches"), Subdivider.GetNumPatches(), BasePatches);
+
+    // A split budget spreads refinement over updates without losing any of it
+    FPTPAdaptiveSubdivider Budgeted;
+    BuildSubdivider(Budgeted, 3, 16);
+    int32 NumUpdates = 1;
+    while (!Budgeted.Update(Near, Delta) && NumUpdates < 1000)
+    {
+        ++NumUpdates;
+    }
+    TestTrue(TEXT("Budgeted refinement takes several updates"), NumUpdates > 1 && NumUpdates < 1000);
+    TestEqual(TEXT("Same leaves as the unbudgeted run"), Budgeted.GetNumLeaves(), NearLeaves);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,156 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "CrustInitialization.h"
+#include "HAL/IConsoleManager.h"
+#include "PTPArena.h"
+#include "PTPSimd.h"
+#include "TectonicData.h"
+#include "Tests/PTPTestMeshes.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPArenaAllocateTest, "GaiaPTP.Arena.Allocate",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPArenaAllocateTest::RunTest(const FString& Parameters)
+{
+    FPTPArena Arena;
+    Arena.Allocate(3, 1);
+    const void* Aligned = Arena.Allocate(64, 64);
+    TestEqual(TEXT("Requested alignment honoured"), (int64)(UPTRINT(Aligned) % 64), (int64)0);
+
+    const TArrayView<int32> Filled = Arena.NewSpan<int32>(100, 7);
+    bool bAllSeven = true;
+    for (int32 Value : Filled)
+    {
+        bAllSeven &= Value == 7;
+    }
+    TestTrue(TEXT("NewSpan fills"), bAllSeven);
+
+    // Overflow into more blocks, then Reset folds them into one that fits the whole run
+    for (int32 i = 0; i < 64; ++i)
+    {
+        Arena.NewSpan<uint8>(16 * 1024);
+    }
+    const SIZE_T HighWater = Arena.GetHighWaterBytes();
+    TestTrue(TEXT("Overflow allocated more blocks"), Arena.GetNumBlockAllocations() > 1);
+    Arena.Reset();
+    TestEqual(TEXT("Reset releases everything"), (int64)Arena.GetUsedBytes(), (int64)0);
+    TestTrue(TEXT("Coalesced block holds the high water"), Arena.GetCapacityBytes() >= HighWater);
+
+    const int32 Warm = Arena.GetNumBlockAllocations();
+    for (int32 Run = 0; Run < 3; ++Run)
+    {
+        Arena.Allocate(3, 1);
+        Arena.Allocate(64, 64);
+        Arena.NewSpan<int32>(100, 7);
+        for (int32 i = 0; i < 64; ++i)
+        {
+            Arena.NewSpan<uint8>(16 * 1024);
+        }
+        Arena.Reset();
+    }
+    TestEqual(TEXT("Repeated runs allocate no blocks"), Arena.GetNumBlockAllocations(), Warm);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPArenaArrayTest, "GaiaPTP.Arena.Array",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPArenaArrayTest::RunTest(const FString& Parameters)
+{
+    FPTPArena Arena;
+    TPTPArenaArray<float> Heap(Arena);
+    FRandomStream Rand(11);
+    for (int32 i = 0; i < 1000; ++i)
+    {
+        Heap.HeapPush(Rand.FRand());
+    }
+    TestEqual(TEXT("Grew past the initial capacity"), Heap.Num(), 1000);
+
+    float Previous = -1.0f;
+    bool bSorted = true;
+    while (!Heap.IsEmpty())
+    {
+        const float Value = Heap.HeapPop();
+        bSorted &= Value >= Previous;
+        Previous = Value;
+    }
+    TestTrue(TEXT("Pops in ascending order"), bSorted);
+
+    // Growing the newest allocation stays in place, so growth costs no copies of the array
+    TPTPArenaArray<int32> List(Arena);
+    for (int32 i = 0; i < 16; ++i)
+    {
+        List.Add(i);
+    }
+    const int32* Before = List.GetView().GetData();
+    List.Add(16);
+    TestTrue(TEXT("Grows in place at the top of the arena"), List.GetView().GetData() == Before);
+    TestEqual(TEXT("Contents kept"), List[16], 16);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPArenaStepTest, "GaiaPTP.Arena.Step",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPArenaStepTest::RunTest(const FString& Parameters)
+{
+    // Several chunks on parallel workers, so the steady state cannot hinge on which worker ran which chunk
+    IConsoleVariable* ParallelCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("ptp.parallel"));
+    const int32 WasParallel = ParallelCVar ? ParallelCVar->GetInt() : 1;
+    if (ParallelCVar)
+    {
+        ParallelCVar->Set(1, ECVF_SetByConsole);
+    }
+
+    TArray<FVector3f> Points;
+    TArray<FIntVector> Triangles;
+    PTPTestMeshes::MakeIcosphere(6, false, Points, Triangles);
+    TestTrue(TEXT("Kernel runs several chunks"), PTPSimd::NumChunks(Points.Num()) > 1);
+    TArray<TArray<int32>> Neighbors;
+    Neighbors.SetNum(Points.Num());
+    for (const FIntVector& Tri : Triangles)
+    {
+        for (int32 k = 0; k < 3; ++k)
+        {
+            Neighbors[Tri[k]].AddUnique(Tri[(k + 1) % 3]);
+            Neighbors[Tri[(k + 1) % 3]].AddUnique(Tri[k]);
+        }
+    }
+    TArray<EPTPBoundaryType> Types;
+    Types.Init(EPTPBoundaryType::None, Points.Num());
+    for (int32 i = 0; i < Points.Num(); ++i)
+    {
+        if (FMath::Abs(Points[i].Z) < 0.05f)
+        {
+            Types[i] = EPTPBoundaryType::Convergent;
+        }
+    }
+
+    TArray<float> Reference;
+    FCrustInitialization::ComputeDistanceToFront(Points, Neighbors, Types, Reference);
+
+    FPTPStepScratch Scratch;
+    const int32 NumWarmUpSteps = 2;
+    int32 NumBlocksAfterWarmUp = 0;
+    bool bMatches = true;
+    for (int32 Step = 0; Step < NumWarmUpSteps + 6; ++Step)
+    {
+        TArray<float> Distance;
+        FCrustInitialization::ComputeDistanceToFront(Points, Neighbors, Types, Distance, &Scratch);
+        bMatches &= Distance == Reference;
+        Scratch.EndStep();
+        if (Step == NumWarmUpSteps - 1)
+        {
+            NumBlocksAfterWarmUp = Scratch.GetNumBlockAllocations();
+        }
+    }
+    if (ParallelCVar)
+    {
+        ParallelCVar->Set(WasParallel, ECVF_SetByConsole);
+    }
+    TestTrue(TEXT("Every step matches the private scratch"), bMatches);
+    TestEqual(TEXT("No block allocations in steady state"), Scratch.GetNumBlockAllocations(), NumBlocksAfterWarmUp);
+    TestTrue(TEXT("Kernel peak recorded"), Scratch.GetKernelPeak(TEXT("DistanceToFront")) > 0);
+    TestTrue(TEXT("High water covers the kernel peak"), Scratch.GetHighWaterBytes() >= Scratch.GetKernelPeak(TEXT("DistanceToFront")));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
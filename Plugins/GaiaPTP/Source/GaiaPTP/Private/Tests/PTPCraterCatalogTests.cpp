@@ -0,0 +1,137 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "PTPCraterCatalog.h"
+#include "PTPRandom.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPCraterCatalogGenerateTest, "GaiaPTP.CraterCatalog.Generate",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPCraterCatalogGenerateTest::RunTest(const FString& Parameters)
+{
+    FPTPCraterParams Params;
+    Params.Seed = 42;
+    Params.NumCraters = 200000;
+    Params.MinDiameterKm = 1.0f;
+    Params.MaxDiameterKm = 500.0f;
+
+    FPTPCraterCatalog Catalog;
+    Catalog.Generate(Params);
+    TestEqual(TEXT("Crater count"), Catalog.Num(), Params.NumCraters);
+    TestEqual(TEXT("One size class per doubling"), Catalog.GetNumSizeClasses(), 9);
+
+    bool bValid = true;
+    int32 NumAtLeastDouble = 0;
+    for (int32 i = 0; i < Catalog.Num(); ++i)
+    {
+        const float D = Catalog.GetDiameterKm(i);
+        const float ExpectedDepth = D <= 10.0f ? 0.2f * D : 2.0f + 0.05f * (D - 10.0f);
+        bValid &= FMath::IsNearlyEqual(Catalog.GetCenter(i).SizeSquared(), 1.0f, 1e-4f);
+        bValid &= D >= 1.0f && D <= 500.0f;
+        bValid &= FMath::IsNearlyEqual(Catalog.GetDepthKm(i), ExpectedDepth, 1e-4f);
+        bValid &= Catalog.GetAgeMy(i) >= 0.0f && Catalog.GetAgeMy(i) < Params.SurfaceAgeMy;
+        NumAtLeastDouble += D >= 2.0f ? 1 : 0;
+    }
+    TestTrue(TEXT("Craters within the parameters"), bValid);
+
+    // P(D >= 2 Dmin) for dN/dD ~ D^-2.5 on [1, 500]
+    const double A = -1.5;
+    const double Expected = (FMath::Pow(2.0, A) - FMath::Pow(500.0, A)) / (1.0 - FMath::Pow(500.0, A));
+    TestTrue(TEXT("Power-law diameters"), FMath::Abs(double(NumAtLeastDouble) / Catalog.Num() - Expected) < 0.01);
+
+    bool bClassesSorted = true;
+    int32 Next = 0;
+    for (int32 Class = 0; Class < Catalog.GetNumSizeClasses(); ++Class)
+    {
+        int32 Begin, End;
+        Catalog.GetSizeClassRange(Class, Begin, End);
+        bClassesSorted &= Begin == Next;
+        for (int32 i = Begin; i < End; ++i)
+        {
+            bClassesSorted &= FMath::FloorToInt(FMath::Log2(Catalog.GetDiameterKm(i))) == Class;
+        }
+        Next = End;
+    }
+    TestTrue(TEXT("Craters grouped by size class"), bClassesSorted && Next == Catalog.Num());
+
+    const double BytesPerCrater = double(Catalog.GetAllocatedSize()) / Catalog.Num();
+    TestTrue(FString::Printf(TEXT("Compact storage (%.1f bytes/crater)"), BytesPerCrater), BytesPerCrater <= 36.0);
+
+    // Crater values depend only on the seed and the sample id
+    FPTPCraterParams FewerParams = Params;
+    FewerParams.NumCraters = 5000;
+    FPTPCraterCatalog Fewer;
+    Fewer.Generate(FewerParams);
+    TMap<uint32, int32> ById;
+    for (int32 i = 0; i < Catalog.Num(); ++i)
+    {
+        ById.Add(Catalog.GetId(i), i);
+    }
+    bool bSameById = true;
+    for (int32 i = 0; i < Fewer.Num(); ++i)
+    {
+        const int32 Match = ById.FindChecked(Fewer.GetId(i));
+        bSameById &= Fewer.GetCenter(i) == Catalog.GetCenter(Match) && Fewer.GetDiameterKm(i) == Catalog.GetDiameterKm(Match)
+            && Fewer.GetAgeMy(i) == Catalog.GetAgeMy(Match);
+    }
+    TestTrue(TEXT("Same crater for the same id"), bSameById);
+
+    FPTPCraterCatalog Again;
+    Again.Generate(Params);
+    bool bRepeatable = Again.Num() == Catalog.Num();
+    for (int32 i = 0; bRepeatable && i < Catalog.Num(); ++i)
+    {
+        bRepeatable &= Again.GetId(i) == Catalog.GetId(i) && Again.GetCenter(i) == Catalog.GetCenter(i);
+    }
+    TestTrue(TEXT("Generation is repeatable"), bRepeatable);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPCraterCatalogQueryTest, "GaiaPTP.CraterCatalog.Query",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPCraterCatalogQueryTest::RunTest(const FString& Parameters)
+{
+    // Small body: the largest classes reach across faces and are scanned, the smallest are finely gridded
+    FPTPCraterParams Params;
+    Params.Seed = 3;
+    Params.PlanetRadiusKm = 250.0f;
+    Params.NumCraters = 50000;
+    Params.MinDiameterKm = 0.5f;
+    Params.MaxDiameterKm = 300.0f;
+    Params.PowerLawExponent = -2.0f;
+
+    FPTPCraterCatalog Catalog;
+    Catalog.Generate(Params);
+
+    // Random points, plus cube seams and corners where the 3x3 block crosses faces
+    TArray<FVector3f> Points;
+    for (uint32 q = 0; q < 2000; ++q)
+    {
+        const float Z = 2.0f * FPTPHash::UnitFloat(FPTPHash::Hash(11u, q, 0u)) - 1.0f;
+        const float Phi = 2.0f * PI * FPTPHash::UnitFloat(FPTPHash::Hash(11u, q, 1u));
+        const float R = FMath::Sqrt(FMath::Max(1.0f - Z * Z, 0.0f));
+        Points.Add(FVector3f(R * FMath::Cos(Phi), R * FMath::Sin(Phi), Z));
+    }
+    Points.Add(FVector3f(1.0f, 1.0f, 1.0f).GetUnsafeNormal());
+    Points.Add(FVector3f(-1.0f, 1.0f, -1.0f).GetUnsafeNormal());
+    Points.Add(FVector3f(1.0f, 1.0f, 0.0f).GetUnsafeNormal());
+    Points.Add(FVector3f(0.0f, -1.0f, 1.0001f).GetUnsafeNormal());
+
+    int32 NumMismatches = 0;
+    int64 NumHits = 0;
+    TArray<int32> Fast, Brute;
+    for (const FVector3f& P : Points)
+    {
+        Fast.Reset();
+        Brute.Reset();
+        Catalog.GatherCratersAffecting(P, Fast);
+        Catalog.GatherCratersAffectingBruteForce(P, Brute);
+        Fast.Sort();
+        NumMismatches += Fast == Brute ? 0 : 1;
+        NumHits += Brute.Num();
+    }
+    TestEqual(TEXT("Spatial hash matches a full scan"), NumMismatches, 0);
+    TestTrue(TEXT("Queries find craters"), NumHits > Points.Num());
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
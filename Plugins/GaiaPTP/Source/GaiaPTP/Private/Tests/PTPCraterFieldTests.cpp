@@ -0,0 +1,158 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "PTPCraterField.h"
+
+static FPTPCraterFieldParams MakeSmallMoonParams()
+{
+    // Dense enough that every morphology shows up in a few thousand queries
+    FPTPCraterFieldParams Params;
+    Params.Seed = 7;
+    Params.PlanetRadiusKm = 400.0f;
+    Params.MinDiameterKm = 0.5f;
+    Params.MaxDiameterKm = 400.0f;
+    Params.DensityAt1Km = 0.2f;
+    Params.MultiRingTransitionKm = 150.0f;
+    return Params;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPCraterFieldSimdMatchesScalarTest, "GaiaPTP.CraterField.SimdMatchesScalar",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPCraterFieldSimdMatchesScalarTest::RunTest(const FString& Parameters)
+{
+    const FPTPCraterField Field(MakeSmallMoonParams());
+
+    FRandomStream Rand(5);
+    TArray<FVector3f> Directions;
+    for (int32 i = 0; i < 2000; ++i)
+    {
+        Directions.Add(FVector3f(Rand.GetUnitVector()));
+    }
+
+    for (const float MinDiameterKm : { 0.0f, 4.0f })
+    {
+        TArray<float> Simd; Simd.SetNumUninitialized(Directions.Num());
+        TArray<float> Scalar; Scalar.SetNumUninitialized(Directions.Num());
+        Field.Evaluate(Directions, Simd, MinDiameterKm);
+        Field.EvaluateScalar(Directions, Scalar, MinDiameterKm);
+
+        float MaxErr = 0.0f;
+        float MaxAbs = 0.0f;
+        for (int32 i = 0; i < Directions.Num(); ++i)
+        {
+            MaxErr = FMath::Max(MaxErr, FMath::Abs(Simd[i] - Scalar[i]));
+            MaxAbs = FMath::Max(MaxAbs, FMath::Abs(Scalar[i]));
+        }
+        TestTrue(FString::Printf(TEXT("SIMD profiles match scalar reference (min diameter %.0f km)"), MinDiameterKm), MaxErr < 1e-3f);
+        TestTrue(TEXT("Craters are present"), MaxAbs > 0.1f);
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPCraterFieldTileIndependenceTest, "GaiaPTP.CraterField.TileIndependence",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPCraterFieldTileIndependenceTest::RunTest(const FString& Parameters)
+{
+    const FPTPCraterField Field(MakeSmallMoonParams());
+
+    // Corner tile of face 2 touches two seams and a cube corner
+    FPTPAmplifyTile Tile;
+    Tile.Face = 2;
+    Tile.TileX = 3;
+    Tile.TileY = 0;
+    Tile.TilesPerFace = 4;
+    Tile.Resolution = 24;
+
+    TArray<FVector3f> Directions;
+    for (int32 Y = 0; Y < Tile.Resolution; ++Y)
+    {
+        for (int32 X = 0; X < Tile.Resolution; ++X)
+        {
+            Directions.Add(Tile.TexelDirection(X, Y));
+        }
+    }
+
+    TArray<float> Batch; Batch.SetNumUninitialized(Directions.Num());
+    Field.Evaluate(Directions, Batch, 1.0f);
+
+    int32 NumMismatch = 0;
+    for (int32 i = 0; i < Directions.Num(); ++i)
+    {
+        float Single = 0.0f;
+        Field.Evaluate(MakeArrayView(&Directions[i], 1), MakeArrayView(&Single, 1), 1.0f);
+        NumMismatch += Single != Batch[i] ? 1 : 0;
+    }
+    TestEqual(TEXT("Values do not depend on which batch or tile evaluates them"), NumMismatch, 0);
+
+    // Shared-edge tiles agree on their common edge
+    FPTPAmplifyTile Left = Tile;
+    Left.TileX = 1;
+    Left.bSharedEdges = true;
+    FPTPAmplifyTile Right = Left;
+    Right.TileX = 2;
+    TArray<float> LeftHeights, RightHeights;
+    LeftHeights.SetNumZeroed(Tile.Resolution * Tile.Resolution);
+    RightHeights.SetNumZeroed(Tile.Resolution * Tile.Resolution);
+    Field.AmplifyTile(Left, LeftHeights);
+    Field.AmplifyTile(Right, RightHeights);
+    bool bSeamless = true;
+    for (int32 Y = 0; Y < Tile.Resolution; ++Y)
+    {
+        bSeamless &= LeftHeights[Y * Tile.Resolution + Tile.Resolution - 1] == RightHeights[Y * Tile.Resolution];
+    }
+    TestTrue(TEXT("Neighbouring tiles match on the shared edge"), bSeamless);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPCraterFieldProfilesTest, "GaiaPTP.CraterField.Profiles",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPCraterFieldProfilesTest::RunTest(const FString& Parameters)
+{
+    const float Depth = 2.0f;
+    const float Rim = 0.3f;
+    const float Reach = 2.5f;
+
+    TestEqual(TEXT("Simple bowl floor"), FPTPCraterField::SimpleProfile(0.0f, Depth, Rim, Reach), -Depth, 1e-5f);
+    TestEqual(TEXT("Simple rim is continuous"), FPTPCraterField::SimpleProfile(0.9999f, Depth, Rim, Reach),
+        FPTPCraterField::SimpleProfile(1.0001f, Depth, Rim, Reach), 1e-3f);
+    TestEqual(TEXT("Ejecta vanishes at the reach"), FPTPCraterField::SimpleProfile(Reach - 1e-4f, Depth, Rim, Reach), 0.0f, 1e-3f);
+    TestEqual(TEXT("Nothing beyond the reach"), FPTPCraterField::SimpleProfile(Reach + 0.1f, Depth, Rim, Reach), 0.0f);
+
+    const float Peak = 0.6f;
+    TestEqual(TEXT("Central peak above the floor"), FPTPCraterField::ComplexProfile(0.0f, Depth, Rim, Peak, Reach), Peak - Depth, 1e-5f);
+    TestEqual(TEXT("Flat floor"), FPTPCraterField::ComplexProfile(0.5f, Depth, Rim, Peak, Reach), -Depth, 1e-5f);
+    TestEqual(TEXT("Complex rim is continuous"), FPTPCraterField::ComplexProfile(0.9999f, Depth, Rim, Peak, Reach),
+        FPTPCraterField::ComplexProfile(1.0001f, Depth, Rim, Peak, Reach), 1e-3f);
+
+    bool bWallRises = true;
+    float Previous = -Depth;
+    for (float R = 0.7f; R <= 1.0f; R += 0.01f)
+    {
+        const float H = FPTPCraterField::ComplexProfile(R, Depth, Rim, Peak, Reach);
+        bWallRises &= H >= Previous - 1e-5f;
+        Previous = H;
+    }
+    TestTrue(TEXT("Terraced wall rises monotonically"), bWallRises);
+
+    TestTrue(TEXT("Basin rings are uplifted"), FPTPCraterField::MultiRingProfile(0.9f, Depth, 3, Reach)
+        > FPTPCraterField::MultiRingProfile(1.1f, Depth, 3, Reach));
+    TestEqual(TEXT("Basin is flat outside its rings"), FPTPCraterField::MultiRingProfile(2.2f, Depth, 4, Reach), 0.0f);
+
+    // At the saturation slope every octave has the same crater density per cell
+    FPTPCraterFieldParams Params = MakeSmallMoonParams();
+    Params.PowerLawExponent = -3.0f;
+    const FPTPCraterField Field(Params);
+    bool bSaturated = true;
+    for (int32 Octave = 1; Octave + 1 < Field.GetNumOctaves(); ++Octave)   // the last octave is cut short by MinDiameterKm
+    {
+        if (Field.GetOctaveResolution(Octave - 1) > 16)   // coarse grids round their cell size too much to compare
+        {
+            const float Ratio = Field.GetMeanCratersPerCell(Octave) / Field.GetMeanCratersPerCell(Octave - 1);
+            bSaturated &= Ratio > 0.8f && Ratio < 1.25f;
+        }
+    }
+    TestTrue(TEXT("Constant craters per cell at saturation"), bSaturated);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,199 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "PTPExemplarLibrary.h"
+#include "PTPExemplarSynthesis.h"
+
+/** DEM with ridges running along +X (height varies with Y only). */
+static FPTPExemplarSource MakeRidgedSource(int32 Size, float AmplitudeM, EOrogenyType Type, float AgeMy)
+{
+    FPTPExemplarSource Source;
+    Source.Width = Size;
+    Source.Height = Size;
+    Source.OrogenyType = Type;
+    Source.AgeMy = AgeMy;
+    Source.HeightsM.SetNumUninitialized(Size * Size);
+    for (int32 Y = 0; Y < Size; ++Y)
+    {
+        for (int32 X = 0; X < Size; ++X)
+        {
+            Source.HeightsM[Y * Size + X] = 1500.0f + AmplitudeM * FMath::Sin(2.0f * PI * Y / 16.0f);
+        }
+    }
+    return Source;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPExemplarIndexTest, "GaiaPTP.Exemplar.IndexMatchesBruteForce",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPExemplarIndexTest::RunTest(const FString& Parameters)
+{
+    FRandomStream Rand(17);
+    TArray<FPTPExemplarDescriptor> Descriptors;
+    for (int32 i = 0; i < 2000; ++i)
+    {
+        FPTPExemplarDescriptor D;
+        D.MinElevationKm = Rand.FRandRange(-0.5f, 2.0f);
+        D.MaxElevationKm = D.MinElevationKm + Rand.FRandRange(0.0f, 6.0f);
+        D.AgeMy = Rand.FRandRange(0.0f, 3000.0f);
+        D.OrogenyType = static_cast<EOrogenyType>(Rand.RandRange(0, 2));
+        D.Anisotropy = Rand.FRand();
+        Descriptors.Add(D);
+    }
+
+    FPTPExemplarIndex Index;
+    Index.Build(Descriptors);
+
+    constexpr int32 K = 5;
+    int32 NumMismatch = 0;
+    for (int32 q = 0; q < 50; ++q)
+    {
+        const FPTPExemplarDescriptor& Query = Descriptors[Rand.RandRange(0, Descriptors.Num() - 1)];
+        TArray<int32> Found;
+        Index.FindNearest(Query, K, Found);
+
+        float QF[FPTPExemplarDescriptor::NumFeatures];
+        Query.ToFeatures(QF);
+        TArray<TPair<float, int32>> All;
+        for (int32 i = 0; i < Descriptors.Num(); ++i)
+        {
+            float F[FPTPExemplarDescriptor::NumFeatures];
+            Descriptors[i].ToFeatures(F);
+            float D2 = 0.0f;
+            for (int32 d = 0; d < FPTPExemplarDescriptor::NumFeatures; ++d)
+            {
+                D2 += FMath::Square(QF[d] - F[d]);
+            }
+            All.Add(TPair<float, int32>(D2, i));
+        }
+        All.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; });
+
+        for (int32 k = 0; k < K; ++k)
+        {
+            NumMismatch += (Found.IsValidIndex(k) && Found[k] == All[k].Value) ? 0 : 1;
+        }
+    }
+    TestEqual(TEXT("KD-tree k-NN equals brute force"), NumMismatch, 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPExemplarLibraryRoundTripTest, "GaiaPTP.Exemplar.LibraryRoundTrip",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPExemplarLibraryRoundTripTest::RunTest(const FString& Parameters)
+{
+    const FString Path = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("PTPExemplarRoundTrip.ptpex"));
+    const TArray<FPTPExemplarSource> Sources = {
+        MakeRidgedSource(96, 800.0f, EOrogenyType::Himalayan, 50.0f),
+        MakeRidgedSource(64, 200.0f, EOrogenyType::None, 1500.0f)
+    };
+    constexpr int32 PatchSize = 32;
+    TestTrue(TEXT("Library written"), FPTPExemplarLibrary::Write(Path, Sources, PatchSize, 32, 30.0f));
+
+    {
+        FPTPExemplarLibrary Library;
+        TestTrue(TEXT("Library opens"), Library.Open(Path, 2));
+        TestEqual(TEXT("Patch count (3x3 + 2x2)"), Library.GetNumPatches(), 13);
+        TestEqual(TEXT("Patch size"), Library.GetPatchSize(), PatchSize);
+
+        // Patch 4 is the centre patch of the first source, origin (32,32)
+        {
+            TSharedPtr<const FPTPExemplarPage, ESPMode::ThreadSafe> Page = Library.GetPage(4);
+            int32 NumWrong = 0;
+            for (int32 Y = 0; Y < PatchSize; ++Y)
+            {
+                for (int32 X = 0; X < PatchSize; ++X)
+                {
+                    const int32 Expected = FMath::RoundToInt(Sources[0].HeightsM[(32 + Y) * 96 + 32 + X]);
+                    NumWrong += Page->Heights[Y * PatchSize + X] == Expected ? 0 : 1;
+                }
+            }
+            TestEqual(TEXT("Page heights round-trip"), NumWrong, 0);
+        }
+
+        Library.GetPage(4);
+        Library.GetPage(5);
+        Library.GetPage(6);
+        Library.GetPage(4);
+        TestEqual(TEXT("Cache hit on a resident page"), Library.GetNumPageHits(), 1);
+        TestEqual(TEXT("LRU evicts beyond capacity"), Library.GetNumPageMisses(), 4);
+
+        const FPTPExemplarDescriptor& D = Library.GetDescriptor(0);
+        TestTrue(TEXT("Ridges along +X give a dominant angle of 0 mod PI"), FMath::Abs(FMath::Sin(D.DominantAngle)) < 0.05f);
+        TestTrue(TEXT("Ridged patch is anisotropic"), D.Anisotropy > 0.9f);
+        TestTrue(TEXT("Orogeny type stored"), D.OrogenyType == EOrogenyType::Himalayan);
+
+        FPTPExemplarDescriptor Query = D;
+        Query.OrogenyType = EOrogenyType::None;
+        TArray<int32> Found;
+        Library.GetIndex().FindNearest(Query, 1, Found);
+        TestTrue(TEXT("Match respects orogeny type"), Found.Num() == 1 && Library.GetDescriptor(Found[0]).OrogenyType == EOrogenyType::None);
+    }
+
+    IFileManager::Get().Delete(*Path);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPExemplarSynthesisTest, "GaiaPTP.Exemplar.Synthesis",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPExemplarSynthesisTest::RunTest(const FString& Parameters)
+{
+    const FString Path = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("PTPExemplarSynthesis.ptpex"));
+    const TArray<FPTPExemplarSource> Sources = { MakeRidgedSource(128, 600.0f, EOrogenyType::Himalayan, 50.0f) };
+    FPTPExemplarLibrary::Write(Path, Sources, 64, 32, 100.0f);
+
+    {
+        FPTPExemplarLibrary Library;
+        TestTrue(TEXT("Library opens"), Library.Open(Path));
+
+        auto MakeSampler = [](float OceanicWeight)
+        {
+            return FPTPCrustSampler([OceanicWeight](TConstArrayView<FVector3f> Directions, TArrayView<FPTPCrustSample> OutSamples)
+            {
+                for (int32 i = 0; i < Directions.Num(); ++i)
+                {
+                    FPTPCrustSample& S = OutSamples[i];
+                    S.Elevation = 1.0f;
+                    S.OceanicWeight = OceanicWeight;
+                    S.OrogenyType = EOrogenyType::Himalayan;
+                    S.OrogenyAge = 50.0f;
+                    S.FoldDirection = FVector3f::CrossProduct(FVector3f::UnitZ(), Directions[i]).GetSafeNormal();
+                }
+            });
+        };
+
+        FPTPExemplarSynthesisParams Params;
+        Params.PlanetRadiusKm = 200.0f;
+
+        FPTPAmplifyTile Tile;
+        Tile.Face = 0;
+        Tile.TilesPerFace = 8;
+        Tile.TileX = 3;
+        Tile.TileY = 3;
+        Tile.Resolution = 32;
+
+        TArray<float> Continental;
+        FPTPExemplarSynthesizer(Params, Library, MakeSampler(0.0f)).SynthesizeTile(Tile, Continental);
+        float Lo = MAX_flt, Hi = -MAX_flt;
+        for (const float H : Continental)
+        {
+            Lo = FMath::Min(Lo, H);
+            Hi = FMath::Max(Hi, H);
+        }
+        TestTrue(TEXT("Continental tile gains exemplar relief"), Hi - Lo > 0.1f && Hi - Lo < 1.3f);
+
+        TArray<float> Oceanic;
+        FPTPExemplarSynthesizer(Params, Library, MakeSampler(1.0f)).SynthesizeTile(Tile, Oceanic);
+        bool bUnchanged = true;
+        for (const float H : Oceanic)
+        {
+            bUnchanged &= H == 1.0f;
+        }
+        TestTrue(TEXT("Oceanic crust is left to the Gabor amplifier"), bUnchanged);
+    }
+
+    IFileManager::Get().Delete(*Path);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,144 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "PTPCubeMap.h"
+#include "PTPGaborAmplifier.h"
+
+/** Analytic crust: oceanic everywhere, ridge along lines of latitude, age growing towards the poles. */
+static FPTPCrustSampler MakeSyntheticOceanSampler(float OceanicWeight)
+{
+    return [OceanicWeight](TConstArrayView<FVector3f> Directions, TArrayView<FPTPCrustSample> OutSamples)
+    {
+        for (int32 i = 0; i < Directions.Num(); ++i)
+        {
+            const FVector3f& D = Directions[i];
+            FPTPCrustSample& S = OutSamples[i];
+            S.Elevation = -4.0f;
+            S.OceanicAge = FMath::Abs(D.Z) * 200.0f;
+            S.RidgeDirection = FVector3f::CrossProduct(FVector3f::UnitZ(), D).GetSafeNormal();
+            S.OceanicWeight = OceanicWeight;
+        }
+    };
+}
+
+static FPTPGaborParams MakeSmallPlanetParams()
+{
+    FPTPGaborParams Params;
+    Params.Seed = 42;
+    Params.PlanetRadiusKm = 1000.0f;
+    Params.CellSizeKm = 40.0f;
+    return Params;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPGaborSimdMatchesScalarTest, "GaiaPTP.Gabor.SimdMatchesScalar",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPGaborSimdMatchesScalarTest::RunTest(const FString& Parameters)
+{
+    const FPTPGaborAmplifier Amplifier(MakeSmallPlanetParams(), MakeSyntheticOceanSampler(1.0f));
+
+    FRandomStream Rand(3);
+    TArray<FVector3f> Directions;
+    for (int32 i = 0; i < 2000; ++i)
+    {
+        Directions.Add(FVector3f(Rand.GetUnitVector()));
+    }
+
+    TArray<float> Simd; Simd.SetNumUninitialized(Directions.Num());
+    TArray<float> Scalar; Scalar.SetNumUninitialized(Directions.Num());
+    Amplifier.Evaluate(Directions, Simd);
+    Amplifier.EvaluateScalar(Directions, Scalar);
+
+    float MaxErr = 0.0f;
+    float MaxAbs = 0.0f;
+    for (int32 i = 0; i < Directions.Num(); ++i)
+    {
+        MaxErr = FMath::Max(MaxErr, FMath::Abs(Simd[i] - Scalar[i]));
+        MaxAbs = FMath::Max(MaxAbs, FMath::Abs(Scalar[i]));
+    }
+    TestTrue(TEXT("SIMD kernels match scalar reference"), MaxErr < 1e-3f);
+    TestTrue(TEXT("Detail is non-trivial on oceanic crust"), MaxAbs > 0.01f);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPGaborTileIndependenceTest, "GaiaPTP.Gabor.TileIndependence",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPGaborTileIndependenceTest::RunTest(const FString& Parameters)
+{
+    const FPTPGaborAmplifier Amplifier(MakeSmallPlanetParams(), MakeSyntheticOceanSampler(1.0f));
+
+    // Corner tile of face 0 touches two seams and a cube corner
+    FPTPAmplifyTile Tile;
+    Tile.Face = 0;
+    Tile.TileX = 3;
+    Tile.TileY = 3;
+    Tile.TilesPerFace = 4;
+    Tile.Resolution = 16;
+
+    TArray<FVector3f> Directions;
+    for (int32 Y = 0; Y < Tile.Resolution; ++Y)
+    {
+        for (int32 X = 0; X < Tile.Resolution; ++X)
+        {
+            Directions.Add(Tile.TexelDirection(X, Y));
+        }
+    }
+
+    TArray<float> Batch; Batch.SetNumUninitialized(Directions.Num());
+    Amplifier.Evaluate(Directions, Batch);
+
+    int32 NumMismatch = 0;
+    for (int32 i = 0; i < Directions.Num(); ++i)
+    {
+        float Single = 0.0f;
+        Amplifier.Evaluate(MakeArrayView(&Directions[i], 1), MakeArrayView(&Single, 1));
+        NumMismatch += Single != Batch[i] ? 1 : 0;
+    }
+    TestEqual(TEXT("Values do not depend on which batch or tile evaluates them"), NumMismatch, 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPGaborContinentalTest, "GaiaPTP.Gabor.ContinentalUnchanged",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPGaborContinentalTest::RunTest(const FString& Parameters)
+{
+    const FPTPGaborAmplifier Amplifier(MakeSmallPlanetParams(), MakeSyntheticOceanSampler(0.0f));
+
+    FPTPAmplifyTile Tile;
+    Tile.Face = 4;
+    Tile.Resolution = 8;
+    TArray<float> Heights;
+    Amplifier.AmplifyTile(Tile, Heights);
+
+    bool bAllBase = Heights.Num() == 64;
+    for (const float H : Heights)
+    {
+        bAllBase &= H == -4.0f;
+    }
+    TestTrue(TEXT("Zero oceanic weight leaves the coarse elevation untouched"), bAllBase);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPCubeMapRoundTripTest, "GaiaPTP.CubeMap.RoundTrip",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPCubeMapRoundTripTest::RunTest(const FString& Parameters)
+{
+    float MaxErr = 0.0f;
+    for (int32 Face = 0; Face < FPTPCubeMap::NumFaces; ++Face)
+    {
+        for (const float S : { -0.9f, -0.3f, 0.0f, 0.45f, 0.95f })
+        {
+            for (const float T : { -0.8f, 0.1f, 0.7f })
+            {
+                int32 OutFace;
+                float OutS, OutT;
+                FPTPCubeMap::DirectionToFace(FPTPCubeMap::FaceToDirection(Face, S, T), OutFace, OutS, OutT);
+                TestEqual(TEXT("Face round-trips"), OutFace, Face);
+                MaxErr = FMath::Max(MaxErr, FMath::Max(FMath::Abs(OutS - S), FMath::Abs(OutT - T)));
+            }
+        }
+    }
+    TestTrue(TEXT("Face coordinates round-trip"), MaxErr < 1e-5f);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
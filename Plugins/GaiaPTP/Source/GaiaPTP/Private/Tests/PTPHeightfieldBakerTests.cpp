@@ -0,0 +1,171 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "PTPCraterField.h"
+#include "PTPHeightfieldBaker.h"
+
+namespace
+{
+    /** Smooth analytic field, so the baked values can be checked texel by texel. */
+    float AnalyticElevationKm(const FVector3f& Dir)
+    {
+        return 6.0f * Dir.Z + 2.0f * Dir.X * Dir.Y;
+    }
+
+    FPTPHeightSource MakeAnalyticSource()
+    {
+        return [](const FPTPAmplifyTile& Tile, TArray<float>& OutElevationKm)
+        {
+            OutElevationKm.SetNumUninitialized(Tile.Resolution * Tile.Resolution);
+            for (int32 Y = 0; Y < Tile.Resolution; ++Y)
+            {
+                for (int32 X = 0; X < Tile.Resolution; ++X)
+                {
+                    OutElevationKm[Y * Tile.Resolution + X] = AnalyticElevationKm(Tile.TexelDirection(X, Y));
+                }
+            }
+        };
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPHeightfieldQuantizeTest, "GaiaPTP.Heightfield.Quantize",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPHeightfieldQuantizeTest::RunTest(const FString& Parameters)
+{
+    TestEqual(TEXT("Bottom of the range"), (int32)FPTPHeightfieldBaker::Quantize(-11.0f, -11.0f, 9.0f), 0);
+    TestEqual(TEXT("Top of the range"), (int32)FPTPHeightfieldBaker::Quantize(9.0f, -11.0f, 9.0f), 65535);
+    TestEqual(TEXT("Clamped below"), (int32)FPTPHeightfieldBaker::Quantize(-20.0f, -11.0f, 9.0f), 0);
+    TestEqual(TEXT("Clamped above"), (int32)FPTPHeightfieldBaker::Quantize(20.0f, -11.0f, 9.0f), 65535);
+
+    const float Step = 20.0f / 65535.0f;
+    float WorstKm = 0.0f;
+    for (float Km = -10.9f; Km < 8.9f; Km += 0.37f)
+    {
+        const float Back = FPTPHeightfieldBaker::Dequantize(FPTPHeightfieldBaker::Quantize(Km, -11.0f, 9.0f), -11.0f, 9.0f);
+        WorstKm = FMath::Max(WorstKm, FMath::Abs(Back - Km));
+    }
+    TestTrue(TEXT("Round trip within half a step"), WorstKm <= 0.5f * Step + 1e-5f);
+
+    // Shared-edge tiles repeat their neighbour's edge texels
+    FPTPAmplifyTile Left;
+    Left.Face = 2;
+    Left.TilesPerFace = 3;
+    Left.Resolution = 17;
+    Left.bSharedEdges = true;
+    FPTPAmplifyTile Right = Left;
+    Right.TileX = 1;
+    bool bShared = true;
+    for (int32 Y = 0; Y < Left.Resolution; ++Y)
+    {
+        bShared &= Left.TexelDirection(Left.Resolution - 1, Y).Equals(Right.TexelDirection(0, Y), 1e-6f);
+    }
+    TestTrue(TEXT("Neighbouring tiles share an edge"), bShared);
+
+    FPTPAmplifyTile Corner = Left;
+    Corner.TileX = 2;
+    Corner.TileY = 2;
+    const FVector3f Expected = FPTPCubeMap::FaceToDirection(2, 1.0f, 1.0f);
+    TestTrue(TEXT("Last texel sits on the face corner"), Corner.TexelDirection(16, 16).Equals(Expected, 1e-6f));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPHeightfieldBakeTest, "GaiaPTP.Heightfield.Bake",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPHeightfieldBakeTest::RunTest(const FString& Parameters)
+{
+    for (const EPTPHeightfieldFormat Format : { EPTPHeightfieldFormat::Png16, EPTPHeightfieldFormat::Raw16 })
+    {
+        const FString FormatName = FPTPHeightfieldBaker::GetExtension(Format);
+        FPTPBakeSettings Settings;
+        Settings.TilesPerFace = 2;
+        Settings.TileResolution = 33;
+        Settings.Format = Format;
+        Settings.Faces = { 0, 4 };
+        Settings.MaxTilesInFlight = 3;   // does not divide the tile count: the last wave is partial
+        Settings.OutputDir = FPaths::AutomationTransientDir() / TEXT("PTPHeightfield") / FormatName;
+        Settings.BaseName = TEXT("Test");
+
+        FPTPBakeManifest Manifest;
+        FString Error;
+        const bool bBaked = FPTPHeightfieldBaker::Bake(MakeAnalyticSource(), Settings, Manifest, Error);
+        if (!TestTrue(FString::Printf(TEXT("%s bake succeeds: %s"), *FormatName, *Error), bBaked))
+        {
+            continue;
+        }
+        TestEqual(TEXT("Tiles of the selected faces"), Manifest.Tiles.Num(), 8);
+
+        FPTPBakeManifest Loaded;
+        TestTrue(TEXT("Manifest loads"), FPTPBakeManifest::Load(Settings.OutputDir / TEXT("Test.json"), Loaded, Error));
+        TestEqual(TEXT("Manifest tiles"), Loaded.Tiles.Num(), Manifest.Tiles.Num());
+        TestEqual(TEXT("Manifest resolution"), Loaded.TileResolution, 33);
+        TestTrue(TEXT("Manifest format"), Loaded.Format == Format);
+
+        // Every texel decodes to the field within a quantization step
+        const float Step = (Settings.MaxElevationKm - Settings.MinElevationKm) / 65535.0f;
+        float WorstKm = 0.0f;
+        TArray<uint16> Heights;
+        for (const FPTPBakedTile& Baked : Loaded.Tiles)
+        {
+            if (!TestTrue(TEXT("Tile reads back"), FPTPHeightfieldBaker::ReadTile(Settings.OutputDir / Baked.File, 33, Format, Heights)))
+            {
+                continue;
+            }
+            FPTPAmplifyTile Tile;
+            Tile.Face = Baked.Face;
+            Tile.TileX = Baked.TileX;
+            Tile.TileY = Baked.TileY;
+            Tile.TilesPerFace = 2;
+            Tile.Resolution = 33;
+            Tile.bSharedEdges = true;
+            for (int32 Y = 0; Y < 33; ++Y)
+            {
+                for (int32 X = 0; X < 33; ++X)
+                {
+                    const float Km = FPTPHeightfieldBaker::Dequantize(Heights[Y * 33 + X], Settings.MinElevationKm, Settings.MaxElevationKm);
+                    WorstKm = FMath::Max(WorstKm, FMath::Abs(Km - AnalyticElevationKm(Tile.TexelDirection(X, Y))));
+                }
+            }
+        }
+        TestTrue(FString::Printf(TEXT("%s texels match the source"), *FormatName), WorstKm <= Step);
+
+        IFileManager::Get().DeleteDirectory(*Settings.OutputDir, false, true);
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPHeightfieldBakeWrongSizeTest, "GaiaPTP.Heightfield.BakeWrongSize",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPHeightfieldBakeWrongSizeTest::RunTest(const FString& Parameters)
+{
+    FPTPCraterFieldParams Params;
+    Params.PlanetRadiusKm = 400.0f;
+    Params.MinDiameterKm = 1.0f;
+    const TSharedRef<const FPTPCraterField> Field = MakeShared<FPTPCraterField>(Params);
+
+    // One texel short: the crater pass and the bake both reject it instead of asserting
+    const FPTPHeightSource Short = [](const FPTPAmplifyTile& Tile, TArray<float>& OutElevationKm)
+    {
+        OutElevationKm.Init(0.0f, Tile.Resolution * Tile.Resolution - 1);
+    };
+
+    FPTPBakeSettings Settings;
+    Settings.TilesPerFace = 1;
+    Settings.TileResolution = 17;
+    Settings.Faces = { 0 };
+    Settings.OutputDir = FPaths::AutomationTransientDir() / TEXT("PTPHeightfield") / TEXT("WrongSize");
+    Settings.BaseName = TEXT("Test");
+
+    AddExpectedError(TEXT("elevations"), EAutomationExpectedErrorFlags::Contains, 0);
+    FPTPBakeManifest Manifest;
+    FString Error;
+    const bool bBaked = FPTPHeightfieldBaker::Bake(FPTPHeightSources::MakeCratered(Short, Field), Settings, Manifest, Error);
+    TestFalse(TEXT("Wrong-sized base tile fails the bake"), bBaked);
+    TestFalse(TEXT("Failure is reported"), Error.IsEmpty());
+
+    IFileManager::Get().DeleteDirectory(*Settings.OutputDir, false, true);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
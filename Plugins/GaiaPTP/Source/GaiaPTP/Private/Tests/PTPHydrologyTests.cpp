@@ -0,0 +1,206 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "PTPAdjacency.h"
+#include "PTPHydrology.h"
+#include "PTPTestMeshes.h"
+
+namespace
+{
+    /** Icosphere with rolling terrain: basins, closed depressions and about a third ocean. */
+    void MakeTerrain(FPTPAdjacency& OutAdjacency, TArray<FVector3f>& OutPoints, TArray<float>& OutElevationKm)
+    {
+        TArray<FIntVector> Triangles;
+        PTPTestMeshes::MakeIcosphere(5, false, OutPoints, Triangles);
+        OutAdjacency.BuildFromTriangles(Triangles, OutPoints.Num());
+
+        OutElevationKm.SetNumUninitialized(OutPoints.Num());
+        for (int32 i = 0; i < OutPoints.Num(); ++i)
+        {
+            const FVector3f& P = OutPoints[i];
+            OutElevationKm[i] = 0.8f * FMath::Sin(5.0f * P.X) * FMath::Cos(4.0f * P.Y) + 0.5f * FMath::Sin(7.0f * P.Z + 1.0f)
+                + 0.3f * FMath::Sin(11.0f * (P.X + P.Y)) + 0.2f;
+        }
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPHydrologyAdjacencyTest, "GaiaPTP.Hydrology.Adjacency",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPHydrologyAdjacencyTest::RunTest(const FString& Parameters)
+{
+    TArray<FVector3f> Points;
+    TArray<FIntVector> Triangles;
+    PTPTestMeshes::MakeIcosphere(3, false, Points, Triangles);
+
+    // Per-point lists the way UPTPPlanetComponent::RestoreNeighbors builds them
+    TArray<TArray<int32>> Lists;
+    Lists.SetNum(Points.Num());
+    for (const FIntVector& Tri : Triangles)
+    {
+        for (int32 k = 0; k < 3; ++k)
+        {
+            Lists[Tri[k]].AddUnique(Tri[(k + 1) % 3]);
+            Lists[Tri[(k + 1) % 3]].AddUnique(Tri[k]);
+        }
+    }
+
+    FPTPAdjacency FromLists;
+    FromLists.Build(Lists);
+    FPTPAdjacency FromTriangles;
+    FromTriangles.BuildFromTriangles(Triangles, Points.Num());
+
+    TestEqual(TEXT("One row per vertex"), FromTriangles.Num(), Points.Num());
+    TestEqual(TEXT("Same number of entries"), FromTriangles.GetNumEntries(), FromLists.GetNumEntries());
+    bool bListOrder = true;
+    bool bSameSets = true;
+    bool bAscending = true;
+    for (int32 v = 0; v < Points.Num(); ++v)
+    {
+        bListOrder &= TArray<int32>(FromLists.GetNeighbors(v)) == Lists[v];
+        TArray<int32> Sorted = Lists[v];
+        Sorted.Sort();
+        bSameSets &= TArray<int32>(FromTriangles.GetNeighbors(v)) == Sorted;
+        for (int32 k = 1; k < FromTriangles.GetDegree(v); ++k)
+        {
+            bAscending &= FromTriangles.GetNeighbors(v)[k - 1] < FromTriangles.GetNeighbors(v)[k];
+        }
+    }
+    TestTrue(TEXT("Lists keep their order"), bListOrder);
+    TestTrue(TEXT("Triangles give the same neighbours"), bSameSets);
+    TestTrue(TEXT("Triangle rows are ascending and unique"), bAscending);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPHydrologyFillTest, "GaiaPTP.Hydrology.FillDepressions",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPHydrologyFillTest::RunTest(const FString& Parameters)
+{
+    FPTPAdjacency Adjacency;
+    TArray<FVector3f> Points;
+    TArray<float> ElevationKm;
+    MakeTerrain(Adjacency, Points, ElevationKm);
+    const int32 N = Points.Num();
+
+    TArray<float> Reference;
+    const int32 NumRaised = FPTPHydrology::FillDepressions(Adjacency, ElevationKm, 0.0f, N, Reference);
+    TestTrue(TEXT("Terrain has closed depressions"), NumRaised > 0);
+
+    bool bNeverLowered = true;
+    bool bOceanKept = true;
+    bool bNoPits = true;
+    for (int32 v = 0; v < N; ++v)
+    {
+        bNeverLowered &= Reference[v] >= ElevationKm[v];
+        bOceanKept &= ElevationKm[v] > 0.0f || Reference[v] == ElevationKm[v];
+        if (ElevationKm[v] > 0.0f)
+        {
+            bool bCanDrain = false;
+            for (int32 n : Adjacency.GetNeighbors(v))
+            {
+                bCanDrain |= Reference[n] <= Reference[v];
+            }
+            bNoPits &= bCanDrain;
+        }
+    }
+    TestTrue(TEXT("Filling never lowers terrain"), bNeverLowered);
+    TestTrue(TEXT("Ocean is left alone"), bOceanKept);
+    TestTrue(TEXT("No land vertex is a pit"), bNoPits);
+
+    // Regions stitched through the spill graph give the single-queue result exactly
+    for (const int32 RegionSize : { 97, 1000, 4096 })
+    {
+        TArray<float> Regional;
+        FPTPHydrology::FillDepressions(Adjacency, ElevationKm, 0.0f, RegionSize, Regional);
+        TestTrue(FString::Printf(TEXT("Region size %d matches the single-queue fill"), RegionSize), Regional == Reference);
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPHydrologyDrainageTest, "GaiaPTP.Hydrology.Drainage",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPHydrologyDrainageTest::RunTest(const FString& Parameters)
+{
+    FPTPAdjacency Adjacency;
+    TArray<FVector3f> Points;
+    TArray<float> ElevationKm;
+    MakeTerrain(Adjacency, Points, ElevationKm);
+    const int32 N = Points.Num();
+
+    FPTPHydrologyParams Params;
+    Params.RiverThreshold = 20.0f;
+    Params.FloodRegionSize = 1000;
+    FPTPDrainage Drainage;
+    FPTPHydrology::Compute(Adjacency, Points, ElevationKm, {}, Params, Drainage);
+
+    // Every land vertex reaches the ocean, and every vertex comes after its receiver
+    TestEqual(TEXT("Order covers the mesh"), Drainage.Order.Num(), N);
+    TArray<int32> Position;
+    Position.SetNumUninitialized(N);
+    for (int32 k = 0; k < Drainage.Order.Num(); ++k)
+    {
+        Position[Drainage.Order[k]] = k;
+    }
+    bool bDownhill = true;
+    bool bReachesOcean = true;
+    bool bTopological = true;
+    double OutletFlow = 0.0;
+    for (int32 v = 0; v < N; ++v)
+    {
+        const int32 Receiver = Drainage.Receivers[v];
+        if (Receiver == INDEX_NONE)
+        {
+            bReachesOcean &= ElevationKm[v] <= 0.0f;
+            OutletFlow += Drainage.Flow[v];
+            continue;
+        }
+        bDownhill &= Drainage.FilledElevationKm[Receiver] <= Drainage.FilledElevationKm[v];
+        bTopological &= Position[Receiver] < Position[v];
+    }
+    TestTrue(TEXT("Receivers never climb"), bDownhill);
+    TestTrue(TEXT("Only ocean vertices are outlets"), bReachesOcean);
+    TestTrue(TEXT("Receivers come first in the order"), bTopological);
+    TestEqual(TEXT("Outlets collect all runoff"), OutletFlow, double(N), 1e-3 * N);
+
+    // Reaches follow receivers, link up at confluences and never lose order downstream
+    TestTrue(TEXT("Rivers were extracted"), Drainage.Reaches.Num() > 0);
+    bool bFollowsReceivers = true;
+    bool bLinked = true;
+    bool bOrderGrows = true;
+    bool bAboveThreshold = true;
+    for (int32 r = 0; r < Drainage.Reaches.Num(); ++r)
+    {
+        const FPTPRiverReach& Reach = Drainage.Reaches[r];
+        const TConstArrayView<int32> Vertices = Drainage.GetReachVertices(r);
+        bFollowsReceivers &= Vertices.Num() >= 2;
+        for (int32 k = 0; k + 1 < Vertices.Num(); ++k)
+        {
+            bFollowsReceivers &= Drainage.Receivers[Vertices[k]] == Vertices[k + 1];
+            bAboveThreshold &= Drainage.Flow[Vertices[k]] >= Params.RiverThreshold;
+        }
+        if (Reach.Downstream != INDEX_NONE)
+        {
+            const FPTPRiverReach& Next = Drainage.Reaches[Reach.Downstream];
+            bLinked &= Drainage.RiverVertices[Next.First] == Vertices.Last();
+            bOrderGrows &= Next.StrahlerOrder >= Reach.StrahlerOrder;
+        }
+        else
+        {
+            bLinked &= Drainage.Receivers[Vertices.Last()] == INDEX_NONE;
+        }
+    }
+    TestTrue(TEXT("Reaches follow receivers"), bFollowsReceivers);
+    TestTrue(TEXT("Reaches end at a confluence or the sea"), bLinked);
+    TestTrue(TEXT("Strahler order never drops downstream"), bOrderGrows);
+    TestTrue(TEXT("River vertices carry the threshold flow"), bAboveThreshold);
+
+    // The result does not depend on how depressions were split into regions
+    Params.FloodRegionSize = N;
+    FPTPDrainage Single;
+    FPTPHydrology::Compute(Adjacency, Points, ElevationKm, {}, Params, Single);
+    TestTrue(TEXT("Same receivers for any region size"), Single.Receivers == Drainage.Receivers);
+    TestTrue(TEXT("Same flow for any region size"), Single.Flow == Drainage.Flow);
+    TestEqual(TEXT("Same rivers for any region size"), Single.RiverVertices.Num(), Drainage.RiverVertices.Num());
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
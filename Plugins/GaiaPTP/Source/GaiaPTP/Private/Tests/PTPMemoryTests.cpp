@@ -0,0 +1,47 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "PTPMemory.h"
+#include "PTPPlanetComponent.h"
+#include "TectonicData.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPMemoryReportTest, "GaiaPTP.Memory.Report",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPMemoryReportTest::RunTest(const FString& Parameters)
+{
+    UPTPPlanetComponent* Planet = NewObject<UPTPPlanetComponent>();
+    TestEqual(TEXT("Empty planet holds nothing"), (int64)Planet->GetMemoryReport().GetTotal(), (int64)0);
+
+    const int32 N = 1000;
+    Planet->SamplePoints.SetNumZeroed(N);
+    Planet->PointPlateIds.Init(0, N);
+    Planet->PlateMembership.Build(Planet->PointPlateIds, 1);
+    Planet->CrustData.SetNum(N);
+    Planet->Neighbors.SetNum(N);
+    for (TArray<int32>& Ring : Planet->Neighbors)
+    {
+        Ring.SetNumZeroed(6);
+    }
+
+    const FPTPMemoryReport Report = Planet->GetMemoryReport();
+    TestTrue(TEXT("Positions are single precision"), Report[EPTPMemoryBucket::SamplePoints] >= N * sizeof(FVector3f)
+        && Report[EPTPMemoryBucket::SamplePoints] < N * sizeof(FVector));
+    TestTrue(TEXT("Plate ids include the membership"), Report[EPTPMemoryBucket::PlateIds] >= 3 * N * sizeof(int32));
+    TestEqual(TEXT("Crust bucket"), (int64)Report[EPTPMemoryBucket::CrustData], (int64)Planet->CrustData.GetAllocatedSize());
+    TestTrue(TEXT("Neighbours count the inner arrays"), Report[EPTPMemoryBucket::Neighbors] >= N * 6 * sizeof(int32) + Planet->Neighbors.GetAllocatedSize());
+    TestEqual(TEXT("No preview on a bare component"), (int64)Report[EPTPMemoryBucket::MeshStreams], (int64)0);
+
+    SIZE_T Sum = 0;
+    for (int32 i = 0; i < (int32)EPTPMemoryBucket::Num; ++i)
+    {
+        Sum += Report.Bytes[i];
+    }
+    TestEqual(TEXT("Total is the sum of the buckets"), (int64)Report.GetTotal(), (int64)Sum);
+
+    FPTPMemoryReport Twice = Report;
+    Twice += Report;
+    TestEqual(TEXT("Reports accumulate"), (int64)Twice.GetTotal(), (int64)(2 * Sum));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,108 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "PTPNoise.h"
+
+static TArray<FVector3f> MakeRandomPositions(int32 N, int32 Seed, float Extent)
+{
+    FRandomStream Rand(Seed);
+    TArray<FVector3f> Out;
+    Out.SetNumUninitialized(N);
+    for (int32 i = 0; i < N; ++i)
+    {
+        Out[i] = FVector3f(Rand.FRandRange(-Extent, Extent), Rand.FRandRange(-Extent, Extent), Rand.FRandRange(-Extent, Extent));
+    }
+    return Out;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPNoiseBatchMatchesScalarTest, "GaiaPTP.Noise.BatchMatchesScalar",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPNoiseBatchMatchesScalarTest::RunTest(const FString& Parameters)
+{
+    // Odd count spanning several chunks so the scalar tail path is exercised
+    const int32 N = 5003;
+    const FPTPNoise Noise(1234);
+    const TArray<FVector3f> Positions = MakeRandomPositions(N, 5, 4.0f);
+
+    const EPTPNoiseType Types[] = { EPTPNoiseType::Simplex, EPTPNoiseType::Fbm, EPTPNoiseType::Ridged };
+    for (const float WarpAmplitude : { 0.0f, 0.3f })
+    {
+        FPTPNoiseSettings Settings;
+        Settings.Frequency = 1.7f;
+        Settings.Octaves = 5;
+        Settings.WarpAmplitude = WarpAmplitude;
+
+        for (const EPTPNoiseType Type : Types)
+        {
+            TArray<float> Values; Values.SetNumUninitialized(N);
+            TArray<FVector3f> Gradients; Gradients.SetNumUninitialized(N);
+            Noise.EvaluateBatch(Type, Positions, Settings, Values, Gradients);
+
+            float MaxErr = 0.0f;
+            for (int32 i = 0; i < N; ++i)
+            {
+                FVector3f Grad;
+                const float Ref = Noise.Evaluate(Type, Positions[i], Settings, &Grad);
+                MaxErr = FMath::Max(MaxErr, FMath::Abs(Values[i] - Ref));
+                MaxErr = FMath::Max(MaxErr, (Gradients[i] - Grad).GetAbsMax() / FMath::Max(1.0f, Grad.GetAbsMax()));
+            }
+            TestTrue(FString::Printf(TEXT("Batch matches scalar (type %d, warp %.1f)"), (int32)Type, WarpAmplitude), MaxErr < 1e-4f);
+        }
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPNoiseGradientTest, "GaiaPTP.Noise.AnalyticGradient",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPNoiseGradientTest::RunTest(const FString& Parameters)
+{
+    const FPTPNoise Noise(99);
+    const TArray<FVector3f> Positions = MakeRandomPositions(64, 11, 3.0f);
+    const float H = 1e-3f;
+
+    FPTPNoiseSettings Settings;
+    Settings.Octaves = 3;
+    Settings.WarpAmplitude = 0.25f;
+
+    for (const EPTPNoiseType Type : { EPTPNoiseType::Simplex, EPTPNoiseType::Fbm, EPTPNoiseType::Ridged })
+    {
+        int32 NumBad = 0;
+        for (const FVector3f& P : Positions)
+        {
+            FVector3f Grad;
+            Noise.Evaluate(Type, P, Settings, &Grad);
+
+            // Central differences; ridged has creases where |n| = 0, so allow a few outliers
+            FVector3f Numeric;
+            for (int32 Axis = 0; Axis < 3; ++Axis)
+            {
+                FVector3f Offset = FVector3f::ZeroVector;
+                Offset[Axis] = H;
+                Numeric[Axis] = (Noise.Evaluate(Type, P + Offset, Settings) - Noise.Evaluate(Type, P - Offset, Settings)) / (2.0f * H);
+            }
+            if ((Numeric - Grad).GetAbsMax() > 2e-2f * FMath::Max(1.0f, Grad.GetAbsMax()))
+            {
+                ++NumBad;
+            }
+        }
+        TestTrue(FString::Printf(TEXT("Analytic gradient matches finite differences (type %d)"), (int32)Type), NumBad <= 2);
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPNoiseDeterminismTest, "GaiaPTP.Noise.Determinism",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPNoiseDeterminismTest::RunTest(const FString& Parameters)
+{
+    const FVector3f P(0.37f, -1.21f, 2.05f);
+    FPTPNoiseSettings Settings;
+
+    TestEqual(TEXT("Same seed gives same value"), FPTPNoise(7).Evaluate(EPTPNoiseType::Fbm, P, Settings), FPTPNoise(7).Evaluate(EPTPNoiseType::Fbm, P, Settings));
+    TestNotEqual(TEXT("Different seeds differ"), FPTPNoise(7).Evaluate(EPTPNoiseType::Fbm, P, Settings), FPTPNoise(8).Evaluate(EPTPNoiseType::Fbm, P, Settings));
+
+    const float Ridged = FPTPNoise(7).Evaluate(EPTPNoiseType::Ridged, P, Settings);
+    TestTrue(TEXT("Ridged is in [0,1]"), Ridged >= 0.0f && Ridged <= 1.0f);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
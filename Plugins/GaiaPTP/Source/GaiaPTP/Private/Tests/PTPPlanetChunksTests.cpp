@@ -0,0 +1,94 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "PTPPlanetChunks.h"
+#include "Tests/PTPTestMeshes.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPPlanetChunksPartitionTest, "GaiaPTP.Chunks.Partition",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPPlanetChunksPartitionTest::RunTest(const FString& Parameters)
+{
+    TArray<FVector3f> Points;
+    TArray<FIntVector> Triangles;
+    PTPTestMeshes::MakeIcosphere(4, false, Points, Triangles);
+
+    FPTPPlanetChunks Chunks;
+    Chunks.Build(Points, Triangles, 2, 2.0f);
+    TestEqual(TEXT("6 * 4^Level chunks"), Chunks.GetNumChunks(), 6 * 16);
+    TestTrue(TEXT("Built for its inputs"), Chunks.IsBuiltFor(Points.Num(), Triangles.Num(), 2, 2.0f));
+    TestFalse(TEXT("Not built for another level"), Chunks.IsBuiltFor(Points.Num(), Triangles.Num(), 3, 2.0f));
+
+    // Every triangle appears exactly once, and chunk ranges tile the order
+    TArray<int32> Seen;
+    Seen.Init(0, Triangles.Num());
+    for (int32 t : Chunks.GetTriangleOrder())
+    {
+        ++Seen[t];
+    }
+    TestEqual(TEXT("Order covers all triangles"), Chunks.GetTriangleOrder().Num(), Triangles.Num());
+    TestFalse(TEXT("Order is a permutation"), Seen.ContainsByPredicate([](int32 Count) { return Count != 1; }));
+    TestEqual(TEXT("Ranges start at 0"), Chunks.GetChunkBegin(0), 0);
+    TestEqual(TEXT("Ranges end at NumTriangles"), Chunks.GetChunkEnd(Chunks.GetNumChunks() - 1), Triangles.Num());
+
+    // Each chunk's cap and sphere contain all of its (scaled) vertices
+    int32 NumOutside = 0;
+    for (int32 c = 0; c < Chunks.GetNumChunks(); ++c)
+    {
+        const FPTPChunkBounds& B = Chunks.GetBounds(c);
+        for (int32 k = Chunks.GetChunkBegin(c); k < Chunks.GetChunkEnd(c); ++k)
+        {
+            const FIntVector& Tri = Triangles[Chunks.GetTriangleOrder()[k]];
+            for (int32 v = 0; v < 3; ++v)
+            {
+                const FVector3f P = Points[Tri[v]] * 2.0f;
+                const bool bInCap = FVector3f::DotProduct(B.Axis, P.GetSafeNormal()) >= B.CosHalfAngle - 1e-5f;
+                const bool bInSphere = FVector3f::Dist(P, B.SphereCenter) <= B.SphereRadius + 1e-3f;
+                NumOutside += (bInCap && bInSphere) ? 0 : 1;
+            }
+        }
+    }
+    TestEqual(TEXT("Bounds enclose chunk vertices"), NumOutside, 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPPlanetChunksHorizonTest, "GaiaPTP.Chunks.Horizon",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPPlanetChunksHorizonTest::RunTest(const FString& Parameters)
+{
+    TArray<FVector3f> Points;
+    TArray<FIntVector> Triangles;
+    PTPTestMeshes::MakeIcosphere(4, false, Points, Triangles);
+
+    FPTPPlanetChunks Chunks;
+    Chunks.Build(Points, Triangles, 1, 1.0f);
+
+    // Camera at three radii on +X sees at most cos(Alpha) = 1/3 around +X
+    const FVector Camera(3.0, 0.0, 0.0);
+    TBitArray<> Visible;
+    Chunks.ComputeVisibility(Camera, nullptr, Visible);
+
+    int32 NumFacingVisible = 0, NumFacing = 0, NumBackVisible = 0;
+    for (int32 c = 0; c < Chunks.GetNumChunks(); ++c)
+    {
+        const float Facing = Chunks.GetBounds(c).Axis.X;
+        if (Facing > 0.5f)
+        {
+            ++NumFacing;
+            NumFacingVisible += Visible[c] ? 1 : 0;
+        }
+        else if (Facing < -0.5f)
+        {
+            NumBackVisible += Visible[c] ? 1 : 0;
+        }
+    }
+    TestTrue(TEXT("Some chunks face the camera"), NumFacing > 0);
+    TestEqual(TEXT("Chunks facing the camera are visible"), NumFacingVisible, NumFacing);
+    TestEqual(TEXT("Chunks on the far side are culled"), NumBackVisible, 0);
+
+    // From inside the sphere nothing is below the horizon
+    Chunks.ComputeVisibility(FVector(0.5, 0.0, 0.0), nullptr, Visible);
+    TestEqual(TEXT("All chunks visible from inside"), Visible.CountSetBits(), Chunks.GetNumChunks());
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,153 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "PTPPlanetMeshBuilder.h"
+#include "PTPPlanetChunks.h"
+#include "RealtimeMeshDataOptimizer.h"
+#include "TectonicData.h"
+#include "Tests/PTPTestMeshes.h"
+#include "Core/RealtimeMeshDataStream.h"
+#include "Core/RealtimeMeshDataTypes.h"
+
+using namespace RealtimeMesh;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPPlanetMeshBuilderSurfaceTest, "GaiaPTP.MeshBuilder.Surface",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPPlanetMeshBuilderSurfaceTest::RunTest(const FString& Parameters)
+{
+    // Octahedron with mixed winding
+    const TArray<FVector3f> Points = {
+        FVector3f(100, 0, 0), FVector3f(-100, 0, 0), FVector3f(0, 100, 0), FVector3f(0, -100, 0), FVector3f(0, 0, 100), FVector3f(0, 0, -100)
+    };
+    const TArray<FIntVector> Triangles = {
+        FIntVector(0, 2, 4), FIntVector(2, 1, 4), FIntVector(1, 3, 4), FIntVector(3, 0, 4),
+        FIntVector(0, 2, 5), FIntVector(2, 1, 5), FIntVector(1, 3, 5), FIntVector(3, 0, 5)
+    };
+    const TArray<int32> PlateIds = { 0, 0, 1, 1, 2, 2 };
+    TArray<FCrustData> Crust;
+    Crust.SetNum(Points.Num());
+    Crust[4].Elevation = 2.5f;
+
+    FRealtimeMeshStreamSet Streams;
+    const FPTPPlanetMeshLayout Layout = FPTPPlanetMeshBuilder::BuildSurface(Points, Triangles, 0.5f, Streams);
+    FPTPPlanetMeshBuilder::FillColors(Layout, PlateIds, Streams.FindChecked(FRealtimeMeshStreams::Color));
+    FPTPPlanetMeshBuilder::FillElevations(Layout, Crust, Streams.FindChecked(FRealtimeMeshStreams::TexCoords));
+
+    TestEqual(TEXT("One vertex per sample"), Layout.NumVertices, Points.Num());
+    TestEqual(TEXT("No duplicated back faces"), Streams.FindChecked(FRealtimeMeshStreams::Triangles).Num(), Triangles.Num());
+
+    TConstArrayView<const FVector3f> Positions = Streams.FindChecked(FRealtimeMeshStreams::Position).GetArrayView<FVector3f>();
+    TestTrue(TEXT("Positions scaled"), Positions[4].Equals(FVector3f(0, 0, 50), 1e-4f));
+
+    int32 NumInward = 0;
+    for (const TIndex3<uint32>& Tri : Streams.FindChecked(FRealtimeMeshStreams::Triangles).GetArrayView<TIndex3<uint32>>())
+    {
+        const FVector3f& A = Positions[Tri.V0];
+        const FVector3f& B = Positions[Tri.V1];
+        const FVector3f& C = Positions[Tri.V2];
+        NumInward += FVector3f::DotProduct(FVector3f::CrossProduct(B - A, C - A), A + B + C) > 0.0f ? 0 : 1;
+    }
+    TestEqual(TEXT("All triangles wound outward"), NumInward, 0);
+
+    TConstArrayView<const FRealtimeMeshTangentsNormalPrecision> Tangents = Streams.FindChecked(FRealtimeMeshStreams::Tangents).GetArrayView<FRealtimeMeshTangentsNormalPrecision>();
+    int32 NumBadFrames = 0;
+    for (int32 i = 0; i < Points.Num(); ++i)
+    {
+        const FVector3f N = Tangents[i].GetNormal();
+        const FVector3f T = Tangents[i].GetTangent();
+        const bool bOk = FVector3f::DotProduct(N, Points[i].GetSafeNormal()) > 0.98f && FMath::Abs(FVector3f::DotProduct(N, T)) < 0.05f;
+        NumBadFrames += bOk ? 0 : 1;
+    }
+    TestEqual(TEXT("Packed normals point outward with perpendicular tangents"), NumBadFrames, 0);
+
+    TConstArrayView<const FColor> Colors = Streams.FindChecked(FRealtimeMeshStreams::Color).GetArrayView<FColor>();
+    TestTrue(TEXT("Colour follows plate id"), Colors[4] == FPTPPlanetMeshBuilder::PlateColor(2) && Colors[0] == FPTPPlanetMeshBuilder::PlateColor(0));
+
+    TArrayView<FRealtimeMeshTexCoordsNormal> TexCoords = Streams.FindChecked(FRealtimeMeshStreams::TexCoords).GetArrayView<FRealtimeMeshTexCoordsNormal>();
+    TestTrue(TEXT("Elevation packed in TexCoord0.U"), FMath::IsNearlyEqual(FVector2f(TexCoords[4][0]).X, 2.5f, 1e-2f));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPPlanetMeshBuilderPointsTest, "GaiaPTP.MeshBuilder.Points",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPPlanetMeshBuilderPointsTest::RunTest(const FString& Parameters)
+{
+    TArray<FVector3f> Points;
+    FRandomStream Rand(3);
+    for (int32 i = 0; i < 101; ++i)
+    {
+        Points.Add(FVector3f(Rand.GetUnitVector() * 6370.0));
+    }
+
+    TArray<FTransform> Transforms;
+    const FPTPPlanetMeshLayout Layout = FPTPPlanetMeshBuilder::BuildPointInstances(Points, 10, 63.7f, 0.5f, 100.0f, Transforms);
+    TestEqual(TEXT("Markers on every 10th sample"), Layout.NumVertices, 11);
+    TestEqual(TEXT("One transform per marker"), Transforms.Num(), 11);
+    TestEqual(TEXT("Instance 5 maps to sample 50"), Layout.VertexToSample(5), 50);
+
+    int32 NumBad = 0;
+    for (int32 m = 0; m < Transforms.Num(); ++m)
+    {
+        const FVector P(Points[m * 10]);
+        const bool bPlaced = Transforms[m].GetLocation().Equals(P * 0.5, 1e-3);
+        const bool bFacing = Transforms[m].GetRotation().GetUpVector().Equals(P.GetSafeNormal(), 1e-4);
+        const bool bSized = FMath::IsNearlyEqual(Transforms[m].GetScale3D().X, 63.7 * 0.5 / 100.0, 1e-5);
+        NumBad += (bPlaced && bFacing && bSized) ? 0 : 1;
+    }
+    TestEqual(TEXT("Quads centred on samples, facing out, scaled to the marker size"), NumBad, 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPPlanetMeshBuilderLODChainTest, "GaiaPTP.MeshBuilder.LODChain",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPPlanetMeshBuilderLODChainTest::RunTest(const FString& Parameters)
+{
+    TArray<FVector3f> Points;
+    TArray<FIntVector> Triangles;
+    PTPTestMeshes::MakeIcosphere(5, false, Points, Triangles);
+
+    FPTPPlanetChunks Chunks;
+    Chunks.Build(Points, Triangles, 1, 100.0f);
+    FRealtimeMeshStreamSet Streams;
+    const FPTPPlanetMeshLayout Layout = FPTPPlanetMeshBuilder::BuildSurface(Points, Triangles, 100.0f, Streams, Chunks.GetTriangleOrder());
+    TArray<int32> PlateIds;
+    PlateIds.Init(0, Points.Num());
+    FPTPPlanetMeshBuilder::FillColors(Layout, PlateIds, Streams.FindChecked(FRealtimeMeshStreams::Color));
+
+    TArray<FRealtimeMeshStreamRange> Ranges;
+    for (int32 c = 0; c < Chunks.GetNumChunks(); ++c)
+    {
+        Ranges.Add(FRealtimeMeshStreamRange(0, Layout.NumVertices, Chunks.GetChunkBegin(c) * 3, Chunks.GetChunkEnd(c) * 3));
+    }
+
+    FRealtimeMeshLODChainSettings Settings;
+    Settings.NumLODs = 3;
+    Settings.ColorWeight = 1.0f;
+    const TArray<FRealtimeMeshSimplifiedLOD> LODs = URealtimeMeshDataOptimizer::GenerateLODChain(Streams, Ranges, Settings);
+    TestTrue(TEXT("At least one simplified LOD"), LODs.Num() > 0);
+
+    int32 PreviousTriangles = Triangles.Num();
+    float PreviousScreenSize = 1.0f;
+    for (const FRealtimeMeshSimplifiedLOD& LOD : LODs)
+    {
+        const int32 NumTriangles = LOD.Indices.Num() / 3;
+        TestTrue(TEXT("Each LOD has fewer triangles"), NumTriangles < PreviousTriangles);
+        TestTrue(TEXT("Screen sizes do not increase"), LOD.ScreenSize <= PreviousScreenSize);
+        TestEqual(TEXT("One range per source section"), LOD.SectionRanges.Num(), Ranges.Num());
+        TestEqual(TEXT("Section ranges tile the index buffer"), LOD.SectionRanges.Last().GetMaxIndex() + 1, LOD.Indices.Num());
+        TestFalse(TEXT("Indices address the compacted vertices"),
+            LOD.Indices.ContainsByPredicate([&](uint32 Index) { return Index >= (uint32)LOD.SourceVertices.Num(); }));
+
+        FRealtimeMeshStreamSet LODStreams;
+        URealtimeMeshDataOptimizer::BuildLODStreams(Streams, LOD, LODStreams);
+        TestEqual(TEXT("Gathered positions"), LODStreams.FindChecked(FRealtimeMeshStreams::Position).Num(), LOD.SourceVertices.Num());
+        TestEqual(TEXT("Gathered colours"), LODStreams.FindChecked(FRealtimeMeshStreams::Color).Num(), LOD.SourceVertices.Num());
+        TestEqual(TEXT("Triangle stream"), LODStreams.FindChecked(FRealtimeMeshStreams::Triangles).Num(), NumTriangles);
+
+        PreviousTriangles = NumTriangles;
+        PreviousScreenSize = LOD.ScreenSize;
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
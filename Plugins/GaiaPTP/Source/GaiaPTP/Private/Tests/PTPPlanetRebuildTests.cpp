@@ -0,0 +1,258 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "FibonacciSphere.h"
+#include "PTPPlanetComponent.h"
+#include "PTPPlanetRebuild.h"
+#include "TectonicData.h"
+
+namespace
+{
+    FPTPRebuildSettings MakeSmallSettings()
+    {
+        FPTPRebuildSettings Settings;
+        Settings.NumSamplePoints = 2000;
+        Settings.PlanetRadiusKm = 6370.0f;
+        Settings.NumPlates = 12;
+        Settings.ContinentalRatio = 0.3f;
+        Settings.MaxPlateSpeedMmPerYear = 100.0f;
+        Settings.AbyssalPlainElevationKm = -6.0f;
+        Settings.HighestOceanicRidgeElevationKm = -1.0f;
+        Settings.InitialSeed = 42;
+        Settings.bBuildAdjacency = false;
+        return Settings;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPRebuildStagesTest, "GaiaPTP.Rebuild.Stages",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPRebuildStagesTest::RunTest(const FString& Parameters)
+{
+    const FPTPRebuildSettings Settings = MakeSmallSettings();
+
+    TArray<EPTPRebuildStage> Stages;
+    FPTPPlanetState State;
+    FString Error;
+    const bool bBuilt = FPTPPlanetRebuild::Run(Settings, State, [&](EPTPRebuildStage Stage) { Stages.Add(Stage); },
+        []() { return false; }, Error);
+
+    TestTrue(TEXT("Rebuild completes"), bBuilt);
+    TestTrue(TEXT("No error"), Error.IsEmpty());
+    TestTrue(TEXT("Stages in order, adjacency skipped"), Stages == TArray<EPTPRebuildStage>(
+        { EPTPRebuildStage::Sampling, EPTPRebuildStage::Seeding, EPTPRebuildStage::Crust }));
+    TestEqual(TEXT("Samples"), State.SamplePoints.Num(), Settings.NumSamplePoints);
+    TestEqual(TEXT("Sample order kept"), State.SampleOrder.Num(), Settings.NumSamplePoints);
+    TestEqual(TEXT("Plate ids"), State.PointPlateIds.Num(), Settings.NumSamplePoints);
+    TestEqual(TEXT("Crust"), State.CrustData.Num(), Settings.NumSamplePoints);
+    TestEqual(TEXT("Plates"), State.Plates.Num(), Settings.NumPlates);
+    TestEqual(TEXT("No boundaries without adjacency"), State.BoundaryTypes.Num(), 0);
+
+    // Same settings, same planet: the async and synchronous paths can be swapped freely
+    FPTPPlanetState Again;
+    FPTPPlanetRebuild::Run(Settings, Again, [](EPTPRebuildStage) {}, []() { return false; }, Error);
+    TestTrue(TEXT("Deterministic plate ids"), Again.PointPlateIds == State.PointPlateIds);
+
+    float Previous = -1.0f;
+    bool bMonotonic = true;
+    for (EPTPRebuildStage Stage : { EPTPRebuildStage::Sampling, EPTPRebuildStage::Seeding, EPTPRebuildStage::Adjacency,
+                                    EPTPRebuildStage::Crust, EPTPRebuildStage::Mesh })
+    {
+        bMonotonic &= FPTPPlanetRebuild::GetStageProgress(Stage) > Previous;
+        Previous = FPTPPlanetRebuild::GetStageProgress(Stage);
+    }
+    TestTrue(TEXT("Stage progress increases"), bMonotonic && Previous < 1.0f);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPRebuildCancelTest, "GaiaPTP.Rebuild.Cancel",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPRebuildCancelTest::RunTest(const FString& Parameters)
+{
+    // Cancel as soon as seeding starts: the crust stage must not run
+    bool bCancelled = false;
+    TArray<EPTPRebuildStage> Stages;
+    FPTPPlanetState State;
+    FString Error;
+    const bool bBuilt = FPTPPlanetRebuild::Run(MakeSmallSettings(), State,
+        [&](EPTPRebuildStage Stage)
+        {
+            Stages.Add(Stage);
+            bCancelled |= Stage == EPTPRebuildStage::Seeding;
+        },
+        [&]() { return bCancelled; }, Error);
+
+    TestFalse(TEXT("Cancelled rebuild reports failure"), bBuilt);
+    TestTrue(TEXT("Cancellation is not an error"), Error.IsEmpty());
+    TestFalse(TEXT("Crust stage skipped"), Stages.Contains(EPTPRebuildStage::Crust));
+    TestEqual(TEXT("No crust generated"), State.CrustData.Num(), 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPRebuildMemoTest, "GaiaPTP.Rebuild.Memoization",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPRebuildMemoTest::RunTest(const FString& Parameters)
+{
+    FPTPRebuildSettings Settings = MakeSmallSettings();
+    FPTPPlanetState State;
+    FString Error;
+    FPTPPlanetRebuild::Run(Settings, State, [](EPTPRebuildStage) {}, []() { return false; }, Error);
+    TestTrue(TEXT("Fresh state recomputes everything but adjacency and boundaries"),
+        State.Recomputed == (EPTPStageMask::All & ~EPTPStageMask::Adjacency & ~EPTPStageMask::Boundaries));
+    const TArray<int32> PlateIds = State.PointPlateIds;
+
+    // Each setting invalidates exactly its downstream suffix
+    const FPTPStageHashes Base = FPTPPlanetRebuild::ComputeStageHashes(Settings);
+    FPTPRebuildSettings Ratio = Settings;
+    Ratio.ContinentalRatio = 0.5f;
+    TestTrue(TEXT("Ratio dirties crust only"), FPTPPlanetRebuild::ComputeStageHashes(Ratio).Diff(Base) == EPTPStageMask::Crust);
+    FPTPRebuildSettings Speed = Settings;
+    Speed.MaxPlateSpeedMmPerYear = 50.0f;
+    TestTrue(TEXT("Speed dirties dynamics and boundaries"),
+        FPTPPlanetRebuild::ComputeStageHashes(Speed).Diff(Base) == (EPTPStageMask::Dynamics | EPTPStageMask::Boundaries));
+    FPTPRebuildSettings Radius = Settings;
+    Radius.PlanetRadiusKm = 3000.0f;
+    TestFalse(TEXT("Radius keeps the triangulation"),
+        EnumHasAnyFlags(FPTPPlanetRebuild::ComputeStageHashes(Radius).Diff(Base), EPTPStageMask::Adjacency | EPTPStageMask::Seed));
+    FPTPRebuildSettings Order = Settings;
+    Order.bSpatialReorder = !Settings.bSpatialReorder;
+    TestTrue(TEXT("Sample order dirties sampling, adjacency and their readers"),
+        FPTPPlanetRebuild::ComputeStageHashes(Order).Diff(Base) == (EPTPStageMask::All & ~EPTPStageMask::Seed & ~EPTPStageMask::Dynamics));
+    FPTPRebuildSettings Count = Settings;
+    Count.NumSamplePoints = 3000;
+    TestTrue(TEXT("Sample count dirties everything but seeding"),
+        FPTPPlanetRebuild::ComputeStageHashes(Count).Diff(Base) == (EPTPStageMask::All & ~EPTPStageMask::Seed & ~EPTPStageMask::Dynamics));
+
+    // A crust tweak reruns the crust stage alone and reads only samples and assignment
+    TestTrue(TEXT("Crust reads samples and assignment"),
+        FPTPPlanetRebuild::GetRequiredInputs(EPTPStageMask::Crust, false, true) == (EPTPStageMask::Sample | EPTPStageMask::Assign));
+    State.Recomputed = EPTPStageMask::None;
+    TArray<EPTPRebuildStage> Stages;
+    FPTPPlanetRebuild::Run(Ratio, State, [&](EPTPRebuildStage Stage) { Stages.Add(Stage); }, []() { return false; }, Error);
+    TestTrue(TEXT("Only the crust stage ran"), Stages == TArray<EPTPRebuildStage>({ EPTPRebuildStage::Crust }));
+    TestTrue(TEXT("Only crust recomputed"), State.Recomputed == EPTPStageMask::Crust);
+    TestTrue(TEXT("Assignment untouched"), State.PointPlateIds == PlateIds);
+
+    // Unchanged settings: nothing runs
+    State.Recomputed = EPTPStageMask::None;
+    Stages.Reset();
+    FPTPPlanetRebuild::Run(Ratio, State, [&](EPTPRebuildStage Stage) { Stages.Add(Stage); }, []() { return false; }, Error);
+    TestEqual(TEXT("No stage reruns"), Stages.Num(), 0);
+    TestTrue(TEXT("Nothing recomputed"), State.Recomputed == EPTPStageMask::None);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPRebuildComponentSettingsTest, "GaiaPTP.Rebuild.ComponentSettings",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPRebuildComponentSettingsTest::RunTest(const FString& Parameters)
+{
+    UPTPPlanetComponent* Planet = NewObject<UPTPPlanetComponent>();
+    Planet->NumSamplePoints = 2000;
+    Planet->NumPlates = 12;
+    Planet->RebuildPlanet();
+    TestEqual(TEXT("Component builds its planet"), Planet->CrustData.Num(), 2000);
+    const FPTPStageHashes Built = Planet->GetStageHashes();
+    const TArray<FCrustData> Crust = Planet->CrustData;
+
+    // Elevation and seed edits on the component reach the crust stage, not just the project settings
+    Planet->AbyssalPlainElevationKm -= 1.0f;
+    TestFalse(TEXT("Abyssal edit dirties the planet"), Planet->IsUpToDate(false));
+    Planet->RebuildPlanet();
+    TestTrue(TEXT("Abyssal edit rebuilds the crust"), Planet->GetStageHashes().Crust != Built.Crust);
+    TestEqual(TEXT("Abyssal edit keeps the samples"), Planet->GetStageHashes().Sample, Built.Sample);
+    bool bDeeper = false;
+    for (int32 i = 0; i < Crust.Num(); ++i)
+    {
+        bDeeper |= Planet->CrustData[i].Elevation < Crust[i].Elevation;
+    }
+    TestTrue(TEXT("Oceanic crust sits deeper"), bDeeper);
+
+    const uint32 AbyssalCrust = Planet->GetStageHashes().Crust;
+    Planet->HighestOceanicRidgeElevationKm -= 0.5f;
+    Planet->RebuildPlanet();
+    TestTrue(TEXT("Ridge edit rebuilds the crust"), Planet->GetStageHashes().Crust != AbyssalCrust);
+
+    const uint32 RidgeCrust = Planet->GetStageHashes().Crust;
+    Planet->InitialSeed += 1;
+    Planet->RebuildPlanet();
+    TestTrue(TEXT("Seed edit rebuilds the crust"), Planet->GetStageHashes().Crust != RidgeCrust);
+    TestTrue(TEXT("Planet matches the component settings"), Planet->IsUpToDate(false));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPRebuildPlateOrderTest, "GaiaPTP.Rebuild.PlateOrder",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPRebuildPlateOrderTest::RunTest(const FString& Parameters)
+{
+    // Every plate range is the run of its own indices, and the triangulation follows the samples
+    auto IsPlateMajor = [](const FPTPPlanetState& State)
+    {
+        bool bContiguous = State.Membership.IsConsistent(State.PointPlateIds);
+        for (int32 p = 0; p < State.Membership.GetNumPlates(); ++p)
+        {
+            const TConstArrayView<int32> Points = State.Membership.GetPlatePoints(p);
+            bContiguous &= Points.Num() == 0 || Points.Last() - Points[0] == Points.Num() - 1;
+        }
+        return bContiguous;
+    };
+    auto CornerDirections = [](const FPTPPlanetState& State)
+    {
+        TArray<FVector3f> Corners;
+        for (const FIntVector& Tri : State.Triangles)
+        {
+            Corners.Add(State.SamplePoints[Tri.X].GetSafeNormal());
+            Corners.Add(State.SamplePoints[Tri.Y].GetSafeNormal());
+            Corners.Add(State.SamplePoints[Tri.Z].GetSafeNormal());
+        }
+        return Corners;
+    };
+    auto SameCorners = [](const TArray<FVector3f>& A, const TArray<FVector3f>& B)
+    {
+        bool bSame = A.Num() == B.Num();
+        for (int32 i = 0; bSame && i < A.Num(); ++i)
+        {
+            bSame = A[i].Equals(B[i], 1.0e-5f);
+        }
+        return bSame;
+    };
+
+    FPTPRebuildSettings Settings = MakeSmallSettings();
+    FPTPPlanetState State;
+    FString Error;
+    FPTPPlanetRebuild::Run(Settings, State, [](EPTPRebuildStage) {}, []() { return false; }, Error);
+    TestTrue(TEXT("Samples grouped by plate"), IsPlateMajor(State));
+
+    TArray<FVector3f> Lattice;
+    FFibonacciSphere::GeneratePoints(Settings.NumSamplePoints, Settings.PlanetRadiusKm, Lattice);
+    bool bIds = true;
+    for (int32 i = 0; i < State.SamplePoints.Num(); ++i)
+    {
+        bIds &= State.SamplePoints[i] == Lattice[State.SampleOrder[i]];
+    }
+    TestTrue(TEXT("Sample ids name their lattice points"), bIds);
+
+    // Stand-in triangulation over consecutive samples, marked current so later runs keep it
+    for (int32 i = 0; i + 2 < State.SamplePoints.Num(); i += 3)
+    {
+        State.Triangles.Add(FIntVector(i, i + 1, i + 2));
+    }
+    State.Hashes.Adjacency = FPTPPlanetRebuild::ComputeStageHashes(Settings).Adjacency;
+    const TArray<FVector3f> Corners = CornerDirections(State);
+
+    // A plate count change regroups the samples and carries the triangulation along
+    Settings.NumPlates = 7;
+    State.Recomputed = EPTPStageMask::None;
+    FPTPPlanetRebuild::Run(Settings, State, [](EPTPRebuildStage) {}, []() { return false; }, Error);
+    TestTrue(TEXT("Regrouped by the new plates"), IsPlateMajor(State));
+    TestTrue(TEXT("Regrouping replaces samples and adjacency"),
+        EnumHasAllFlags(State.Recomputed, EPTPStageMask::Sample | EPTPStageMask::Adjacency));
+    TestTrue(TEXT("Triangles keep their corners after regrouping"), SameCorners(CornerDirections(State), Corners));
+
+    // A radius change resamples into the cached order, so the kept triangulation stays valid
+    Settings.PlanetRadiusKm = 3000.0f;
+    FPTPPlanetRebuild::Run(Settings, State, [](EPTPRebuildStage) {}, []() { return false; }, Error);
+    TestTrue(TEXT("Triangles keep their corners after resampling"), SameCorners(CornerDirections(State), Corners));
+    TestTrue(TEXT("Resampled at the new radius"), FMath::IsNearlyEqual(State.SamplePoints[0].Size(), 3000.0f, 0.1f));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
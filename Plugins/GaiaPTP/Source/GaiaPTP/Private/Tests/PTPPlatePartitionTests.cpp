@@ -0,0 +1,126 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "PTPPlateMembership.h"
+#include "PTPPlatePartition.h"
+#include <atomic>
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPPlatePartitionSplitTest, "GaiaPTP.PlatePartition.Split",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPPlatePartitionSplitTest::RunTest(const FString& Parameters)
+{
+    // One giant plate, a few mid-sized ones and an empty one
+    const TArray<int32> Sizes = { 10000, 0, 300, 1025, 1 };
+    TArray<int32> PlateIds;
+    for (int32 Plate = 0; Plate < Sizes.Num(); ++Plate)
+    {
+        for (int32 i = 0; i < Sizes[Plate]; ++i)
+        {
+            PlateIds.Add(Plate);
+        }
+    }
+    FPTPPlateMembership Membership;
+    Membership.Build(PlateIds, Sizes.Num());
+
+    const FPTPPlatePartition Partition(Membership, 1024);
+    TestEqual(TEXT("Plates"), Partition.GetNumPlates(), Sizes.Num());
+    TestEqual(TEXT("Giant plate split"), Partition.GetPlateItems(0).Num(), 10);
+    TestEqual(TEXT("Empty plate has no items"), Partition.GetPlateItems(1).Num(), 0);
+    TestEqual(TEXT("Just over the item size splits in two"), Partition.GetPlateItems(3).Num(), 2);
+
+    for (int32 Plate = 0; Plate < Sizes.Num(); ++Plate)
+    {
+        int32 Next = 0;
+        int32 Smallest = MAX_int32, Largest = 0;
+        for (const FPTPPlateWorkItem& Item : Partition.GetPlateItems(Plate))
+        {
+            TestEqual(TEXT("Item belongs to its plate"), Item.Plate, Plate);
+            TestEqual(TEXT("Items tile the plate"), Item.Begin, Next);
+            Next = Item.End;
+            Smallest = FMath::Min(Smallest, Item.Num());
+            Largest = FMath::Max(Largest, Item.Num());
+        }
+        TestEqual(TEXT("Items cover the plate"), Next, Sizes[Plate]);
+        TestTrue(TEXT("Items within the size"), Largest <= 1024);
+        TestTrue(TEXT("Items evenly split"), Largest == 0 || Largest - Smallest <= 1);
+    }
+
+    const FPTPPlatePartition PerPlate(Membership, MAX_int32);
+    TestEqual(TEXT("Unbounded item size gives one item per non-empty plate"), PerPlate.GetNumItems(), 4);
+    TestEqual(TEXT("Per-plate item spans the giant plate"), PerPlate.GetPlateItems(0)[0].Num(), Sizes[0]);
+    TestEqual(TEXT("Per-plate item spans a mid-sized plate"), PerPlate.GetPlateItems(3)[0].Num(), Sizes[3]);
+
+    // Plate sizes near the int32 limit split without overflowing
+    FPTPPlatePartition Huge;
+    Huge.Build(2, [](int32 Plate) { return Plate == 0 ? MAX_int32 - 1 : 2; }, MAX_int32);
+    TestEqual(TEXT("Huge plates still get one item each"), Huge.GetNumItems(), 2);
+    TestEqual(TEXT("Huge item covers its plate"), Huge.GetPlateItems(0)[0].End, MAX_int32 - 1);
+    Huge.Build(1, [](int32) { return MAX_int32; }, 1 << 30);
+    TestEqual(TEXT("Huge plate splits by the item size"), Huge.GetNumItems(), 2);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPPlatePartitionDispatchTest, "GaiaPTP.PlatePartition.Dispatch",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPPlatePartitionDispatchTest::RunTest(const FString& Parameters)
+{
+    TArray<int32> PlateIds;
+    for (int32 i = 0; i < 20000; ++i)
+    {
+        PlateIds.Add(i < 15000 ? 0 : 1 + i % 7);
+    }
+    FPTPPlateMembership Membership;
+    Membership.Build(PlateIds, 8);
+    const FPTPPlatePartition Partition(Membership, 512);
+
+    // Per-plate sums through item partials, as a centroid pass does
+    TArray<int64> Partials;
+    Partials.SetNumZeroed(Partition.GetNumItems());
+    TArray<int64> Sums;
+    Sums.SetNumZeroed(Membership.GetNumPlates());
+    TArray<int32> Visits;
+    Visits.SetNumZeroed(PlateIds.Num());
+    std::atomic<int32> WorkBeforePrologue{ 0 };
+    std::atomic<int32> EpilogueBeforeWork{ 0 };
+    TArray<uint8> PrologueDone;
+    PrologueDone.SetNumZeroed(Membership.GetNumPlates());
+    std::atomic<int32> NumWorkDone{ 0 };
+
+    Partition.Dispatch(
+        [&](int32 Plate) { PrologueDone[Plate] = 1; },
+        [&](int32 ItemIdx, const FPTPPlateWorkItem& Item)
+        {
+            WorkBeforePrologue += PrologueDone[Item.Plate] ? 0 : 1;
+            for (int32 Point : Item.Slice(Membership.GetPlatePoints(Item.Plate)))
+            {
+                ++Visits[Point];
+                Partials[ItemIdx] += Point;
+            }
+            ++NumWorkDone;
+        },
+        [&](int32 Plate)
+        {
+            EpilogueBeforeWork += NumWorkDone.load() == Partition.GetNumItems() ? 0 : 1;
+            for (int32 i = 0; i < Partition.GetPlateItems(Plate).Num(); ++i)
+            {
+                Sums[Plate] += Partials[Partition.GetFirstItem(Plate) + i];
+            }
+        });
+
+    TestEqual(TEXT("Prologues finish before work"), WorkBeforePrologue.load(), 0);
+    TestEqual(TEXT("Epilogues start after all work"), EpilogueBeforeWork.load(), 0);
+
+    bool bEachOnce = true;
+    TArray<int64> Expected;
+    Expected.SetNumZeroed(Membership.GetNumPlates());
+    for (int32 i = 0; i < PlateIds.Num(); ++i)
+    {
+        bEachOnce &= Visits[i] == 1;
+        Expected[PlateIds[i]] += i;
+    }
+    TestTrue(TEXT("Every point visited once"), bEachOnce);
+    TestTrue(TEXT("Reductions match"), Sums == Expected);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
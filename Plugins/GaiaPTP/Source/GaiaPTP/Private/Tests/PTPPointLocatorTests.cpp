@@ -0,0 +1,101 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "PTPPointLocator.h"
+#include "Tests/PTPTestMeshes.h"
+
+static TArray<FVector3f> MakeQueries(int32 Num, int32 Seed)
+{
+    FRandomStream Rand(Seed);
+    TArray<FVector3f> Queries;
+    Queries.SetNumUninitialized(Num);
+    for (FVector3f& Q : Queries)
+    {
+        Q = FVector3f(Rand.GetUnitVector());
+    }
+    return Queries;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPPointLocatorContainmentTest, "GaiaPTP.PointLocator.Containment",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPPointLocatorContainmentTest::RunTest(const FString& Parameters)
+{
+    TArray<FVector3f> Points;
+    TArray<FIntVector> Triangles;
+    PTPTestMeshes::MakeIcosphere(4, false, Points, Triangles);
+
+    FPTPPointLocator Locator;
+    TestTrue(TEXT("Locator builds on a closed mesh"), Locator.Build(Points, Triangles));
+
+    int32 NumOutside = 0;
+    int32 NumBadWeights = 0;
+    int32 NumBadReconstruction = 0;
+    for (const FVector3f& Q : MakeQueries(2000, 5))
+    {
+        const FPTPLocation L = Locator.Locate(Q);
+        const FIntVector& T = Locator.GetTriangle(L.Triangle);
+        const FVector3f& A = Points[T.X];
+        const FVector3f& B = Points[T.Y];
+        const FVector3f& C = Points[T.Z];
+
+        // Containment in the spherical triangle: Q is on the inner side of all three great-circle edges
+        const float Slack = -1e-5f;
+        const bool bInside = FVector3f::DotProduct(FVector3f::CrossProduct(A, B), Q) >= Slack
+            && FVector3f::DotProduct(FVector3f::CrossProduct(B, C), Q) >= Slack
+            && FVector3f::DotProduct(FVector3f::CrossProduct(C, A), Q) >= Slack;
+        NumOutside += bInside ? 0 : 1;
+
+        const FVector3f& W = L.Barycentrics;
+        const bool bValid = W.GetMin() >= 0.0f && FMath::IsNearlyEqual(W.X + W.Y + W.Z, 1.0f, 1e-4f);
+        NumBadWeights += bValid ? 0 : 1;
+
+        // Weighted vertices point along the query direction (central projection)
+        const FVector3f P = A * W.X + B * W.Y + C * W.Z;
+        NumBadReconstruction += FVector3f::DotProduct(P.GetSafeNormal(), Q) > 0.99999f ? 0 : 1;
+    }
+    TestEqual(TEXT("Located triangle contains the query"), NumOutside, 0);
+    TestEqual(TEXT("Barycentrics are non-negative and sum to 1"), NumBadWeights, 0);
+    TestEqual(TEXT("Barycentrics reconstruct the query direction"), NumBadReconstruction, 0);
+    TestEqual(TEXT("No brute-force fallbacks on a well-shaped mesh"), Locator.GetNumFallbacks(), 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPPointLocatorBatchTest, "GaiaPTP.PointLocator.BatchMatchesSingle",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPPointLocatorBatchTest::RunTest(const FString& Parameters)
+{
+    TArray<FVector3f> Points;
+    TArray<FIntVector> Triangles;
+    PTPTestMeshes::MakeIcosphere(3, true, Points, Triangles);
+
+    FPTPPointLocator Locator;
+    TestTrue(TEXT("Locator builds on an inward-wound mesh"), Locator.Build(Points, Triangles));
+
+    const TArray<FVector3f> Queries = MakeQueries(10000, 11);
+    TArray<FPTPLocation> Batch;
+    Batch.SetNumUninitialized(Queries.Num());
+    Locator.LocateBatch(Queries, Batch);
+
+    int32 NumMismatch = 0;
+    for (int32 i = 0; i < Queries.Num(); ++i)
+    {
+        // Queries on a shared edge may resolve to either neighbour; compare the interpolated point instead
+        const FPTPLocation Single = Locator.Locate(Queries[i]);
+        auto Interpolate = [&](const FPTPLocation& L)
+        {
+            const FIntVector& T = Locator.GetTriangle(L.Triangle);
+            return Points[T.X] * L.Barycentrics.X + Points[T.Y] * L.Barycentrics.Y + Points[T.Z] * L.Barycentrics.Z;
+        };
+        NumMismatch += (Single.Triangle == Batch[i].Triangle || Interpolate(Single).Equals(Interpolate(Batch[i]), 1e-4f)) ? 0 : 1;
+    }
+    TestEqual(TEXT("LocateBatch equals Locate"), NumMismatch, 0);
+
+    TArray<FIntVector> Open = Triangles;
+    Open.Pop();
+    FPTPPointLocator OpenLocator;
+    AddExpectedError(TEXT("triangulation is not closed"), EAutomationExpectedErrorFlags::Contains, 1);
+    TestFalse(TEXT("Open mesh is rejected"), OpenLocator.Build(Points, Open));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,143 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "CrustInitialization.h"
+#include "FibonacciSphere.h"
+#include "PTPPlateMembership.h"
+#include "PTPPrecision.h"
+#include "TectonicSeeding.h"
+
+namespace
+{
+    // Brute-force K nearest neighbours on the double lattice so both paths share one adjacency
+    void BuildNearestNeighbors(const TArray<FVector>& Points, int32 K, TArray<TArray<int32>>& OutNeighbors)
+    {
+        OutNeighbors.SetNum(Points.Num());
+        for (int32 i = 0; i < Points.Num(); ++i)
+        {
+            TArray<TPair<double, int32>> Dist;
+            Dist.Reserve(Points.Num());
+            for (int32 j = 0; j < Points.Num(); ++j)
+            {
+                if (j != i)
+                {
+                    Dist.Emplace(FVector::DistSquared(Points[i], Points[j]), j);
+                }
+            }
+            Dist.Sort([](const TPair<double, int32>& A, const TPair<double, int32>& B) { return A.Key < B.Key; });
+            OutNeighbors[i].Reset();
+            for (int32 k = 0; k < K; ++k)
+            {
+                OutNeighbors[i].Add(Dist[k].Value);
+            }
+        }
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPPrecisionSamplingTest, "GaiaPTP.Precision.Sampling",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPPrecisionSamplingTest::RunTest(const FString& Parameters)
+{
+    const float RadiusKm = 6370.0f;
+    TArray<FVector> Double;
+    TArray<FVector3f> Single;
+    FFibonacciSphere::GeneratePoints(20000, RadiusKm, Double);
+    FFibonacciSphere::GeneratePoints(20000, RadiusKm, Single);
+    TestEqual(TEXT("Same sample count"), Single.Num(), Double.Num());
+
+    // Both overloads round the double lattice to float, so they must agree to well under a metre
+    double MaxErrorKm = 0.0;
+    for (int32 i = 0; i < Double.Num(); ++i)
+    {
+        MaxErrorKm = FMath::Max(MaxErrorKm, FVector::Dist(FVector(Single[i]), Double[i]));
+    }
+    AddInfo(FString::Printf(TEXT("Max position error: %.6f km"), MaxErrorKm));
+    TestTrue(TEXT("Positions agree to a metre"), MaxErrorKm < 1e-3);
+
+    TArray<FVector> Seeds;
+    FTectonicSeeding::GeneratePlateSeeds(40, Seeds);
+    TArray<int32> DoubleIds, SingleIds;
+    FPTPPlateMembership DoubleMembership, SingleMembership;
+    FTectonicSeeding::AssignPointsToSeeds(Double, Seeds, DoubleIds, DoubleMembership);
+    FTectonicSeeding::AssignPointsToSeeds(Single, Seeds, SingleIds, SingleMembership);
+
+    // Only points equidistant to two seeds to within float rounding may switch plates
+    int32 NumDiffer = 0;
+    for (int32 i = 0; i < DoubleIds.Num(); ++i)
+    {
+        NumDiffer += DoubleIds[i] != SingleIds[i] ? 1 : 0;
+    }
+    TestTrue(TEXT("Plate assignment matches on 99.9% of samples"), NumDiffer * 1000 <= DoubleIds.Num());
+    TestTrue(TEXT("Membership consistent"), SingleMembership.IsConsistent(SingleIds));
+
+    // Same partition for both so the crust comparison sees only the position precision
+    TArray<FCrustData> DoubleCrust, SingleCrust;
+    FCrustInitialization::InitializeCrustData(Double, DoubleMembership, 0.3f, -6.0f, -1.0f, 12345, DoubleCrust);
+    FCrustInitialization::InitializeCrustData(Single, DoubleMembership, 0.3f, -6.0f, -1.0f, 12345, SingleCrust);
+    int32 NumBad = 0;
+    for (int32 i = 0; i < DoubleCrust.Num(); ++i)
+    {
+        const FCrustData& A = DoubleCrust[i];
+        const FCrustData& B = SingleCrust[i];
+        const bool bSame = A.Type == B.Type
+            && FMath::IsNearlyEqual(A.Elevation, B.Elevation, 1e-3f)
+            && FMath::IsNearlyEqual(A.OceanicAge, B.OceanicAge, 1e-2f)
+            && A.RidgeDirection.Equals(B.RidgeDirection, 1e-4f);
+        NumBad += bSame ? 0 : 1;
+    }
+    TestEqual(TEXT("Crust matches the double path"), NumBad, 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPPrecisionBoundariesTest, "GaiaPTP.Precision.Boundaries",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPPrecisionBoundariesTest::RunTest(const FString& Parameters)
+{
+    TArray<FVector> Double;
+    FFibonacciSphere::GeneratePoints(2000, 6370.0f, Double);
+    TArray<FVector3f> Single;
+    PTPPrecision::ToFloat(Double, Single);
+
+    TArray<FVector> RoundTrip;
+    PTPPrecision::ToDouble(Single, RoundTrip);
+    TestTrue(TEXT("Widening a float is exact"), FVector3f(RoundTrip[17]) == Single[17] && RoundTrip.Num() == Double.Num());
+
+    TArray<TArray<int32>> Neighbors;
+    BuildNearestNeighbors(Double, 6, Neighbors);
+    TArray<FVector> Seeds;
+    FTectonicSeeding::GeneratePlateSeeds(12, Seeds);
+    TArray<int32> PlateIds;
+    FPTPPlateMembership Membership;
+    FTectonicSeeding::AssignPointsToSeeds(Double, Seeds, PlateIds, Membership);
+    TArray<FTectonicPlate> Plates;
+    FCrustInitialization::InitializePlateDynamics(12, 6370.0f, 100.0f, 7, Plates);
+
+    TArray<EPTPBoundaryType> DoubleTypes, SingleTypes;
+    FCrustInitialization::ClassifyPlateBoundaries(Double, PlateIds, Plates, Neighbors, DoubleTypes);
+    FCrustInitialization::ClassifyPlateBoundaries(Single, PlateIds, Plates, Neighbors, SingleTypes);
+    int32 NumBoundary = 0, NumDiffer = 0;
+    for (int32 i = 0; i < DoubleTypes.Num(); ++i)
+    {
+        NumBoundary += DoubleTypes[i] != EPTPBoundaryType::None ? 1 : 0;
+        NumDiffer += DoubleTypes[i] != SingleTypes[i] ? 1 : 0;
+    }
+    // Only a projection sitting on the +-0.5 threshold may flip
+    TestTrue(TEXT("Has boundaries"), NumBoundary > 0);
+    TestTrue(TEXT("Boundary types match on 99% of boundary points"), NumDiffer * 100 <= NumBoundary);
+
+    TArray<float> DoubleDistance, SingleDistance;
+    FCrustInitialization::ComputeDistanceToFront(Double, Neighbors, DoubleTypes, DoubleDistance);
+    FCrustInitialization::ComputeDistanceToFront(Single, Neighbors, DoubleTypes, SingleDistance);
+    int32 NumFar = 0;
+    for (int32 i = 0; i < DoubleDistance.Num(); ++i)
+    {
+        const float A = DoubleDistance[i];
+        const float B = SingleDistance[i];
+        const bool bClose = A == B || FMath::Abs(A - B) <= 1e-4f * FMath::Max(A, 1.0f);
+        NumFar += bClose ? 0 : 1;
+    }
+    TestEqual(TEXT("Distance to front within relative 1e-4"), NumFar, 0);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
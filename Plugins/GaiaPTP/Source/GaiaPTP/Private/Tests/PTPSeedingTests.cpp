@@ -3,6 +3,7 @@
 #include "Misc/AutomationTest.h"
 #include "FibonacciSphere.h"
 #include "TectonicSeeding.h"
+#include "PTPPlateMembership.h"
 
 static void MakeSmallSphere(int32 N, float R, TArray<FVector>& Out)
 {
@@ -42,4 +43,51 @@ bool FPTPSeedingBasicTest::RunTest(const FString& Parameters)
     return true;
 }
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPPlateMembershipTest, "GaiaPTP.Seeding.Membership",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPPlateMembershipTest::RunTest(const FString& Parameters)
+{
+    const int32 N = 1000;
+    const int32 M = 10;
+    TArray<FVector> Points; MakeSmallSphere(N, 1.0f, Points);
+    TArray<FVector> Seeds; FTectonicSeeding::GeneratePlateSeeds(M, Seeds);
+
+    // Both overloads agree: each plate's range holds exactly its old per-plate list
+    TArray<int32> PointToPlate; TArray<TArray<int32>> PlateToPoints;
+    FTectonicSeeding::AssignPointsToSeeds(Points, Seeds, PointToPlate, PlateToPoints);
+    TArray<int32> PointPlateIds; FPTPPlateMembership Membership;
+    FTectonicSeeding::AssignPointsToSeeds(Points, Seeds, PointPlateIds, Membership);
+
+    TestTrue(TEXT("Same plate ids"), PointPlateIds == PointToPlate);
+    TestEqual(TEXT("Plate count"), Membership.GetNumPlates(), M);
+    TestEqual(TEXT("Every point a member"), Membership.GetNumPoints(), N);
+    bool bSameLists = true;
+    for (int32 p = 0; p < M; ++p)
+    {
+        bSameLists &= TArray<int32>(Membership.GetPlatePoints(p)) == PlateToPoints[p];
+    }
+    TestTrue(TEXT("Ranges match per-plate lists"), bSameLists);
+    TestTrue(TEXT("Consistent after build"), Membership.IsConsistent(PointPlateIds));
+
+    // Rift the first half of plate 3 onto plate 7, and move one point from plate 0 to plate 1
+    const TArray<int32> Plate3(Membership.GetPlatePoints(3));
+    TArray<FPTPPlateTransfer> Moves;
+    for (int32 k = 0; k < Plate3.Num() / 2; ++k)
+    {
+        Moves.Add({ Plate3[k], 7 });
+    }
+    Moves.Add({ Membership.GetPlatePoints(0)[0], 1 });
+    const int32 Count0 = Membership.GetPlateCount(0);
+    const int32 Count9 = Membership.GetPlateCount(9);
+    Membership.ApplyTransfers(Moves, PointPlateIds);
+
+    TestTrue(TEXT("Consistent after transfers"), Membership.IsConsistent(PointPlateIds));
+    TestEqual(TEXT("Rifted points moved"), PointPlateIds[Plate3[0]], 7);
+    TestEqual(TEXT("Plate 3 shrank"), Membership.GetPlateCount(3), Plate3.Num() - Plate3.Num() / 2);
+    TestEqual(TEXT("Plate 0 shrank"), Membership.GetPlateCount(0), Count0 - 1);
+    TestEqual(TEXT("Untouched plate keeps its range"), Membership.GetPlateCount(9), Count9);
+    TestEqual(TEXT("Slot map follows"), Membership.GetPlatePoints(7)[Membership.GetSlot(Plate3[0]) - Membership.GetPlateOffset(7)], Plate3[0]);
+    return true;
+}
+
 #endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,140 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "FibonacciSphere.h"
+#include "PTPPlanetRebuild.h"
+#include "PTPSpatialOrder.h"
+
+namespace
+{
+    // Brute-force K nearest neighbours; small N only
+    template <typename VectorType>
+    void BuildNearestNeighbors(const TArray<VectorType>& Points, int32 K, TArray<TArray<int32>>& OutNeighbors)
+    {
+        OutNeighbors.SetNum(Points.Num());
+        for (int32 i = 0; i < Points.Num(); ++i)
+        {
+            TArray<TPair<double, int32>> Dist;
+            Dist.Reserve(Points.Num());
+            for (int32 j = 0; j < Points.Num(); ++j)
+            {
+                if (j != i)
+                {
+                    Dist.Emplace(FVector::DistSquared(FVector(Points[i]), FVector(Points[j])), j);
+                }
+            }
+            Dist.Sort([](const TPair<double, int32>& A, const TPair<double, int32>& B) { return A.Key < B.Key; });
+            OutNeighbors[i].Reset();
+            for (int32 k = 0; k < K; ++k)
+            {
+                OutNeighbors[i].Add(Dist[k].Value);
+            }
+        }
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPSpatialOrderLocalityTest, "GaiaPTP.SpatialOrder.Locality",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPSpatialOrderLocalityTest::RunTest(const FString& Parameters)
+{
+    TArray<FVector> Points;
+    FFibonacciSphere::GeneratePoints(2000, 6370.0f, Points);
+
+    TArray<int32> NewToOld;
+    FPTPSpatialOrder::ComputeHilbertOrder(Points, NewToOld);
+    TArray<int32> Sorted = NewToOld;
+    Sorted.Sort();
+    bool bPermutation = Sorted.Num() == Points.Num();
+    for (int32 i = 0; bPermutation && i < Sorted.Num(); ++i)
+    {
+        bPermutation = Sorted[i] == i;
+    }
+    TestTrue(TEXT("Order is a permutation"), bPermutation);
+
+    bool bKeysSorted = true;
+    for (int32 i = 1; i < NewToOld.Num(); ++i)
+    {
+        bKeysSorted &= FPTPSpatialOrder::HilbertKey(FVector3f(Points[NewToOld[i - 1]])) <= FPTPSpatialOrder::HilbertKey(FVector3f(Points[NewToOld[i]]));
+    }
+    TestTrue(TEXT("Keys ascend"), bKeysSorted);
+
+    // Latitude order keeps most neighbours a ring (~sqrt(N)) away; the Hilbert order keeps them close
+    TArray<TArray<int32>> Neighbors;
+    BuildNearestNeighbors(Points, 6, Neighbors);
+    const float Before = FPTPSpatialOrder::ComputeNeighborLocality(Neighbors, 32);
+
+    FPTPSpatialOrder::Permute(Points, NewToOld);
+    BuildNearestNeighbors(Points, 6, Neighbors);
+    const float After = FPTPSpatialOrder::ComputeNeighborLocality(Neighbors, 32);
+
+    AddInfo(FString::Printf(TEXT("Neighbours within 32 indices: %.2f -> %.2f"), Before, After));
+    TestTrue(TEXT("Most neighbours close in memory"), After > 0.6f);
+    TestTrue(TEXT("Locality at least doubles"), After > 2.0f * Before);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPSpatialOrderRemapTest, "GaiaPTP.SpatialOrder.Remap",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPSpatialOrderRemapTest::RunTest(const FString& Parameters)
+{
+    FPTPPlanetState State;
+    FFibonacciSphere::GeneratePoints(500, 6370.0f, State.SamplePoints);
+    const int32 N = State.SamplePoints.Num();
+    BuildNearestNeighbors(State.SamplePoints, 6, State.Neighbors);
+    for (int32 i = 0; i < N; ++i)
+    {
+        State.PointPlateIds.Add(State.SamplePoints[i].X >= 0.0f ? 0 : 1);
+        State.DistanceToFrontKm.Add(float(i));
+        State.Triangles.Add(FIntVector(i, State.Neighbors[i][0], State.Neighbors[i][1]));
+    }
+    State.Membership.Build(State.PointPlateIds, 2);
+    const FPTPPlanetState Original = State;
+
+    TArray<int32> NewToOld;
+    FPTPSpatialOrder::ComputeHilbertOrder(State.SamplePoints, NewToOld);
+    FPTPSpatialOrder::Reorder(State, NewToOld);
+
+    TestTrue(TEXT("Sample order recorded"), State.SampleOrder == NewToOld);
+    bool bPerPoint = true;
+    bool bLinks = true;
+    for (int32 i = 0; i < N; ++i)
+    {
+        const int32 Id = State.SampleOrder[i];
+        bPerPoint &= State.SamplePoints[i] == Original.SamplePoints[Id];
+        bPerPoint &= State.PointPlateIds[i] == Original.PointPlateIds[Id];
+        bPerPoint &= State.DistanceToFrontKm[i] == float(Id);
+        for (int32 k = 0; k < State.Neighbors[i].Num(); ++k)
+        {
+            bLinks &= State.SampleOrder[State.Neighbors[i][k]] == Original.Neighbors[Id][k];
+        }
+    }
+    TestTrue(TEXT("Per-point arrays follow their samples"), bPerPoint);
+    TestTrue(TEXT("Neighbours point at the same samples"), bLinks);
+
+    bool bTriangles = true;
+    for (int32 t = 0; t < N; ++t)
+    {
+        const FIntVector& Tri = State.Triangles[t];
+        const FIntVector& Old = Original.Triangles[t];
+        bTriangles &= State.SamplePoints[Tri.X] == Original.SamplePoints[Old.X]
+            && State.SamplePoints[Tri.Y] == Original.SamplePoints[Old.Y]
+            && State.SamplePoints[Tri.Z] == Original.SamplePoints[Old.Z];
+    }
+    TestTrue(TEXT("Triangles keep their corners"), bTriangles);
+
+    TestTrue(TEXT("Plate membership remapped"), State.Membership.IsConsistent(State.PointPlateIds));
+    TestEqual(TEXT("Plate size"), State.Membership.GetPlateCount(0), Original.Membership.GetPlateCount(0));
+
+    // A second reorder composes: ids still name the original lattice point
+    TArray<int32> Reverse;
+    for (int32 i = N - 1; i >= 0; --i)
+    {
+        Reverse.Add(i);
+    }
+    FPTPSpatialOrder::Reorder(State, Reverse);
+    TestTrue(TEXT("Composed ids stay stable"), State.SamplePoints[0] == Original.SamplePoints[State.SampleOrder[0]]
+        && State.SampleOrder[0] == NewToOld.Last());
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
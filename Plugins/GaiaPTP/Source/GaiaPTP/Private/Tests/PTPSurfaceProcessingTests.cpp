@@ -0,0 +1,82 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "SurfaceProcessing.h"
+
+static void MakeRandomSurface(int32 N, int32 Seed, FPTPCrustSurfaceSoA& Out)
+{
+    FRandomStream Rand(Seed);
+    Out.CrustType.SetNum(N);
+    Out.Elevation.SetNum(N);
+    Out.OceanicAge.SetNum(N);
+    Out.OrogenyAge.SetNum(N);
+    Out.TrenchMask.SetNum(N);
+    for (int32 i = 0; i < N; ++i)
+    {
+        const bool bContinental = Rand.FRand() < 0.3f;
+        Out.CrustType[i] = static_cast<uint8>(bContinental ? ECrustType::Continental : ECrustType::Oceanic);
+        Out.Elevation[i] = bContinental ? Rand.FRandRange(-0.5f, 10.0f) : Rand.FRandRange(-11.0f, -1.0f);
+        Out.OceanicAge[i] = bContinental ? 0.0f : Rand.FRandRange(0.0f, 200.0f);
+        Out.OrogenyAge[i] = bContinental ? Rand.FRandRange(500.0f, 3000.0f) : 0.0f;
+        Out.TrenchMask[i] = (!bContinental && Rand.FRand() < 0.05f) ? 1 : 0;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPSurfaceSimdMatchesScalarTest, "GaiaPTP.Surface.SimdMatchesScalar",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPSurfaceSimdMatchesScalarTest::RunTest(const FString& Parameters)
+{
+    // Odd count spanning several chunks so the vector tail path is exercised
+    const int32 N = 40003;
+    FPTPSurfaceProcessParams Params;
+
+    FPTPCrustSurfaceSoA Simd; MakeRandomSurface(N, 77, Simd);
+    FPTPCrustSurfaceSoA Scalar; MakeRandomSurface(N, 77, Scalar);
+
+    FSurfaceProcessing::Apply(Params, Simd);
+    FSurfaceProcessing::ApplyScalar(Params, Scalar, 0, N);
+
+    float MaxErr = 0.0f;
+    for (int32 i = 0; i < N; ++i)
+    {
+        MaxErr = FMath::Max(MaxErr, FMath::Abs(Simd.Elevation[i] - Scalar.Elevation[i]));
+        MaxErr = FMath::Max(MaxErr, FMath::Abs(Simd.OceanicAge[i] - Scalar.OceanicAge[i]));
+        MaxErr = FMath::Max(MaxErr, FMath::Abs(Simd.OrogenyAge[i] - Scalar.OrogenyAge[i]));
+    }
+    TestTrue(TEXT("SIMD pass matches scalar reference"), MaxErr < 1e-5f);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPSurfaceRulesTest, "GaiaPTP.Surface.Rules",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPSurfaceRulesTest::RunTest(const FString& Parameters)
+{
+    FPTPSurfaceProcessParams Params;
+    const float Dt = Params.TimeStepMy;
+
+    // Samples: continental peak, continental below sea level, young ocean, ocean at trench depth, trench sample
+    FPTPCrustSurfaceSoA F;
+    F.CrustType = { (uint8)ECrustType::Continental, (uint8)ECrustType::Continental, (uint8)ECrustType::Oceanic, (uint8)ECrustType::Oceanic, (uint8)ECrustType::Oceanic };
+    F.Elevation = { 10.0f, -0.2f, -1.0f, -10.0f, -8.0f };
+    F.OceanicAge = { 0.0f, 0.0f, 10.0f, 150.0f, 100.0f };
+    F.OrogenyAge = { 100.0f, 900.0f, 0.0f, 0.0f, 0.0f };
+    F.TrenchMask = { 0, 0, 0, 0, 1 };
+
+    FSurfaceProcessing::Apply(Params, F);
+
+    TestTrue(TEXT("Peak erodes by εc·δt"), FMath::IsNearlyEqual(F.Elevation[0], 10.0f - Params.ContinentalErosion * Dt, 1e-5f));
+    TestTrue(TEXT("Submerged continent untouched"), FMath::IsNearlyEqual(F.Elevation[1], -0.2f));
+    TestTrue(TEXT("Young ocean subsides by 0.9·εo·δt"), FMath::IsNearlyEqual(F.Elevation[2], -1.0f - 0.9f * Params.OceanicElevationDampening * Dt, 1e-5f));
+    TestTrue(TEXT("Trench depth is stable"), FMath::IsNearlyEqual(F.Elevation[3], -10.0f));
+
+    const float ExpectedTrench = -8.0f - 0.2f * Params.OceanicElevationDampening * Dt + Params.SedimentAccretion * Dt;
+    TestTrue(TEXT("Trench sample accretes sediment"), FMath::IsNearlyEqual(F.Elevation[4], ExpectedTrench, 1e-5f));
+
+    TestTrue(TEXT("Orogeny ages on continents"), FMath::IsNearlyEqual(F.OrogenyAge[0], 100.0f + Dt));
+    TestTrue(TEXT("Oceanic age unchanged on continents"), FMath::IsNearlyEqual(F.OceanicAge[0], 0.0f));
+    TestTrue(TEXT("Oceanic crust ages"), FMath::IsNearlyEqual(F.OceanicAge[2], 10.0f + Dt));
+    TestTrue(TEXT("Orogeny age unchanged on oceans"), FMath::IsNearlyEqual(F.OrogenyAge[2], 0.0f));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
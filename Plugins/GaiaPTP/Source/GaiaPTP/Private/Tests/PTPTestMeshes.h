@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Small closed meshes shared by the automation tests. */
+namespace PTPTestMeshes
+{
+    /** Subdivided icosahedron; triangles wound inward when bInward is set. */
+    inline void MakeIcosphere(int32 Subdivisions, bool bInward, TArray<FVector3f>& OutPoints, TArray<FIntVector>& OutTriangles)
+    {
+        const float G = (1.0f + FMath::Sqrt(5.0f)) * 0.5f;
+        OutPoints = {
+            FVector3f(-1, G, 0), FVector3f(1, G, 0), FVector3f(-1, -G, 0), FVector3f(1, -G, 0),
+            FVector3f(0, -1, G), FVector3f(0, 1, G), FVector3f(0, -1, -G), FVector3f(0, 1, -G),
+            FVector3f(G, 0, -1), FVector3f(G, 0, 1), FVector3f(-G, 0, -1), FVector3f(-G, 0, 1)
+        };
+        for (FVector3f& P : OutPoints)
+        {
+            P.Normalize();
+        }
+        OutTriangles = {
+            FIntVector(0, 11, 5), FIntVector(0, 5, 1), FIntVector(0, 1, 7), FIntVector(0, 7, 10), FIntVector(0, 10, 11),
+            FIntVector(1, 5, 9), FIntVector(5, 11, 4), FIntVector(11, 10, 2), FIntVector(10, 7, 6), FIntVector(7, 1, 8),
+            FIntVector(3, 9, 4), FIntVector(3, 4, 2), FIntVector(3, 2, 6), FIntVector(3, 6, 8), FIntVector(3, 8, 9),
+            FIntVector(4, 9, 5), FIntVector(2, 4, 11), FIntVector(6, 2, 10), FIntVector(8, 6, 7), FIntVector(9, 8, 1)
+        };
+
+        for (int32 s = 0; s < Subdivisions; ++s)
+        {
+            TMap<uint64, int32> Midpoints;
+            auto Midpoint = [&](int32 A, int32 B)
+            {
+                const uint64 Key = (static_cast<uint64>(FMath::Min(A, B)) << 32) | static_cast<uint64>(FMath::Max(A, B));
+                if (const int32* Found = Midpoints.Find(Key))
+                {
+                    return *Found;
+                }
+                const int32 Idx = OutPoints.Add((OutPoints[A] + OutPoints[B]).GetSafeNormal());
+                Midpoints.Add(Key, Idx);
+                return Idx;
+            };
+
+            TArray<FIntVector> Next;
+            Next.Reserve(OutTriangles.Num() * 4);
+            for (const FIntVector& T : OutTriangles)
+            {
+                const int32 AB = Midpoint(T.X, T.Y);
+                const int32 BC = Midpoint(T.Y, T.Z);
+                const int32 CA = Midpoint(T.Z, T.X);
+                Next.Add(FIntVector(T.X, AB, CA));
+                Next.Add(FIntVector(T.Y, BC, AB));
+                Next.Add(FIntVector(T.Z, CA, BC));
+                Next.Add(FIntVector(AB, BC, CA));
+            }
+            OutTriangles = MoveTemp(Next);
+        }
+
+        if (bInward)
+        {
+            for (FIntVector& T : OutTriangles)
+            {
+                Swap(T.Y, T.Z);
+            }
+        }
+    }
+}
@@ -0,0 +1,316 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "CrustInitialization.h"
+#include "PTPOverlayBuilder.h"
+#include "PTPPlanetMeshBuilder.h"
+#include "PTPVisualizationLayers.h"
+#include "TectonicData.h"
+#include "Tests/PTPTestMeshes.h"
+#include "Core/RealtimeMeshDataStream.h"
+#include "Core/RealtimeMeshDataTypes.h"
+
+using namespace RealtimeMesh;
+
+namespace
+{
+    /** Icosphere of radius 1000 km split into plate 0 (X < 0) and plate 1 (X >= 0), with adjacency. */
+    void MakeTwoPlatePlanet(TArray<FVector3f>& OutPoints, TArray<FIntVector>& OutTriangles, TArray<int32>& OutPlateIds,
+                            TArray<TArray<int32>>& OutNeighbors, TArray<FTectonicPlate>& OutPlates)
+    {
+        PTPTestMeshes::MakeIcosphere(4, false, OutPoints, OutTriangles);
+        OutPlateIds.SetNum(OutPoints.Num());
+        for (int32 i = 0; i < OutPoints.Num(); ++i)
+        {
+            OutPoints[i] *= 1000.0f;
+            OutPlateIds[i] = OutPoints[i].X < 0.0 ? 0 : 1;
+        }
+
+        OutNeighbors.SetNum(OutPoints.Num());
+        for (const FIntVector& Tri : OutTriangles)
+        {
+            for (int32 k = 0; k < 3; ++k)
+            {
+                OutNeighbors[Tri[k]].AddUnique(Tri[(k + 1) % 3]);
+                OutNeighbors[Tri[(k + 1) % 3]].AddUnique(Tri[k]);
+            }
+        }
+
+        OutPlates.SetNum(2);
+        OutPlates[0].PlateId = 0;
+        OutPlates[1].PlateId = 1;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPBoundaryClassificationTest, "GaiaPTP.VizLayers.BoundaryTypes",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPBoundaryClassificationTest::RunTest(const FString& Parameters)
+{
+    TArray<FVector3f> Points;
+    TArray<FIntVector> Triangles;
+    TArray<int32> PlateIds;
+    TArray<TArray<int32>> Neighbors;
+    TArray<FTectonicPlate> Plates;
+    MakeTwoPlatePlanet(Points, Triangles, PlateIds, Neighbors, Plates);
+
+    // Opposite spins about +Y: on the X = 0 boundary the relative velocity is along X, scaled by Z,
+    // so plates converge where Z > 0 and pull apart where Z < 0
+    Plates[0].RotationAxis = FVector::YAxisVector;
+    Plates[0].AngularVelocity = 0.05f;
+    Plates[1].RotationAxis = FVector::YAxisVector;
+    Plates[1].AngularVelocity = -0.05f;
+
+    TArray<EPTPBoundaryType> Types;
+    FCrustInitialization::ClassifyPlateBoundaries(Points, PlateIds, Plates, Neighbors, Types);
+
+    int32 NumNorth = 0, NumNorthConvergent = 0, NumSouth = 0, NumSouthDivergent = 0, NumInteriorTagged = 0;
+    for (int32 i = 0; i < Points.Num(); ++i)
+    {
+        const bool bBoundary = Neighbors[i].ContainsByPredicate([&](int32 n) { return PlateIds[n] != PlateIds[i]; });
+        if (!bBoundary)
+        {
+            NumInteriorTagged += Types[i] != EPTPBoundaryType::None ? 1 : 0;
+        }
+        else if (Points[i].Z > 300.0)
+        {
+            ++NumNorth;
+            NumNorthConvergent += Types[i] == EPTPBoundaryType::Convergent ? 1 : 0;
+        }
+        else if (Points[i].Z < -300.0)
+        {
+            ++NumSouth;
+            NumSouthDivergent += Types[i] == EPTPBoundaryType::Divergent ? 1 : 0;
+        }
+    }
+    TestTrue(TEXT("Boundary has points on both sides"), NumNorth > 0 && NumSouth > 0);
+    TestEqual(TEXT("Approaching plates are convergent"), NumNorthConvergent, NumNorth);
+    TestEqual(TEXT("Separating plates are divergent"), NumSouthDivergent, NumSouth);
+    TestEqual(TEXT("Interior points are not boundaries"), NumInteriorTagged, 0);
+
+    // Opposite spins about +X move both sides along the boundary circle: transform
+    Plates[0].RotationAxis = FVector::XAxisVector;
+    Plates[1].RotationAxis = FVector::XAxisVector;
+    FCrustInitialization::ClassifyPlateBoundaries(Points, PlateIds, Plates, Neighbors, Types);
+    int32 NumBoundary = 0, NumTransform = 0;
+    for (int32 i = 0; i < Points.Num(); ++i)
+    {
+        if (Types[i] != EPTPBoundaryType::None)
+        {
+            ++NumBoundary;
+            NumTransform += Types[i] == EPTPBoundaryType::Transform ? 1 : 0;
+        }
+    }
+    TestTrue(TEXT("Boundary points found"), NumBoundary > 0);
+    TestEqual(TEXT("Sliding plates are transform"), NumTransform, NumBoundary);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPDistanceToFrontTest, "GaiaPTP.VizLayers.DistanceToFront",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPDistanceToFrontTest::RunTest(const FString& Parameters)
+{
+    TArray<FVector3f> Points;
+    TArray<FIntVector> Triangles;
+    TArray<int32> PlateIds;
+    TArray<TArray<int32>> Neighbors;
+    TArray<FTectonicPlate> Plates;
+    MakeTwoPlatePlanet(Points, Triangles, PlateIds, Neighbors, Plates);
+
+    TArray<EPTPBoundaryType> Types;
+    Types.Init(EPTPBoundaryType::None, Points.Num());
+    int32 NumFront = 0;
+    for (int32 i = 0; i < Points.Num(); ++i)
+    {
+        if (FMath::Abs(Points[i].X) < 1.0)
+        {
+            Types[i] = EPTPBoundaryType::Convergent;
+            ++NumFront;
+        }
+    }
+    TestTrue(TEXT("Icosphere has vertices on the X = 0 great circle"), NumFront > 0);
+
+    TArray<float> Distance;
+    FCrustInitialization::ComputeDistanceToFront(Points, Neighbors, Types, Distance);
+
+    // Shortest paths: 0 on the front, otherwise the best neighbor plus the edge length
+    int32 NumViolations = 0;
+    for (int32 i = 0; i < Points.Num(); ++i)
+    {
+        float Best = Types[i] == EPTPBoundaryType::Convergent ? 0.0f : TNumericLimits<float>::Max();
+        for (int32 n : Neighbors[i])
+        {
+            Best = FMath::Min(Best, Distance[n] + FVector3f::Dist(Points[i], Points[n]));
+        }
+        NumViolations += FMath::IsNearlyEqual(Distance[i], Best, 1e-2f) ? 0 : 1;
+    }
+    TestEqual(TEXT("Distances satisfy the shortest-path condition"), NumViolations, 0);
+
+    // Along edges the path is at least the great-circle distance and not much longer
+    const int32 Pole = Points.IndexOfByPredicate([](const FVector3f& P) { return P.X > 999.0f; });
+    if (TestTrue(TEXT("Icosphere has a vertex on +X"), Pole != INDEX_NONE))
+    {
+        const float Arc = 1000.0f * HALF_PI;
+        TestTrue(TEXT("Pole distance close to the quarter arc"), Distance[Pole] >= Arc * 0.99f && Distance[Pole] <= Arc * 1.25f);
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPVisualizationLayersEncodingTest, "GaiaPTP.VizLayers.Encoding",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPVisualizationLayersEncodingTest::RunTest(const FString& Parameters)
+{
+    EPTPVisualizationLayer Layer = EPTPVisualizationLayer::PlateId;
+    TestTrue(TEXT("Find by name"), FPTPVisualizationLayers::FindLayer(TEXT("oceanicage"), Layer) && Layer == EPTPVisualizationLayer::OceanicAge);
+    TestTrue(TEXT("Find by index"), FPTPVisualizationLayers::FindLayer(TEXT("5"), Layer) && Layer == EPTPVisualizationLayer::BoundaryType);
+    TestFalse(TEXT("Unknown names rejected"), FPTPVisualizationLayers::FindLayer(TEXT("Temperature"), Layer));
+    TestFalse(TEXT("Plate id is a colour layer"), FPTPVisualizationLayers::IsScalar(EPTPVisualizationLayer::PlateId));
+    TestTrue(TEXT("Elevation is a scalar layer"), FPTPVisualizationLayers::IsScalar(EPTPVisualizationLayer::Elevation));
+
+    TArray<FVector3f> Points;
+    TArray<FIntVector> Triangles;
+    TArray<int32> PlateIds;
+    TArray<TArray<int32>> Neighbors;
+    TArray<FTectonicPlate> Plates;
+    MakeTwoPlatePlanet(Points, Triangles, PlateIds, Neighbors, Plates);
+
+    TArray<FCrustData> Crust;
+    Crust.SetNum(Points.Num());
+    for (int32 i = 0; i < Points.Num(); ++i)
+    {
+        Crust[i].Elevation = (float)(Points[i].Z / 100.0);   // -10..10 km
+        Crust[i].OceanicAge = 300.0f;                         // beyond the layer range
+        Crust[i].Type = PlateIds[i] == 0 ? ECrustType::Oceanic : ECrustType::Continental;
+    }
+
+    FPTPLayerSource Source;
+    Source.Points = Points;
+    Source.PlateIds = PlateIds;
+    Source.Crust = Crust;
+    Source.Plates = Plates;
+    Source.ElevationRangeKm = FVector2f(-10.0f, 10.0f);
+
+    FRealtimeMeshStreamSet Streams;
+    const FPTPPlanetMeshLayout Layout = FPTPPlanetMeshBuilder::BuildSurface(Points, Triangles, 1.0f, Streams);
+    FRealtimeMeshStream& TexCoordStream = Streams.FindChecked(FRealtimeMeshStreams::TexCoords);
+    FPTPPlanetMeshBuilder::FillElevations(Layout, Crust, TexCoordStream);
+    FPTPVisualizationLayers::FillScalars(EPTPVisualizationLayer::Elevation, Layout, Source, TexCoordStream);
+
+    TArrayView<FRealtimeMeshTexCoordsNormal> TexCoords = TexCoordStream.GetArrayView<FRealtimeMeshTexCoordsNormal>();
+    int32 NumBadU = 0, NumBadV = 0;
+    for (int32 v = 0; v < Layout.NumVertices; ++v)
+    {
+        const FVector2f UV(TexCoords[v][0]);
+        const int32 i = Layout.VertexToSample(v);
+        NumBadU += FMath::IsNearlyEqual(UV.X, Crust[i].Elevation, 1e-2f) ? 0 : 1;
+        NumBadV += FMath::IsNearlyEqual(UV.Y, (Crust[i].Elevation + 10.0f) / 20.0f, 1e-3f) ? 0 : 1;
+    }
+    TestEqual(TEXT("Scalar layer leaves elevation in U"), NumBadU, 0);
+    TestEqual(TEXT("Scalar layer normalized into V"), NumBadV, 0);
+
+    // Values outside the range saturate; elevation in U is untouched by a layer switch
+    FPTPVisualizationLayers::FillScalars(EPTPVisualizationLayer::OceanicAge, Layout, Source, TexCoordStream);
+    TestTrue(TEXT("Out of range values clamp to 1"), FMath::IsNearlyEqual(FVector2f(TexCoords[0][0]).Y, 1.0f));
+    TestTrue(TEXT("Switching layers keeps U"), FMath::IsNearlyEqual(FVector2f(TexCoords[0][0]).X, Crust[0].Elevation, 1e-2f));
+
+    FRealtimeMeshStream& ColorStream = Streams.FindChecked(FRealtimeMeshStreams::Color);
+    FPTPVisualizationLayers::FillColors(EPTPVisualizationLayer::CrustType, Layout, Source, ColorStream);
+    TConstArrayView<const FColor> Colors = ColorStream.GetArrayView<FColor>();
+    const int32 Oceanic = PlateIds.IndexOfByKey(0);
+    const int32 Continental = PlateIds.IndexOfByKey(1);
+    TestTrue(TEXT("Crust types get distinct colours"), Colors[Oceanic] != Colors[Continental]);
+    TestTrue(TEXT("Colour matches the sampled colour"),
+        Colors[Oceanic] == FPTPVisualizationLayers::SampleColor(EPTPVisualizationLayer::CrustType, Source, Oceanic));
+
+    // Point preview instances carry the same colour plus the normalized scalar
+    FPTPPlanetMeshLayout Instances;
+    Instances.NumVertices = 2;
+    Instances.SampleStride = 7;
+    TArray<float> CustomData;
+    CustomData.SetNumZeroed(Instances.NumVertices * FPTPVisualizationLayers::NumInstanceCustomData);
+    FPTPVisualizationLayers::FillInstanceCustomData(EPTPVisualizationLayer::Elevation, Instances, Source, CustomData);
+    const int32 Second = Instances.VertexToSample(1);
+    const float Expected = (Crust[Second].Elevation + 10.0f) / 20.0f;
+    TestTrue(TEXT("Instance scalar normalized"), FMath::IsNearlyEqual(CustomData[FPTPVisualizationLayers::NumInstanceCustomData + 3], Expected, 1e-5f));
+    TestTrue(TEXT("Instance colour from the ramp"), FMath::IsNearlyEqual(CustomData[FPTPVisualizationLayers::NumInstanceCustomData],
+        FPTPVisualizationLayers::RampColor(Expected).R / 255.0f, 1e-5f));
+
+    TestTrue(TEXT("Ramp endpoints"), FPTPVisualizationLayers::RampColor(-1.0f) == FPTPVisualizationLayers::RampColor(0.0f)
+        && FPTPVisualizationLayers::RampColor(2.0f) == FPTPVisualizationLayers::RampColor(1.0f)
+        && FPTPVisualizationLayers::RampColor(0.0f) != FPTPVisualizationLayers::RampColor(1.0f));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPTPOverlayGeometryTest, "GaiaPTP.VizLayers.Overlay",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPTPOverlayGeometryTest::RunTest(const FString& Parameters)
+{
+    TArray<FVector3f> Points;
+    TArray<FIntVector> Triangles;
+    TArray<int32> PlateIds;
+    TArray<TArray<int32>> Neighbors;
+    TArray<FTectonicPlate> Plates;
+    MakeTwoPlatePlanet(Points, Triangles, PlateIds, Neighbors, Plates);
+    Plates[0].RotationAxis = FVector::YAxisVector;
+    Plates[0].AngularVelocity = 0.05f;
+    Plates[1].RotationAxis = FVector::YAxisVector;
+    Plates[1].AngularVelocity = -0.05f;
+
+    TArray<EPTPBoundaryType> Types;
+    FCrustInitialization::ClassifyPlateBoundaries(Points, PlateIds, Plates, Neighbors, Types);
+
+    FPTPLayerSource Source;
+    Source.Points = Points;
+    Source.PlateIds = PlateIds;
+    Source.Plates = Plates;
+    Source.BoundaryTypes = Types;
+
+    // Stride: power of two, coarser from further away, 1 when the target exceeds the visible samples
+    const int32 NearStride = FPTPOverlayBuilder::ChooseArrowStride(100000, 1500.0, 1000.0, 1000);
+    const int32 FarStride = FPTPOverlayBuilder::ChooseArrowStride(100000, 10000.0, 1000.0, 1000);
+    TestTrue(TEXT("Stride grows with distance"), FarStride > NearStride);
+    TestTrue(TEXT("Stride is a power of two"), FMath::IsPowerOfTwo(NearStride) && FMath::IsPowerOfTwo(FarStride));
+    TestEqual(TEXT("Dense target keeps every sample"), FPTPOverlayBuilder::ChooseArrowStride(1000, 1500.0, 1000.0, 4000), 1);
+
+    TArray<FPTPOverlayArrow> Arrows;
+    FPTPOverlayBuilder::GatherVelocityArrows(Source, 4, FVector3f::ZeroVector, -1.0f, Arrows);
+    TestEqual(TEXT("One arrow per stride"), Arrows.Num(), (Points.Num() + 3) / 4);
+    TArray<FPTPOverlayArrow> CapArrows;
+    FPTPOverlayBuilder::GatherVelocityArrows(Source, 1, FVector3f::ZAxisVector, 0.5f, CapArrows);
+    TestTrue(TEXT("Cap arrows only"), CapArrows.Num() > 0 && CapArrows.Num() < Points.Num() / 2
+        && !CapArrows.ContainsByPredicate([](const FPTPOverlayArrow& A) { return A.Origin.GetSafeNormal().Z < 0.49f; }));
+
+    TArray<FPTPOverlaySegment> Segments;
+    FPTPOverlayBuilder::GatherBoundarySegments(Source, Neighbors, Segments);
+    TestTrue(TEXT("Boundary segments found"), Segments.Num() > 0);
+    bool bSamePlate = true;
+    for (const FPTPOverlaySegment& Segment : Segments)
+    {
+        bSamePlate &= (Segment.A.X < 0.0f) == (Segment.B.X < 0.0f);
+    }
+    TestTrue(TEXT("Segments stay on one plate"), bSamePlate);
+
+    FRealtimeMeshStreamSet ArrowStreams, SegmentStreams;
+    FPTPOverlayBuilder::BuildArrows(Arrows, FPTPOverlayStyle(), 1.0f, ArrowStreams);
+    FPTPOverlayBuilder::BuildSegments(Segments, FPTPOverlayStyle(), 1.0f, SegmentStreams);
+    TestEqual(TEXT("Arrow vertices"), ArrowStreams.FindChecked(FRealtimeMeshStreams::Position).Num(), Arrows.Num() * 7);
+    TestEqual(TEXT("Arrow triangles"), ArrowStreams.FindChecked(FRealtimeMeshStreams::Triangles).Num(), Arrows.Num() * 3);
+    TestEqual(TEXT("Segment vertices"), SegmentStreams.FindChecked(FRealtimeMeshStreams::Position).Num(), Segments.Num() * 4);
+    TestEqual(TEXT("Segment triangles"), SegmentStreams.FindChecked(FRealtimeMeshStreams::Triangles).Num(), Segments.Num() * 2);
+
+    // Ribbons face outward and sit above the surface
+    TConstArrayView<const FVector3f> Positions = SegmentStreams.FindChecked(FRealtimeMeshStreams::Position).GetArrayView<FVector3f>();
+    TConstArrayView<const TIndex3<uint32>> Tris = SegmentStreams.FindChecked(FRealtimeMeshStreams::Triangles).GetArrayView<TIndex3<uint32>>();
+    bool bOutward = true, bLifted = true;
+    for (const TIndex3<uint32>& Tri : Tris)
+    {
+        const FVector3f& A = Positions[Tri.V0];
+        const FVector3f N = FVector3f::CrossProduct(Positions[Tri.V1] - A, Positions[Tri.V2] - A);
+        bOutward &= FVector3f::DotProduct(N, A) > 0.0f;
+        bLifted &= A.Size() > 1000.0f;
+    }
+    TestTrue(TEXT("Segments wind outward"), bOutward);
+    TestTrue(TEXT("Segments lifted"), bLifted);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
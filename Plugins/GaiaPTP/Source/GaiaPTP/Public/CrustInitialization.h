@@ -2,6 +2,9 @@
 
 #include "CoreMinimal.h"
 #include "TectonicData.h"
+#include "PTPPlateMembership.h"
+
+class FPTPStepScratch;
 
 /**
  * Utilities for initializing crust data and plate dynamics for a new planet.
@@ -37,6 +40,30 @@ public:
         TArray<FCrustData>& OutCrustData
     );
 
+    /**
+     * InitializeCrustData over a plate partition; per-plate work streams each plate's contiguous range.
+     *
+     * @param Membership - Which points belong to each plate (input)
+     */
+    static void InitializeCrustData(
+        const TArray<FVector>& SamplePoints,
+        const FPTPPlateMembership& Membership,
+        float ContinentalRatio,
+        float AbyssalPlainElevationKm,
+        float HighestOceanicRidgeElevationKm,
+        int32 Seed,
+        TArray<FCrustData>& OutCrustData
+    );
+    static void InitializeCrustData(
+        const TArray<FVector3f>& SamplePoints,
+        const FPTPPlateMembership& Membership,
+        float ContinentalRatio,
+        float AbyssalPlainElevationKm,
+        float HighestOceanicRidgeElevationKm,
+        int32 Seed,
+        TArray<FCrustData>& OutCrustData
+    );
+
     /**
      * Task 1.13: Initialize plate dynamics (rotation axes and angular velocities).
      *
@@ -75,7 +102,77 @@ public:
         TArray<bool>& OutIsBoundaryPoint
     );
 
+    /**
+     * Classify plate boundary points by relative plate motion.
+     *
+     * The boundary normal is the mean direction towards neighbors on other plates. The relative
+     * velocity of this point's plate against the (first) neighboring plate is projected onto it;
+     * the normalized projection s gives the type: s > 0.5 convergent, s < -0.5 divergent,
+     * otherwise transform (including plates at rest relative to each other).
+     *
+     * @param SamplePoints - Sphere sample positions in km (input)
+     * @param PointPlateIds - Which plate each point belongs to (input)
+     * @param Plates - Plates indexed by plate id, with initialized dynamics (input)
+     * @param Neighbors - Adjacency list for each point (input)
+     * @param OutBoundaryTypes - Boundary type per point, None for interior points (output)
+     * @param Scratch - Step scratch to record the kernel's transient peak on, may be null (input)
+     */
+    static void ClassifyPlateBoundaries(
+        const TArray<FVector>& SamplePoints,
+        const TArray<int32>& PointPlateIds,
+        const TArray<FTectonicPlate>& Plates,
+        const TArray<TArray<int32>>& Neighbors,
+        TArray<EPTPBoundaryType>& OutBoundaryTypes,
+        FPTPStepScratch* Scratch = nullptr
+    );
+    static void ClassifyPlateBoundaries(
+        const TArray<FVector3f>& SamplePoints,
+        const TArray<int32>& PointPlateIds,
+        const TArray<FTectonicPlate>& Plates,
+        const TArray<TArray<int32>>& Neighbors,
+        TArray<EPTPBoundaryType>& OutBoundaryTypes,
+        FPTPStepScratch* Scratch = nullptr
+    );
+
+    /**
+     * Distance from every point to the nearest convergent boundary point, measured along
+     * adjacency edges (multi-source Dijkstra). Unreachable points get TNumericLimits<float>::Max().
+     *
+     * @param SamplePoints - Sphere sample positions in km (input)
+     * @param Neighbors - Adjacency list for each point (input)
+     * @param BoundaryTypes - Output of ClassifyPlateBoundaries (input)
+     * @param OutDistanceKm - Distance per point in km (output)
+     * @param Scratch - Step scratch for the seed lists and the queue; a private one when null (input)
+     */
+    static void ComputeDistanceToFront(
+        const TArray<FVector>& SamplePoints,
+        const TArray<TArray<int32>>& Neighbors,
+        const TArray<EPTPBoundaryType>& BoundaryTypes,
+        TArray<float>& OutDistanceKm,
+        FPTPStepScratch* Scratch = nullptr
+    );
+    static void ComputeDistanceToFront(
+        const TArray<FVector3f>& SamplePoints,
+        const TArray<TArray<int32>>& Neighbors,
+        const TArray<EPTPBoundaryType>& BoundaryTypes,
+        TArray<float>& OutDistanceKm,
+        FPTPStepScratch* Scratch = nullptr
+    );
+
 private:
+    // Helper: Shared body of the InitializeCrustData overloads; GetPlatePoints returns the members of a plate
+    template <typename VectorType>
+    static void InitializeCrustDataForPlates(
+        const TArray<VectorType>& SamplePoints,
+        int32 NumPlates,
+        TFunctionRef<TConstArrayView<int32>(int32)> GetPlatePoints,
+        float ContinentalRatio,
+        float AbyssalPlainElevationKm,
+        float HighestOceanicRidgeElevationKm,
+        int32 Seed,
+        TArray<FCrustData>& OutCrustData
+    );
+
     // Helper: Classify a plate as oceanic or continental based on random selection
     static void ClassifyPlates(
         int32 NumPlates,
@@ -14,5 +14,8 @@ struct FFibonacciSphere
      * The center is at the origin.
      */
     static void GeneratePoints(int32 N, float RadiusKm, TArray<FVector>& OutPoints);
+
+    /** Single-precision storage variant used by the simulation state (see PTPPrecision.h). */
+    static void GeneratePoints(int32 N, float RadiusKm, TArray<FVector3f>& OutPoints);
 };
 
@@ -53,6 +53,10 @@ public:
     UPROPERTY(EditAnywhere, Config, Category="Sampling")
     bool bAllowDynamicResample;
 
+    /** Per-planet memory budget in MB (state plus preview mesh); exceeding it logs a warning. 0 disables the check. */
+    UPROPERTY(EditAnywhere, Config, Category="Memory", meta=(ClampMin="0"))
+    int32 MemoryBudgetMB;
+
     /** Global seed for deterministic operations (debug/testing). */
     UPROPERTY(EditAnywhere, Config, Category="Simulation")
     int32 InitialSeed;
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PTPHeightfieldBaker.h"
+
+class URealtimeMeshSimple;
+
+/** Refinement settings (Documentation/Research/RTHAP/Implementation_Guide.md, 2.3 Adaptive Subdivision). */
+struct FPTPSubdivisionSettings
+{
+    float PlanetRadiusKm = 6370.0f;
+
+    /** A triangle splits while its longest edge is more than SplitRatio times its distance to the query point. */
+    float SplitRatio = 0.25f;
+
+    /** Children merge back once the parent is MergeHysteresis times farther than where it split; above 1 so small moves never flip a split. */
+    float MergeHysteresis = 1.5f;
+
+    /** Deepest level below a base triangle; each level halves the edge length. */
+    int32 MaxLevel = 12;
+
+    /**
+     * Levels per patch. A node at a multiple of PatchLevels starts a new patch holding its subtree
+     * that many levels down, so a split or merge rebuilds at most a few 4^PatchLevels triangles.
+     */
+    int32 PatchLevels = 3;
+
+    /** Base triangles are grouped into root patches by FPTPPlanetChunks at this level (6 * 4^Level groups). */
+    int32 RootPatchLevel = 2;
+
+    /** Largest |elevation| expected from the height source, pre-VerticalScale; pads node bounds for the distance test. */
+    float MaxReliefKm = 12.0f;
+
+    /** Exaggeration applied to elevation when placing vertices. */
+    float VerticalScale = 1.0f;
+
+    /** Splits per Update; the rest of the due work carries over to the next one. */
+    int32 MaxSplitsPerUpdate = 4096;
+};
+
+/** Current mesh of one patch, ready for a section-group upload. Vertex indices are local to the patch. */
+struct FPTPSubdivisionPatch
+{
+    int32 Id = INDEX_NONE;
+    bool bCreated = false;           // the id has no section group yet (new, or reused after a removal in the same delta)
+    TArray<FVector3f> Positions;     // km from the planet centre, ghost vertices on their parent edge
+    TArray<float> ElevationKm;
+    TArray<FIntVector> Triangles;    // wound outward
+};
+
+/** What an Update changed. Apply removals before patches: a removed id can come back as a new patch. */
+struct FPTPSubdivisionDelta
+{
+    TArray<FPTPSubdivisionPatch> Patches;
+    TArray<int32> RemovedPatches;
+
+    int32 NumSplits = 0;
+    int32 NumMerges = 0;
+    int32 NumNewVertices = 0;
+    int32 NumChecks = 0;              // queued split/merge tests that came due
+
+    void Reset();
+};
+
+/**
+ * CPU adaptive dyadic subdivision of the planet mesh (guide 2.3-2.5), for headless bakes and
+ * machines without a GPU path.
+ *
+ * Every base triangle roots a restricted quadtree: a triangle splits into four through its edge
+ * midpoints, and before it does, any coarser neighbour across one of its edges is split first, so
+ * edge-adjacent leaves never differ by more than one level. A leaf whose neighbour is finer emits
+ * the dyadic pattern over the midpoints its edges carry (1, 2, 3 or 4 triangles), so index
+ * buffers never hold a T-junction. A midpoint with only one side split is a ghost vertex: it is
+ * placed on the chord of its parent edge, keeping the coarse side flat and the two sides crack-free,
+ * and takes its true height once both sides split.
+ *
+ * Refinement is driven by the distance from each node to a query point. Nodes are not revisited
+ * every update: each split or merge test is queued with the distance the query point can travel
+ * before its outcome could change (the distance to a bound is 1-Lipschitz), and an update only pops
+ * the tests that came due. New vertices of an update are evaluated through the height source in
+ * one batch, and only patches touched by a split or merge are re-emitted, so the cost of an
+ * update follows the refinement delta rather than the size of the mesh.
+ */
+class GAIAPTP_API FPTPAdaptiveSubdivider
+{
+public:
+    /**
+     * Start from the base triangulation, every base triangle a leaf due for its first test.
+     *
+     * @param Points - Base vertex positions, any radius (input)
+     * @param Triangles - Triangulation of Points, either winding (input)
+     * @param InSettings - Refinement settings (input)
+     * @param InHeightSource - Elevation at vertex directions, e.g. FPTPHeightSources::MakeGaborPoints (input)
+     */
+    void Build(const TArray<FVector3f>& Points, const TArray<FIntVector>& Triangles, const FPTPSubdivisionSettings& InSettings,
+               FPTPPointHeightSource InHeightSource);
+
+    void Reset();
+
+    /**
+     * Refine towards and coarsen away from a query point.
+     *
+     * @param QueryPointKm - Camera or query point relative to the planet centre (input)
+     * @param OutDelta - Patches re-emitted or removed (output)
+     * @return false if MaxSplitsPerUpdate cut the update short
+     */
+    bool Update(const FVector& QueryPointKm, FPTPSubdivisionDelta& OutDelta);
+
+    /** Every leaf's triangles in one buffer over the live vertices (indices into OutPositions). For bakes and tests. */
+    void GetMesh(TArray<FVector3f>& OutPositions, TArray<FIntVector>& OutTriangles) const;
+
+    /** Whether every leaf edge is split at most once on its far side. For tests. */
+    bool IsRestricted() const;
+
+    /**
+     * Upload a delta as section groups "PTPAdaptive_<patch>" of one LOD: removals first, then new
+     * and rebuilt patches, with the preview mesh's streams and elevation in TexCoord0.U.
+     *
+     * @param Mesh - Target mesh (input)
+     * @param Delta - Output of Update (input)
+     * @param Scale - Visualization scale applied to positions (input)
+     * @param LODIndex - LOD holding the patch groups (input)
+     */
+    static void ApplyToRealtimeMesh(URealtimeMeshSimple& Mesh, const FPTPSubdivisionDelta& Delta, float Scale, int32 LODIndex = 0);
+
+    int32 GetNumNodes() const { return Nodes.Num() - FreeBlocks.Num() * 4; }
+    int32 GetNumLeaves() const { return NumLeaves; }
+    int32 GetNumVertices() const { return Vertices.Num() - FreeVertices.Num(); }
+    int32 GetNumPatches() const { return NumLivePatches; }
+    int32 GetMaxDepth() const;
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    struct FVertex
+    {
+        FVector3f Direction = FVector3f::ZeroVector;
+        FVector3f PositionKm = FVector3f::ZeroVector;
+        FVector3f GhostKm = FVector3f::ZeroVector;   // on the chord of the parent edge
+        float ElevationKm = 0.0f;
+        float GhostElevationKm = 0.0f;
+        int32 Edge = INDEX_NONE;                     // edge this vertex is the midpoint of; INDEX_NONE for base vertices
+        bool bAlive = false;
+        bool bPending = false;                       // height not evaluated yet
+    };
+
+    struct FEdge
+    {
+        int32 V[2] = { INDEX_NONE, INDEX_NONE };
+        int32 Users[2] = { INDEX_NONE, INDEX_NONE }; // the triangles on either side at this edge's level
+        int32 Midpoint = INDEX_NONE;
+        int32 NumSplit = 0;                          // users split through the midpoint
+    };
+
+    struct FNode
+    {
+        int32 Corners[3] = { INDEX_NONE, INDEX_NONE, INDEX_NONE };
+        int32 Edges[3] = { INDEX_NONE, INDEX_NONE, INDEX_NONE };   // edge k runs from corner k to corner k + 1
+        int32 Parent = INDEX_NONE;
+        int32 FirstChild = INDEX_NONE;                             // four consecutive nodes
+        int32 Patch = INDEX_NONE;
+        uint32 Stamp = 0;                                          // bumped on every reschedule and free
+        int32 Level = 0;
+        float SizeKm = 0.0f;                                       // longest edge
+        float BoundKm = 0.0f;                                      // radius around CenterKm enclosing the triangle and its relief
+        FVector3f CenterKm = FVector3f::ZeroVector;
+    };
+
+    struct FPatch
+    {
+        TArray<int32> Roots;
+        bool bAlive = false;
+        bool bDirty = false;
+        bool bUploaded = false;   // the consumer holds a section group for this id
+    };
+
+    /** A queued split (leaf) or merge (parent of four leaves) test. */
+    struct FCheck
+    {
+        double Deadline = 0.0;    // in cumulative query travel
+        int32 Node = INDEX_NONE;
+        uint32 Stamp = 0;
+
+        bool operator<(const FCheck& Other) const { return Deadline < Other.Deadline; }
+    };
+
+    bool IsLeaf(int32 Node) const { return Nodes[Node].FirstChild == INDEX_NONE; }
+    bool IsMergeable(int32 Node) const;
+    bool CanMerge(int32 Node) const;
+    double GetDistanceKm(int32 Node) const;
+    FVector3f GetSurfaceKm(int32 Vertex, float* OutElevationKm = nullptr) const;
+
+    void Check(int32 Node);
+    void Schedule(int32 Node, double Deadline);
+    void Split(int32 Node);
+    void Merge(int32 Node);
+
+    void InitNode(int32 Node, int32 A, int32 B, int32 C, int32 Parent, int32 Level);
+    void ReleaseNode(int32 Node);
+    int32 AddEdgeUser(int32 A, int32 B, int32 Node);
+    void RemoveEdgeUser(int32 Edge, int32 Node);
+    int32 GetOtherUser(int32 Edge, int32 Node) const;
+    int32 NewMidpoint(int32 Edge);
+    int32 AllocVertex();
+    int32 AllocPatch();
+    void FreePatch(int32 Patch);
+    void MarkDirty(int32 Node, int32 Depth);
+
+    void FreeVertex(int32 Vertex);
+    void MarkPatchDirty(int32 Patch);
+    int32 EvaluatePending();
+    void EmitLeaf(int32 Node, TFunctionRef<void(int32, int32, int32)> Emit) const;
+    void EmitPatch(int32 Patch, FPTPSubdivisionPatch& OutPatch) const;
+
+    FPTPSubdivisionSettings Settings;
+    FPTPPointHeightSource HeightSource;
+
+    TArray<FNode> Nodes;              // base triangles first, then blocks of four children
+    TArray<int32> FreeBlocks;
+    int32 NumBaseNodes = 0;
+    int32 NumLeaves = 0;
+
+    TArray<FVertex> Vertices;
+    TArray<int32> FreeVertices;
+    TArray<int32> PendingVertices;
+
+    TArray<FEdge> Edges;
+    TArray<int32> FreeEdges;
+    TMap<uint64, int32> EdgeLookup;   // (min vertex, max vertex) -> edge
+
+    TArray<FPatch> Patches;
+    TArray<int32> FreePatches;
+    TArray<int32> DirtyPatches;
+    TArray<int32> RemovedPatches;
+    int32 NumLivePatches = 0;
+
+    TArray<FCheck> Queue;             // min-heap on Deadline
+    double TravelKm = 0.0;
+    FVector LastQueryKm = FVector::ZeroVector;
+    bool bHasQuery = false;
+    int32 SplitBudget = 0;
+    int32 UpdateSplits = 0;
+    int32 UpdateMerges = 0;
+};
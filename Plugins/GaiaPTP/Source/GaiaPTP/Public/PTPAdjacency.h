@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Mesh adjacency in compressed sparse row form.
+ *
+ * Vertex v's neighbours are Neighbors[Offsets[v] .. Offsets[v + 1]). One allocation instead of
+ * one heap array per point, so whole-mesh passes stream through it; on a Hilbert-ordered mesh
+ * (PTPSpatialOrder.h) neighbouring rows also sit close together. Built from the per-point lists
+ * UPTPPlanetComponent and FPTPPlanetState keep, or straight from a triangulation.
+ */
+class GAIAPTP_API FPTPAdjacency
+{
+public:
+    /** Flatten per-point neighbour lists, keeping their order (parallel, honours ptp.parallel). */
+    void Build(const TArray<TArray<int32>>& InNeighbors);
+
+    /**
+     * Every triangle edge as a neighbour pair; each row ascending, without duplicates.
+     *
+     * @param Triangles - Vertex triples; indices outside [0, NumVertices) are skipped (input)
+     * @param NumVertices - Rows to build (input)
+     */
+    void BuildFromTriangles(TConstArrayView<FIntVector> Triangles, int32 NumVertices);
+
+    void Reset()
+    {
+        Offsets.Reset();
+        Neighbors.Reset();
+    }
+
+    int32 Num() const { return FMath::Max(Offsets.Num() - 1, 0); }
+    int32 GetNumEntries() const { return Neighbors.Num(); }
+    int32 GetDegree(int32 Vertex) const { return Offsets[Vertex + 1] - Offsets[Vertex]; }
+    SIZE_T GetAllocatedSize() const { return Offsets.GetAllocatedSize() + Neighbors.GetAllocatedSize(); }
+
+    TConstArrayView<int32> GetNeighbors(int32 Vertex) const
+    {
+        return TConstArrayView<int32>(Neighbors.GetData() + Offsets[Vertex], GetDegree(Vertex));
+    }
+
+private:
+    TArray<int32> Offsets;     // Num() + 1 entries
+    TArray<int32> Neighbors;
+};
@@ -0,0 +1,264 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Algo/Impl/BinaryHeap.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/UniquePtr.h"
+#include <type_traits>
+
+/**
+ * Linear allocator for transient kernel buffers. Spans are bumped off the current block and only
+ * released all at once by Reset, so a kernel's temporaries cost a pointer add instead of a heap
+ * round trip. Memory is not zeroed and destructors never run: only trivially destructible types.
+ *
+ * Blocks are kept across Reset. A run that overflowed into several blocks is coalesced into a
+ * single block of its high-water size, so from the second run of the same workload on, the arena
+ * makes no heap allocations.
+ *
+ * Not thread-safe; share work between threads through FPTPStepScratch worker arenas.
+ */
+class GAIAPTP_API FPTPArena
+{
+public:
+    FPTPArena() = default;
+    ~FPTPArena();
+    FPTPArena(const FPTPArena&) = delete;
+    FPTPArena& operator=(const FPTPArena&) = delete;
+
+    void* Allocate(SIZE_T Bytes, SIZE_T Alignment = 16);
+
+    /** Grow an allocation; in place when it is the most recent one and its block has room, else copied. */
+    void* Reallocate(void* Ptr, SIZE_T OldBytes, SIZE_T NewBytes, SIZE_T Alignment = 16);
+
+    /** Uninitialized span of Num elements. */
+    template <typename T>
+    TArrayView<T> NewSpan(int32 Num)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena memory is released without running destructors");
+        return TArrayView<T>(static_cast<T*>(Allocate(sizeof(T) * FMath::Max(Num, 0), alignof(T))), FMath::Max(Num, 0));
+    }
+
+    /** Span of Num copies of Value. */
+    template <typename T>
+    TArrayView<T> NewSpan(int32 Num, const T& Value)
+    {
+        TArrayView<T> Span = NewSpan<T>(Num);
+        for (T& Element : Span)
+        {
+            Element = Value;
+        }
+        return Span;
+    }
+
+    /** Release every span at once. */
+    void Reset();
+
+    /** Start a new peak window at the current usage. */
+    void ResetPeak();
+
+    SIZE_T GetUsedBytes() const { return Used; }
+    /** Growth of the usage over the current peak window. */
+    SIZE_T GetPeakBytes() const { return Peak - PeakBase; }
+    /** Largest usage between two resets since construction. */
+    SIZE_T GetHighWaterBytes() const { return HighWater; }
+    SIZE_T GetCapacityBytes() const;
+    /** Heap allocations made for blocks since construction. */
+    int32 GetNumBlockAllocations() const { return NumBlockAllocations; }
+
+private:
+    struct FBlock
+    {
+        uint8* Data = nullptr;
+        SIZE_T Size = 0;
+    };
+
+    void AddBlock(SIZE_T MinBytes);
+    void FreeBlocks();
+
+    // Inline so the bookkeeping itself stays off the heap in the common one-block case
+    TArray<FBlock, TInlineAllocator<4>> Blocks;
+    int32 Current = 0;
+    SIZE_T Offset = 0;              // into Blocks[Current]
+    SIZE_T Used = 0;                // bytes handed out since Reset, alignment padding included
+    SIZE_T Peak = 0;
+    SIZE_T PeakBase = 0;
+    SIZE_T HighWater = 0;
+    int32 NumBlockAllocations = 0;
+    void* Last = nullptr;           // most recent allocation, the only one that can grow in place
+};
+
+/**
+ * Growable array on an arena, for frontiers and candidate lists whose size is only known at the
+ * end. Growth reallocates on the arena, in place while nothing else was allocated after it.
+ */
+template <typename T>
+class TPTPArenaArray
+{
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>, "Arena arrays hold plain data only");
+
+public:
+    explicit TPTPArenaArray(FPTPArena& InArena, int32 InitialCapacity = 0)
+        : Arena(InArena)
+    {
+        if (InitialCapacity > 0)
+        {
+            Data = static_cast<T*>(Arena.Allocate(sizeof(T) * InitialCapacity, alignof(T)));
+            Max = InitialCapacity;
+        }
+    }
+
+    int32 Num() const { return Count; }
+    bool IsEmpty() const { return Count == 0; }
+    T& operator[](int32 Index) { checkSlow(Index >= 0 && Index < Count); return Data[Index]; }
+    const T& operator[](int32 Index) const { checkSlow(Index >= 0 && Index < Count); return Data[Index]; }
+    TArrayView<T> GetView() const { return TArrayView<T>(Data, Count); }
+
+    void Add(const T& Item)
+    {
+        if (Count == Max)
+        {
+            Grow();
+        }
+        Data[Count++] = Item;
+    }
+
+    void Reset() { Count = 0; }
+
+    /** Min-heap on operator<, as TArray::HeapPush with the default predicate. */
+    void HeapPush(const T& Item)
+    {
+        Add(Item);
+        AlgoImpl::HeapSiftUp(Data, 0, Count - 1, FIdentityFunctor(), TLess<T>());
+    }
+
+    T HeapPop()
+    {
+        check(Count > 0);
+        const T Top = Data[0];
+        Data[0] = Data[--Count];
+        if (Count > 0)
+        {
+            AlgoImpl::HeapSiftDown(Data, 0, Count, FIdentityFunctor(), TLess<T>());
+        }
+        return Top;
+    }
+
+private:
+    void Grow()
+    {
+        const int32 NewMax = FMath::Max(16, Max * 2);
+        Data = static_cast<T*>(Arena.Reallocate(Data, sizeof(T) * Max, sizeof(T) * NewMax, alignof(T)));
+        Max = NewMax;
+    }
+
+    FPTPArena& Arena;
+    T* Data = nullptr;
+    int32 Count = 0;
+    int32 Max = 0;
+};
+
+/**
+ * Transient memory of one simulation step: a step arena for the sequential parts of kernels and a
+ * pool of worker arenas that ParallelFor tasks lease for their own spans. Everything is reset
+ * wholesale by EndStep; spans from a worker arena stay valid until then, so tasks can hand lists
+ * back to the sequential part of their kernel.
+ *
+ * Which tasks share a worker arena depends on scheduling, so its size settles only once the
+ * widest fan-out has been seen. Per-task output with a known bound (a chunk's share of the points)
+ * is better sliced from one step-arena span, which costs the same bytes every step.
+ *
+ * Kernels bracket their work with FPTPKernelScratchScope to record their peak transient bytes.
+ */
+class GAIAPTP_API FPTPStepScratch
+{
+public:
+    /** Exclusive use of one worker arena until destroyed. */
+    class GAIAPTP_API FWorkerLease
+    {
+    public:
+        FWorkerLease(FPTPStepScratch& InOwner, int32 InIndex, FPTPArena& InArena) : Owner(&InOwner), Index(InIndex), Arena(&InArena) {}
+        FWorkerLease(FWorkerLease&& Other) : Owner(Other.Owner), Index(Other.Index), Arena(Other.Arena) { Other.Owner = nullptr; }
+        FWorkerLease(const FWorkerLease&) = delete;
+        FWorkerLease& operator=(const FWorkerLease&) = delete;
+        ~FWorkerLease();
+
+        FPTPArena& operator*() const { return *Arena; }
+        FPTPArena* operator->() const { return Arena; }
+
+    private:
+        FPTPStepScratch* Owner;
+        int32 Index;
+        FPTPArena* Arena;   // cached: the pool array may grow while the lease is held
+    };
+
+    FPTPStepScratch() = default;
+    ~FPTPStepScratch();
+    FPTPStepScratch(const FPTPStepScratch&) = delete;
+    FPTPStepScratch& operator=(const FPTPStepScratch&) = delete;
+
+    /** Arena for the calling thread's sequential work; not for use inside ParallelFor tasks. */
+    FPTPArena& GetStepArena() { return StepArena; }
+
+    /** Lease a worker arena for one ParallelFor task; the pool grows to the widest fan-out seen. */
+    FWorkerLease AcquireWorkerArena();
+
+    void BeginKernel(FName Kernel);
+    void EndKernel();
+
+    /** Reset every arena and publish the step's high water to `stat GaiaPTP` and the CSV profile. */
+    void EndStep();
+
+    /** Largest transient bytes of Kernel over all steps, step and worker arenas together. */
+    SIZE_T GetKernelPeak(FName Kernel) const;
+    const TMap<FName, SIZE_T>& GetKernelPeaks() const { return KernelPeaks; }
+
+    SIZE_T GetCapacityBytes() const;
+    SIZE_T GetHighWaterBytes() const { return HighWater; }
+    int32 GetNumWorkerArenas() const { return WorkerArenas.Num(); }
+    /** Heap allocations for blocks over all arenas; constant once steps reach steady state. */
+    int32 GetNumBlockAllocations() const;
+
+    /** Log the per-kernel peaks. */
+    void LogKernelPeaks() const;
+
+private:
+    void ReleaseWorkerArena(int32 Index);
+    void UpdateStats();
+
+    FPTPArena StepArena;
+    TArray<TUniquePtr<FPTPArena>> WorkerArenas;
+    TArray<int32> FreeWorkers;
+    FCriticalSection WorkerLock;
+
+    TMap<FName, SIZE_T> KernelPeaks;
+    FName CurrentKernel;
+    SIZE_T HighWater = 0;
+
+    // What this scratch last added to the `stat GaiaPTP` high-water counter
+    SIZE_T ReportedHighWater = 0;
+};
+
+/** Records a kernel's transient peak on a scratch for the lifetime of the scope; no-op on null. */
+class FPTPKernelScratchScope
+{
+public:
+    FPTPKernelScratchScope(FPTPStepScratch* InScratch, FName Kernel)
+        : Scratch(InScratch)
+    {
+        if (Scratch)
+        {
+            Scratch->BeginKernel(Kernel);
+        }
+    }
+
+    ~FPTPKernelScratchScope()
+    {
+        if (Scratch)
+        {
+            Scratch->EndKernel();
+        }
+    }
+
+private:
+    FPTPStepScratch* Scratch;
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Impact population settings (Documentation/Research/Impact_Cratering/Crater_Generation_Design.md). */
+struct FPTPCraterParams
+{
+    int32 Seed = 0;
+    float PlanetRadiusKm = 1737.0f;
+    int32 NumCraters = 100000;
+
+    /** Diameters follow a truncated power law, dN/dD ~ D^PowerLawExponent. Raise MinDiameterKm for thick atmospheres. */
+    float MinDiameterKm = 0.5f;
+    float MaxDiameterKm = 1000.0f;
+    float PowerLawExponent = -2.5f;
+
+    /** Simple bowls (depth = DepthRatio * D) below, complex craters with shallower growth above. */
+    float ComplexTransitionKm = 10.0f;
+    float DepthRatio = 0.2f;
+    float ComplexDepthSlope = 0.05f;
+
+    /** Impact ages are uniform over the surface age. */
+    float SurfaceAgeMy = 4000.0f;
+
+    /** Reach of a crater in crater radii: rim plus ejecta blanket. Queries return every crater this close. */
+    float InfluenceRadii = 2.5f;
+};
+
+/**
+ * Impact crater catalogue. Centres, diameters and ages are sampled in parallel from a counter-based
+ * RNG (FPTPHash) keyed on the crater's sample id, so the catalogue is the same for any thread count.
+ *
+ * Storage is SoA, 28 bytes per crater plus ~4 bytes of cell offsets. Craters are grouped into size
+ * classes (one per doubling of diameter) and, within a class, sorted by the cube-map cell
+ * (FPTPCubeMap) of their centre. Each class has its own grid, with cells at least as wide as the
+ * reach of its largest crater, so "craters affecting p" only visits the 3x3 cells around p in each
+ * class: a few dozen candidates instead of millions.
+ */
+class GAIAPTP_API FPTPCraterCatalog
+{
+public:
+    /** Sample Params.NumCraters craters and build the spatial hash (parallel, honours ptp.parallel). */
+    void Generate(const FPTPCraterParams& InParams);
+
+    /**
+     * Expected number of visible craters for a surface (design doc, "Crater Density Calculation").
+     *
+     * @param NumVertices - Vertices of the surface mesh the density is calibrated against (input)
+     * @param SurfaceAgeGyr - Age of the surface (input)
+     * @param TectonicActivity - 0 for a dead world, ~1 for Earth (input)
+     * @param AtmosphericDensity - 0 for airless bodies, ~1 for Earth (input)
+     */
+    static int32 ComputeNumCraters(int32 NumVertices, float SurfaceAgeGyr, float TectonicActivity, float AtmosphericDensity);
+
+    /** Inverse CDF of dN/dD ~ D^Exponent on [MinKm, MaxKm], for a uniform U in [0,1). */
+    static float SampleDiameterKm(float U, float MinKm, float MaxKm, float Exponent);
+
+    /** Bowl depth from the diameter: DepthRatio * D for simple craters, shallower growth past the transition. */
+    static float ComputeDepthKm(float DiameterKm, float ComplexTransitionKm, float DepthRatio, float ComplexDepthSlope)
+    {
+        return DiameterKm <= ComplexTransitionKm
+            ? DepthRatio * DiameterKm
+            : DepthRatio * ComplexTransitionKm + ComplexDepthSlope * (DiameterKm - ComplexTransitionKm);
+    }
+
+    /** Call Visit with every crater whose reach contains unit direction P, by size class then cell. */
+    void ForEachCraterAffecting(const FVector3f& P, TFunctionRef<void(int32 Crater)> Visit) const;
+
+    /** Indices of the craters affecting P, appended to OutCraters. */
+    void GatherCratersAffecting(const FVector3f& P, TArray<int32>& OutCraters) const;
+
+    /** Reference for GatherCratersAffecting that scans every crater. Used by tests. */
+    void GatherCratersAffectingBruteForce(const FVector3f& P, TArray<int32>& OutCraters) const;
+
+    /** True if the crater's reach contains unit direction P. */
+    FORCEINLINE bool Affects(int32 Crater, const FVector3f& P) const
+    {
+        return (P | Centers[Crater]) >= FMath::Cos(GetInfluenceAngle(Crater));
+    }
+
+    int32 Num() const { return Centers.Num(); }
+    const FPTPCraterParams& GetParams() const { return Params; }
+
+    const FVector3f& GetCenter(int32 Crater) const { return Centers[Crater]; }
+    float GetDiameterKm(int32 Crater) const { return DiameterKm[Crater]; }
+    float GetDepthKm(int32 Crater) const { return DepthKm[Crater]; }
+    float GetAgeMy(int32 Crater) const { return AgeMy[Crater]; }
+    bool IsComplex(int32 Crater) const { return DiameterKm[Crater] > Params.ComplexTransitionKm; }
+
+    /** Sample id the crater was drawn with; stable across rebuilds, for per-crater hashes. */
+    uint32 GetId(int32 Crater) const { return Ids[Crater]; }
+
+    /** Reach of a crater, in radians on the unit sphere. */
+    float GetInfluenceAngle(int32 Crater) const { return 0.5f * DiameterKm[Crater] * Params.InfluenceRadii / Params.PlanetRadiusKm; }
+
+    int32 GetNumSizeClasses() const { return Classes.Num(); }
+
+    /** Craters of a size class, [Begin, End). */
+    void GetSizeClassRange(int32 Class, int32& OutBegin, int32& OutEnd) const;
+
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    /** Craters with diameter in [Min * 2^k, Min * 2^(k+1)), bucketed on Resolution^2 cells per face. */
+    struct FSizeClass
+    {
+        int32 Resolution = 0;   // 0: reach too wide for a grid, every query scans the class
+        int32 CellBase = 0;     // first entry of the class in CellOffsets
+        int32 NumCells = 1;
+    };
+
+    int32 GetSizeClass(float Diameter) const;
+
+    FPTPCraterParams Params;
+
+    TArray<FVector3f> Centers;   // unit directions
+    TArray<float> DiameterKm;    // rim to rim
+    TArray<float> DepthKm;       // floor below the pre-impact surface
+    TArray<float> AgeMy;         // time since impact
+    TArray<uint32> Ids;          // sample id
+
+    TArray<FSizeClass> Classes;
+    TArray<int32> CellOffsets;   // craters of cell c of class k: [CellOffsets[CellBase + c], CellOffsets[CellBase + c + 1])
+};
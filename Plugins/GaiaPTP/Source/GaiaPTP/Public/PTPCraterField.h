@@ -0,0 +1,160 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PTPCubeMap.h"
+
+/** Procedural impact population and morphology (Crater_Generation_Design.md, "Raycast Crater Lookup"). */
+struct FPTPCraterFieldParams
+{
+    int32 Seed = 0;
+    float PlanetRadiusKm = 1737.0f;
+
+    /**
+     * Diameter range; octaves halve from MaxDiameterKm down to MinDiameterKm. Directions are single
+     * precision (~0.1 m on a Moon-sized body), so craters much below 10 m lose their shape.
+     */
+    float MinDiameterKm = 0.01f;
+    float MaxDiameterKm = 500.0f;
+
+    /**
+     * Cumulative density N(>D) = DensityAt1Km * D^(PowerLawExponent + 1) per km^2. The default -3 is the
+     * saturation slope: every octave then puts the same number of craters in each of its cells.
+     */
+    float PowerLawExponent = -3.0f;
+    float DensityAt1Km = 0.02f;
+
+    /** Simple bowls below ComplexTransitionKm, central peaks and terraces above, multi-ring basins above MultiRingTransitionKm. */
+    float ComplexTransitionKm = 10.0f;
+    float MultiRingTransitionKm = 300.0f;
+    float DepthRatio = 0.2f;
+    float ComplexDepthSlope = 0.05f;
+
+    /** Rim height as a fraction of depth, and central peak height as a fraction of depth. */
+    float SimpleRimRatio = 0.1f;
+    float ComplexRimRatio = 0.15f;
+    float PeakRatio = 0.3f;
+
+    /** Reach of a crater in crater radii: rim plus ejecta blanket. */
+    float InfluenceRadii = 2.5f;
+
+    /** Relief kept by the oldest craters; crater ages are uniform, relief fades linearly with age. */
+    float MinFreshness = 0.3f;
+
+    /** Poisson draws per cell are capped here. */
+    int32 MaxCratersPerCell = 8;
+};
+
+/**
+ * Crater relief evaluated on demand, with nothing stored per crater.
+ *
+ * Diameters are split into octaves (MaxDiameterKm / 2^k). Each octave has its own equi-angular
+ * cube-map grid, with cells at least as wide as the reach of its largest crater. The craters of a
+ * cell are a Poisson draw hashed from (seed, octave, cell) with FPTPHash. A point's relief is the
+ * sum over the 3x3 cells around it in every octave, so any region can be evaluated independently,
+ * in any order and at any density. Memory is the octave table, whatever the crater count -- a
+ * metre-scale dead moon has billions of craters.
+ *
+ * Evaluation mirrors FPTPGaborAmplifier: a batch generates the craters of the cells it touches
+ * once, packs each home cell's neighbourhood into padded SoA blocks per morphology, and sums four
+ * craters per iteration with VectorRegister4Float profiles. Multi-ring basins are rare and run
+ * scalar. Octaves whose largest crater is below MinDiameterKm are skipped, which is the LOD control:
+ * AmplifyTile drops craters narrower than two texels.
+ */
+class GAIAPTP_API FPTPCraterField
+{
+public:
+    explicit FPTPCraterField(const FPTPCraterFieldParams& InParams);
+
+    /**
+     * Crater relief (km) at each direction.
+     *
+     * @param Directions - Unit directions (input)
+     * @param OutReliefKm - Relief per direction (output, must match Directions.Num())
+     * @param MinDiameterKm - Smaller craters are skipped (input)
+     * @param bParallel - Split the batch across workers; tile drivers pass false and parallelize over tiles
+     */
+    void Evaluate(TConstArrayView<FVector3f> Directions, TArrayView<float> OutReliefKm, float MinDiameterKm = 0.0f, bool bParallel = true) const;
+
+    /** Scalar reference for Evaluate, one crater at a time. Used by tests. */
+    void EvaluateScalar(TConstArrayView<FVector3f> Directions, TArrayView<float> OutReliefKm, float MinDiameterKm = 0.0f) const;
+
+    /**
+     * Add crater relief to a tile's elevations, skipping craters narrower than MinFeatureTexels texels.
+     *
+     * @param Tile - Region the elevations cover (input)
+     * @param InOutElevationKm - Tile.Resolution^2 heights, row-major (input/output)
+     * @return false, leaving the heights untouched, if InOutElevationKm is not Tile.Resolution^2 long
+     */
+    bool AmplifyTile(const FPTPAmplifyTile& Tile, TArray<float>& InOutElevationKm, float MinFeatureTexels = 2.0f) const;
+
+    /** Radial profiles at normalized distance R (1 on the rim). Zero at and beyond Reach. */
+    static float SimpleProfile(float R, float DepthKm, float RimKm, float Reach);
+    static float ComplexProfile(float R, float DepthKm, float RimKm, float PeakKm, float Reach);
+    static float MultiRingProfile(float R, float DepthKm, int32 NumRings, float Reach);
+
+    int32 GetNumOctaves() const { return Octaves.Num(); }
+
+    /** Expected craters per cell in an octave. */
+    float GetMeanCratersPerCell(int32 Octave) const { return Octaves[Octave].MeanPerCell; }
+
+    int32 GetOctaveResolution(int32 Octave) const { return Octaves[Octave].Resolution; }
+
+private:
+    enum class ECraterKind : uint8
+    {
+        Simple,
+        Complex,
+        MultiRing
+    };
+
+    struct FOctave
+    {
+        int32 Resolution = 1;    // 1: faces are the cells, and every query visits all six
+        float MinDiameterKm = 0.0f;
+        float MaxDiameterKm = 0.0f;
+        float MeanPerCell = 0.0f;
+    };
+
+    /** One generated crater, ready for the profiles. */
+    struct FCrater
+    {
+        FVector3f Center = FVector3f::ZeroVector;
+        float InvChordRadius2 = 0.0f;   // 1 / chord(radius)^2: R^2 = |P - Center|^2 * InvChordRadius2
+        float DepthKm = 0.0f;
+        float RimKm = 0.0f;
+        ECraterKind Kind = ECraterKind::Simple;
+        uint8 NumRings = 0;
+    };
+
+    /** Craters of a set of home-cell neighbourhoods, SoA, padded per block to a multiple of four. */
+    struct FPackedCraters
+    {
+        TArray<float> CX, CY, CZ;
+        TArray<float> InvChordRadius2;
+        TArray<float> Depth;
+        TArray<float> Rim;
+    };
+
+    struct FBlock
+    {
+        int32 SimpleFirst = 0;
+        int32 SimpleNum = 0;
+        int32 ComplexFirst = 0;
+        int32 ComplexNum = 0;
+        int32 BasinFirst = 0;
+        int32 BasinNum = 0;
+    };
+
+    /** Append the craters of a cell of an octave's grid that are at least MinDiameterKm across. */
+    void GenerateCell(int32 Octave, int64 Cell, float MinDiameterKm, TArray<FCrater>& OutCraters) const;
+
+    int64 HomeCell(int32 Octave, const FVector3f& Dir) const;
+    int32 NeighborhoodCells(int32 Octave, int64 Cell, int64 OutCells[9]) const;
+
+    float EvaluateScalarCrater(const FCrater& Crater, const FVector3f& P) const;
+    float EvaluateBlock(const FPackedCraters& Simple, const FPackedCraters& Complex, TConstArrayView<FCrater> Basins,
+                        const FBlock& Block, const FVector3f& P) const;
+
+    FPTPCraterFieldParams Params;
+    TArray<FOctave> Octaves;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TectonicData.h"
+
+/** Coarse crust state interpolated at an arbitrary direction; input to the amplification kernels. */
+struct FPTPCrustSample
+{
+    float Elevation = 0.0f;                               // km relative to sea level
+    float OceanicAge = 0.0f;                              // My
+    FVector3f RidgeDirection = FVector3f::ZeroVector;     // unit tangent along the ridge, zero on continents
+    float OceanicWeight = 0.0f;                           // 1 on oceanic crust, 0 on continental, blended across coasts
+
+    float OrogenyAge = 0.0f;                              // My
+    EOrogenyType OrogenyType = EOrogenyType::None;        // of the nearest sample (categorical, not blended)
+    FVector3f FoldDirection = FVector3f::ZeroVector;      // unit tangent along fold lines, zero if none
+};
+
+/**
+ * Batched crust lookup: fills OutSamples[i] for unit direction Directions[i].
+ * Called once per impulse table and once per output tile, never per texel.
+ */
+using FPTPCrustSampler = TFunction<void(TConstArrayView<FVector3f> Directions, TArrayView<FPTPCrustSample> OutSamples)>;
+
+/** Factories for crust samplers over a planet's coarse state. */
+class GAIAPTP_API FPTPCrustSampling
+{
+public:
+    /**
+     * Inverse-distance blend of the nearest samples found through a cube-map bucket grid.
+     * Direction fields are sign-aligned before blending and re-projected onto the tangent plane.
+     * The arrays are copied, so the planet may change afterwards.
+     */
+    static FPTPCrustSampler MakeNearestSampler(const TArray<FVector3f>& SamplePoints, const TArray<FCrustData>& CrustData);
+
+    /**
+     * Barycentric interpolation over the coarse triangulation via FPTPPointLocator; categorical fields
+     * come from the vertex with the largest weight. Falls back to MakeNearestSampler if the
+     * triangulation cannot be located against (empty or not closed).
+     */
+    static FPTPCrustSampler MakeBarycentricSampler(const TArray<FVector3f>& SamplePoints, const TArray<FIntVector>& Triangles,
+                                                   const TArray<FCrustData>& CrustData);
+};
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Algo/Sort.h"
+
+/**
+ * Equi-angular cube-map parameterization of the unit sphere.
+ *
+ * Faces are ordered +X, -X, +Y, -Y, +Z, -Z. Face coordinates S,T are in [-1,1] and map to the
+ * face plane through tan(S*PI/4), which keeps cell sizes within ~30% of each other across a face
+ * (a plain gnomonic map varies by ~5x). dDir/dS x dDir/dT points outward on every face.
+ *
+ * Cells of a Resolution x Resolution grid per face are identified by a single int32:
+ * Face * Resolution^2 + Y * Resolution + X.
+ */
+struct FPTPCubeMap
+{
+    static constexpr int32 NumFaces = 6;
+
+    /** Narrowest cell (edge midpoints, across the seam) relative to the mean cell width, 2 / Resolution. */
+    static constexpr float MinCellWidthFraction = 0.7f;
+
+    /** Largest per-face resolution whose cell ids, NumFaces * Resolution^2 of them, still fit in int32. */
+    static constexpr int32 MaxCellIdResolution = 18000;
+
+    /** Unit direction for face coordinates S,T (values slightly outside [-1,1] extrapolate on the face plane). */
+    static FORCEINLINE FVector3f FaceToDirection(int32 Face, float S, float T)
+    {
+        const float U = FMath::Tan(S * (PI / 4.0f));
+        const float V = FMath::Tan(T * (PI / 4.0f));
+        FVector3f D;
+        switch (Face)
+        {
+        case 0:  D = FVector3f(1.0f, U, V);   break;
+        case 1:  D = FVector3f(-1.0f, -U, V); break;
+        case 2:  D = FVector3f(-U, 1.0f, V);  break;
+        case 3:  D = FVector3f(U, -1.0f, V);  break;
+        case 4:  D = FVector3f(U, V, 1.0f);   break;
+        default: D = FVector3f(U, -V, -1.0f); break;
+        }
+        return D.GetUnsafeNormal();
+    }
+
+    /** Inverse of FaceToDirection; Dir need not be normalized. */
+    static FORCEINLINE void DirectionToFace(const FVector3f& Dir, int32& OutFace, float& OutS, float& OutT)
+    {
+        const FVector3f A = Dir.GetAbs();
+        float U, V;
+        if (A.X >= A.Y && A.X >= A.Z)
+        {
+            OutFace = Dir.X >= 0.0f ? 0 : 1;
+            U = (Dir.X >= 0.0f ? Dir.Y : -Dir.Y) / A.X;
+            V = Dir.Z / A.X;
+        }
+        else if (A.Y >= A.Z)
+        {
+            OutFace = Dir.Y >= 0.0f ? 2 : 3;
+            U = (Dir.Y >= 0.0f ? -Dir.X : Dir.X) / A.Y;
+            V = Dir.Z / A.Y;
+        }
+        else
+        {
+            OutFace = Dir.Z >= 0.0f ? 4 : 5;
+            U = Dir.X / A.Z;
+            V = (Dir.Z >= 0.0f ? Dir.Y : -Dir.Y) / A.Z;
+        }
+        OutS = FMath::Atan(U) * (4.0f / PI);
+        OutT = FMath::Atan(V) * (4.0f / PI);
+    }
+
+    /** Cell id containing Dir on a Resolution x Resolution grid per face. */
+    static FORCEINLINE int32 CellId(const FVector3f& Dir, int32 Resolution)
+    {
+        int32 Face;
+        float S, T;
+        DirectionToFace(Dir, Face, S, T);
+        const int32 X = FMath::Clamp((int32)((S + 1.0f) * 0.5f * Resolution), 0, Resolution - 1);
+        const int32 Y = FMath::Clamp((int32)((T + 1.0f) * 0.5f * Resolution), 0, Resolution - 1);
+        return (Face * Resolution + Y) * Resolution + X;
+    }
+
+    static FORCEINLINE void CellCoords(int32 Cell, int32 Resolution, int32& OutFace, int32& OutX, int32& OutY)
+    {
+        OutX = Cell % Resolution;
+        OutY = (Cell / Resolution) % Resolution;
+        OutFace = Cell / (Resolution * Resolution);
+    }
+
+    /** Centre direction of cell (X,Y) on Face; X/Y may lie one cell outside the face. */
+    static FORCEINLINE FVector3f CellCenter(int32 Face, int32 X, int32 Y, int32 Resolution)
+    {
+        const float Step = 2.0f / Resolution;
+        return FaceToDirection(Face, -1.0f + (X + 0.5f) * Step, -1.0f + (Y + 0.5f) * Step);
+    }
+
+    /**
+     * The 3x3 block of cells around Cell, crossing face seams (cells off the face are resolved by
+     * projecting their centre onto the neighbouring face). Ids are unique and sorted ascending, so the
+     * result is a pure function of the cell; cube corners yield 8 cells instead of 9.
+     *
+     * @return number of ids written to OutCells
+     */
+    static int32 NeighborhoodCells(int32 Cell, int32 Resolution, int32 OutCells[9])
+    {
+        int32 Face, X, Y;
+        CellCoords(Cell, Resolution, Face, X, Y);
+
+        int32 Count = 0;
+        for (int32 DY = -1; DY <= 1; ++DY)
+        {
+            for (int32 DX = -1; DX <= 1; ++DX)
+            {
+                const int32 NX = X + DX;
+                const int32 NY = Y + DY;
+                int32 Id;
+                if (NX >= 0 && NX < Resolution && NY >= 0 && NY < Resolution)
+                {
+                    Id = (Face * Resolution + NY) * Resolution + NX;
+                }
+                else if ((NX < 0 || NX >= Resolution) && (NY < 0 || NY >= Resolution))
+                {
+                    continue; // diagonal past a cube corner: the two edge neighbours already cover it
+                }
+                else
+                {
+                    Id = CellId(CellCenter(Face, NX, NY, Resolution), Resolution);
+                }
+
+                bool bSeen = false;
+                for (int32 i = 0; i < Count; ++i)
+                {
+                    bSeen |= OutCells[i] == Id;
+                }
+                if (!bSeen)
+                {
+                    OutCells[Count++] = Id;
+                }
+            }
+        }
+
+        Algo::Sort(MakeArrayView(OutCells, Count));
+        return Count;
+    }
+
+    /** Cells per face edge so cells are roughly CellSizeKm across on a sphere of RadiusKm. */
+    static FORCEINLINE int32 ResolutionForCellSize(float RadiusKm, float CellSizeKm)
+    {
+        return FMath::Max(1, FMath::CeilToInt((HALF_PI * RadiusKm) / CellSizeKm));
+    }
+};
+
+static_assert(int64(FPTPCubeMap::NumFaces) * FPTPCubeMap::MaxCellIdResolution * FPTPCubeMap::MaxCellIdResolution <= MAX_int32,
+    "Cell ids at MaxCellIdResolution must fit in int32");
+
+/**
+ * One square region of a cube face, sampled at texel centres. With bSharedEdges the texels sit on
+ * the corners of a (Resolution - 1)-quad grid instead, so neighbouring tiles repeat each other's
+ * edge row and the face edges land exactly on the cube seams -- the layout Landscape imports expect.
+ */
+struct FPTPAmplifyTile
+{
+    int32 Face = 0;
+    int32 TileX = 0;
+    int32 TileY = 0;
+    int32 TilesPerFace = 1;
+    int32 Resolution = 256;   // texels per tile edge
+    bool bSharedEdges = false;
+
+    /** Unit direction of texel (X,Y), row-major within the tile. */
+    FVector3f TexelDirection(int32 X, int32 Y) const
+    {
+        if (bSharedEdges)
+        {
+            const int32 Quads = FMath::Max(Resolution - 1, 1);
+            const float Step = 2.0f / (TilesPerFace * Quads);
+            return FPTPCubeMap::FaceToDirection(Face, -1.0f + (TileX * Quads + X) * Step, -1.0f + (TileY * Quads + Y) * Step);
+        }
+        const float Step = 2.0f / (TilesPerFace * Resolution);
+        return FPTPCubeMap::FaceToDirection(Face,
+            -1.0f + (TileX * Resolution + X + 0.5f) * Step,
+            -1.0f + (TileY * Resolution + Y + 0.5f) * Step);
+    }
+};
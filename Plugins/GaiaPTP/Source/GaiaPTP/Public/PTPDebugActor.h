@@ -2,11 +2,22 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Async/Future.h"
 #include "PTPDebugActor.generated.h"
 
 class URealtimeMeshComponent;
+class APTPPlanetActor;
+class UMaterialInterface;
+struct FPTPOverlayMeshes;
 
-/** Minimal debug actor that will host RealtimeMesh visualizations. */
+/**
+ * Debug overlays for a planet actor: plate velocity arrows and boundary lines coloured by type.
+ *
+ * Each overlay is one batched section group on this actor's RMC, built on a worker thread and
+ * swapped in when ready. Arrow density follows the camera distance through a power-of-two sample
+ * stride, and arrows are only gathered over the visible cap. Call MarkOverlayDirty after a
+ * simulation step; only the overlay streams are re-sent, the planet mesh is untouched.
+ */
 UCLASS()
 class GAIAPTP_API APTPDebugActor : public AActor
 {
@@ -15,8 +26,49 @@ class GAIAPTP_API APTPDebugActor : public AActor
 public:
     APTPDebugActor();
 
+    /** Rebuild the overlays on the next tick (e.g. after plates moved or boundaries were reclassified). */
+    void MarkOverlayDirty() { bOverlayDirty = true; }
+
+    /** Rebuild the overlays from the planet's current state. */
+    UFUNCTION(BlueprintCallable, CallInEditor, Category="PTP|Overlay")
+    void RefreshOverlays();
+
 protected:
     UPROPERTY(VisibleAnywhere, Category="PTP")
     URealtimeMeshComponent* RealtimeMesh;
-};
 
+    // Planet whose plates are drawn; the overlay follows its transform
+    UPROPERTY(EditAnywhere, Category="PTP|Overlay")
+    APTPPlanetActor* PlanetActor;
+
+    UPROPERTY(EditAnywhere, Category="PTP|Overlay")
+    bool bShowVelocityArrows = true;
+
+    UPROPERTY(EditAnywhere, Category="PTP|Overlay")
+    bool bShowBoundaries = true;
+
+    // Approximate number of arrows over the visible cap; the sample stride is chosen from the camera distance
+    UPROPERTY(EditAnywhere, Category="PTP|Overlay", meta=(ClampMin="100", EditCondition="bShowVelocityArrows"))
+    int32 TargetArrows = 4000;
+
+    // Unlit vertex-colour material for the overlay ribbons
+    UPROPERTY(EditAnywhere, Category="PTP|Overlay")
+    UMaterialInterface* OverlayMaterial;
+
+    virtual void Tick(float DeltaSeconds) override;
+    virtual bool ShouldTickIfViewportsOnly() const override { return true; }
+
+private:
+    bool UpdateView();
+    void LaunchOverlayBuild();
+    void ApplyOverlays(FPTPOverlayMeshes& Meshes);
+
+    TFuture<TSharedPtr<FPTPOverlayMeshes>> PendingBuild;
+    bool bOverlayDirty = true;
+    bool bGroupsCreated = false;
+
+    // View the resident arrows were gathered for
+    int32 ViewStride = 0;
+    FVector3f ViewDir = FVector3f::ZeroVector;
+    float ViewHalfAngle = PI;
+};
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+#include "TectonicTypes.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Summary of one exemplar patch used for matching (guide Part 5, continental amplification).
+ * Heights are relative to sea level; DominantAngle is the ridge-line orientation in patch space
+ * (radians from +X, modulo PI) and Anisotropy in [0,1] says how strongly the patch is oriented.
+ */
+struct FPTPExemplarDescriptor
+{
+    float MinElevationKm = 0.0f;
+    float MaxElevationKm = 0.0f;
+    float MeanElevationKm = 0.0f;
+    float AgeMy = 0.0f;
+    EOrogenyType OrogenyType = EOrogenyType::None;
+    float DominantAngle = 0.0f;
+    float Anisotropy = 0.0f;
+
+    static constexpr int32 NumFeatures = 5;
+
+    /** Weighted feature vector used by the index; orogeny type is scaled to dominate so types never mix. */
+    void ToFeatures(float OutFeatures[NumFeatures]) const;
+
+    friend FArchive& operator<<(FArchive& Ar, FPTPExemplarDescriptor& D);
+};
+
+/**
+ * Static KD-tree over descriptor features, stored as an implicit balanced tree (median of the
+ * widest dimension at the middle of each range) so it serializes as flat arrays.
+ * k-NN queries are O(log N) for the typical exemplar library of a few thousand patches.
+ */
+class GAIAPTP_API FPTPExemplarIndex
+{
+public:
+    void Build(TConstArrayView<FPTPExemplarDescriptor> Descriptors);
+
+    /**
+     * Find the K patches nearest to Query in feature space.
+     *
+     * @param Query - Target descriptor (input)
+     * @param K - Number of neighbours wanted (input)
+     * @param OutPatches - Patch indices, nearest first; fewer than K if the index is small (output)
+     */
+    void FindNearest(const FPTPExemplarDescriptor& Query, int32 K, TArray<int32>& OutPatches) const;
+
+    int32 Num() const { return PatchIds.Num(); }
+
+    friend FArchive& operator<<(FArchive& Ar, FPTPExemplarIndex& Index);
+
+private:
+    void Search(int32 Begin, int32 End, const float* Query, int32 K, TArray<TPair<float, int32>>& Heap) const;
+
+    TArray<float> Features;   // NumFeatures per node, in tree order
+    TArray<int32> PatchIds;   // patch index per node
+    TArray<uint8> SplitDims;  // split dimension per node
+};
+
+/** One exemplar patch's heights, kept alive while a synthesis tile reads it. */
+struct GAIAPTP_API FPTPExemplarPage
+{
+    ~FPTPExemplarPage();
+
+    const int16* Heights = nullptr;   // PatchSize^2 meters, row-major
+    IMappedFileRegion* Region = nullptr;
+    TArray<int16> Loaded;             // used when the platform cannot memory-map
+};
+
+/** Source DEM for building a library; patches are cut on a regular stride. */
+struct FPTPExemplarSource
+{
+    TArray<float> HeightsM;           // Width * Height, row-major, meters
+    int32 Width = 0;
+    int32 Height = 0;
+    EOrogenyType OrogenyType = EOrogenyType::None;
+    float AgeMy = 0.0f;
+};
+
+/**
+ * Memory-mapped library of DEM exemplar patches plus its descriptor index.
+ *
+ * File layout (.ptpex): header, page-aligned patch data (PatchSize^2 int16 meters per patch),
+ * then descriptors and the serialized KD-tree. Open() reads only the header and index; patch pages
+ * are mapped on demand and kept in an LRU cache, so the exemplar set does not need to fit in RAM.
+ */
+class GAIAPTP_API FPTPExemplarLibrary
+{
+public:
+    static constexpr uint32 FileMagic = 0x58505450; // 'PTPX'
+    static constexpr uint32 FileVersion = 1;
+    static constexpr int64 PageAlignment = 4096;
+
+    FPTPExemplarLibrary();
+    ~FPTPExemplarLibrary();
+
+    /**
+     * Cut sources into patches, compute descriptors and write a library file.
+     *
+     * @param Path - Output file (input)
+     * @param Sources - DEMs with their tectonic metadata (input)
+     * @param PatchSize - Patch edge in texels (input)
+     * @param Stride - Texels between patch origins; less than PatchSize overlaps patches (input)
+     * @param MetersPerTexel - Ground resolution of the sources (input)
+     * @return false on I/O error
+     */
+    static bool Write(const FString& Path, TConstArrayView<FPTPExemplarSource> Sources, int32 PatchSize, int32 Stride, float MetersPerTexel);
+
+    /** Descriptor for one patch of heights (meters); exposed for tests and tooling. */
+    static FPTPExemplarDescriptor Describe(const float* HeightsM, int32 PatchSize, EOrogenyType OrogenyType, float AgeMy);
+
+    /** Open a library; MaxCachedPages bounds how many patches stay mapped. */
+    bool Open(const FString& Path, int32 MaxCachedPages = 256);
+    void Close();
+    bool IsOpen() const { return NumPatches > 0; }
+
+    /**
+     * Fetch a patch, mapping it if not cached. Thread-safe; the page stays valid while referenced,
+     * but references must be released before the library is closed.
+     *
+     * @return null, without caching anything, if the patch could not be mapped or read
+     */
+    TSharedPtr<const FPTPExemplarPage, ESPMode::ThreadSafe> GetPage(int32 PatchIndex);
+
+    const FPTPExemplarIndex& GetIndex() const { return Index; }
+    const FPTPExemplarDescriptor& GetDescriptor(int32 PatchIndex) const { return Descriptors[PatchIndex]; }
+    int32 GetNumPatches() const { return NumPatches; }
+    int32 GetPatchSize() const { return PatchSize; }
+    float GetMetersPerTexel() const { return MetersPerTexel; }
+
+    /** Cache statistics since Open(). */
+    int32 GetNumPageMisses() const { return NumPageMisses; }
+    int32 GetNumPageHits() const { return NumPageHits; }
+
+private:
+    int64 PageBytes() const { return Align((int64)PatchSize * PatchSize * sizeof(int16), PageAlignment); }
+
+    FString FilePath;
+    int32 NumPatches = 0;
+    int32 PatchSize = 0;
+    float MetersPerTexel = 0.0f;
+    int64 DataOffset = 0;
+
+    TArray<FPTPExemplarDescriptor> Descriptors;
+    FPTPExemplarIndex Index;
+
+    TUniquePtr<IMappedFileHandle> MappedFile;
+    FCriticalSection CacheLock;
+    TLruCache<int32, TSharedPtr<const FPTPExemplarPage, ESPMode::ThreadSafe>> PageCache;
+    int32 NumPageMisses = 0;
+    int32 NumPageHits = 0;
+};
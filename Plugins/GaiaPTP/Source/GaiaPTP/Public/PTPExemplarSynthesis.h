@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PTPCrustSample.h"
+#include "PTPCubeMap.h"
+
+class FPTPExemplarLibrary;
+
+/** Configuration for exemplar-based continental amplification. */
+struct FPTPExemplarSynthesisParams
+{
+    int32 Seed = 0;
+    float PlanetRadiusKm = 6370.0f;
+
+    /** k-NN candidates per splat; one is picked by hash so neighbouring splats vary. */
+    int32 NumCandidates = 4;
+
+    /** Multiplier on exemplar relief (patch height minus patch mean) before it is added to the coarse elevation. */
+    float DetailScale = 1.0f;
+};
+
+/**
+ * Continental amplification (guide Part 5): blends rotated DEM exemplar patches over the coarse crust.
+ *
+ * Splats sit at the centres of a cube-map grid whose cells are one window radius across. Each splat
+ * describes its coarse region (elevation range over the footprint, orogeny type and age, whether a
+ * fold direction exists), picks a patch through the library's KD-tree, and rotates it so the patch's
+ * dominant ridge orientation follows the local FoldDirection. Texels blend the splats of their 3x3
+ * cell neighbourhood with a smooth radial window. Like the Gabor amplifier, results are a pure
+ * function of direction, so tiles are independent and run in parallel.
+ */
+class GAIAPTP_API FPTPExemplarSynthesizer
+{
+public:
+    /** The library must stay open for the synthesizer's lifetime. */
+    FPTPExemplarSynthesizer(const FPTPExemplarSynthesisParams& InParams, FPTPExemplarLibrary& InLibrary, FPTPCrustSampler InSampler);
+
+    /**
+     * Amplified elevation for one tile: coarse elevation plus blended exemplar relief on continents.
+     *
+     * @param Tile - Region to amplify (input)
+     * @param OutElevationKm - Resolution^2 heights, row-major (output)
+     */
+    void SynthesizeTile(const FPTPAmplifyTile& Tile, TArray<float>& OutElevationKm) const;
+
+    /** SynthesizeTile over many tiles, parallel across tiles (honours ptp.parallel). */
+    void SynthesizeTiles(TConstArrayView<FPTPAmplifyTile> Tiles, TArray<TArray<float>>& OutElevationKm) const;
+
+    int32 GetSplatResolution() const { return SplatResolution; }
+
+private:
+    FPTPExemplarSynthesisParams Params;
+    FPTPExemplarLibrary* Library = nullptr;
+    FPTPCrustSampler Sampler;
+
+    int32 SplatResolution = 1;
+    float TexelKm = 0.0f;         // exemplar ground resolution
+    float WindowRadiusKm = 0.0f;  // splat blend radius, inside the patch footprint
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PTPCrustSample.h"
+#include "PTPCubeMap.h"
+
+/** Gabor kernel configuration for oceanic amplification (guide Part 5). */
+struct FPTPGaborParams
+{
+    int32 Seed = 0;
+    float PlanetRadiusKm = 6370.0f;
+
+    /** Impulse grid cell size; also the Gaussian envelope radius, so it bounds the largest feature. */
+    float CellSizeKm = 20.0f;
+    int32 ImpulsesPerCell = 8;
+
+    /** Envelope sharpness: K(r) = exp(-PI * (Sharpness * r / CellSizeKm)^2). */
+    float EnvelopeSharpness = 1.5f;
+
+    /** Abyssal hill wavelength and amplitude at the ridge and on old crust (lerped by OceanicAge / AgeScaleMy). */
+    float YoungWavelengthKm = 4.0f;
+    float OldWavelengthKm = 10.0f;
+    float YoungAmplitudeKm = 0.25f;
+    float OldAmplitudeKm = 0.08f;
+    float AgeScaleMy = 120.0f;
+};
+
+/**
+ * CPU sparse-convolution Gabor noise for oceanic amplification.
+ *
+ * Impulses live on an equi-angular cube-map grid (FPTPCubeMap) and are hashed from cell ids with
+ * FPTPHash, so any direction's value depends only on the seed and the crust state -- tiles can be
+ * amplified independently, in any order and in parallel, and always agree on shared edges.
+ * Each impulse takes its frequency, amplitude and orientation from the crust sampled at the impulse:
+ * the cosine runs across RidgeDirection (abyssal hills parallel to the ridge), with wavelength
+ * growing and amplitude decaying with OceanicAge.
+ *
+ * Evaluation builds an impulse table for the cells a batch touches (one sampler call), packs each
+ * cell's 3x3 neighbourhood into a padded SoA block, and sums four impulses per iteration with
+ * VectorRegister4Float Gaussian/cosine kernels.
+ */
+class GAIAPTP_API FPTPGaborAmplifier
+{
+public:
+    FPTPGaborAmplifier(const FPTPGaborParams& InParams, FPTPCrustSampler InSampler);
+
+    /**
+     * Gabor detail (km) at each direction.
+     *
+     * @param Directions - Unit directions (input)
+     * @param OutDetailKm - Detail height per direction (output, must match Directions.Num())
+     * @param bParallel - Split the batch across workers; tile drivers pass false and parallelize over tiles
+     */
+    void Evaluate(TConstArrayView<FVector3f> Directions, TArrayView<float> OutDetailKm, bool bParallel = true) const;
+
+    /** Scalar reference for Evaluate, one impulse at a time. Used by tests. */
+    void EvaluateScalar(TConstArrayView<FVector3f> Directions, TArrayView<float> OutDetailKm) const;
+
+    /**
+     * Amplified elevation for one tile: coarse elevation plus Gabor detail.
+     *
+     * @param Tile - Region to amplify (input)
+     * @param OutElevationKm - Resolution^2 heights, row-major (output)
+     */
+    void AmplifyTile(const FPTPAmplifyTile& Tile, TArray<float>& OutElevationKm) const;
+
+    /** AmplifyTile over many tiles, parallel across tiles (honours ptp.parallel). */
+    void AmplifyTiles(TConstArrayView<FPTPAmplifyTile> Tiles, TArray<TArray<float>>& OutElevationKm) const;
+
+    int32 GetCellResolution() const { return CellResolution; }
+
+private:
+    /** Impulses of a set of cells, SoA, with kernel parameters already resolved. */
+    struct FImpulseTable
+    {
+        TMap<int32, int32> CellToFirst;   // cell id -> first impulse index (ImpulsesPerCell consecutive)
+        TArray<float> PX, PY, PZ;         // position, km
+        TArray<float> WX, WY, WZ;         // wave vector, radians per km
+        TArray<float> Phase;
+        TArray<float> Amplitude;
+    };
+
+    /** Neighbourhood impulses for one home cell, padded to a multiple of four with zero amplitude. */
+    struct FBlock
+    {
+        int32 First = 0;
+        int32 Num = 0;
+    };
+
+    void BuildTable(TConstArrayView<int32> Cells, FImpulseTable& OutTable) const;
+    void BuildBlocks(const FImpulseTable& Table, TConstArrayView<int32> HomeCells, TMap<int32, int32>& OutCellToBlock,
+                     TArray<FBlock>& OutBlocks, FImpulseTable& OutPacked) const;
+    float EvaluateBlock(const FImpulseTable& Packed, const FBlock& Block, const FVector3f& PositionKm) const;
+
+    FPTPGaborParams Params;
+    FPTPCrustSampler Sampler;
+    int32 CellResolution = 1;
+    float EnvelopeA2Pi = 0.0f;   // PI * a^2 with a = Sharpness / CellSizeKm
+    float Normalization = 1.0f;
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PTPCrustSample.h"
+#include "PTPCubeMap.h"
+
+class FPTPCraterField;
+class FPTPExemplarSynthesizer;
+class FPTPGaborAmplifier;
+
+/** Elevation in km for every texel of a tile, row-major (Resolution^2 values). Called concurrently for different tiles. */
+using FPTPHeightSource = TFunction<void(const FPTPAmplifyTile& Tile, TArray<float>& OutElevationKm)>;
+
+/** Elevation in km at scattered unit directions, for mesh vertices rather than texels. Batches can be any size. */
+using FPTPPointHeightSource = TFunction<void(TConstArrayView<FVector3f> Directions, TArrayView<float> OutElevationKm)>;
+
+/** Factories for height sources over a planet's coarse or amplified elevation. */
+class GAIAPTP_API FPTPHeightSources
+{
+public:
+    /** Coarse elevation through a crust sampler, e.g. FPTPCrustSampling::MakeBarycentricSampler. */
+    static FPTPHeightSource MakeCoarse(FPTPCrustSampler Sampler);
+
+    /** Coarse elevation plus oceanic Gabor detail. */
+    static FPTPHeightSource MakeGabor(TSharedRef<const FPTPGaborAmplifier> Amplifier);
+
+    /** Coarse elevation with exemplar-synthesized continental relief. */
+    static FPTPHeightSource MakeExemplar(TSharedRef<const FPTPExemplarSynthesizer> Synthesizer);
+
+    /** Another source plus procedural crater relief, down to craters two texels across. */
+    static FPTPHeightSource MakeCratered(FPTPHeightSource Base, TSharedRef<const FPTPCraterField> Field);
+
+    /** Coarse elevation at points. */
+    static FPTPPointHeightSource MakeCoarsePoints(FPTPCrustSampler Sampler);
+
+    /** Coarse elevation plus oceanic Gabor detail at points; Sampler should be the one the amplifier was built with. */
+    static FPTPPointHeightSource MakeGaborPoints(FPTPCrustSampler Sampler, TSharedRef<const FPTPGaborAmplifier> Amplifier);
+
+    /** Another point source plus crater relief, skipping craters narrower than MinDiameterKm. */
+    static FPTPPointHeightSource MakeCrateredPoints(FPTPPointHeightSource Base, TSharedRef<const FPTPCraterField> Field, float MinDiameterKm = 0.0f);
+};
+
+enum class EPTPHeightfieldFormat : uint8
+{
+    Png16,   // 16-bit grayscale PNG
+    Raw16    // headerless little-endian uint16, as Landscape imports .r16
+};
+
+/** What to bake and where. Tiles share their edge texels, so a face is TilesPerFace * (TileResolution - 1) + 1 texels across. */
+struct FPTPBakeSettings
+{
+    int32 TilesPerFace = 4;
+    int32 TileResolution = 1009;                 // 63 * 16 + 1: a whole number of Landscape components
+    EPTPHeightfieldFormat Format = EPTPHeightfieldFormat::Png16;
+
+    /** Elevation range mapped onto 0..65535; fixed up front since tiles are written before the whole planet is seen. */
+    float MinElevationKm = -11.0f;
+    float MaxElevationKm = 9.0f;
+
+    float PlanetRadiusKm = 6370.0f;
+    FString OutputDir;
+    FString BaseName = TEXT("Planet");
+
+    /** Faces to bake, 0-5 (+X, -X, +Y, -Y, +Z, -Z); empty bakes all six. */
+    TArray<int32> Faces;
+
+    /** Tiles held in memory at once; 0 uses one per worker thread. */
+    int32 MaxTilesInFlight = 0;
+
+    int32 GetFaceResolution() const { return TilesPerFace * (TileResolution - 1) + 1; }
+};
+
+/** One written tile. */
+struct FPTPBakedTile
+{
+    int32 Face = 0;
+    int32 TileX = 0;
+    int32 TileY = 0;
+    FString File;              // relative to the manifest
+    float MinKm = 0.0f;        // elevation range actually found in the tile
+    float MaxKm = 0.0f;
+    int32 NumClamped = 0;      // texels outside the bake range
+};
+
+/** JSON description of a bake: layout, quantization and the tile files, next to the tiles. */
+struct GAIAPTP_API FPTPBakeManifest
+{
+    int32 TilesPerFace = 0;
+    int32 TileResolution = 0;
+    EPTPHeightfieldFormat Format = EPTPHeightfieldFormat::Png16;
+    float MinElevationKm = 0.0f;
+    float MaxElevationKm = 0.0f;
+    float PlanetRadiusKm = 0.0f;
+    TArray<FPTPBakedTile> Tiles;
+
+    /** Km between neighbouring texels along a face edge (mean over the equi-angular grid). */
+    float GetTexelSpacingKm() const { return HALF_PI * PlanetRadiusKm / FMath::Max(TilesPerFace * (TileResolution - 1), 1); }
+
+    const FPTPBakedTile* FindTile(int32 Face, int32 TileX, int32 TileY) const;
+
+    bool Save(const FString& Path, FString& OutError) const;
+    static bool Load(const FString& Path, FPTPBakeManifest& OutManifest, FString& OutError);
+};
+
+/**
+ * Rasterizes an elevation field onto the six cube faces (FPTPCubeMap) and streams it to disk as
+ * 16-bit tiles with a JSON manifest.
+ *
+ * Tiles are produced in parallel waves of MaxTilesInFlight; each tile is quantized and written as
+ * soon as it is done and then dropped, so memory stays at a few tiles however large the bake -- a
+ * 6 x 16k^2 bake (TilesPerFace 16, TileResolution 1009) never holds more than the tiles in flight.
+ */
+class GAIAPTP_API FPTPHeightfieldBaker
+{
+public:
+    /**
+     * Bake every selected tile.
+     *
+     * @param Source - Height source (input)
+     * @param Settings - Layout, range and output location (input)
+     * @param OutManifest - Description of the written tiles, also saved as <OutputDir>/<BaseName>.json (output)
+     * @param OutError - Reason for a failure (output)
+     * @param IsCancelled - Polled between waves (input)
+     * @return true if every tile and the manifest were written
+     */
+    static bool Bake(const FPTPHeightSource& Source, const FPTPBakeSettings& Settings, FPTPBakeManifest& OutManifest, FString& OutError,
+                     TFunctionRef<bool()> IsCancelled = [] { return false; });
+
+    /** Map an elevation onto 0..65535 over [MinKm, MaxKm], clamping outside. */
+    static uint16 Quantize(float ElevationKm, float MinKm, float MaxKm);
+    static float Dequantize(uint16 Value, float MinKm, float MaxKm);
+
+    /** Encode Resolution^2 heights in Format. */
+    static bool EncodeTile(TConstArrayView<uint16> Heights, int32 Resolution, EPTPHeightfieldFormat Format, TArray64<uint8>& OutBytes);
+
+    /** Read a tile written by Bake back into Resolution^2 heights. */
+    static bool ReadTile(const FString& Path, int32 Resolution, EPTPHeightfieldFormat Format, TArray<uint16>& OutHeights);
+
+    static const TCHAR* GetExtension(EPTPHeightfieldFormat Format);
+};
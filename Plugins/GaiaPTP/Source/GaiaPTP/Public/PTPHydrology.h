@@ -0,0 +1,111 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FPTPAdjacency;
+class FPTPStepScratch;
+
+/** Drainage settings (Documentation/Research/RTHAP/Implementation_Guide.md, 1.4 River Network Generation). */
+struct FPTPHydrologyParams
+{
+    /** Vertices at or below sea level are ocean: they take in flow and pass it nowhere. */
+    float SeaLevelKm = 0.0f;
+
+    /** Flow at which a channel becomes a river. With the default unit runoff, the number of vertices drained. */
+    float RiverThreshold = 100.0f;
+
+    /**
+     * Vertices per depression-filling region. Regions of consecutive indices are flooded in
+     * parallel and stitched through their spill points, so the mesh should be Hilbert-ordered
+     * (PTPSpatialOrder.h) for regions to be compact. The result does not depend on the size.
+     */
+    int32 FloodRegionSize = 64 * 1024;
+};
+
+/** A river reach: a run of receivers from a source or confluence down to the next confluence or the sea. */
+struct FPTPRiverReach
+{
+    int32 First = 0;                  // into FPTPDrainage::RiverVertices
+    int32 Num = 0;
+    int32 StrahlerOrder = 1;
+    int32 Downstream = INDEX_NONE;    // reach starting at this one's last vertex; INDEX_NONE at the sea or an inland sink
+};
+
+/** Drainage of a planet's surface. Per-vertex arrays are indexed like the mesh. */
+struct GAIAPTP_API FPTPDrainage
+{
+    TArray<float> FilledElevationKm;  // depressions raised to their spill level
+    TArray<int32> Receivers;          // steepest descent on the filled surface, INDEX_NONE for ocean and sinks
+    TArray<float> Flow;               // runoff of the vertex and everything upstream of it
+    TArray<uint8> StrahlerOrder;      // Horton-Strahler order of river vertices, 0 elsewhere
+
+    /** Every vertex after its receiver, grouped by steps to the outlet: level k is Order[LevelOffsets[k] .. LevelOffsets[k + 1]). */
+    TArray<int32> Order;
+    TArray<int32> LevelOffsets;
+
+    TArray<FPTPRiverReach> Reaches;
+    TArray<int32> RiverVertices;      // reach polylines, upstream to downstream; a reach ends on the vertex the next one starts from
+
+    int32 NumFilledVertices = 0;      // land raised by depression filling
+
+    TConstArrayView<int32> GetReachVertices(int32 Reach) const
+    {
+        return TConstArrayView<int32>(RiverVertices.GetData() + Reaches[Reach].First, Reaches[Reach].Num);
+    }
+
+    SIZE_T GetAllocatedSize() const;
+};
+
+/**
+ * Drainage network of the planet mesh: depression filling, flow directions, flow accumulation and
+ * river reaches, on the CSR adjacency (PTPAdjacency.h).
+ *
+ * Every pass is parallel (honours ptp.parallel) and deterministic: results are bit-identical for
+ * any thread count and any FloodRegionSize.
+ *  - Depressions are filled with the improved priority-flood of Barnes et al., per region of
+ *    FloodRegionSize consecutive vertices. Region borders are provisional outlets, each labelled
+ *    with its own watershed; a small priority-flood over the spill graph of those watersheds then
+ *    gives every watershed its true water level (Barnes 2016, "Parallel priority-flood").
+ *  - Receivers are the steepest descent on the filled surface. Filled flats have no descent and
+ *    drain along a breadth-first search towards their spill points.
+ *  - Accumulation runs over the receiver tree level by level from the sources down: a vertex sums
+ *    its donors in ascending order, so floating-point sums do not depend on scheduling.
+ */
+class GAIAPTP_API FPTPHydrology
+{
+public:
+    /**
+     * Full drainage of a mesh.
+     *
+     * @param Adjacency - Mesh neighbours (input)
+     * @param Points - Vertex positions, any radius (input)
+     * @param ElevationKm - Surface elevation relative to sea level (input)
+     * @param Runoff - Water each vertex contributes, or empty for 1 everywhere (input)
+     * @param Params - Sea level, river threshold and flood region size (input)
+     * @param Out - Drainage, all arrays resized to the vertex count (output)
+     * @param Scratch - Step scratch for the transient buffers; a private one when null (input)
+     */
+    static void Compute(const FPTPAdjacency& Adjacency, TConstArrayView<FVector3f> Points, TConstArrayView<float> ElevationKm,
+                        TConstArrayView<float> Runoff, const FPTPHydrologyParams& Params, FPTPDrainage& Out,
+                        FPTPStepScratch* Scratch = nullptr);
+
+    /**
+     * Raise every land depression to the level where it spills towards the ocean. Without ocean
+     * the lowest vertex is the outlet. With RegionSize >= the vertex count this is the classic
+     * single-queue priority-flood.
+     *
+     * @param OutFilledKm - Filled elevation (output)
+     * @return Number of land vertices raised
+     */
+    static int32 FillDepressions(const FPTPAdjacency& Adjacency, TConstArrayView<float> ElevationKm, float SeaLevelKm,
+                                 int32 RegionSize, TArray<float>& OutFilledKm, FPTPStepScratch* Scratch = nullptr);
+
+    /**
+     * Steepest-descent receiver of every land vertex on a filled surface; flats drain towards
+     * their spill points. Ocean vertices, and land with nowhere lower to go, get INDEX_NONE.
+     *
+     * @param OutReceivers - Receiver per vertex (output)
+     */
+    static void ComputeReceivers(const FPTPAdjacency& Adjacency, TConstArrayView<FVector3f> Points, TConstArrayView<float> FilledKm,
+                                 float SeaLevelKm, TArray<int32>& OutReceivers);
+};
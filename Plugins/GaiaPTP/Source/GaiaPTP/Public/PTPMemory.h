@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+// LLM tag for planet state, rebuild scratch and preview meshes; see `stat LLMFULL`
+LLM_DECLARE_TAG_API(GaiaPTP, GAIAPTP_API);
+
+/** What the bytes of a planet are spent on; one `stat GaiaPTP` counter each. */
+enum class EPTPMemoryBucket : uint8
+{
+    SamplePoints,   // SamplePoints, SampleOrder
+    PlateIds,       // PointPlateIds, plate membership
+    CrustData,
+    Boundaries,     // IsBoundaryPoint, BoundaryTypes, DistanceToFrontKm
+    Neighbors,
+    Triangles,
+    Plates,
+    MeshStreams,    // CPU copy of the preview streams, all LODs
+    Chunks,         // chunk partition and vertex -> sample layouts of the preview
+    Scratch,        // arenas kept warm for the rebuild kernels (FPTPStepScratch)
+
+    Num
+};
+
+/** Allocated bytes per bucket for one planet. */
+struct GAIAPTP_API FPTPMemoryReport
+{
+    SIZE_T Bytes[(int32)EPTPMemoryBucket::Num] = {};
+
+    SIZE_T& operator[](EPTPMemoryBucket Bucket) { return Bytes[(int32)Bucket]; }
+    SIZE_T operator[](EPTPMemoryBucket Bucket) const { return Bytes[(int32)Bucket]; }
+
+    SIZE_T GetTotal() const;
+    FPTPMemoryReport& operator+=(const FPTPMemoryReport& Other);
+};
+
+/** Memory accounting shared by the planet component and actor. */
+class GAIAPTP_API FPTPMemory
+{
+public:
+    static const TCHAR* GetBucketName(EPTPMemoryBucket Bucket);
+
+    /** Allocated bytes of a nested array, outer and inner. */
+    static SIZE_T GetAllocatedSize(const TArray<TArray<int32>>& Nested);
+
+    /**
+     * Move the `stat GaiaPTP` counters from what an owner reported last to its current report.
+     * The counters are totals over all planets, so each owner keeps the report it contributed.
+     *
+     * @param InOutReported - Report this owner contributed so far; replaced by Current (input/output)
+     * @param Current - Report to contribute now; empty to withdraw the owner (input)
+     */
+    static void UpdateStats(FPTPMemoryReport& InOutReported, const FPTPMemoryReport& Current);
+
+    /** Per-planet budget from UGaiaPTPSettings::MemoryBudgetMB; 0 when unlimited. */
+    static SIZE_T GetBudgetBytes();
+
+    /**
+     * Warn when a planet exceeds the budget, naming its largest buckets.
+     *
+     * @param Report - Bytes held by the planet (input)
+     * @param Owner - Name used in the warning (input)
+     * @return False if over budget
+     */
+    static bool CheckBudget(const FPTPMemoryReport& Report, const FString& Owner);
+
+    /** Log one table row per bucket, with bytes per sample when NumSamples > 0. */
+    static void LogReport(const FPTPMemoryReport& Report, int32 NumSamples);
+};
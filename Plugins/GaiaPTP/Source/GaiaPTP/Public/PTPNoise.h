@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Which composite FPTPNoise evaluates. */
+enum class EPTPNoiseType : uint8
+{
+    Simplex,    // single octave, range ~[-1,1]
+    Fbm,        // fractional Brownian motion, range ~[-1,1]
+    Ridged      // sum of (1-|n|)^2 octaves, range [0,1]
+};
+
+/** Octave and domain-warp configuration. Frequencies are in cycles per input unit. */
+struct FPTPNoiseSettings
+{
+    float Frequency = 1.0f;
+    int32 Octaves = 4;
+    float Lacunarity = 2.0f;
+    float Gain = 0.5f;
+
+    /** Domain-warp displacement in input units; 0 disables warping. */
+    float WarpAmplitude = 0.0f;
+    float WarpFrequency = 1.0f;
+};
+
+/**
+ * Seeded 3D simplex noise with fBm / ridged composites and analytic gradients.
+ *
+ * The scalar functions are the reference; EvaluateBatch runs the same arithmetic four lanes at a
+ * time with VectorRegister4Float and chunks the array across workers, so results agree with the
+ * scalar path to float rounding. Gradients are with respect to the input position (including
+ * frequency scaling and the domain warp Jacobian) and can be used directly for normals.
+ */
+class GAIAPTP_API FPTPNoise
+{
+public:
+    explicit FPTPNoise(int32 Seed = 0);
+
+    /** Single simplex octave at P. */
+    float Simplex(const FVector3f& P, FVector3f* OutGradient = nullptr) const;
+
+    /** Scalar reference for one position, including domain warping. */
+    float Evaluate(EPTPNoiseType Type, const FVector3f& P, const FPTPNoiseSettings& Settings, FVector3f* OutGradient = nullptr) const;
+
+    /**
+     * Evaluate noise for every position (parallel over chunks, honours ptp.parallel).
+     *
+     * @param Type - Composite to evaluate (input)
+     * @param Positions - Sample positions (input)
+     * @param Settings - Octave/warp configuration (input)
+     * @param OutValues - One value per position (output, must match Positions.Num())
+     * @param OutGradients - Optional gradient per position; pass an empty view to skip (output)
+     */
+    void EvaluateBatch(EPTPNoiseType Type, TConstArrayView<FVector3f> Positions, const FPTPNoiseSettings& Settings,
+                       TArrayView<float> OutValues, TArrayView<FVector3f> OutGradients = TArrayView<FVector3f>()) const;
+
+private:
+    /** Evaluate lanes [Index, Index+4) of Positions; shared by EvaluateBatch chunks. */
+    void EvaluateLanes(EPTPNoiseType Type, const FVector3f* Positions, const FPTPNoiseSettings& Settings, float* OutValues, FVector3f* OutGradients) const;
+
+    float Octaves(EPTPNoiseType Type, const FVector3f& P, const FPTPNoiseSettings& Settings, FVector3f& OutGradient) const;
+
+    uint8 Perm[512];
+};
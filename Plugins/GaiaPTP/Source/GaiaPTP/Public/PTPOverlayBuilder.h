@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FPTPLayerSource;
+
+namespace RealtimeMesh
+{
+    struct FRealtimeMeshStreamSet;
+}
+
+/** One velocity arrow: a tangent velocity (mm/yr) at a sample position (km). */
+struct FPTPOverlayArrow
+{
+    FVector3f Origin;
+    FVector3f Velocity;
+};
+
+/** One boundary line segment between two sample positions (km). */
+struct FPTPOverlaySegment
+{
+    FVector3f A;
+    FVector3f B;
+    FColor Color;
+};
+
+/** Shape and placement of overlay ribbons, in km before the visualization scale. */
+struct FPTPOverlayStyle
+{
+    float Width = 20.0f;            // ribbon width; arrow heads are twice as wide
+    float Lift = 5.0f;              // radial offset above the surface
+    float KmPerMmPerYear = 5.0f;    // arrow length per unit of plate speed
+    float MaxSpeedMmPerYear = 100.0f;
+};
+
+/**
+ * Batched line/arrow geometry for the debug overlays.
+ *
+ * Overlays are flat ribbons lying in the tangent plane, one section group per layer, so a layer
+ * refresh replaces a single stream set instead of issuing per-line debug draws. Gathering reads
+ * planet data and belongs on the game thread; Build* only read the gathered arrays and are meant
+ * to run on a worker.
+ */
+class GAIAPTP_API FPTPOverlayBuilder
+{
+public:
+    /**
+     * Pick the arrow stride for a camera distance so about TargetArrows arrows fall inside the
+     * visible cap. Rounded down to a power of two so small camera moves do not trigger rebuilds.
+     *
+     * @param NumPoints - Number of samples (input)
+     * @param CameraDistance - Camera distance from the planet centre, any unit (input)
+     * @param Radius - Planet radius in the same unit (input)
+     * @param TargetArrows - Arrows wanted on screen (input)
+     */
+    static int32 ChooseArrowStride(int32 NumPoints, double CameraDistance, double Radius, int32 TargetArrows);
+
+    /**
+     * One arrow per Stride-th sample with its plate's velocity; samples without a plate are skipped.
+     *
+     * @param Source - Planet data; needs PlateIds and Plates (input)
+     * @param Stride - Sample step, from ChooseArrowStride (input)
+     * @param ViewDir - Unit direction from the planet centre to the camera (input)
+     * @param MinCos - Samples whose direction is further than acos(MinCos) from ViewDir are skipped; -1 keeps all (input)
+     * @param OutArrows - Arrows (output)
+     */
+    static void GatherVelocityArrows(const FPTPLayerSource& Source, int32 Stride, const FVector3f& ViewDir, float MinCos,
+                                     TArray<FPTPOverlayArrow>& OutArrows);
+
+    /**
+     * Boundary outline: a segment between every pair of adjacent boundary points on the same plate,
+     * coloured by the boundary type of its first point.
+     *
+     * @param Source - Planet data; needs PlateIds and BoundaryTypes (input)
+     * @param Neighbors - Adjacency list for each point (input)
+     * @param OutSegments - Segments, each edge once (output)
+     */
+    static void GatherBoundarySegments(const FPTPLayerSource& Source, const TArray<TArray<int32>>& Neighbors, TArray<FPTPOverlaySegment>& OutSegments);
+
+    /** Arrow ribbons (3 triangles each) coloured by speed through the scalar ramp. */
+    static void BuildArrows(TConstArrayView<FPTPOverlayArrow> Arrows, const FPTPOverlayStyle& Style, float Scale,
+                            RealtimeMesh::FRealtimeMeshStreamSet& OutStreams);
+
+    /** Segment ribbons (2 triangles each). */
+    static void BuildSegments(TConstArrayView<FPTPOverlaySegment> Segments, const FPTPOverlayStyle& Style, float Scale,
+                              RealtimeMesh::FRealtimeMeshStreamSet& OutStreams);
+};
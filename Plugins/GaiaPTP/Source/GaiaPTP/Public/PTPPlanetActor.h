@@ -2,10 +2,19 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "PTPPlanetMeshBuilder.h"
+#include "PTPPlanetChunks.h"
+#include "PTPMemory.h"
+#include "PTPVisualizationLayers.h"
+#include "PTPPlanetRebuild.h"
 #include "PTPPlanetActor.generated.h"
 
 class URealtimeMeshComponent;
 class UPTPPlanetComponent;
+class URealtimeMeshSimple;
+class UMaterialInstanceDynamic;
+class UInstancedStaticMeshComponent;
+class SNotificationItem;
 
 UENUM(BlueprintType)
 enum class EPTPPreviewMode : uint8
@@ -14,6 +23,17 @@ enum class EPTPPreviewMode : uint8
     Surface  UMETA(DisplayName = "Surface")
 };
 
+/** Mesh data that must be re-sent to the RMC. Anything short of Geometry is edited in place. */
+enum class EPTPMeshDirtyFlags : uint8
+{
+    None     = 0,
+    Geometry = 1 << 0,   // positions, tangents and indices: full section group rebuild (instance transforms in Points mode)
+    Color    = 1 << 1,   // colour layer (plate colours unless a colour visualization layer is shown)
+    Scalar   = 1 << 2,   // elevation (km) in TexCoord0.U and the scalar visualization layer in TexCoord0.V
+    All      = Geometry | Color | Scalar
+};
+ENUM_CLASS_FLAGS(EPTPMeshDirtyFlags);
+
 /** Actor that hosts the planet component and an RMC for visualization. */
 UCLASS()
 class GAIAPTP_API APTPPlanetActor : public AActor
@@ -22,6 +42,27 @@ class GAIAPTP_API APTPPlanetActor : public AActor
 public:
     APTPPlanetActor();
 
+    /** Flag mesh attributes as stale (e.g. after a simulation step changed plate ids or elevations). */
+    void MarkMeshDirty(EPTPMeshDirtyFlags Flags) { DirtyFlags |= Flags; }
+
+    /**
+     * Push pending mesh changes. Rebuilds the section group if geometry is dirty or the resident
+     * group no longer matches the preview settings; otherwise only the dirty attribute streams are
+     * rewritten in place and uploaded, leaving positions, tangents and indices resident.
+     */
+    void RefreshMesh();
+
+    /** Show another visualization layer; only the colour or scalar stream it is encoded in is re-uploaded. */
+    UFUNCTION(BlueprintCallable, Category="PTP|Preview")
+    void SetVisualizationLayer(EPTPVisualizationLayer Layer);
+
+    UPTPPlanetComponent* GetPlanet() const { return Planet; }
+
+    /** Allocated bytes of the planet state plus the resident preview. */
+    FPTPMemoryReport GetMemoryReport() const;
+
+    virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
 protected:
     UPROPERTY(VisibleAnywhere, Category="PTP")
     URealtimeMeshComponent* RealtimeMesh;
@@ -29,15 +70,43 @@ protected:
     UPROPERTY(VisibleAnywhere, Category="PTP")
     UPTPPlanetComponent* Planet;
 
+    // Points preview: one instanced quad per drawn sample, coloured through per-instance custom data
+    UPROPERTY(VisibleAnywhere, Category="PTP")
+    UInstancedStaticMeshComponent* PointInstances;
+
     // Preview mode selector for editor visualization
     UPROPERTY(EditAnywhere, Category="PTP|Preview")
     EPTPPreviewMode PreviewMode = EPTPPreviewMode::Surface;
 
-    // Material to use for planet rendering (should use vertex colors)
+    // Material to use for planet rendering (should use vertex colors and be two-sided)
     UPROPERTY(EditAnywhere, Category="PTP|Preview")
     class UMaterialInterface* PlanetMaterial;
 
-    // Build/refresh CGAL adjacency (triangles & neighbors). Exposed as an editor button.
+    // Material for the Points preview; reads the layer colour from PerInstanceCustomData 0-2 and the normalized scalar from 3
+    UPROPERTY(EditAnywhere, Category="PTP|Preview")
+    class UMaterialInterface* PointMaterial;
+
+    // Quantity shown on the preview. Scalar layers need a material reading TexCoord0.V through its ramp when PTPScalarLayer is 1
+    UPROPERTY(EditAnywhere, Category="PTP|Preview")
+    EPTPVisualizationLayer VisualizationLayer = EPTPVisualizationLayer::PlateId;
+
+    // Split the surface into cube-face chunks and hide those behind the horizon or outside the view frustum
+    UPROPERTY(EditAnywhere, Category="PTP|Preview")
+    bool bChunkCulling = true;
+
+    // Quadtree depth per cube face; the surface is drawn as 6 * 4^ChunkLevel sections
+    UPROPERTY(EditAnywhere, Category="PTP|Preview", meta=(ClampMin="0", ClampMax="5", EditCondition="bChunkCulling"))
+    int32 ChunkLevel = 2;
+
+    // Simplified surface LODs generated after the full-resolution mesh; 0 disables the LOD chain
+    UPROPERTY(EditAnywhere, Category="PTP|Preview", meta=(ClampMin="0", ClampMax="7"))
+    int32 NumSimplifiedLODs = 3;
+
+    // Screen-space error (pixels at 1080p) a simplified LOD may show before it is selected
+    UPROPERTY(EditAnywhere, Category="PTP|Preview", meta=(ClampMin="0.1", EditCondition="NumSimplifiedLODs > 0"))
+    float LODPixelError = 1.0f;
+
+    // Rebuild the planet with CGAL adjacency (triangles & neighbors) in the background. Exposed as an editor button.
     UFUNCTION(CallInEditor, Category="PTP|Preview")
     void BuildAdjacency();
 
@@ -47,7 +116,52 @@ protected:
 
     virtual void OnConstruction(const FTransform& Transform) override;
     virtual void BeginPlay() override;
+    virtual void Tick(float DeltaSeconds) override;
+    virtual void BeginDestroy() override;
 
 private:
     void RebuildMesh();
+    void UpdateMeshAttributes(EPTPMeshDirtyFlags Flags);
+    bool IsGeometryResident() const;
+    void UpdateChunkVisibility();
+    void BuildSurfaceLODs(URealtimeMeshSimple* RMSimple, const RealtimeMesh::FRealtimeMeshStreamSet& Streams);
+    void FillAttributes(EPTPMeshDirtyFlags Flags, const FPTPPlanetMeshLayout& Layout, RealtimeMesh::FRealtimeMeshStream* ColorStream,
+                        RealtimeMesh::FRealtimeMeshStream* TexCoordStream) const;
+    void ApplyLayerMaterialParameters();
+    void RebuildPointInstances();
+    void UpdatePointInstanceData();
+    void RequestRebuild();
+    void HandleRebuildProgress(EPTPRebuildStage Stage, float Progress);
+    void HandleRebuildCompleted(bool bSucceeded);
+    FPTPMemoryReport GetPreviewMemoryReport() const;
+    void UpdateMemoryStats();
+
+    // Instance of PlanetMaterial carrying the layer parameters
+    UPROPERTY(Transient)
+    UMaterialInstanceDynamic* PlanetMaterialInstance = nullptr;
+
+    EPTPMeshDirtyFlags DirtyFlags = EPTPMeshDirtyFlags::All;
+
+    // Settings the resident section group was built with; a mismatch forces a geometry rebuild
+    EPTPPreviewMode ResidentMode = EPTPPreviewMode::Surface;
+    FPTPPlanetMeshLayout ResidentLayout;
+    float ResidentScale = 0.0f;
+    uint32 ResidentGeometryHash = 0;   // FPTPStageHashes::GetGeometryHash of the planet data the geometry was built from
+    int32 ResidentChunkLevel = INDEX_NONE;   // INDEX_NONE when the surface is a single section
+    int32 ResidentSimplifiedLODs = 0;
+    float ResidentLODPixelError = 0.0f;
+    TArray<FPTPPlanetMeshLayout> ResidentLODLayouts;   // layouts of LOD 1..N, vertices mapped back to samples
+    SIZE_T ResidentMeshBytes = 0;   // CPU copy of the surface streams over all LODs; the GPU holds another
+
+    // What this actor last added to the `stat GaiaPTP` counters; the planet component reports its own arrays
+    FPTPMemoryReport ReportedMemory;
+
+    // Chunk membership is kept across rebuilds and only recomputed when the triangulation changes
+    FPTPPlanetChunks Chunks;
+    TBitArray<> ChunkVisible;
+
+#if WITH_EDITOR
+    // Progress toast for the rebuild in flight
+    TWeakPtr<SNotificationItem> RebuildNotification;
+#endif
 };
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FConvexVolume;
+
+/** Bounds of one chunk in mesh-local units: a cap on the planet sphere and a sphere enclosing it. */
+struct FPTPChunkBounds
+{
+    FVector3f Axis = FVector3f::UnitZ();   // unit direction of the cap centre
+    float CosHalfAngle = 1.0f;             // angular radius of the cap, seen from the planet centre
+    float SinHalfAngle = 0.0f;
+    FVector3f SphereCenter = FVector3f::ZeroVector;
+    float SphereRadius = 0.0f;
+};
+
+/**
+ * Cube-face quadtree partition of the surface triangulation for per-chunk culling.
+ *
+ * Each triangle goes to the leaf (cube-map cell at 2^Level per face edge) containing its centroid;
+ * triangles are then ordered by chunk so every chunk is one contiguous index range and can be
+ * drawn as its own RMC section. Membership depends only on the points and triangles, so it is
+ * built once and reused until the triangulation changes.
+ */
+class GAIAPTP_API FPTPPlanetChunks
+{
+public:
+    /**
+     * Partition the triangulation.
+     *
+     * @param Points - Sample positions, all at the planet radius (input)
+     * @param Triangles - Triangulation of Points (input)
+     * @param Level - Quadtree depth per cube face; 6 * 4^Level chunks (input)
+     * @param Scale - Scale applied to Points by the mesh, so bounds are in mesh-local units (input)
+     */
+    void Build(const TArray<FVector3f>& Points, const TArray<FIntVector>& Triangles, int32 Level, float Scale);
+
+    void Reset();
+
+    /** Whether Build was last called with a matching triangulation size and settings. */
+    bool IsBuiltFor(int32 NumPoints, int32 NumTriangles, int32 Level, float Scale) const;
+
+    int32 GetNumChunks() const { return Bounds.Num(); }
+    int32 GetLevel() const { return BuiltLevel; }
+    SIZE_T GetAllocatedSize() const { return TriangleOrder.GetAllocatedSize() + ChunkStart.GetAllocatedSize() + Bounds.GetAllocatedSize(); }
+
+    /** Triangle indices sorted by chunk; chunk C owns [GetChunkBegin(C), GetChunkEnd(C)). */
+    TConstArrayView<int32> GetTriangleOrder() const { return TriangleOrder; }
+    int32 GetChunkBegin(int32 Chunk) const { return ChunkStart[Chunk]; }
+    int32 GetChunkEnd(int32 Chunk) const { return ChunkStart[Chunk + 1]; }
+    const FPTPChunkBounds& GetBounds(int32 Chunk) const { return Bounds[Chunk]; }
+
+    /** True if any part of the chunk's cap can be seen over the horizon from CameraLocal. */
+    bool IsAboveHorizon(int32 Chunk, const FVector& CameraLocal) const;
+
+    /**
+     * Horizon test per chunk, plus a frustum test of the enclosing sphere when a frustum is given.
+     *
+     * @param CameraLocal - Camera position in mesh-local units (input)
+     * @param FrustumLocal - View frustum in mesh-local units, or null to skip (input)
+     * @param OutVisible - One bit per chunk (output)
+     */
+    void ComputeVisibility(const FVector& CameraLocal, const FConvexVolume* FrustumLocal, TBitArray<>& OutVisible) const;
+
+private:
+    TArray<int32> TriangleOrder;
+    TArray<int32> ChunkStart;       // NumChunks + 1 offsets into TriangleOrder
+    TArray<FPTPChunkBounds> Bounds;
+    float Radius = 0.0f;            // planet radius in mesh-local units
+
+    int32 BuiltLevel = INDEX_NONE;
+    int32 BuiltNumPoints = 0;
+    int32 BuiltNumTriangles = 0;
+    float BuiltScale = 0.0f;
+};
@@ -2,8 +2,17 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "TectonicTypes.h"
+#include "PTPPlanetRebuild.h"
+#include "PTPMemory.h"
+#include "PTPArena.h"
+#include "Async/Future.h"
+#include "HAL/ThreadSafeCounter.h"
 #include "PTPPlanetComponent.generated.h"
 
+DECLARE_MULTICAST_DELEGATE_TwoParams(FPTPRebuildProgressDelegate, EPTPRebuildStage /*Stage*/, float /*Progress*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FPTPRebuildCompletedDelegate, bool /*bSucceeded*/);
+
 /** Component holding per-planet settings and data; prefers actor-local overrides. */
 UCLASS(ClassGroup=(Gaia), meta=(BlueprintSpawnableComponent))
 class GAIAPTP_API UPTPPlanetComponent : public UActorComponent
@@ -27,6 +36,10 @@ public:
     UPROPERTY(EditAnywhere, Category="PTP|Sampling")
     int32 NumSamplePoints;
 
+    // Store samples grouped by plate, each plate in cube-map Hilbert order, so plates and mesh neighbours sit close in memory
+    UPROPERTY(EditAnywhere, Category="PTP|Sampling")
+    bool bSpatialReorder;
+
     UPROPERTY(EditAnywhere, Category="PTP|Sampling", meta=(ClampMin="1"))
     int32 DebugDrawStride;
 
@@ -36,6 +49,10 @@ public:
     UPROPERTY(EditAnywhere, Category="PTP|Plates", meta=(ClampMin="0.0", ClampMax="1.0"))
     float ContinentalRatio;
 
+    // Seed for plate placement and crust noise
+    UPROPERTY(EditAnywhere, Category="PTP|Plates")
+    int32 InitialSeed;
+
     // --- Elevations (km) ---
     UPROPERTY(EditAnywhere, Category="PTP|Elevations")
     float HighestOceanicRidgeElevationKm;
@@ -87,13 +104,22 @@ public:
 
     // Runtime planet data - not exposed in Details panel but duplicated to PIE for instant startup
     // Note: Removing Transient allows PIE duplication while keeping them hidden (no EditAnywhere/VisibleAnywhere)
+    // Sample positions in km, single precision (see PTPPrecision.h; Blueprints use UPTPPrecisionLibrary)
+    UPROPERTY()
+    TArray<FVector3f> SamplePoints;
+
+    // Mapping from sample index -> Fibonacci lattice index (stable external id); empty when not reordered
     UPROPERTY()
-    TArray<FVector> SamplePoints;
+    TArray<int32> SampleOrder;
 
     // Mapping from sample index -> plate id
     UPROPERTY()
     TArray<int32> PointPlateIds;
 
+    // Mapping from plate id -> contiguous range of sample indices, kept in step with PointPlateIds
+    UPROPERTY()
+    FPTPPlateMembership PlateMembership;
+
     // Crust data per sample point
     UPROPERTY()
     TArray<struct FCrustData> CrustData;
@@ -102,11 +128,19 @@ public:
     UPROPERTY()
     TArray<bool> IsBoundaryPoint;
 
+    // Boundary type per sample point from relative plate motion (None for interior points)
+    UPROPERTY()
+    TArray<EPTPBoundaryType> BoundaryTypes;
+
+    // Distance along adjacency edges to the nearest convergent boundary point (km)
+    UPROPERTY()
+    TArray<float> DistanceToFrontKm;
+
     // Plate data
     UPROPERTY()
     TArray<struct FTectonicPlate> Plates;
 
-    // Adjacency — nested TArray cannot be a UPROPERTY; keep internal (will need manual duplication)
+    // Adjacency — nested TArray cannot be a UPROPERTY; restored from Triangles on register
     TArray<TArray<int32>> Neighbors;
 
     // Triangulation mesh
@@ -117,17 +151,73 @@ public:
     UFUNCTION(BlueprintCallable, Category="PTP")
     void ApplyDefaultsFromProjectSettings();
 
+    /** Regenerate the stages invalidated by a settings change on the calling thread, without building adjacency. */
     UFUNCTION(BlueprintCallable, Category="PTP")
     void RebuildPlanet();
 
-    // Adjacency building is provided by the CGAL module tests and tools; will be wired later for editor usage.
+    /** Whether the planet data matches the current settings; adjacency and boundaries only count when requested. */
+    bool IsUpToDate(bool bWithAdjacency) const;
+
+    /** Allocated bytes of the planet state, per array. */
+    FPTPMemoryReport GetMemoryReport() const;
+
+    virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
+    /** Kernel scratch of the last rebuild, for its per-kernel peaks; null before the first one. */
+    const FPTPStepScratch* GetScratch() const { return Scratch.Get(); }
+
+    /** Input hashes of the cached stage outputs. */
+    const FPTPStageHashes& GetStageHashes() const { return StageHashes; }
+
+    /**
+     * Regenerate the invalidated stages on a worker thread and swap the results in on the game thread.
+     *
+     * Settings and the cached outputs the dirty stages read are snapshotted when called. Requesting again with different settings cancels the
+     * rebuild in flight; with the same settings it returns the in-flight future. Progress and
+     * completion are broadcast on the game thread, and the future resolves after the swap.
+     *
+     * @param bWithAdjacency - Also triangulate and classify plate boundaries (input)
+     * @return Resolves to true once the component holds data for the requested settings, false if cancelled or failed
+     */
+    TSharedFuture<bool> RebuildPlanetAsync(bool bWithAdjacency = true);
+
+    /** Drop the rebuild in flight, if any; its results are discarded. */
+    void CancelRebuild();
+
+    bool IsRebuilding() const { return InFlightGeneration != 0; }
+
+    /** Broadcast on the game thread as each stage of the current rebuild starts. */
+    FPTPRebuildProgressDelegate OnRebuildProgress;
+
+    /** Broadcast on the game thread when the current rebuild was swapped in (true), failed or was cancelled (false). */
+    FPTPRebuildCompletedDelegate OnRebuildCompleted;
 
 protected:
     virtual void OnRegister() override;
+    virtual void OnUnregister() override;
 
 private:
-    // Cache for RebuildPlanet() optimization - parameter hash
-    uint32 CachedSettingsHash = 0;
-
-    uint32 ComputeSettingsHash() const;
+    // Input hashes of the stage outputs above; saved with them so cached data survives reloads
+    UPROPERTY()
+    FPTPStageHashes StageHashes;
+
+    FPTPRebuildSettings MakeRebuildSettings(bool bWithAdjacency) const;
+    FPTPPlanetState MakeRebuildInput(const FPTPRebuildSettings& Settings) const;
+    void ApplyState(FPTPPlanetState&& State);
+    void RestoreNeighbors();
+    void UpdateMemoryStats();
+    TSharedPtr<FPTPStepScratch> AcquireScratch();
+
+    // What this component last added to the `stat GaiaPTP` counters
+    FPTPMemoryReport ReportedMemory;
+
+    // Transient kernel buffers kept warm between rebuilds; a rebuild still holding it gets a fresh one
+    TSharedPtr<FPTPStepScratch> Scratch;
+
+    // Bumped by every request and cancel; workers compare against their own value to detect cancellation
+    TSharedRef<FThreadSafeCounter> RebuildGeneration = MakeShared<FThreadSafeCounter>();
+    int32 InFlightGeneration = 0;
+    uint32 InFlightHash = 0;
+    bool bInFlightAdjacency = false;
+    TSharedFuture<bool> InFlightFuture;
 };
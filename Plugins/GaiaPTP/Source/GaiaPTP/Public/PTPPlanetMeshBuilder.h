@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FCrustData;
+
+namespace RealtimeMesh
+{
+    struct FRealtimeMeshStream;
+    struct FRealtimeMeshStreamSet;
+}
+
+/** Mapping from preview mesh vertices (or point instances) to planet samples. */
+struct FPTPPlanetMeshLayout
+{
+    int32 NumVertices = 0;         // instances for the point preview
+    int32 NumTriangles = 0;
+    int32 SampleStride = 1;
+    TArray<int32> VertexSamples;   // explicit mapping for simplified LODs; overrides the stride when set
+
+    FORCEINLINE int32 VertexToSample(int32 Vertex) const
+    {
+        return VertexSamples.Num() > 0 ? VertexSamples[Vertex] : Vertex * SampleStride;
+    }
+};
+
+/**
+ * Bulk stream fill for the planet preview mesh.
+ *
+ * Position, tangent, colour, TexCoord0 and triangle streams are sized once and filled in parallel
+ * ranges; tangent frames are built and packed with vector registers. Triangles are emitted once,
+ * wound outward -- the preview material is expected to be two-sided instead of carrying a
+ * duplicated back-face index buffer. BuildSurface sizes the colour and TexCoord0 streams;
+ * FillColors/FillElevations write them, either right after a build or later in place. The point
+ * preview is instanced and only needs one transform per marker.
+ */
+class GAIAPTP_API FPTPPlanetMeshBuilder
+{
+public:
+    /**
+     * One vertex per sample, one outward-wound triangle per input triangle.
+     *
+     * @param Points - Sample positions in km (input)
+     * @param Triangles - Triangulation of Points; triangles with invalid indices become degenerate (input)
+     * @param Scale - Visualization scale applied to positions (input)
+     * @param OutStreams - Replaced with the filled streams (output)
+     * @param TriangleOrder - Optional permutation; output triangle t is Triangles[TriangleOrder[t]] (input)
+     */
+    static FPTPPlanetMeshLayout BuildSurface(const TArray<FVector3f>& Points, const TArray<FIntVector>& Triangles, float Scale,
+                                             RealtimeMesh::FRealtimeMeshStreamSet& OutStreams,
+                                             TConstArrayView<int32> TriangleOrder = TConstArrayView<int32>());
+
+    /**
+     * One instance per Stride-th sample for the instanced point preview: a quad mesh scaled to
+     * MarkerSize and turned so its +Z normal faces outward.
+     *
+     * @param Points - Sample positions in km (input)
+     * @param Stride - Keep every Stride-th sample (input)
+     * @param MarkerSize - Marker edge length in km, pre-scale (input)
+     * @param Scale - Visualization scale applied to positions (input)
+     * @param QuadSize - Edge length of the instanced quad mesh in its own units (input)
+     * @param OutTransforms - Instance transforms relative to the actor (output)
+     */
+    static FPTPPlanetMeshLayout BuildPointInstances(const TArray<FVector3f>& Points, int32 Stride, float MarkerSize, float Scale, float QuadSize,
+                                                    TArray<FTransform>& OutTransforms);
+
+    /** Per-vertex plate colours (cyan where the plate id is missing). */
+    static void FillColors(const FPTPPlanetMeshLayout& Layout, TConstArrayView<int32> PlateIds, RealtimeMesh::FRealtimeMeshStream& ColorStream);
+
+    /** Per-vertex elevation (km) packed into TexCoord0.U; V is left to the scalar visualization layer. */
+    static void FillElevations(const FPTPPlanetMeshLayout& Layout, TConstArrayView<FCrustData> Crust, RealtimeMesh::FRealtimeMeshStream& TexCoordStream);
+
+    /** Pastel colour hashed from a plate id. */
+    static FColor PlateColor(int32 PlateId);
+};
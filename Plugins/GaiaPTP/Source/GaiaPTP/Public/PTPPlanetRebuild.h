@@ -0,0 +1,165 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TectonicTypes.h"
+#include "TectonicData.h"
+#include "PTPPlateMembership.h"
+#include "PTPPlanetRebuild.generated.h"
+
+class FPTPStepScratch;
+
+/** Progress stages of a planet rebuild, in execution order. Mesh runs on the game thread after the data is swapped in. */
+UENUM(BlueprintType)
+enum class EPTPRebuildStage : uint8
+{
+    Sampling   UMETA(DisplayName="Sampling"),
+    Adjacency  UMETA(DisplayName="Adjacency"),
+    Seeding    UMETA(DisplayName="Seeding"),
+    Crust      UMETA(DisplayName="Crust"),
+    Mesh       UMETA(DisplayName="Mesh")
+};
+
+/** Nodes of the rebuild graph, each with its own cached output. */
+enum class EPTPStageMask : uint8
+{
+    None       = 0,
+    Sample     = 1 << 0,   // SamplePoints, SampleOrder
+    Adjacency  = 1 << 1,   // Neighbors, Triangles
+    Seed       = 1 << 2,   // Plates: count, ids, seed directions
+    Assign     = 1 << 3,   // PointPlateIds, Membership
+    Crust      = 1 << 4,   // CrustData
+    Dynamics   = 1 << 5,   // Plates: rotation axes and angular velocities
+    Boundaries = 1 << 6,   // IsBoundaryPoint, BoundaryTypes, DistanceToFrontKm
+    All        = 0x7F
+};
+ENUM_CLASS_FLAGS(EPTPStageMask);
+
+/**
+ * Input hash of every graph node; each folds in the hashes of the nodes it reads, so a setting
+ * change invalidates exactly its downstream suffix. 0 marks a missing output.
+ *
+ *   Sample(N, radius, order)   Adjacency(N, order)
+ *   Seed(plates)           Assign(Sample, Seed)       Crust(Assign, ratio, elevations, seed)
+ *   Dynamics(Seed, radius, speed, seed)               Boundaries(Adjacency, Assign, Dynamics)
+ *
+ * With spatial reordering the assignment stage also regroups samples by plate, rewriting the
+ * sample and adjacency outputs in place; their hashes stay put because only the indices move.
+ *
+ * The mesh node (visualization scale, preview mode) lives on APTPPlanetActor and keys its
+ * geometry on GetGeometryHash.
+ */
+USTRUCT()
+struct GAIAPTP_API FPTPStageHashes
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    uint32 Sample = 0;
+
+    UPROPERTY()
+    uint32 Adjacency = 0;
+
+    UPROPERTY()
+    uint32 Seed = 0;
+
+    UPROPERTY()
+    uint32 Assign = 0;
+
+    UPROPERTY()
+    uint32 Crust = 0;
+
+    UPROPERTY()
+    uint32 Dynamics = 0;
+
+    UPROPERTY()
+    uint32 Boundaries = 0;
+
+    /** Nodes whose hash differs from Other. */
+    EPTPStageMask Diff(const FPTPStageHashes& Other) const;
+
+    /** Hash of everything the preview geometry is built from (sample positions and triangulation, in the assignment's order). */
+    uint32 GetGeometryHash() const { return HashCombine(HashCombine(Sample, Adjacency), Assign); }
+};
+
+/** Settings snapshot a rebuild runs from, taken on the game thread so workers never read UObjects. */
+struct FPTPRebuildSettings
+{
+    int32 NumSamplePoints = 0;
+    float PlanetRadiusKm = 0.0f;
+    int32 NumPlates = 0;
+    float ContinentalRatio = 0.0f;
+    float MaxPlateSpeedMmPerYear = 0.0f;
+    float AbyssalPlainElevationKm = 0.0f;
+    float HighestOceanicRidgeElevationKm = 0.0f;
+    int32 InitialSeed = 0;
+    bool bSpatialReorder = true;   // group samples by plate, each along a cube-map Hilbert curve (FPTPSpatialOrder)
+    bool bBuildAdjacency = true;   // otherwise a stale triangulation is dropped rather than rebuilt, and boundaries with it
+};
+
+/**
+ * Cached stage outputs and their hashes. On input to Run it carries whatever the caller already
+ * has (only the outputs a dirty stage reads need to be present); on output Recomputed names the
+ * outputs Run replaced, which UPTPPlanetComponent swaps in one go.
+ */
+struct FPTPPlanetState
+{
+    FPTPStageHashes Hashes;
+    EPTPStageMask Recomputed = EPTPStageMask::None;
+
+    TArray<FVector3f> SamplePoints;   // km, single precision (PTPPrecision.h)
+    TArray<int32> SampleOrder;     // Fibonacci index of each sample, empty when not reordered; part of the Sample output
+    TArray<int32> PointPlateIds;
+    FPTPPlateMembership Membership;
+    TArray<FCrustData> CrustData;
+    TArray<FTectonicPlate> Plates;
+    TArray<TArray<int32>> Neighbors;
+    TArray<FIntVector> Triangles;
+    TArray<bool> IsBoundaryPoint;
+    TArray<EPTPBoundaryType> BoundaryTypes;
+    TArray<float> DistanceToFrontKm;
+
+    /** Transient buffers of the boundary kernels, reused across rebuilds; not an output. Run uses a private one when null. */
+    TSharedPtr<FPTPStepScratch> Scratch;
+};
+
+/**
+ * The planet generation pipeline: sampling, adjacency, seeding, assignment, crust, dynamics and
+ * boundary classification, memoized per stage on FPTPStageHashes.
+ *
+ * Run only reads its settings snapshot and its state, so it can run on any thread. Stages whose
+ * hash is unchanged are skipped, so tweaking a crust parameter reruns the crust stage alone.
+ * Cancellation is polled between stages; a stage that has started, such as the CGAL
+ * triangulation, runs to completion.
+ */
+class GAIAPTP_API FPTPPlanetRebuild
+{
+public:
+    /**
+     * Generate a planet.
+     *
+     * @param Settings - Settings snapshot (input)
+     * @param InOutState - Cached outputs to reuse; receives the recomputed ones, partial if cancelled or failed (input/output)
+     * @param OnStage - Called from the running thread as each stage that actually runs starts (input)
+     * @param IsCancelled - Polled between stages; returning true stops the rebuild (input)
+     * @param OutError - Reason for a failure, empty when cancelled (output)
+     * @return true if every stage completed
+     */
+    static bool Run(const FPTPRebuildSettings& Settings, FPTPPlanetState& InOutState, TFunctionRef<void(EPTPRebuildStage)> OnStage,
+                    TFunctionRef<bool()> IsCancelled, FString& OutError);
+
+    /** Hashes a rebuild with these settings produces. */
+    static FPTPStageHashes ComputeStageHashes(const FPTPRebuildSettings& Settings);
+
+    /**
+     * Outputs that dirty stages read but do not produce; anything in this mask must be present
+     * in the state handed to Run.
+     *
+     * @param Dirty - Stages that will rerun, from FPTPStageHashes::Diff (input)
+     * @param bBuildAdjacency - Whether a missing triangulation will be built (input)
+     * @param bSpatialReorder - Whether samples are stored in plate-major Hilbert order (input)
+     */
+    static EPTPStageMask GetRequiredInputs(EPTPStageMask Dirty, bool bBuildAdjacency, bool bSpatialReorder);
+
+    /** Fraction of a typical rebuild finished when Stage starts, for progress bars. */
+    static float GetStageProgress(EPTPRebuildStage Stage);
+};
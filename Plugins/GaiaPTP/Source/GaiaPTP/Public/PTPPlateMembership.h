@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PTPPlateMembership.generated.h"
+
+/** Move of one sample point to another plate (terrane transfer, rifting). */
+struct FPTPPlateTransfer
+{
+    int32 Point = INDEX_NONE;
+    int32 ToPlate = INDEX_NONE;
+};
+
+/**
+ * Plate membership as one partition of the sample indices.
+ *
+ * Points holds every sample index grouped by plate; plate p owns the range
+ * [Offsets[p], Offsets[p + 1]), ascending within the range so per-plate kernels walk the
+ * per-point arrays front to back. With the rebuild's plate-major sample order each range is
+ * the contiguous run of its own indices. Slots maps a sample index to its position
+ * in Points. The per-point plate id stays in UPTPPlanetComponent::PointPlateIds; this is the
+ * reverse index built from it, replacing one heap array per plate.
+ */
+USTRUCT()
+struct GAIAPTP_API FPTPPlateMembership
+{
+    GENERATED_BODY()
+
+    /** Build from per-point plate ids with a counting sort; ids outside [0, NumPlates) are left out. */
+    void Build(TConstArrayView<int32> PointPlateIds, int32 NumPlates);
+
+    /**
+     * Move points between plates in one pass. Only the plates between the lowest and highest
+     * plate touched are repartitioned; ranges outside that span keep their place.
+     *
+     * @param Transfers - Moves to apply; a point listed twice ends on its last target (input)
+     * @param InOutPointPlateIds - Per-point plate ids this membership was built from (input/output)
+     */
+    void ApplyTransfers(TConstArrayView<FPTPPlateTransfer> Transfers, TArray<int32>& InOutPointPlateIds);
+
+    void Reset()
+    {
+        Offsets.Reset();
+        Points.Reset();
+        Slots.Reset();
+    }
+
+    int32 GetNumPlates() const { return FMath::Max(Offsets.Num() - 1, 0); }
+    int32 GetNumPoints() const { return Points.Num(); }
+    int32 GetPlateOffset(int32 Plate) const { return Offsets[Plate]; }
+    int32 GetPlateCount(int32 Plate) const { return Offsets[Plate + 1] - Offsets[Plate]; }
+    int32 GetSlot(int32 Point) const { return Slots[Point]; }
+    SIZE_T GetAllocatedSize() const { return Offsets.GetAllocatedSize() + Points.GetAllocatedSize() + Slots.GetAllocatedSize(); }
+
+    /** Sample indices of Plate, ascending. */
+    TConstArrayView<int32> GetPlatePoints(int32 Plate) const
+    {
+        return TConstArrayView<int32>(Points.GetData() + Offsets[Plate], GetPlateCount(Plate));
+    }
+
+    /** Offsets, Points and Slots agree with PointPlateIds. */
+    bool IsConsistent(TConstArrayView<int32> PointPlateIds) const;
+
+private:
+    // Plate p owns Points[Offsets[p] .. Offsets[p + 1]); NumPlates + 1 entries
+    UPROPERTY()
+    TArray<int32> Offsets;
+
+    // Sample indices grouped by plate
+    UPROPERTY()
+    TArray<int32> Points;
+
+    // Sample index -> position in Points, INDEX_NONE for unassigned samples
+    UPROPERTY()
+    TArray<int32> Slots;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FPTPPlateMembership;
+
+/** One unit of per-plate work: the points [Begin, End) of a plate's point list. */
+struct FPTPPlateWorkItem
+{
+    int32 Plate = INDEX_NONE;
+    int32 Begin = 0;
+    int32 End = 0;
+
+    int32 Num() const { return End - Begin; }
+
+    /** This item's share of the plate's points. */
+    TConstArrayView<int32> Slice(TConstArrayView<int32> PlatePoints) const { return PlatePoints.Slice(Begin, End - Begin); }
+};
+
+/**
+ * Load-balanced dispatch for per-plate kernels. Voronoi plates differ in size by orders of
+ * magnitude, so ParallelFor over plates waits on the largest plate; this splits every plate into
+ * items of at most ItemSize points and runs the items instead.
+ *
+ * Dispatch runs three phases, each parallel and each finished before the next starts: Prologue
+ * once per plate, Work once per item, Epilogue once per plate. Per-plate reductions (centroids,
+ * sums) write partial results per item index in Work and fold them in Epilogue.
+ *
+ * The split depends only on the plate sizes and ItemSize, never on the core count, so folding
+ * partials in item order gives the same bits on every machine.
+ */
+class GAIAPTP_API FPTPPlatePartition
+{
+public:
+    /** Points per item: small enough to balance 64 workers on a 100k-point planet, large enough to amortize scheduling. */
+    static constexpr int32 DefaultItemSize = 1024;
+
+    FPTPPlatePartition() = default;
+    explicit FPTPPlatePartition(const FPTPPlateMembership& Membership, int32 ItemSize = DefaultItemSize) { Build(Membership, ItemSize); }
+
+    /**
+     * Split plates into items; items are ordered by plate, then by range.
+     *
+     * @param NumPlates - Number of plates (input)
+     * @param GetPlateSize - Number of points of a plate (input)
+     * @param ItemSize - Largest item in points; MAX_int32 gives one item per plate (input)
+     */
+    void Build(int32 NumPlates, TFunctionRef<int32(int32)> GetPlateSize, int32 ItemSize = DefaultItemSize);
+    void Build(const FPTPPlateMembership& Membership, int32 ItemSize = DefaultItemSize);
+
+    int32 GetNumPlates() const { return FMath::Max(PlateItems.Num() - 1, 0); }
+    int32 GetNumItems() const { return Items.Num(); }
+    const FPTPPlateWorkItem& GetItem(int32 ItemIdx) const { return Items[ItemIdx]; }
+
+    /** Items of Plate, consecutive; empty for a plate without points. */
+    TConstArrayView<FPTPPlateWorkItem> GetPlateItems(int32 Plate) const
+    {
+        return TConstArrayView<FPTPPlateWorkItem>(Items.GetData() + PlateItems[Plate], PlateItems[Plate + 1] - PlateItems[Plate]);
+    }
+    int32 GetFirstItem(int32 Plate) const { return PlateItems[Plate]; }
+
+    /**
+     * Run a per-plate kernel over the items.
+     *
+     * @param Prologue - Per-plate setup, runs for every plate before any Work (input)
+     * @param Work - Per-item body, gets the item index for partial results (input)
+     * @param Epilogue - Per-plate fold, runs for every plate after all Work (input)
+     * @param bForceSingleThread - Run every phase on the calling thread, in order (input)
+     */
+    void Dispatch(
+        TFunctionRef<void(int32 Plate)> Prologue,
+        TFunctionRef<void(int32 ItemIdx, const FPTPPlateWorkItem& Item)> Work,
+        TFunctionRef<void(int32 Plate)> Epilogue,
+        bool bForceSingleThread = false) const;
+
+    /** Run Work over the items, without per-plate hooks. */
+    void Dispatch(TFunctionRef<void(int32 ItemIdx, const FPTPPlateWorkItem& Item)> Work, bool bForceSingleThread = false) const;
+
+private:
+    TArray<FPTPPlateWorkItem> Items;
+
+    // Plate p owns Items[PlateItems[p] .. PlateItems[p + 1]); NumPlates + 1 entries
+    TArray<int32> PlateItems;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/** Containing triangle and barycentric weights for one query direction. */
+struct FPTPLocation
+{
+    int32 Triangle = INDEX_NONE;
+    FVector3f Barycentrics = FVector3f::ZeroVector;   // weights of the oriented triangle's vertices X, Y, Z; sum to 1
+};
+
+/**
+ * Point location on the coarse spherical triangulation (UPTPPlanetComponent::Triangles).
+ *
+ * A cube-map seed grid stores, per cell, the triangle containing the cell centre. A query starts
+ * there (or at a caller hint) and walks across triangle edges towards the point -- with ~2
+ * triangles per cell the walk is usually 0-2 steps. Triangles are re-wound outward on build, so
+ * the input winding does not matter. Barycentrics are those of the central projection of the
+ * direction onto the triangle's plane, matching how the mesh is drawn.
+ */
+class GAIAPTP_API FPTPPointLocator
+{
+public:
+    /**
+     * Build adjacency and the seed grid.
+     *
+     * @param Points - Triangulation vertices, any radius (input)
+     * @param Triangles - Closed triangulation of Points (input)
+     * @param GridResolution - Seed cells per cube face edge; 0 picks ~2 triangles per cell (input)
+     * @return false if the triangulation is empty or not closed
+     */
+    bool Build(TConstArrayView<FVector3f> Points, const TArray<FIntVector>& Triangles, int32 GridResolution = 0);
+
+    /** Locate one unit direction; HintTriangle (e.g. the previous query's result) shortens coherent walks. */
+    FPTPLocation Locate(const FVector3f& Direction, int32 HintTriangle = INDEX_NONE) const;
+
+    /**
+     * Locate many unit directions. Queries are bucketed by seed cell so consecutive walks start
+     * from nearby triangles, then processed in parallel chunks (honours ptp.parallel).
+     *
+     * @param Directions - Unit query directions (input)
+     * @param OutLocations - One result per query, in query order (output, must match Directions.Num())
+     */
+    void LocateBatch(TConstArrayView<FVector3f> Directions, TArrayView<FPTPLocation> OutLocations) const;
+
+    bool IsBuilt() const { return Triangles.Num() > 0; }
+    int32 GetNumTriangles() const { return Triangles.Num(); }
+
+    /** Outward-wound vertex indices of a triangle; FPTPLocation::Barycentrics follow this order. */
+    const FIntVector& GetTriangle(int32 Triangle) const { return Triangles[Triangle]; }
+
+    /** Walks that hit MaxWalkSteps and fell back to a full scan since Build (diagnostic). */
+    int32 GetNumFallbacks() const { return NumFallbacks.load(std::memory_order_relaxed); }
+
+private:
+    int32 Walk(const FVector3f& P, int32 Start) const;
+    int32 BruteForce(const FVector3f& P) const;
+    FPTPLocation MakeLocation(const FVector3f& P, int32 Triangle) const;
+
+    TArray<FVector3f> Vertices;        // unit directions
+    TArray<FIntVector> Triangles;      // outward winding
+    TArray<FVector3f> EdgeNormals;     // 3 per triangle: cross(V[k+1], V[k+2]), edge opposite vertex k
+    TArray<FIntVector> Adjacent;       // triangle across the edge opposite vertex k
+    TArray<int32> CellSeeds;
+    int32 Resolution = 1;
+    int32 MaxWalkSteps = 0;
+
+    mutable std::atomic<int32> NumFallbacks{ 0 };
+};
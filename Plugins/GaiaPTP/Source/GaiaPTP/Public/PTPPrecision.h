@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Precision policy of the PTP simulation state.
+ *
+ * Per-sample positions and directions are stored as FVector3f: inputs are floats, a float keeps
+ * ~0.5 m at Earth radius in km, and half the bytes means twice the lanes per SIMD op and per cache
+ * line on the largest arrays. Double is kept where error accumulates: plate rotations and angular
+ * velocities (FTectonicPlate), reductions over many samples (centroids, boundary normals) and the
+ * CGAL triangulation, whose exact predicates want doubles anyway. Kernels load a float sample and
+ * widen it locally when they combine it with those.
+ *
+ * Conversions happen at the edges only: the mesh builders write the float render streams directly,
+ * and UPTPPrecisionLibrary widens for Blueprints, which have no FVector3f type.
+ */
+namespace PTPPrecision
+{
+    inline void ToDouble(TConstArrayView<FVector3f> In, TArray<FVector>& Out)
+    {
+        Out.SetNumUninitialized(In.Num());
+        for (int32 i = 0; i < In.Num(); ++i)
+        {
+            Out[i] = FVector(In[i]);
+        }
+    }
+
+    inline void ToFloat(TConstArrayView<FVector> In, TArray<FVector3f>& Out)
+    {
+        Out.SetNumUninitialized(In.Num());
+        for (int32 i = 0; i < In.Num(); ++i)
+        {
+            Out[i] = FVector3f(In[i]);
+        }
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "TectonicData.h"
+#include "PTPPrecisionLibrary.generated.h"
+
+class UPTPPlanetComponent;
+
+/** Blueprint access to the single-precision PTP state (see PTPPrecision.h); values are widened to FVector on the way out. */
+UCLASS()
+class GAIAPTP_API UPTPPrecisionLibrary : public UBlueprintFunctionLibrary
+{
+    GENERATED_BODY()
+
+public:
+    /** Sample positions in km, in storage order. */
+    UFUNCTION(BlueprintPure, Category="PTP|Precision")
+    static TArray<FVector> GetSamplePoints(const UPTPPlanetComponent* Planet);
+
+    /** One sample position in km; zero for an invalid index. */
+    UFUNCTION(BlueprintPure, Category="PTP|Precision")
+    static FVector GetSamplePoint(const UPTPPlanetComponent* Planet, int32 Index);
+
+    UFUNCTION(BlueprintPure, Category="PTP|Precision")
+    static FVector GetRidgeDirection(const FCrustData& Crust) { return FVector(Crust.RidgeDirection); }
+
+    UFUNCTION(BlueprintPure, Category="PTP|Precision")
+    static FVector GetFoldDirection(const FCrustData& Crust) { return FVector(Crust.FoldDirection); }
+
+    UFUNCTION(BlueprintCallable, Category="PTP|Precision")
+    static void SetRidgeDirection(UPARAM(ref) FCrustData& Crust, FVector Direction) { Crust.RidgeDirection = FVector3f(Direction); }
+
+    UFUNCTION(BlueprintCallable, Category="PTP|Precision")
+    static void SetFoldDirection(UPARAM(ref) FCrustData& Crust, FVector Direction) { Crust.FoldDirection = FVector3f(Direction); }
+};
@@ -2,12 +2,19 @@
 
 #include "CoreMinimal.h"
 #include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
 
 CSV_DECLARE_CATEGORY_EXTERN(GAIA_PTP);
 
+// `stat GaiaPTP`: memory and scratch counters of the PTP module
+DECLARE_STATS_GROUP(TEXT("GaiaPTP"), STATGROUP_GaiaPTP, STATCAT_Advanced);
+
 namespace PTPProfiling
 {
     void RegisterConsoleCommands();
     void UnregisterConsoleCommands();
+
+    /** Whether PTP kernels may use ParallelFor (`ptp.parallel`, on by default). Safe from any thread. */
+    GAIAPTP_API bool IsParallelEnabled();
 }
 
@@ -17,3 +17,37 @@ struct FPTPRandom
     FVector VRand() { return Stream.VRand(); }
 };
 
+
+/**
+ * Stateless counter-based hash RNG. Values depend only on (Seed, key), never on evaluation order,
+ * so parallel and tiled generators reproduce the same numbers for the same ids.
+ */
+struct FPTPHash
+{
+    /** 32-bit integer finalizer (lowbias32). */
+    static FORCEINLINE uint32 Mix(uint32 X)
+    {
+        X ^= X >> 16;
+        X *= 0x7feb352dU;
+        X ^= X >> 15;
+        X *= 0x846ca68bU;
+        X ^= X >> 16;
+        return X;
+    }
+
+    static FORCEINLINE uint32 Hash(uint32 Seed, uint32 A)
+    {
+        return Mix(Mix(Seed + 0x9e3779b9U) ^ A);
+    }
+
+    static FORCEINLINE uint32 Hash(uint32 Seed, uint32 A, uint32 B)
+    {
+        return Mix(Hash(Seed, A) ^ (B * 0x85ebca6bU));
+    }
+
+    /** Uniform float in [0,1) from the top 24 bits of a hash. */
+    static FORCEINLINE float UnitFloat(uint32 H)
+    {
+        return (H >> 8) * (1.0f / 16777216.0f);
+    }
+};
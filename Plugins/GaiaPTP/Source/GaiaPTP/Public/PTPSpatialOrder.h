@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FPTPPlanetState;
+
+/**
+ * Spatial reordering of sample points for memory locality.
+ *
+ * Fibonacci samples come out ordered by latitude, so mesh neighbours sit ~sqrt(N) indices apart.
+ * Sorting by a cube-map Hilbert key (face, then the Hilbert index of the face cell) puts most
+ * neighbours within a few indices of each other, which helps every neighbour-walking kernel and
+ * the GPU vertex cache. The rebuild groups samples by plate first (ComputePlateHilbertOrder), so
+ * per-plate kernels stream one contiguous span. Permutations are stored NewToOld: entry i is the
+ * previous index of the sample now at i.
+ */
+class GAIAPTP_API FPTPSpatialOrder
+{
+public:
+    /** Hilbert key of a direction: face in bits 32-34, 16-bit-per-axis Hilbert index below. */
+    static uint64 HilbertKey(const FVector3f& Dir);
+
+    /**
+     * Permutation sorting points by HilbertKey; ties keep their input order.
+     *
+     * @param Points - Sample positions, any radius (input)
+     * @param OutNewToOld - Permutation (output, Points.Num())
+     */
+    static void ComputeHilbertOrder(TConstArrayView<FVector> Points, TArray<int32>& OutNewToOld);
+    static void ComputeHilbertOrder(TConstArrayView<FVector3f> Points, TArray<int32>& OutNewToOld);
+
+    /**
+     * Permutation grouping points by plate, sorted by HilbertKey within each plate; ties keep
+     * their input order. Plate ranges of FPTPPlateMembership then become contiguous spans.
+     *
+     * @param Points - Sample positions, any radius (input)
+     * @param PointPlateIds - Plate of each point, INDEX_NONE sorting first (input)
+     * @param OutNewToOld - Permutation (output, Points.Num())
+     */
+    static void ComputePlateHilbertOrder(TConstArrayView<FVector3f> Points, TConstArrayView<int32> PointPlateIds, TArray<int32>& OutNewToOld);
+
+    /** Whether NewToOld leaves every index in place. */
+    static bool IsIdentity(TConstArrayView<int32> NewToOld);
+
+    /** OldToNew from NewToOld. */
+    static void InvertPermutation(TConstArrayView<int32> NewToOld, TArray<int32>& OutOldToNew);
+
+    /** Gather Array through NewToOld; arrays whose size does not match are left alone. */
+    template <typename T>
+    static void Permute(TArray<T>& Array, TConstArrayView<int32> NewToOld)
+    {
+        if (Array.Num() != NewToOld.Num())
+        {
+            return;
+        }
+        TArray<T> Out;
+        Out.Reserve(Array.Num());
+        for (int32 Old : NewToOld)
+        {
+            Out.Add(MoveTemp(Array[Old]));
+        }
+        Array = MoveTemp(Out);
+    }
+
+    /** Fraction of neighbour links whose endpoints are at most Window indices apart; a locality score in [0, 1]. */
+    static float ComputeNeighborLocality(const TArray<TArray<int32>>& Neighbors, int32 Window);
+
+    /**
+     * Reorder every per-point array of a planet state through one permutation, rewrite triangle,
+     * neighbour and plate membership indices, and compose the permutation into State.SampleOrder so
+     * each sample keeps its original (Fibonacci) id.
+     *
+     * @param State - Planet data, all per-point arrays sized alike (input/output)
+     * @param NewToOld - Permutation over the current sample indices (input)
+     */
+    static void Reorder(FPTPPlanetState& State, TConstArrayView<int32> NewToOld);
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TectonicTypes.h"
+#include "PTPVisualizationLayers.generated.h"
+
+struct FCrustData;
+struct FTectonicPlate;
+struct FPTPPlanetMeshLayout;
+class UPTPPlanetComponent;
+
+namespace RealtimeMesh
+{
+    struct FRealtimeMeshStream;
+}
+
+/** Per-sample quantity shown on the planet preview. */
+UENUM(BlueprintType)
+enum class EPTPVisualizationLayer : uint8
+{
+    PlateId            UMETA(DisplayName="Plate Id"),
+    Elevation          UMETA(DisplayName="Elevation"),
+    CrustType          UMETA(DisplayName="Crust Type"),
+    OceanicAge         UMETA(DisplayName="Oceanic Age"),
+    OrogenyAge         UMETA(DisplayName="Orogeny Age"),
+    BoundaryType       UMETA(DisplayName="Boundary Type"),
+    VelocityMagnitude  UMETA(DisplayName="Velocity Magnitude"),
+    DistanceToFront    UMETA(DisplayName="Distance To Front")
+};
+
+/** How a layer reaches the material. */
+enum class EPTPLayerEncoding : uint8
+{
+    Color,    // categorical: RGBA8 vertex colour stream
+    Scalar    // continuous: value normalized to [0, 1] in TexCoord0.V (half float), mapped by the material's colour ramp
+};
+
+/** Static description of a layer. */
+struct FPTPLayerInfo
+{
+    const TCHAR* Name;
+    EPTPLayerEncoding Encoding;
+    const TCHAR* Units;
+};
+
+/** Planet data the layer kernels read; views must outlive the fill calls. */
+struct GAIAPTP_API FPTPLayerSource
+{
+    TConstArrayView<FVector3f> Points;             // km
+    TConstArrayView<int32> PlateIds;
+    TConstArrayView<FCrustData> Crust;
+    TConstArrayView<FTectonicPlate> Plates;        // indexed by plate id
+    TConstArrayView<EPTPBoundaryType> BoundaryTypes;
+    TConstArrayView<float> DistanceToFrontKm;
+
+    // Scalar ranges that depend on planet settings
+    FVector2f ElevationRangeKm = FVector2f(-10.0f, 10.0f);
+    float MaxPlateSpeedMmPerYear = 100.0f;
+    float FrontRangeKm = 4200.0f;
+
+    static FPTPLayerSource FromPlanet(const UPTPPlanetComponent& Planet);
+};
+
+/**
+ * Visualization layers for the planet preview.
+ *
+ * Each layer is a per-vertex kernel run in parallel ranges over a mesh layout. Colour layers
+ * rewrite only the colour stream and scalar layers only TexCoord0.V, so switching layers
+ * re-uploads a single attribute stream and leaves positions, tangents and indices resident.
+ * The preview material selects between vertex colour and its ramp with the scalar parameter
+ * ScalarLayerParameter (0 or 1); RampColor is the CPU copy of that ramp used for captures.
+ */
+class GAIAPTP_API FPTPVisualizationLayers
+{
+public:
+    static const FName ScalarLayerParameter;
+
+    /** Custom data floats per point-preview instance: layer colour RGB (0-1, sRGB) and the normalized scalar. */
+    static constexpr int32 NumInstanceCustomData = 4;
+
+    static const FPTPLayerInfo& GetInfo(EPTPVisualizationLayer Layer);
+    static bool IsScalar(EPTPVisualizationLayer Layer) { return GetInfo(Layer).Encoding == EPTPLayerEncoding::Scalar; }
+
+    /** Parse a layer name (case-insensitive, as in FPTPLayerInfo::Name) or its numeric index. */
+    static bool FindLayer(const FString& NameOrIndex, EPTPVisualizationLayer& OutLayer);
+
+    /** Raw value of a scalar layer at a sample, in the layer's units; 0 where data is missing. */
+    static float SampleScalar(EPTPVisualizationLayer Layer, const FPTPLayerSource& Source, int32 Sample);
+
+    /** Range mapped to [0, 1] by the scalar encoding. */
+    static FVector2f GetScalarRange(EPTPVisualizationLayer Layer, const FPTPLayerSource& Source);
+
+    /** Colour of a colour layer at a sample (cyan where data is missing). */
+    static FColor SampleColor(EPTPVisualizationLayer Layer, const FPTPLayerSource& Source, int32 Sample);
+
+    /**
+     * Write a colour layer into the vertex colour stream.
+     *
+     * @param Layer - Colour-encoded layer (input)
+     * @param Layout - Vertex to sample mapping of the stream (input)
+     * @param Source - Planet data (input)
+     * @param ColorStream - FColor stream with Layout.NumVertices entries (output)
+     */
+    static void FillColors(EPTPVisualizationLayer Layer, const FPTPPlanetMeshLayout& Layout, const FPTPLayerSource& Source,
+                           RealtimeMesh::FRealtimeMeshStream& ColorStream);
+
+    /**
+     * Write a scalar layer, normalized to [0, 1], into TexCoord0.V. U (elevation) is preserved.
+     *
+     * @param Layer - Scalar-encoded layer (input)
+     * @param Layout - Vertex to sample mapping of the stream (input)
+     * @param Source - Planet data (input)
+     * @param TexCoordStream - FRealtimeMeshTexCoordsNormal stream with Layout.NumVertices entries (output)
+     */
+    static void FillScalars(EPTPVisualizationLayer Layer, const FPTPPlanetMeshLayout& Layout, const FPTPLayerSource& Source,
+                            RealtimeMesh::FRealtimeMeshStream& TexCoordStream);
+
+    /**
+     * Write a layer into point-preview instance custom data. Scalar layers store their ramp colour
+     * and normalized value, colour layers their colour and 0.
+     *
+     * @param Layer - Layer to write (input)
+     * @param Layout - Instance to sample mapping (input)
+     * @param Source - Planet data (input)
+     * @param OutCustomData - NumInstanceCustomData floats per instance (output, Layout.NumVertices * NumInstanceCustomData)
+     */
+    static void FillInstanceCustomData(EPTPVisualizationLayer Layer, const FPTPPlanetMeshLayout& Layout, const FPTPLayerSource& Source,
+                                       TArrayView<float> OutCustomData);
+
+    /** Colour ramp for normalized scalar values; matches the preview material. */
+    static FColor RampColor(float Normalized);
+
+    /**
+     * Render a layer to an equirectangular image without the renderer: each pixel takes the
+     * sample with the largest barycentric weight in the triangle containing its direction.
+     *
+     * @param Layer - Layer to render (input)
+     * @param Source - Planet data (input)
+     * @param Triangles - Triangulation of Source.Points (input)
+     * @param Width - Image width; height is Width / 2 (input)
+     * @param OutPixels - Row-major pixels, row 0 at the north pole (+Z) (output)
+     * @return false if the triangulation cannot be located against
+     */
+    static bool RenderEquirectangular(EPTPVisualizationLayer Layer, const FPTPLayerSource& Source, const TArray<FIntVector>& Triangles,
+                                      int32 Width, TArray<FColor>& OutPixels);
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TectonicData.h"
+
+class FPTPNoise;
+struct FPTPNoiseSettings;
+class UPTPPlanetComponent;
+
+/**
+ * Constants for the Phase 4 surface processes (paper Section 4.5).
+ * Rates are in mm/year, which is numerically identical to km/My, so Rate * TimeStepMy is km.
+ */
+struct FPTPSurfaceProcessParams
+{
+    float TimeStepMy = 2.0f;                    // δt
+    float ContinentalErosion = 3.0e-5f;         // εc
+    float OceanicElevationDampening = 4.0e-2f;  // εo
+    float SedimentAccretion = 3.0e-1f;          // εf
+    float HighestContinentalAltitudeKm = 10.0f; // zc
+    float OceanicTrenchElevationKm = -10.0f;    // zt
+};
+
+/**
+ * Structure-of-arrays copy of the crust fields that surface processing touches every step.
+ * Keeping these contiguous lets the fused pass stream 10 bytes per sample instead of the full FCrustData.
+ */
+struct GAIAPTP_API FPTPCrustSurfaceSoA
+{
+    TArray<uint8> CrustType;   // ECrustType
+    TArray<float> Elevation;   // km
+    TArray<float> OceanicAge;  // My
+    TArray<float> OrogenyAge;  // My
+
+    /** Non-zero for samples in an oceanic trench (subduction front). Empty means no trenches. */
+    TArray<uint8> TrenchMask;
+
+    int32 Num() const { return Elevation.Num(); }
+
+    /** Copy the surface fields out of AoS crust data (TrenchMask is left untouched). */
+    void Gather(const TArray<FCrustData>& Crust);
+
+    /** Write the surface fields back into AoS crust data. */
+    void Scatter(TArray<FCrustData>& Crust) const;
+};
+
+/**
+ * Phase 4: continental erosion, oceanic dampening and trench sediment accretion.
+ * All three rules (and crust ageing) run in one fused pass so the arrays are read once per step.
+ */
+class GAIAPTP_API FSurfaceProcessing
+{
+public:
+    /**
+     * Apply one time step of surface processes to every sample.
+     *
+     * - Continental: z -= (max(z,0) / zc) * εc * δt, never eroding below sea level
+     * - Oceanic:     z -= clamp(1 - z/zt, 0, 1) * εo * δt, never sinking below zt
+     * - Trench:      z += εf * δt (oceanic samples flagged in TrenchMask only)
+     * - Ages:        oceanic age / orogeny age advance by δt for their crust type
+     *
+     * Vectorized over the SoA arrays and parallel over cache-sized chunks (honours ptp.parallel).
+     * Crust type is applied with lane masks, so there is no per-sample branch.
+     *
+     * @param Params - Rates, reference elevations and time step (input)
+     * @param Fields - Surface fields, updated in place (input/output)
+     */
+    static void Apply(const FPTPSurfaceProcessParams& Params, FPTPCrustSurfaceSoA& Fields);
+
+    /** Scalar reference for Apply over [Begin, End). Used for the SIMD tail and by tests. */
+    static void ApplyScalar(const FPTPSurfaceProcessParams& Params, FPTPCrustSurfaceSoA& Fields, int32 Begin, int32 End);
+
+    /**
+     * Add low-frequency coherent noise to the elevation field (guide "Low Frequency Coherent Noise").
+     * Noise is sampled on the unit sphere in one batched call, so Settings.Frequency is per planet radius.
+     *
+     * @param SamplePoints - Sample positions, any radius (input)
+     * @param Noise - Seeded noise evaluator (input)
+     * @param Settings - Octave/warp configuration (input)
+     * @param AmplitudeKm - Elevation added for a noise value of 1 (input)
+     * @param Fields - Surface fields; Elevation is updated in place (input/output)
+     */
+    static void ApplyLowFrequencyNoise(const TArray<FVector3f>& SamplePoints, const FPTPNoise& Noise, const FPTPNoiseSettings& Settings,
+                                       float AmplitudeKm, FPTPCrustSurfaceSoA& Fields);
+
+    /** Build parameters from a planet's per-actor rates and the project time step. */
+    static FPTPSurfaceProcessParams MakeParams(const UPTPPlanetComponent& Planet);
+};
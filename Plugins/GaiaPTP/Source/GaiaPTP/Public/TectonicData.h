@@ -4,7 +4,10 @@
 #include "TectonicTypes.h"
 #include "TectonicData.generated.h"
 
-/** Per-sample crust data stored on the planetary sphere. Units in km unless noted. */
+/**
+ * Per-sample crust data stored on the planetary sphere. Units in km unless noted.
+ * Directions are single precision (see PTPPrecision.h); Blueprints reach them through UPTPPrecisionLibrary.
+ */
 USTRUCT(BlueprintType)
 struct GAIAPTP_API FCrustData
 {
@@ -23,8 +26,8 @@ struct GAIAPTP_API FCrustData
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PTP|Oceanic")
     float OceanicAge; // My
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PTP|Oceanic")
-    FVector RidgeDirection; // normalized
+    UPROPERTY(EditAnywhere, Category="PTP|Oceanic")
+    FVector3f RidgeDirection; // normalized
 
     // Continental parameters
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PTP|Continental")
@@ -33,18 +36,18 @@ struct GAIAPTP_API FCrustData
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PTP|Continental")
     EOrogenyType OrogenyType;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PTP|Continental")
-    FVector FoldDirection; // normalized
+    UPROPERTY(EditAnywhere, Category="PTP|Continental")
+    FVector3f FoldDirection; // normalized
 
     FCrustData()
         : Type(ECrustType::Oceanic)
         , Thickness(7.0f)
         , Elevation(-6.0f)
         , OceanicAge(0.0f)
-        , RidgeDirection(FVector::ZeroVector)
+        , RidgeDirection(FVector3f::ZeroVector)
         , OrogenyAge(0.0f)
         , OrogenyType(EOrogenyType::None)
-        , FoldDirection(FVector::ZeroVector)
+        , FoldDirection(FVector3f::ZeroVector)
     {}
 };
 
@@ -82,8 +85,7 @@ struct GAIAPTP_API FTectonicPlate
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PTP|Plate")
     int32 PlateId;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PTP|Plate")
-    TArray<int32> PointIndices;
+    // Member points live in FPTPPlateMembership, one partition for all plates
 
     /** Unit vector on sphere indicating the plate seed/centroid position. */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PTP|Plate")
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "PTPPlateMembership.h"
 
 /** Utilities for seeding plates and assigning points via spherical Voronoi. */
 struct FTectonicSeeding
@@ -19,5 +20,17 @@ struct FTectonicSeeding
                                     const TArray<FVector>& Seeds,
                                     TArray<int32>& OutPointToPlate,
                                     TArray<TArray<int32>>& OutPlateToPoints);
+
+    /**
+     * Same assignment, with Plate->Points as one partition instead of one array per plate.
+     */
+    static void AssignPointsToSeeds(const TArray<FVector>& Points,
+                                    const TArray<FVector>& Seeds,
+                                    TArray<int32>& OutPointToPlate,
+                                    FPTPPlateMembership& OutMembership);
+    static void AssignPointsToSeeds(const TArray<FVector3f>& Points,
+                                    const TArray<FVector>& Seeds,
+                                    TArray<int32>& OutPointToPlate,
+                                    FPTPPlateMembership& OutMembership);
 };
 
@@ -18,3 +18,12 @@ enum class EOrogenyType : uint8
     Himalayan   UMETA(DisplayName="Himalayan")     // Continental collision
 };
 
+
+UENUM(BlueprintType)
+enum class EPTPBoundaryType : uint8
+{
+    None        UMETA(DisplayName="None"),         // Interior point
+    Convergent  UMETA(DisplayName="Convergent"),   // Plates move towards each other (subduction/collision front)
+    Divergent   UMETA(DisplayName="Divergent"),    // Plates move apart (ridge)
+    Transform   UMETA(DisplayName="Transform")     // Plates slide past each other
+};
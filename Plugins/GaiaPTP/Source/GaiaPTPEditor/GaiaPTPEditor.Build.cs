@@ -20,7 +20,8 @@ public class GaiaPTPEditor : ModuleRules
 
         PrivateDependencyModuleNames.AddRange(new string[]
         {
-            "Projects"
+            "Projects",
+            "Landscape"
         });
 
         PublicIncludePaths.AddRange(new string[]
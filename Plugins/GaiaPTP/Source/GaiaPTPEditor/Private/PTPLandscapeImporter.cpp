@@ -0,0 +1,134 @@
+#include "PTPLandscapeImporter.h"
+#include "Editor.h"
+#include "HAL/IConsoleManager.h"
+#include "Landscape.h"
+#include "LandscapeProxy.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPTPLandscapeImport, Log, All);
+
+int32 FPTPLandscapeImporter::GetComponentQuads(int32 TileResolution)
+{
+    // Landscape components are 2^n - 1 quads per side; prefer the largest that tiles evenly
+    const int32 Quads = TileResolution - 1;
+    for (const int32 ComponentQuads : { 255, 127, 63, 31, 15, 7 })
+    {
+        if (Quads >= ComponentQuads && Quads % ComponentQuads == 0)
+        {
+            return ComponentQuads;
+        }
+    }
+    return 0;
+}
+
+bool FPTPLandscapeImporter::ImportTiles(UWorld* World, const FString& ManifestPath, TConstArrayView<FIntVector> Selection,
+                                        const FPTPLandscapeImportSettings& Settings, TArray<ALandscape*>& OutLandscapes, FString& OutError)
+{
+    OutLandscapes.Reset();
+    FPTPBakeManifest Manifest;
+    if (!World || !FPTPBakeManifest::Load(ManifestPath, Manifest, OutError))
+    {
+        OutError = World ? OutError : TEXT("no world");
+        return false;
+    }
+
+    const int32 Res = Manifest.TileResolution;
+    const int32 ComponentQuads = GetComponentQuads(Res);
+    if (ComponentQuads == 0)
+    {
+        OutError = FString::Printf(TEXT("tile resolution %d is not a whole number of Landscape components"), Res);
+        return false;
+    }
+
+    TArray<const FPTPBakedTile*> Tiles;
+    if (Selection.Num() == 0)
+    {
+        for (const FPTPBakedTile& Tile : Manifest.Tiles)
+        {
+            Tiles.Add(&Tile);
+        }
+    }
+    for (const FIntVector& Wanted : Selection)
+    {
+        const FPTPBakedTile* Tile = Manifest.FindTile(Wanted.X, Wanted.Y, Wanted.Z);
+        if (!Tile)
+        {
+            OutError = FString::Printf(TEXT("tile F%d X%d Y%d is not in the bake"), Wanted.X, Wanted.Y, Wanted.Z);
+            return false;
+        }
+        Tiles.Add(Tile);
+    }
+
+    // Landscape heights: local Z = (h - 32768) / 128, so the 16-bit range spans 512 units at scale 1
+    const float SpacingUnits = Manifest.GetTexelSpacingKm() * Settings.WorldUnitsPerKm;
+    const float RangeUnits = (Manifest.MaxElevationKm - Manifest.MinElevationKm) * Settings.WorldUnitsPerKm;
+    const FVector Scale(SpacingUnits, SpacingUnits, RangeUnits / 512.0f);
+    const float MidKm = 0.5f * (Manifest.MinElevationKm + Manifest.MaxElevationKm);
+    const float TileUnits = (Res - 1) * SpacingUnits;
+    const FString BakeDir = FPaths::GetPath(ManifestPath);
+
+    for (const FPTPBakedTile* Tile : Tiles)
+    {
+        TArray<uint16> Heights;
+        if (!FPTPHeightfieldBaker::ReadTile(BakeDir / Tile->File, Res, Manifest.Format, Heights))
+        {
+            OutError = FString::Printf(TEXT("cannot read tile '%s'"), *Tile->File);
+            return false;
+        }
+
+        const FVector Location = Settings.Origin + FVector(
+            (Tile->Face * Manifest.TilesPerFace + Tile->TileX) * TileUnits,
+            Tile->TileY * TileUnits,
+            MidKm * Settings.WorldUnitsPerKm);
+        ALandscape* Landscape = World->SpawnActor<ALandscape>(Location, FRotator::ZeroRotator);
+        if (!Landscape)
+        {
+            OutError = TEXT("failed to spawn a Landscape actor");
+            return false;
+        }
+        Landscape->SetActorRelativeScale3D(Scale);
+        Landscape->SetActorLabel(FPaths::GetBaseFilename(Tile->File));
+
+        TMap<FGuid, TArray<uint16>> HeightData;
+        HeightData.Add(FGuid(), MoveTemp(Heights));
+        TMap<FGuid, TArray<FLandscapeImportLayerInfo>> LayerInfos;
+        LayerInfos.Add(FGuid(), TArray<FLandscapeImportLayerInfo>());
+        Landscape->Import(FGuid::NewGuid(), 0, 0, Res - 1, Res - 1, 1, ComponentQuads, HeightData, nullptr, LayerInfos,
+            ELandscapeImportAlphamapType::Additive);
+        OutLandscapes.Add(Landscape);
+    }
+
+    UE_LOG(LogPTPLandscapeImport, Log, TEXT("Imported %d heightfield tiles of %d^2 from %s"), OutLandscapes.Num(), Res, *ManifestPath);
+    return true;
+}
+
+namespace
+{
+    // Usage: ptp.bake.import <manifest.json> [face x y]...
+    void PTPBakeImport(const TArray<FString>& Args)
+    {
+        if (Args.Num() < 1 || (Args.Num() - 1) % 3 != 0)
+        {
+            UE_LOG(LogPTPLandscapeImport, Warning, TEXT("ptp.bake.import: expected a manifest path, optionally followed by face x y triples"));
+            return;
+        }
+        TArray<FIntVector> Selection;
+        for (int32 i = 1; i + 2 < Args.Num(); i += 3)
+        {
+            Selection.Add(FIntVector(FCString::Atoi(*Args[i]), FCString::Atoi(*Args[i + 1]), FCString::Atoi(*Args[i + 2])));
+        }
+
+        UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+        TArray<ALandscape*> Landscapes;
+        FString Error;
+        if (!FPTPLandscapeImporter::ImportTiles(World, Args[0], Selection, FPTPLandscapeImportSettings(), Landscapes, Error))
+        {
+            UE_LOG(LogPTPLandscapeImport, Warning, TEXT("ptp.bake.import: %s"), *Error);
+        }
+    }
+
+    FAutoConsoleCommand CmdBakeImport(
+        TEXT("ptp.bake.import"),
+        TEXT("Import baked heightfield tiles as Landscapes into the editor world: ptp.bake.import <manifest.json> [face x y]..."),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&PTPBakeImport));
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PTPHeightfieldBaker.h"
+
+class ALandscape;
+class UWorld;
+
+/** Placement of imported heightfield tiles. */
+struct FPTPLandscapeImportSettings
+{
+    /** World units per km; 100000 keeps the planet at true scale in centimetres. */
+    float WorldUnitsPerKm = 100000.0f;
+
+    /** Origin of the unfolded layout: faces side by side along X, each TilesPerFace tiles square. */
+    FVector Origin = FVector::ZeroVector;
+};
+
+/**
+ * Editor import of baked cube-map tiles (FPTPHeightfieldBaker) as Landscape actors.
+ *
+ * Each tile becomes its own ALandscape, scaled so texels are the bake's texel spacing apart and
+ * sea level sits at Origin.Z. Tiles of one face share their edge texels and are placed edge to
+ * edge, so neighbouring proxies stitch; different faces are laid out side by side, since a cube
+ * face seam has no planar equivalent.
+ */
+class GAIAPTPEDITOR_API FPTPLandscapeImporter
+{
+public:
+    /**
+     * Import tiles from a bake.
+     *
+     * @param World - Editor world to spawn into (input)
+     * @param ManifestPath - Manifest written by FPTPHeightfieldBaker::Bake (input)
+     * @param Selection - Tiles as (face, x, y); empty imports every tile of the manifest (input)
+     * @param Settings - Scale and placement (input)
+     * @param OutLandscapes - Spawned actors, one per imported tile (output)
+     * @param OutError - Reason for a failure (output)
+     * @return true if every selected tile was imported
+     */
+    static bool ImportTiles(UWorld* World, const FString& ManifestPath, TConstArrayView<FIntVector> Selection,
+                            const FPTPLandscapeImportSettings& Settings, TArray<ALandscape*>& OutLandscapes, FString& OutError);
+
+    /** Quads per Landscape component for a tile; 0 if no supported component size divides the tile. */
+    static int32 GetComponentQuads(int32 TileResolution);
+};
@@ -7,6 +7,13 @@
 #include "Mesh/RealtimeMeshBlueprintMeshBuilder.h"
 #include "Core/RealtimeMeshBuilder.h"
 #include "MeshOptimizer/meshoptimizer.h"
+#include "RealtimeMeshSimple.h"
+#include "RealtimeMeshThreadingSubsystem.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Unique.h"
+#include "Data/RealtimeMeshUpdateBuilder.h"
 
 using namespace RealtimeMesh;
 
@@ -326,6 +333,373 @@ void URealtimeMeshDataOptimizer::OptimizeVertexFetch(RealtimeMesh::FRealtimeMesh
 	RemapAllVertexStreams(Streams, RemapTable, NewVertexCount);
 }
 
+// Simplified index buffers of one section, over the section's own compacted vertices
+struct FRealtimeMeshSectionLODChain
+{
+	TArray<uint32> LocalToSource;
+	TArray<TArray<uint32>> Indices;
+	TArray<float> Errors;
+};
+
+static void SimplifySectionChain(FRealtimeMeshSectionLODChain& Chain, TConstArrayView<uint32> SectionIndices, TConstArrayView<FVector3f> Positions,
+	TConstArrayView<float> Attributes, TConstArrayView<float> AttributeWeights, float MeshScale, int32 NumLODs, const FRealtimeMeshLODChainSettings& Settings)
+{
+	Chain.Indices.SetNum(NumLODs);
+	Chain.Errors.Init(0.0f, NumLODs);
+	if (SectionIndices.Num() == 0)
+	{
+		return;
+	}
+
+	// Compact to the vertices this section uses so each simplification only touches its share of the mesh
+	Chain.LocalToSource = TArray<uint32>(SectionIndices.GetData(), SectionIndices.Num());
+	Chain.LocalToSource.Sort();
+	Chain.LocalToSource.SetNum(Algo::Unique(Chain.LocalToSource));
+	const int32 NumLocalVertices = Chain.LocalToSource.Num();
+	const int32 AttributeCount = AttributeWeights.Num();
+
+	TArray<FVector3f> LocalPositions;
+	TArray<float> LocalAttributes;
+	LocalPositions.SetNumUninitialized(NumLocalVertices);
+	LocalAttributes.SetNumUninitialized(NumLocalVertices * AttributeCount);
+	for (int32 Index = 0; Index < NumLocalVertices; Index++)
+	{
+		const uint32 SourceIndex = Chain.LocalToSource[Index];
+		LocalPositions[Index] = Positions[SourceIndex];
+		for (int32 Attribute = 0; Attribute < AttributeCount; Attribute++)
+		{
+			LocalAttributes[Index * AttributeCount + Attribute] = Attributes[SourceIndex * AttributeCount + Attribute];
+		}
+	}
+
+	TArray<uint32> Previous;
+	Previous.SetNumUninitialized(SectionIndices.Num());
+	for (int32 Index = 0; Index < SectionIndices.Num(); Index++)
+	{
+		Previous[Index] = Algo::LowerBound(Chain.LocalToSource, SectionIndices[Index]);
+	}
+
+	// meshoptimizer errors are relative to the extent of its input; convert to and from the extent of the whole mesh
+	const float SectionScale = meshopt_simplifyScale(reinterpret_cast<const float*>(LocalPositions.GetData()), NumLocalVertices, sizeof(FVector3f));
+	const float ErrorScale = SectionScale > UE_SMALL_NUMBER ? MeshScale / SectionScale : 1.0f;
+
+	for (int32 LODIndex = 0; LODIndex < NumLODs; LODIndex++)
+	{
+		const size_t TargetIndexCount = FMath::Max<size_t>(3, static_cast<size_t>(Previous.Num() * Settings.ReductionPerLOD) / 3 * 3);
+
+		TArray<uint32>& Simplified = Chain.Indices[LODIndex];
+		Simplified.SetNumUninitialized(Previous.Num());
+		float StepError = 0.0f;
+		size_t IndexCount = 0;
+		if (AttributeCount > 0)
+		{
+			IndexCount = meshopt_simplifyWithAttributes(Simplified.GetData(), Previous.GetData(), Previous.Num(),
+				reinterpret_cast<const float*>(LocalPositions.GetData()), NumLocalVertices, sizeof(FVector3f),
+				LocalAttributes.GetData(), AttributeCount * sizeof(float), AttributeWeights.GetData(), AttributeCount, nullptr,
+				TargetIndexCount, Settings.MaxError * ErrorScale, meshopt_SimplifyLockBorder, &StepError);
+		}
+		else
+		{
+			IndexCount = meshopt_simplify(Simplified.GetData(), Previous.GetData(), Previous.Num(),
+				reinterpret_cast<const float*>(LocalPositions.GetData()), NumLocalVertices, sizeof(FVector3f),
+				TargetIndexCount, Settings.MaxError * ErrorScale, meshopt_SimplifyLockBorder, &StepError);
+		}
+		Simplified.SetNum(IndexCount);
+		Chain.Errors[LODIndex] = StepError / ErrorScale;
+		Previous = Simplified;
+	}
+}
+
+TArray<FRealtimeMeshSimplifiedLOD> URealtimeMeshDataOptimizer::GenerateLODChain(const RealtimeMesh::FRealtimeMeshStreamSet& Streams,
+	TConstArrayView<FRealtimeMeshStreamRange> SectionRanges, const FRealtimeMeshLODChainSettings& Settings)
+{
+	TArray<FRealtimeMeshSimplifiedLOD> LODs;
+
+	// Check that we have vertex data to simplify
+	if (!ensure(Streams.Contains(FRealtimeMeshStreams::Position) && Streams.Contains(FRealtimeMeshStreams::Triangles)))
+	{
+		return LODs;
+	}
+
+	const int32 NumLODs = FMath::Clamp(Settings.NumLODs, 0, REALTIME_MESH_MAX_LODS - 1);
+
+	// Positions and indices in the plain layouts meshoptimizer expects
+	TArray<FVector3f> Positions;
+	{
+		TRealtimeMeshStreamBuilder<const FVector3f, void> PositionBuilder(Streams.FindChecked(FRealtimeMeshStreams::Position));
+		Positions.SetNumUninitialized(PositionBuilder.Num());
+		for (int32 Index = 0; Index < Positions.Num(); Index++)
+		{
+			Positions[Index] = PositionBuilder[Index];
+		}
+	}
+	const int32 NumVertices = Positions.Num();
+
+	TArray<uint32> Indices;
+	{
+		TRealtimeMeshStreamBuilder<const TIndex3<uint32>, void> TriangleBuilder(Streams.FindChecked(FRealtimeMeshStreams::Triangles));
+		Indices.SetNumUninitialized(TriangleBuilder.Num() * 3);
+		for (int32 Index = 0; Index < TriangleBuilder.Num(); Index++)
+		{
+			const TIndex3<uint32> Triangle = TriangleBuilder[Index];
+			Indices[Index * 3 + 0] = Triangle.V0;
+			Indices[Index * 3 + 1] = Triangle.V1;
+			Indices[Index * 3 + 2] = Triangle.V2;
+		}
+	}
+
+	if (NumLODs == 0 || NumVertices == 0 || Indices.Num() == 0)
+	{
+		return LODs;
+	}
+
+	// Interleaved attributes for the error metric: normal, colour and first UV channel, each only if weighted and present
+	auto FindVertexStream = [&](const FRealtimeMeshStreamKey& StreamKey, float Weight) -> const FRealtimeMeshStream*
+	{
+		const FRealtimeMeshStream* Stream = Streams.Find(StreamKey);
+		return (Weight > 0.0f && Stream && Stream->Num() == NumVertices) ? Stream : nullptr;
+	};
+	const FRealtimeMeshStream* TangentStream = FindVertexStream(FRealtimeMeshStreams::Tangents, Settings.NormalWeight);
+	const FRealtimeMeshStream* ColorStream = FindVertexStream(FRealtimeMeshStreams::Color, Settings.ColorWeight);
+	const FRealtimeMeshStream* TexCoordStream = FindVertexStream(FRealtimeMeshStreams::TexCoords, Settings.TexCoordWeight);
+
+	TArray<float> AttributeWeights;
+	if (TangentStream) { AttributeWeights.Append({ Settings.NormalWeight, Settings.NormalWeight, Settings.NormalWeight }); }
+	if (ColorStream) { AttributeWeights.Append({ Settings.ColorWeight, Settings.ColorWeight, Settings.ColorWeight }); }
+	if (TexCoordStream) { AttributeWeights.Append({ Settings.TexCoordWeight, Settings.TexCoordWeight }); }
+	const int32 AttributeCount = AttributeWeights.Num();
+
+	TArray<float> Attributes;
+	Attributes.SetNumUninitialized(NumVertices * AttributeCount);
+	int32 AttributeOffset = 0;
+	if (TangentStream)
+	{
+		TRealtimeMeshStreamBuilder<const FRealtimeMeshTangentsHighPrecision, void> TangentBuilder(*TangentStream);
+		for (int32 Index = 0; Index < NumVertices; Index++)
+		{
+			const FRealtimeMeshTangentsHighPrecision Tangent = TangentBuilder[Index];
+			const FVector3f Normal = Tangent.GetNormal();
+			float* Attribute = &Attributes[Index * AttributeCount + AttributeOffset];
+			Attribute[0] = Normal.X;
+			Attribute[1] = Normal.Y;
+			Attribute[2] = Normal.Z;
+		}
+		AttributeOffset += 3;
+	}
+	if (ColorStream)
+	{
+		TRealtimeMeshStreamBuilder<const FColor, void> ColorBuilder(*ColorStream);
+		for (int32 Index = 0; Index < NumVertices; Index++)
+		{
+			const FColor Color = ColorBuilder[Index];
+			float* Attribute = &Attributes[Index * AttributeCount + AttributeOffset];
+			Attribute[0] = Color.R / 255.0f;
+			Attribute[1] = Color.G / 255.0f;
+			Attribute[2] = Color.B / 255.0f;
+		}
+		AttributeOffset += 3;
+	}
+	if (TexCoordStream)
+	{
+		TRealtimeMeshStridedStreamBuilder<const FVector2f, void> TexCoordBuilder(*TexCoordStream);
+		for (int32 Index = 0; Index < NumVertices; Index++)
+		{
+			const FVector2f TexCoord = TexCoordBuilder[Index];
+			float* Attribute = &Attributes[Index * AttributeCount + AttributeOffset];
+			Attribute[0] = TexCoord.X;
+			Attribute[1] = TexCoord.Y;
+		}
+		AttributeOffset += 2;
+	}
+
+	TArray<FInt32Range> IndexRanges;
+	if (SectionRanges.Num() == 0)
+	{
+		IndexRanges.Add(FInt32Range(0, Indices.Num()));
+	}
+	for (const FRealtimeMeshStreamRange& Range : SectionRanges)
+	{
+		const int32 First = FMath::Clamp(Range.GetMinIndex(), 0, Indices.Num());
+		IndexRanges.Add(FInt32Range(First, FMath::Clamp(Range.GetMaxIndex() + 1, First, Indices.Num())));
+	}
+
+	const float MeshScale = meshopt_simplifyScale(reinterpret_cast<const float*>(Positions.GetData()), NumVertices, sizeof(FVector3f));
+
+	TArray<FRealtimeMeshSectionLODChain> Chains;
+	Chains.SetNum(IndexRanges.Num());
+	auto SimplifySection = [&](int32 SectionIndex)
+	{
+		const FInt32Range& Range = IndexRanges[SectionIndex];
+		const TConstArrayView<uint32> SectionIndices(Indices.GetData() + Range.GetLowerBoundValue(), Range.Size<int32>());
+		SimplifySectionChain(Chains[SectionIndex], SectionIndices, Positions, Attributes, AttributeWeights, MeshScale, NumLODs, Settings);
+	};
+
+	// Sections are independent; run them on the realtime mesh pool when it is up
+	URealtimeMeshThreadingSubsystem* ThreadingSubsystem = GEngine ? URealtimeMeshThreadingSubsystem::Get() : nullptr;
+	if (ThreadingSubsystem && Chains.Num() > 1)
+	{
+		TArray<TFuture<void>> Tasks;
+		Tasks.Reserve(Chains.Num());
+		for (int32 SectionIndex = 0; SectionIndex < Chains.Num(); SectionIndex++)
+		{
+			Tasks.Add(AsyncPool(ThreadingSubsystem->GetThreadPool(), [&SimplifySection, SectionIndex]() { SimplifySection(SectionIndex); }));
+		}
+		for (TFuture<void>& Task : Tasks)
+		{
+			Task.Wait();
+		}
+	}
+	else
+	{
+		ParallelFor(Chains.Num(), SimplifySection);
+	}
+
+	// Stitch the sections of each LOD together over a compacted vertex set, kept in source order for fetch locality
+	TArray<uint32> SourceToLOD;
+	int32 PreviousIndexCount = Indices.Num();
+	float PreviousError = 0.0f;
+	float PreviousScreenSize = 1.0f;
+	for (int32 LODIndex = 0; LODIndex < NumLODs; LODIndex++)
+	{
+		int32 IndexCount = 0;
+		float StepError = 0.0f;
+		for (const FRealtimeMeshSectionLODChain& Chain : Chains)
+		{
+			IndexCount += Chain.Indices[LODIndex].Num();
+			StepError = FMath::Max(StepError, Chain.Errors[LODIndex]);
+		}
+
+		// Stop once a step no longer pays for another LOD
+		if (IndexCount == 0 || IndexCount > PreviousIndexCount * 0.9f)
+		{
+			break;
+		}
+
+		FRealtimeMeshSimplifiedLOD& LOD = LODs.AddDefaulted_GetRef();
+		SourceToLOD.Init(~0u, NumVertices);
+		for (const FRealtimeMeshSectionLODChain& Chain : Chains)
+		{
+			for (const uint32 LocalIndex : Chain.Indices[LODIndex])
+			{
+				SourceToLOD[Chain.LocalToSource[LocalIndex]] = 0;
+			}
+		}
+		for (int32 Index = 0; Index < NumVertices; Index++)
+		{
+			if (SourceToLOD[Index] != ~0u)
+			{
+				SourceToLOD[Index] = LOD.SourceVertices.Add(Index);
+			}
+		}
+
+		LOD.Indices.Reserve(IndexCount);
+		for (const FRealtimeMeshSectionLODChain& Chain : Chains)
+		{
+			const int32 FirstIndex = LOD.Indices.Num();
+			for (const uint32 LocalIndex : Chain.Indices[LODIndex])
+			{
+				LOD.Indices.Add(SourceToLOD[Chain.LocalToSource[LocalIndex]]);
+			}
+			LOD.SectionRanges.Add(FRealtimeMeshStreamRange(0, LOD.SourceVertices.Num(), FirstIndex, LOD.Indices.Num()));
+		}
+
+		// Errors add up along the chain; a LOD may be drawn once its error projects below the pixel budget
+		LOD.Error = PreviousError + StepError;
+		LOD.ScreenSize = LOD.Error > 0.0f
+			? FMath::Min(PreviousScreenSize, Settings.MaxPixelError / (LOD.Error * Settings.ReferenceScreenHeight))
+			: PreviousScreenSize;
+
+		PreviousIndexCount = IndexCount;
+		PreviousError = LOD.Error;
+		PreviousScreenSize = LOD.ScreenSize;
+	}
+
+	return LODs;
+}
+
+void URealtimeMeshDataOptimizer::BuildLODStreams(const RealtimeMesh::FRealtimeMeshStreamSet& Source, const FRealtimeMeshSimplifiedLOD& LOD, RealtimeMesh::FRealtimeMeshStreamSet& OutStreams)
+{
+	OutStreams.Empty();
+
+	Source.ForEach([&](const FRealtimeMeshStream& Stream)
+	{
+		if (Stream.GetStreamType() != ERealtimeMeshStreamType::Vertex)
+		{
+			return;
+		}
+
+		if (Stream.Num() <= 1) // Single element streams apply equally to all vertices
+		{
+			OutStreams.AddStream(Stream);
+			return;
+		}
+
+		FRealtimeMeshStream NewStream(Stream.GetStreamKey(), Stream.GetLayout());
+		NewStream.SetNumUninitialized(LOD.SourceVertices.Num());
+		const int32 Stride = Stream.GetStride();
+		for (int32 Index = 0; Index < LOD.SourceVertices.Num(); Index++)
+		{
+			FMemory::Memcpy(NewStream.GetDataRawAtVertex(Index), Stream.GetDataRawAtVertex(LOD.SourceVertices[Index]), Stride);
+		}
+		OutStreams.AddStream(MoveTemp(NewStream));
+	});
+
+	FRealtimeMeshStream& Triangles = OutStreams.AddStream<TIndex3<uint32>>(FRealtimeMeshStreams::Triangles);
+	Triangles.SetNumUninitialized(LOD.Indices.Num() / 3);
+	FMemory::Memcpy(Triangles.GetData(), LOD.Indices.GetData(), LOD.Indices.Num() * sizeof(uint32));
+}
+
+void URealtimeMeshDataOptimizer::ApplyLODChain(URealtimeMeshSimple* Mesh, const FRealtimeMeshSectionGroupKey& SourceGroupKey, const RealtimeMesh::FRealtimeMeshStreamSet& Source,
+	TConstArrayView<FRealtimeMeshSimplifiedLOD> LODs, TConstArrayView<int32> SectionIds, int32 MaterialSlot)
+{
+	if (!Mesh)
+	{
+		UE_LOG(LogRealtimeMesh, Warning, TEXT("ApplyLODChain: Invalid Mesh"));
+		return;
+	}
+
+	int32 NumMeshLODs = 0;
+	{
+		const FRealtimeMeshAccessContext AccessContext(Mesh->GetMesh());
+		NumMeshLODs = Mesh->GetMesh()->GetNumLODs(AccessContext);
+	}
+	while (NumMeshLODs > LODs.Num() + 1)
+	{
+		Mesh->RemoveTrailingLOD();
+		NumMeshLODs--;
+	}
+
+	for (int32 Index = 0; Index < LODs.Num(); Index++)
+	{
+		const FRealtimeMeshSimplifiedLOD& LOD = LODs[Index];
+		const FRealtimeMeshLODConfig LODConfig(LOD.ScreenSize);
+		FRealtimeMeshLODKey LODKey(Index + 1);
+		if (Index + 1 < NumMeshLODs)
+		{
+			Mesh->UpdateLODConfig(LODKey, LODConfig);
+		}
+		else
+		{
+			LODKey = Mesh->AddLOD(LODConfig);
+		}
+
+		FRealtimeMeshStreamSet Streams;
+		BuildLODStreams(Source, LOD, Streams);
+
+		const FRealtimeMeshSectionGroupKey GroupKey = FRealtimeMeshSectionGroupKey::Create(LODKey, SourceGroupKey.Name());
+		Mesh->CreateSectionGroup(GroupKey, MoveTemp(Streams), FRealtimeMeshSectionGroupConfig(), false);
+		for (int32 RangeIndex = 0; RangeIndex < LOD.SectionRanges.Num(); RangeIndex++)
+		{
+			if (LOD.SectionRanges[RangeIndex].NumPrimitives(3) == 0)
+			{
+				continue;
+			}
+			const int32 SectionId = SectionIds.IsValidIndex(RangeIndex) ? SectionIds[RangeIndex] : RangeIndex;
+			Mesh->CreateSection(FRealtimeMeshSectionKey::Create(GroupKey, SectionId), FRealtimeMeshSectionConfig(MaterialSlot), LOD.SectionRanges[RangeIndex]);
+		}
+	}
+}
+
 void URealtimeMeshDataOptimizer::OptimizeMeshIndexing(URealtimeMeshStreamSet* Streams)
 {
 	if (!Streams)
@@ -4,10 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "Core/RealtimeMeshDataStream.h"
+#include "Core/RealtimeMeshKeys.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "RealtimeMeshDataOptimizer.generated.h"
 
 class URealtimeMeshStreamSet;
+class URealtimeMeshSimple;
 
 UENUM()
 enum class ERealtimeMeshOptimizationQuality : uint8
@@ -16,6 +18,51 @@ enum class ERealtimeMeshOptimizationQuality : uint8
 	GenerationSpeed
 };
 
+/**
+ *	Settings for URealtimeMeshDataOptimizer::GenerateLODChain
+ */
+struct REALTIMEMESHEXT_API FRealtimeMeshLODChainSettings
+{
+	// Number of simplified LODs generated after the source mesh, at most REALTIME_MESH_MAX_LODS - 1
+	int32 NumLODs = 3;
+
+	// Target index count of each LOD as a fraction of the previous one
+	float ReductionPerLOD = 0.25f;
+
+	// Largest error a single simplification step may introduce, relative to the extent of the whole mesh
+	float MaxError = 0.05f;
+
+	// Weights of the vertex attributes in the simplification error, 0 to ignore an attribute
+	float NormalWeight = 0.5f;
+	float ColorWeight = 0.0f;
+	float TexCoordWeight = 0.0f;
+
+	// Screen-space error, in pixels at ReferenceScreenHeight, a LOD may show before it is selected; drives the LOD screen sizes
+	float MaxPixelError = 1.0f;
+	float ReferenceScreenHeight = 1080.0f;
+};
+
+/**
+ *	One simplified level of a LOD chain, over a compacted subset of the source vertices
+ */
+struct REALTIMEMESHEXT_API FRealtimeMeshSimplifiedLOD
+{
+	// Source vertex of each vertex in this LOD
+	TArray<uint32> SourceVertices;
+
+	// Triangle list indexing into SourceVertices
+	TArray<uint32> Indices;
+
+	// Range of each source section within this LOD, in the order the source ranges were given
+	TArray<FRealtimeMeshStreamRange> SectionRanges;
+
+	// Accumulated simplification error relative to the extent of the whole mesh
+	float Error = 0.0f;
+
+	// Screen size below which this LOD is drawn
+	float ScreenSize = 0.0f;
+};
+
 /**
  * 
  */
@@ -46,6 +93,29 @@ public:
 	 */
 	static void OptimizeVertexFetch(RealtimeMesh::FRealtimeMeshStreamSet& Streams);
 
+	/**
+	 *	Generates a chain of simplified LODs with meshopt_simplifyWithAttributes, each built from the one before it.
+	 *	Every section range is simplified on its own with its border locked, so sections stay crack-free against each other
+	 *	and keep a range in every LOD. Sections are processed in parallel on the realtime mesh thread pool. The chain stops
+	 *	early once a step no longer reduces the mesh meaningfully.
+	 *	@param SectionRanges	Index ranges of the sections to simplify independently; empty treats the whole mesh as one section
+	 */
+	static TArray<FRealtimeMeshSimplifiedLOD> GenerateLODChain(const RealtimeMesh::FRealtimeMeshStreamSet& Streams,
+		TConstArrayView<FRealtimeMeshStreamRange> SectionRanges, const FRealtimeMeshLODChainSettings& Settings);
+
+	/**
+	 *	Builds the stream set of a simplified LOD by gathering every vertex stream of Source through its SourceVertices.
+	 */
+	static void BuildLODStreams(const RealtimeMesh::FRealtimeMeshStreamSet& Source, const FRealtimeMeshSimplifiedLOD& LOD, RealtimeMesh::FRealtimeMeshStreamSet& OutStreams);
+
+	/**
+	 *	Uploads a LOD chain: LOD i + 1 of Mesh gets a section group named like SourceGroupKey holding LODs[i], with one section
+	 *	per range and the LOD's screen size. Sections use SectionIds[r] for range r, or r when no ids are given.
+	 *	Trailing LODs of Mesh beyond the chain are removed.
+	 */
+	static void ApplyLODChain(URealtimeMeshSimple* Mesh, const FRealtimeMeshSectionGroupKey& SourceGroupKey, const RealtimeMesh::FRealtimeMeshStreamSet& Source,
+		TConstArrayView<FRealtimeMeshSimplifiedLOD> LODs, TConstArrayView<int32> SectionIds = TConstArrayView<int32>(), int32 MaterialSlot = 0);
+
 
 	/**
 	 *	Generates, or re-generates the Triangles streams to remove redundant vertices.